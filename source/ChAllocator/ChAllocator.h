@@ -0,0 +1,161 @@
+#ifndef CHALLOCATOR
+#define CHALLOCATOR
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+#include "ChArena.h"
+#include "ChPool.h"
+
+/**
+ * @brief A standard allocator that allocates from a ChArena.
+ *
+ * Deallocation is a no-op; the memory is reclaimed when the arena is reset. The allocator only refers to the arena,
+ * so the arena must outlive every container that uses it. Containers keep their arena when they are move assigned or
+ * swapped, like std::pmr containers; swapping containers of different arenas is not allowed.
+ *
+ * @code
+ * ChArena arena;
+ * ChVector<int, ChArenaAllocator<int>> ids(arena);
+ * @endcode
+ *
+ * @tparam T The type of the allocated objects.
+ */
+template <typename T>
+class ChArenaAllocator
+{
+public:
+    using value_type = T;
+
+    /**
+     * @brief Constructs an allocator that allocates from `arena`.
+     *
+     * @param arena The arena to allocate from.
+     */
+    ChArenaAllocator(ChArena &arena) noexcept : arena_(&arena) {}
+
+    /**
+     * @brief Constructs an allocator for T that allocates from the arena of `other`.
+     */
+    template <typename U>
+    ChArenaAllocator(const ChArenaAllocator<U> &other) noexcept : arena_(&other.arena()) {}
+
+    /**
+     * @brief Allocates uninitialized memory for `count` objects.
+     *
+     * @throws std::bad_array_new_length if the size overflows, std::bad_alloc if the arena cannot grow.
+     */
+    T *allocate(size_t count)
+    {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T *>(arena_->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * @brief Does nothing. The memory is reclaimed when the arena is reset.
+     */
+    void deallocate(T *, size_t) noexcept {}
+
+    /**
+     * @brief Returns the arena of the allocator.
+     */
+    ChArena &arena() const noexcept
+    {
+        return *arena_;
+    }
+
+private:
+    ChArena *arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ChArenaAllocator<T> &left, const ChArenaAllocator<U> &right) noexcept
+{
+    return &left.arena() == &right.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ChArenaAllocator<T> &left, const ChArenaAllocator<U> &right) noexcept
+{
+    return !(left == right);
+}
+
+/**
+ * @brief A standard allocator that allocates from a ChPool.
+ *
+ * Memory freed by a container goes back to the free lists of the pool for reuse. The allocator only refers to the
+ * pool, so the pool must outlive every container that uses it. Containers keep their pool when they are move assigned
+ * or swapped; swapping containers of different pools is not allowed.
+ *
+ * @tparam T The type of the allocated objects.
+ */
+template <typename T>
+class ChPoolAllocator
+{
+public:
+    using value_type = T;
+
+    /**
+     * @brief Constructs an allocator that allocates from `pool`.
+     *
+     * @param pool The pool to allocate from.
+     */
+    ChPoolAllocator(ChPool &pool) noexcept : pool_(&pool) {}
+
+    /**
+     * @brief Constructs an allocator for T that allocates from the pool of `other`.
+     */
+    template <typename U>
+    ChPoolAllocator(const ChPoolAllocator<U> &other) noexcept : pool_(&other.pool()) {}
+
+    /**
+     * @brief Allocates uninitialized memory for `count` objects.
+     *
+     * @throws std::bad_array_new_length if the size overflows, std::bad_alloc if the memory cannot be allocated.
+     */
+    T *allocate(size_t count)
+    {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T *>(pool_->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * @brief Returns the memory of `count` objects to the pool.
+     */
+    void deallocate(T *pointer, size_t count) noexcept
+    {
+        pool_->deallocate(pointer, count * sizeof(T), alignof(T));
+    }
+
+    /**
+     * @brief Returns the pool of the allocator.
+     */
+    ChPool &pool() const noexcept
+    {
+        return *pool_;
+    }
+
+private:
+    ChPool *pool_;
+};
+
+template <typename T, typename U>
+bool operator==(const ChPoolAllocator<T> &left, const ChPoolAllocator<U> &right) noexcept
+{
+    return &left.pool() == &right.pool();
+}
+
+template <typename T, typename U>
+bool operator!=(const ChPoolAllocator<T> &left, const ChPoolAllocator<U> &right) noexcept
+{
+    return !(left == right);
+}
+
+#endif
\ No newline at end of file
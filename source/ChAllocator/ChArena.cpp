@@ -0,0 +1,133 @@
+#include "ChArena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+// The header of every block. The usable memory follows it and starts at the fundamental alignment.
+struct alignas(std::max_align_t) ChArena::Block
+{
+    Block *next;
+    size_t size;
+};
+
+namespace
+{
+    // Blocks stop doubling at this size, so one burst of allocations does not leave a huge block behind
+    const size_t maxBlockSize = static_cast<size_t>(64) << 20;
+
+    uintptr_t alignUp(uintptr_t address, size_t alignment)
+    {
+        return (address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    }
+}
+
+ChArena::ChArena(size_t blockSize)
+    : blocks_(nullptr), cursor_(nullptr), end_(nullptr), nextBlockSize_(std::max<size_t>(blockSize, 64)), used_(0), reserved_(0)
+{
+}
+
+ChArena::~ChArena()
+{
+    release();
+}
+
+void *ChArena::allocate(size_t size, size_t alignment)
+{
+    uintptr_t aligned = alignUp(reinterpret_cast<uintptr_t>(cursor_), alignment);
+    if (cursor_ == nullptr || aligned > reinterpret_cast<uintptr_t>(end_) || size > reinterpret_cast<uintptr_t>(end_) - aligned)
+    {
+        grow(size, alignment);
+        aligned = alignUp(reinterpret_cast<uintptr_t>(cursor_), alignment);
+    }
+
+    char *result = reinterpret_cast<char *>(aligned);
+    used_ += static_cast<size_t>(result + size - cursor_);
+    cursor_ = result + size;
+    return result;
+}
+
+void ChArena::reset()
+{
+    if (blocks_ == nullptr)
+    {
+        return;
+    }
+
+    Block *largest = blocks_;
+    for (Block *block = blocks_->next; block != nullptr; block = block->next)
+    {
+        if (block->size > largest->size)
+        {
+            largest = block;
+        }
+    }
+
+    Block *block = blocks_;
+    while (block != nullptr)
+    {
+        Block *next = block->next;
+        if (block != largest)
+        {
+            ::operator delete(block);
+        }
+        block = next;
+    }
+
+    largest->next = nullptr;
+    blocks_ = largest;
+    cursor_ = reinterpret_cast<char *>(largest + 1);
+    end_ = cursor_ + largest->size;
+    used_ = 0;
+    reserved_ = largest->size;
+}
+
+void ChArena::release()
+{
+    while (blocks_ != nullptr)
+    {
+        Block *next = blocks_->next;
+        ::operator delete(blocks_);
+        blocks_ = next;
+    }
+    cursor_ = nullptr;
+    end_ = nullptr;
+    used_ = 0;
+    reserved_ = 0;
+}
+
+size_t ChArena::bytesUsed() const
+{
+    return used_;
+}
+
+size_t ChArena::bytesReserved() const
+{
+    return reserved_;
+}
+
+void ChArena::grow(size_t size, size_t alignment)
+{
+    if (size > std::numeric_limits<size_t>::max() - sizeof(Block) - alignment)
+    {
+        throw std::bad_alloc();
+    }
+
+    // Room for the worst case padding keeps the allocation inside the block whatever the alignment
+    size_t blockSize = std::max(nextBlockSize_, size + alignment);
+    Block *block = static_cast<Block *>(::operator new(sizeof(Block) + blockSize));
+    block->next = blocks_;
+    block->size = blockSize;
+    blocks_ = block;
+
+    // The unused tail of the previous block is abandoned; it counts as used so that bytesUsed covers all waste
+    if (cursor_ != nullptr)
+    {
+        used_ += static_cast<size_t>(end_ - cursor_);
+    }
+    cursor_ = reinterpret_cast<char *>(block + 1);
+    end_ = cursor_ + blockSize;
+    reserved_ += blockSize;
+    nextBlockSize_ = std::min(std::max(nextBlockSize_, blockSize) * 2, maxBlockSize);
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#ifndef CHARENA
+#define CHARENA
+
+#include <cstddef>
+
+/**
+ * @brief A monotonic memory arena.
+ *
+ * Allocations bump a pointer through large blocks and are never freed one by one; `reset()` releases all of them at
+ * once. This suits objects that share a lifetime, such as the temporaries of a single request. Blocks grow
+ * geometrically, so an arena that is reset and reused settles on a single block and stops calling the system
+ * allocator altogether.
+ *
+ * An arena is not thread safe. Use ChArenaAllocator to put standard containers and ChVector objects into an arena.
+ *
+ * @code
+ * ChArena arena;
+ * for (const Request &request : requests)
+ * {
+ *     ChVector<int, ChArenaAllocator<int>> ids(arena);
+ *     ...
+ *     arena.reset();
+ * }
+ * @endcode
+ */
+class ChArena
+{
+public:
+    /**
+     * @brief Constructs an empty arena. No memory is allocated until the first allocation.
+     *
+     * @param blockSize The size in bytes of the first block. Later blocks double in size.
+     */
+    explicit ChArena(size_t blockSize = 4096);
+
+    /**
+     * @brief Destructor. Frees all blocks. Objects in the arena are not destroyed.
+     */
+    ~ChArena();
+
+    ChArena(const ChArena &) = delete;
+    ChArena &operator=(const ChArena &) = delete;
+
+    /**
+     * @brief Allocates `size` bytes aligned to `alignment`.
+     *
+     * @param size The number of bytes to allocate.
+     * @param alignment The alignment of the memory, a power of two.
+     * @return A pointer to the memory, which stays valid until the arena is reset or destroyed.
+     * @throws std::bad_alloc if a new block cannot be allocated.
+     */
+    void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Releases all allocations at once in constant time, apart from freeing surplus blocks.
+     *
+     * The largest block is kept for the allocations that follow; the others are freed.
+     */
+    void reset();
+
+    /**
+     * @brief Releases all allocations and frees all blocks.
+     */
+    void release();
+
+    /**
+     * @brief Returns the number of bytes handed out since the last reset, including alignment padding and the unused
+     * ends of full blocks.
+     */
+    size_t bytesUsed() const;
+
+    /**
+     * @brief Returns the number of bytes held in blocks.
+     */
+    size_t bytesReserved() const;
+
+private:
+    struct Block;
+
+    /**
+     * @brief Adds a block large enough for `size` bytes at `alignment` and makes it the current one.
+     */
+    void grow(size_t size, size_t alignment);
+
+    Block *blocks_;
+    char *cursor_;
+    char *end_;
+    size_t nextBlockSize_;
+    size_t used_;
+    size_t reserved_;
+};
+
+#endif
\ No newline at end of file
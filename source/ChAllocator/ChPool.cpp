@@ -0,0 +1,137 @@
+#include "ChPool.h"
+
+#include <algorithm>
+#include <new>
+
+// The header of every slab. The blocks follow it and start at the fundamental alignment.
+struct alignas(std::max_align_t) ChPool::Slab
+{
+    Slab *next;
+};
+
+namespace
+{
+    const size_t minClassBits = 3;
+
+    /**
+     * @brief Returns the size class of a request: the index of the smallest power of two of at least 8 bytes that
+     * holds `size` bytes at `alignment`.
+     */
+    size_t sizeClassOf(size_t size, size_t alignment)
+    {
+        size_t bytes = std::max(size, alignment);
+        size_t sizeClass = 0;
+        while ((static_cast<size_t>(1) << (sizeClass + minClassBits)) < bytes)
+        {
+            ++sizeClass;
+        }
+        return sizeClass;
+    }
+
+    size_t classSize(size_t sizeClass)
+    {
+        return static_cast<size_t>(1) << (sizeClass + minClassBits);
+    }
+
+    bool isPooled(size_t size, size_t alignment)
+    {
+        return size <= ChPool::maxPooledSize && alignment <= alignof(std::max_align_t);
+    }
+}
+
+const size_t ChPool::maxPooledSize;
+
+ChPool::ChPool(size_t slabSize)
+    : slabs_(nullptr), freeLists_(), cursors_(), ends_(), slabSize_(std::max(slabSize, 4 * maxPooledSize)), reserved_(0)
+{
+}
+
+ChPool::~ChPool()
+{
+    release();
+}
+
+void *ChPool::allocate(size_t size, size_t alignment)
+{
+    if (!isPooled(size, alignment))
+    {
+        if (alignment > alignof(std::max_align_t))
+        {
+            return ::operator new(size, std::align_val_t(alignment));
+        }
+        return ::operator new(size);
+    }
+
+    size_t sizeClass = sizeClassOf(size, alignment);
+    void *block = freeLists_[sizeClass];
+    if (block != nullptr)
+    {
+        freeLists_[sizeClass] = *static_cast<void **>(block);
+        return block;
+    }
+    return carve(sizeClass);
+}
+
+void ChPool::deallocate(void *pointer, size_t size, size_t alignment) noexcept
+{
+    if (pointer == nullptr)
+    {
+        return;
+    }
+    if (!isPooled(size, alignment))
+    {
+        if (alignment > alignof(std::max_align_t))
+        {
+            ::operator delete(pointer, std::align_val_t(alignment));
+        }
+        else
+        {
+            ::operator delete(pointer);
+        }
+        return;
+    }
+
+    // A free block stores the link to the next free block of its class in its first bytes
+    size_t sizeClass = sizeClassOf(size, alignment);
+    *static_cast<void **>(pointer) = freeLists_[sizeClass];
+    freeLists_[sizeClass] = pointer;
+}
+
+void ChPool::release()
+{
+    while (slabs_ != nullptr)
+    {
+        Slab *next = slabs_->next;
+        ::operator delete(slabs_);
+        slabs_ = next;
+    }
+    std::fill(freeLists_, freeLists_ + classCount, nullptr);
+    std::fill(cursors_, cursors_ + classCount, nullptr);
+    std::fill(ends_, ends_ + classCount, nullptr);
+    reserved_ = 0;
+}
+
+size_t ChPool::bytesReserved() const
+{
+    return reserved_;
+}
+
+void *ChPool::carve(size_t sizeClass)
+{
+    // Blocks are carved one at a time rather than threading the whole slab onto the free list, so a fresh slab is
+    // only touched as far as it is used
+    const size_t size = classSize(sizeClass);
+    if (cursors_[sizeClass] == ends_[sizeClass])
+    {
+        Slab *slab = static_cast<Slab *>(::operator new(sizeof(Slab) + slabSize_));
+        slab->next = slabs_;
+        slabs_ = slab;
+        reserved_ += slabSize_;
+        cursors_[sizeClass] = reinterpret_cast<char *>(slab + 1);
+        ends_[sizeClass] = cursors_[sizeClass] + slabSize_ / size * size;
+    }
+
+    void *block = cursors_[sizeClass];
+    cursors_[sizeClass] += size;
+    return block;
+}
\ No newline at end of file
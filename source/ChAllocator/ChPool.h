@@ -0,0 +1,90 @@
+#ifndef CHPOOL
+#define CHPOOL
+
+#include <cstddef>
+
+/**
+ * @brief A memory pool with free lists for power of two size classes.
+ *
+ * Requests of up to `maxPooledSize` bytes are rounded up to a size class and served from slabs that the pool carves
+ * up on demand. Freed memory goes onto the free list of its class and is reused by the next request of that class,
+ * so a steady pattern of allocations and frees never reaches the system allocator. Slabs are only returned by
+ * `release()` or the destructor. Larger and over-aligned requests are passed through to the system allocator.
+ *
+ * Unlike ChArena, a pool reuses memory freed by long-lived containers that grow and shrink. A pool is not thread
+ * safe. Use ChPoolAllocator to put standard containers and ChVector objects into a pool.
+ */
+class ChPool
+{
+public:
+    /**
+     * @brief The largest request served from the size classes.
+     */
+    static const size_t maxPooledSize = 4096;
+
+    /**
+     * @brief Constructs an empty pool. No memory is allocated until the first allocation.
+     *
+     * @param slabSize The size in bytes of the slabs carved into blocks. Raised to hold at least a few blocks of the
+     * largest class.
+     */
+    explicit ChPool(size_t slabSize = 64 * 1024);
+
+    /**
+     * @brief Destructor. Frees all slabs. Objects in the pool are not destroyed.
+     */
+    ~ChPool();
+
+    ChPool(const ChPool &) = delete;
+    ChPool &operator=(const ChPool &) = delete;
+
+    /**
+     * @brief Allocates `size` bytes aligned to `alignment`.
+     *
+     * @param size The number of bytes to allocate.
+     * @param alignment The alignment of the memory, a power of two.
+     * @return A pointer to the memory.
+     * @throws std::bad_alloc if the memory cannot be allocated.
+     */
+    void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Returns memory obtained from `allocate` to the pool.
+     *
+     * @param pointer The memory to free.
+     * @param size The size passed to `allocate`.
+     * @param alignment The alignment passed to `allocate`.
+     */
+    void deallocate(void *pointer, size_t size, size_t alignment = alignof(std::max_align_t)) noexcept;
+
+    /**
+     * @brief Frees all slabs, which releases every pooled allocation at once. Allocations passed through to the
+     * system allocator must still be deallocated one by one.
+     */
+    void release();
+
+    /**
+     * @brief Returns the number of bytes held in slabs.
+     */
+    size_t bytesReserved() const;
+
+private:
+    struct Slab;
+
+    // Size classes 8, 16, ..., maxPooledSize
+    static const size_t classCount = 10;
+
+    /**
+     * @brief Carves a block of size class `sizeClass` from the current slab of that class, adding a slab if needed.
+     */
+    void *carve(size_t sizeClass);
+
+    Slab *slabs_;
+    void *freeLists_[classCount];
+    char *cursors_[classCount];
+    char *ends_[classCount];
+    size_t slabSize_;
+    size_t reserved_;
+};
+
+#endif
\ No newline at end of file
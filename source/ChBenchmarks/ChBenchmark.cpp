@@ -0,0 +1,390 @@
+#include "ChBenchmark.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+
+namespace
+{
+    std::atomic<uint64_t> allocationCounter(0);
+    std::atomic<uint64_t> byteCounter(0);
+
+    void *countedAllocation(size_t size)
+    {
+        allocationCounter.fetch_add(1, std::memory_order_relaxed);
+        byteCounter.fetch_add(size, std::memory_order_relaxed);
+        void *pointer = std::malloc(size == 0 ? 1 : size);
+        if (pointer == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return pointer;
+    }
+
+    void *countedAlignedAllocation(size_t size, std::align_val_t alignment)
+    {
+        allocationCounter.fetch_add(1, std::memory_order_relaxed);
+        byteCounter.fetch_add(size, std::memory_order_relaxed);
+        const size_t align = static_cast<size_t>(alignment);
+        void *pointer = nullptr;
+#if defined(_MSC_VER)
+        pointer = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+        // aligned_alloc wants the size to be a multiple of the alignment
+        pointer = std::aligned_alloc(align, (std::max(size, static_cast<size_t>(1)) + align - 1) / align * align);
+#endif
+        if (pointer == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return pointer;
+    }
+
+    void alignedFree(void *pointer)
+    {
+#if defined(_MSC_VER)
+        _aligned_free(pointer);
+#else
+        std::free(pointer);
+#endif
+    }
+
+    // Writes `value` as a JSON string
+    void writeJsonString(std::ostream &out, const std::string &value)
+    {
+        out << '"';
+        for (char ch : value)
+        {
+            switch (ch)
+            {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20)
+                {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+                    out << escaped;
+                }
+                else
+                {
+                    out << ch;
+                }
+            }
+        }
+        out << '"';
+    }
+
+    std::string formatNumber(double value)
+    {
+        char text[64];
+        std::snprintf(text, sizeof(text), "%.3f", value);
+        return text;
+    }
+}
+
+// The program-wide allocation functions count every allocation for ChBenchmarkState
+
+void *operator new(size_t size)
+{
+    return countedAllocation(size);
+}
+
+void *operator new[](size_t size)
+{
+    return countedAllocation(size);
+}
+
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    return countedAlignedAllocation(size, alignment);
+}
+
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+    return countedAlignedAllocation(size, alignment);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return countedAllocation(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return countedAllocation(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept
+{
+    alignedFree(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept
+{
+    alignedFree(pointer);
+}
+
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept
+{
+    alignedFree(pointer);
+}
+
+void operator delete[](void *pointer, size_t, std::align_val_t) noexcept
+{
+    alignedFree(pointer);
+}
+
+void ChBenchmark::escape(const void *pointer)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(pointer) : "memory");
+#else
+    // Reading the sink back keeps the store in use for compilers that would call it set but unused
+    static const void *volatile sink;
+    sink = pointer;
+    static_cast<void>(sink);
+#endif
+}
+
+uint64_t ChBenchmark::allocationCount()
+{
+    return allocationCounter.load(std::memory_order_relaxed);
+}
+
+uint64_t ChBenchmark::allocatedBytes()
+{
+    return byteCounter.load(std::memory_order_relaxed);
+}
+
+ChBenchmarkState::ChBenchmarkState(size_t iterations)
+    : iterations_(iterations), running_(false), startAllocations_(0), startBytes_(0), elapsed_(0), allocations_(0), bytes_(0)
+{
+    resumeTiming();
+}
+
+size_t ChBenchmarkState::iterations() const
+{
+    return iterations_;
+}
+
+void ChBenchmarkState::resetTiming()
+{
+    running_ = false;
+    elapsed_ = 0;
+    allocations_ = 0;
+    bytes_ = 0;
+    resumeTiming();
+}
+
+void ChBenchmarkState::pauseTiming()
+{
+    if (!running_)
+    {
+        return;
+    }
+    Clock::time_point now = Clock::now();
+    elapsed_ += std::chrono::duration<double, std::nano>(now - start_).count();
+    allocations_ += ChBenchmark::allocationCount() - startAllocations_;
+    bytes_ += ChBenchmark::allocatedBytes() - startBytes_;
+    running_ = false;
+}
+
+void ChBenchmarkState::resumeTiming()
+{
+    if (running_)
+    {
+        return;
+    }
+    running_ = true;
+    startAllocations_ = ChBenchmark::allocationCount();
+    startBytes_ = ChBenchmark::allocatedBytes();
+    start_ = Clock::now();
+}
+
+void ChBenchmarkState::finish()
+{
+    pauseTiming();
+}
+
+double ChBenchmarkState::elapsedNanoseconds() const
+{
+    return elapsed_;
+}
+
+uint64_t ChBenchmarkState::allocations() const
+{
+    return allocations_;
+}
+
+uint64_t ChBenchmarkState::allocatedBytes() const
+{
+    return bytes_;
+}
+
+void ChBenchmarkSuite::add(const std::string &name, Body body)
+{
+    entries_.push_back({name, std::move(body)});
+}
+
+std::vector<std::string> ChBenchmarkSuite::names(const std::string &filter) const
+{
+    std::vector<std::string> result;
+    for (const Entry &entry : entries_)
+    {
+        if (entry.name.find(filter) != std::string::npos)
+        {
+            result.push_back(entry.name);
+        }
+    }
+    return result;
+}
+
+std::vector<ChBenchmarkResult> ChBenchmarkSuite::run(const Options &options, std::ostream &progress) const
+{
+    std::vector<ChBenchmarkResult> results;
+    char row[256];
+    std::snprintf(row, sizeof(row), "%-64s %14s %12s %14s\n", "Benchmark", "ns/op", "allocs/op", "bytes/op");
+    progress << row;
+    for (const Entry &entry : entries_)
+    {
+        if (entry.name.find(options.filter) == std::string::npos)
+        {
+            continue;
+        }
+        ChBenchmarkResult result = measure(entry, options);
+        std::snprintf(row, sizeof(row), "%-64s %14.2f %12.2f %14.1f\n", result.name.c_str(), result.nanosecondsPerOp, result.allocationsPerOp, result.bytesPerOp);
+        progress << row << std::flush;
+        results.push_back(result);
+    }
+    return results;
+}
+
+ChBenchmarkResult ChBenchmarkSuite::measure(const Entry &entry, const Options &options) const
+{
+    const double minNanoseconds = options.minTime * 1e9;
+    const size_t maxIterations = 1000000000;
+
+    // Grow the iteration count until a run is long enough, aiming a little past the minimum so that the next run
+    // usually is the last one
+    size_t iterations = 1;
+    ChBenchmarkState state(iterations);
+    while (true)
+    {
+        state = ChBenchmarkState(iterations);
+        entry.body(state);
+        state.finish();
+        const double elapsed = state.elapsedNanoseconds();
+        if (elapsed >= minNanoseconds || iterations >= maxIterations)
+        {
+            break;
+        }
+        double factor = elapsed <= 0 ? 100 : minNanoseconds * 1.4 / elapsed;
+        factor = std::min(std::max(factor, 2.0), 100.0);
+        iterations = std::min(static_cast<size_t>(std::ceil(iterations * factor)), maxIterations);
+    }
+
+    std::vector<double> times = {state.elapsedNanoseconds() / iterations};
+    for (size_t repetition = 1; repetition < options.repetitions; ++repetition)
+    {
+        ChBenchmarkState repeated(iterations);
+        entry.body(repeated);
+        repeated.finish();
+        times.push_back(repeated.elapsedNanoseconds() / iterations);
+    }
+    std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+
+    ChBenchmarkResult result;
+    result.name = entry.name;
+    result.iterations = iterations;
+    result.nanosecondsPerOp = times[times.size() / 2];
+    result.allocationsPerOp = static_cast<double>(state.allocations()) / iterations;
+    result.bytesPerOp = static_cast<double>(state.allocatedBytes()) / iterations;
+    return result;
+}
+
+void ChBenchmarkSuite::writeJson(const std::vector<ChBenchmarkResult> &results, const Options &options, std::ostream &out)
+{
+    std::vector<ChBenchmarkResult> sorted = results;
+    std::sort(sorted.begin(), sorted.end(), [](const ChBenchmarkResult &left, const ChBenchmarkResult &right)
+    {
+        return left.name < right.name;
+    });
+
+    char date[32] = "";
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": ";
+    writeJsonString(out, date);
+    out << ",\n";
+#if defined(NDEBUG)
+    out << "    \"build\": \"release\",\n";
+#else
+    out << "    \"build\": \"debug\",\n";
+#endif
+    out << "    \"minTime\": " << formatNumber(options.minTime) << ",\n";
+    out << "    \"repetitions\": " << options.repetitions << "\n";
+    out << "  },\n";
+    out << "  \"benchmarks\": [";
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        const ChBenchmarkResult &result = sorted[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+        writeJsonString(out, result.name);
+        out << ", \"iterations\": " << result.iterations;
+        out << ", \"ns_per_op\": " << formatNumber(result.nanosecondsPerOp);
+        out << ", \"allocs_per_op\": " << formatNumber(result.allocationsPerOp);
+        out << ", \"bytes_per_op\": " << formatNumber(result.bytesPerOp) << "}";
+    }
+    out << "\n  ]\n}\n";
+}
\ No newline at end of file
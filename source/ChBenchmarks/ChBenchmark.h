@@ -0,0 +1,274 @@
+#ifndef CHBENCHMARK
+#define CHBENCHMARK
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The timing of one run of a benchmark, handed to the benchmark body.
+ *
+ * The body performs the operation `iterations()` times. Timing and allocation counting start before the body is
+ * called; work that should not be measured, such as building the input, goes before `resetTiming()` or between
+ * `pauseTiming()` and `resumeTiming()`.
+ *
+ * @code
+ * suite.add("ChString::toLower", [](ChBenchmarkState &state)
+ * {
+ *     ChString text = makeText(1024);
+ *     state.resetTiming();
+ *     for (size_t i = 0; i < state.iterations(); ++i)
+ *     {
+ *         ChBenchmark::doNotOptimize(text.toLower());
+ *     }
+ * });
+ * @endcode
+ */
+class ChBenchmarkState
+{
+public:
+    explicit ChBenchmarkState(size_t iterations);
+
+    /**
+     * @brief Returns the number of times the body must perform the operation.
+     */
+    size_t iterations() const;
+
+    /**
+     * @brief Discards the time and allocations measured so far.
+     */
+    void resetTiming();
+
+    /**
+     * @brief Stops measuring until `resumeTiming()`.
+     */
+    void pauseTiming();
+
+    /**
+     * @brief Starts measuring again after `pauseTiming()`.
+     */
+    void resumeTiming();
+
+    /**
+     * @brief Stops measuring. Called by the suite after the body returns.
+     */
+    void finish();
+
+    /**
+     * @brief Returns the measured time in nanoseconds.
+     */
+    double elapsedNanoseconds() const;
+
+    /**
+     * @brief Returns the number of allocations made while measuring.
+     */
+    uint64_t allocations() const;
+
+    /**
+     * @brief Returns the number of bytes allocated while measuring.
+     */
+    uint64_t allocatedBytes() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    size_t iterations_;
+    bool running_;
+    Clock::time_point start_;
+    uint64_t startAllocations_;
+    uint64_t startBytes_;
+    double elapsed_;
+    uint64_t allocations_;
+    uint64_t bytes_;
+};
+
+/**
+ * @brief The measurements of one benchmark.
+ */
+struct ChBenchmarkResult
+{
+    std::string name;
+    size_t iterations;
+    double nanosecondsPerOp;
+    double allocationsPerOp;
+    double bytesPerOp;
+};
+
+/**
+ * @brief A named set of micro-benchmarks.
+ *
+ * Each benchmark is first run with a growing iteration count until one run takes at least the minimum time, and that
+ * run is measured. With several repetitions the median time per operation is reported. Allocations are counted by the
+ * replacement of the global operator new in the benchmark program, so every allocation on any thread is included.
+ */
+class ChBenchmarkSuite
+{
+public:
+    using Body = std::function<void(ChBenchmarkState &)>;
+
+    /**
+     * @brief How the benchmarks are run.
+     */
+    struct Options
+    {
+        // Only the benchmarks whose name contains this string run
+        std::string filter;
+        // The least time in seconds a measured run takes
+        double minTime = 0.1;
+        // The number of measured runs per benchmark
+        size_t repetitions = 1;
+    };
+
+    /**
+     * @brief Adds a benchmark.
+     *
+     * @param name The name of the benchmark, such as "ChVector<int>::sort/100000".
+     * @param body The body of the benchmark. It is only called when the benchmark runs.
+     */
+    void add(const std::string &name, Body body);
+
+    /**
+     * @brief Returns the names of the benchmarks that match `filter`.
+     */
+    std::vector<std::string> names(const std::string &filter) const;
+
+    /**
+     * @brief Runs the benchmarks that match the filter and returns their results. Each result is also printed to
+     * `progress` as a table row as soon as it is known.
+     */
+    std::vector<ChBenchmarkResult> run(const Options &options, std::ostream &progress) const;
+
+    /**
+     * @brief Writes results as a JSON document with one object per benchmark, sorted by name so that the output of
+     * two releases can be diffed.
+     */
+    static void writeJson(const std::vector<ChBenchmarkResult> &results, const Options &options, std::ostream &out);
+
+private:
+    struct Entry
+    {
+        std::string name;
+        Body body;
+    };
+
+    ChBenchmarkResult measure(const Entry &entry, const Options &options) const;
+
+    std::vector<Entry> entries_;
+};
+
+/**
+ * @brief Helpers for writing benchmark bodies.
+ */
+namespace ChBenchmark
+{
+    /**
+     * @brief Passes a pointer to code the compiler cannot see. Used by `doNotOptimize` where inline assembly is not
+     * available.
+     */
+    void escape(const void *pointer);
+
+    /**
+     * @brief Keeps the compiler from optimizing away the computation of `value`.
+     */
+    template <typename T>
+    inline void doNotOptimize(const T &value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "m"(value) : "memory");
+#else
+        escape(&value);
+#endif
+    }
+
+    /**
+     * @brief Makes the compiler assume that all memory was read and written.
+     */
+    inline void clobberMemory()
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : : "memory");
+#else
+        escape(nullptr);
+#endif
+    }
+
+    /**
+     * @brief Returns the number of allocations made by the program so far.
+     */
+    uint64_t allocationCount();
+
+    /**
+     * @brief Returns the number of bytes allocated by the program so far.
+     */
+    uint64_t allocatedBytes();
+
+    /**
+     * @brief Returns a benchmark body that builds its input with `setup()` and then measures `op(input)`.
+     *
+     * `op` receives the same input every iteration; it may modify it as long as the next call does the same work.
+     */
+    template <typename Setup, typename Op>
+    ChBenchmarkSuite::Body repeat(Setup setup, Op op)
+    {
+        return [setup, op](ChBenchmarkState &state)
+        {
+            auto input = setup();
+            state.resetTiming();
+            for (size_t i = 0; i < state.iterations(); ++i)
+            {
+                if constexpr (std::is_void<decltype(op(input))>::value)
+                {
+                    op(input);
+                    clobberMemory();
+                }
+                else
+                {
+                    doNotOptimize(op(input));
+                }
+            }
+        };
+    }
+
+    /**
+     * @brief Returns a benchmark body that measures `op` on a fresh copy of the input every iteration, for operations
+     * that consume or modify their input. Making the copy is not measured.
+     */
+    template <typename Setup, typename Op>
+    ChBenchmarkSuite::Body repeatOnCopy(Setup setup, Op op)
+    {
+        return [setup, op](ChBenchmarkState &state)
+        {
+            const auto input = setup();
+            std::optional<typename std::remove_const<decltype(input)>::type> copy;
+            state.resetTiming();
+            for (size_t i = 0; i < state.iterations(); ++i)
+            {
+                // The copy is also destroyed outside the measurement
+                state.pauseTiming();
+                copy.emplace(input);
+                state.resumeTiming();
+                if constexpr (std::is_void<decltype(op(*copy))>::value)
+                {
+                    op(*copy);
+                    clobberMemory();
+                }
+                else
+                {
+                    doNotOptimize(op(*copy));
+                }
+                state.pauseTiming();
+                copy.reset();
+                state.resumeTiming();
+            }
+        };
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "ChBenchmarks.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: ChBenchmarks [options]\n"
+                     "  --filter <text>      Run only the benchmarks whose name contains <text>\n"
+                     "  --min-time <seconds> Minimum duration of a measured run (default 0.1)\n"
+                     "  --repetitions <n>    Measured runs per benchmark; the median is reported (default 1)\n"
+                     "  --json <path>        Also write the results as JSON to <path>, or to stdout for '-'\n"
+                     "  --list               Print the names of the benchmarks and exit\n";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ChBenchmarkSuite suite;
+    addStringBenchmarks(suite);
+    addVectorBenchmarks(suite);
+    addContainerBenchmarks(suite);
+    addHashMapBenchmarks(suite);
+    addMapBenchmarks(suite);
+    addSetBenchmarks(suite);
+    addUnorderedSetBenchmarks(suite);
+
+    ChBenchmarkSuite::Options options;
+    std::string jsonPath;
+    bool list = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (argument == "--filter" && hasValue)
+        {
+            options.filter = argv[++i];
+        }
+        else if (argument == "--min-time" && hasValue)
+        {
+            options.minTime = std::atof(argv[++i]);
+        }
+        else if (argument == "--repetitions" && hasValue)
+        {
+            options.repetitions = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        }
+        else if (argument == "--json" && hasValue)
+        {
+            jsonPath = argv[++i];
+        }
+        else if (argument == "--list")
+        {
+            list = true;
+        }
+        else
+        {
+            printUsage();
+            return argument == "--help" ? 0 : 1;
+        }
+    }
+
+    if (list)
+    {
+        for (const std::string &name : suite.names(options.filter))
+        {
+            std::cout << name << '\n';
+        }
+        return 0;
+    }
+
+#if !defined(NDEBUG)
+    std::cerr << "ChBenchmarks: this is an unoptimized build; configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers\n";
+#endif
+
+    // With the JSON on stdout, the table goes to stderr so that the output stays parseable
+    std::ostream &progress = jsonPath == "-" ? std::cerr : std::cout;
+    std::vector<ChBenchmarkResult> results = suite.run(options, progress);
+    if (jsonPath == "-")
+    {
+        ChBenchmarkSuite::writeJson(results, options, std::cout);
+    }
+    else if (!jsonPath.empty())
+    {
+        std::ofstream file(jsonPath);
+        ChBenchmarkSuite::writeJson(results, options, file);
+        if (!file)
+        {
+            std::cerr << "ChBenchmarks: cannot write " << jsonPath << '\n';
+            return 1;
+        }
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef CHBENCHMARKS
+#define CHBENCHMARKS
+
+#include "ChBenchmark.h"
+
+/**
+ * @brief Adds the benchmarks of ChString and its companion classes to `suite`.
+ */
+void addStringBenchmarks(ChBenchmarkSuite &suite);
+
+/**
+ * @brief Adds the benchmarks of ChVector and its algorithms to `suite`.
+ */
+void addVectorBenchmarks(ChBenchmarkSuite &suite);
+
+/**
+ * @brief Adds the benchmarks of the other containers and the allocators to `suite`.
+ */
+void addContainerBenchmarks(ChBenchmarkSuite &suite);
+
+/**
+ * @brief Adds the benchmarks of ChHashMap and ChConcurrentHashMap, side by side with std::unordered_map, to `suite`.
+ */
+void addHashMapBenchmarks(ChBenchmarkSuite &suite);
+
+/**
+ * @brief Adds the benchmarks of ChMap, side by side with std::map, to `suite`.
+ */
+void addMapBenchmarks(ChBenchmarkSuite &suite);
+
+/**
+ * @brief Adds the benchmarks of ChSet, side by side with std::set and a sorted std::vector, to `suite`.
+ */
+void addSetBenchmarks(ChBenchmarkSuite &suite);
+
+/**
+ * @brief Adds the benchmarks of ChUnorderedSet in each of its representations, side by side with std::unordered_set,
+ * to `suite`.
+ */
+void addUnorderedSetBenchmarks(ChBenchmarkSuite &suite);
+
+#endif
\ No newline at end of file
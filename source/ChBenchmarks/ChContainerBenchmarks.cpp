@@ -0,0 +1,259 @@
+#include "ChAllocator.h"
+#include "ChBenchmarks.h"
+#include "ChFrontVector.cpp"
+#include "ChSmallVector.cpp"
+#include "ChTuple.cpp"
+#include "ChTupleVector.cpp"
+#include "ChVector.cpp"
+#include "ChVectorFile.h"
+#include <filesystem>
+#include <string>
+
+using ChBenchmark::repeat;
+using ChBenchmark::repeatOnCopy;
+
+namespace
+{
+    struct Particle
+    {
+        int id;
+        double mass;
+        double x;
+        double y;
+        double z;
+        unsigned char active;
+    };
+
+    void addAllocators(ChBenchmarkSuite &suite)
+    {
+        // Many short-lived vectors, the pattern the arena and the pool are meant for
+        suite.add("ChVector<int> std::allocator/1000 vectors of 16", repeat([] { return 0; }, [](int)
+        {
+            size_t total = 0;
+            for (int i = 0; i < 1000; ++i)
+            {
+                ChVector<int> values;
+                for (int j = 0; j < 16; ++j)
+                {
+                    values.push_back(j);
+                }
+                total += values.size();
+            }
+            return total;
+        }));
+        suite.add("ChVector<int> ChArenaAllocator/1000 vectors of 16", repeat([] { return 0; }, [](int)
+        {
+            ChArena arena;
+            size_t total = 0;
+            for (int i = 0; i < 1000; ++i)
+            {
+                ChVector<int, ChArenaAllocator<int>> values(arena);
+                for (int j = 0; j < 16; ++j)
+                {
+                    values.push_back(j);
+                }
+                total += values.size();
+            }
+            return total;
+        }));
+        suite.add("ChVector<int> ChPoolAllocator/1000 vectors of 16", repeat([] { return 0; }, [](int)
+        {
+            ChPool pool;
+            size_t total = 0;
+            for (int i = 0; i < 1000; ++i)
+            {
+                ChVector<int, ChPoolAllocator<int>> values(pool);
+                for (int j = 0; j < 16; ++j)
+                {
+                    values.push_back(j);
+                }
+                total += values.size();
+            }
+            return total;
+        }));
+        suite.add("ChArena::allocate/64B", repeat([] { return 0; }, [](int)
+        {
+            ChArena arena;
+            for (int i = 0; i < 1000; ++i)
+            {
+                ChBenchmark::doNotOptimize(arena.allocate(64));
+            }
+        }));
+        suite.add("ChPool::allocate/deallocate/64B", repeat([] { return 0; }, [](int)
+        {
+            ChPool pool;
+            for (int i = 0; i < 1000; ++i)
+            {
+                void *pointer = pool.allocate(64);
+                ChBenchmark::doNotOptimize(pointer);
+                pool.deallocate(pointer, 64);
+            }
+        }));
+    }
+
+    void addSmallVector(ChBenchmarkSuite &suite)
+    {
+        suite.add("ChVector<int>::push_back/8", repeat([] { return 0; }, [](int)
+        {
+            ChVector<int> values;
+            for (int i = 0; i < 8; ++i)
+            {
+                values.push_back(i);
+            }
+            return values.size();
+        }));
+        suite.add("ChSmallVector<int, 8>::push_back/8", repeat([] { return 0; }, [](int)
+        {
+            ChSmallVector<int, 8> values;
+            for (int i = 0; i < 8; ++i)
+            {
+                values.push_back(i);
+            }
+            return values.size();
+        }));
+        suite.add("ChSmallVector<int, 8>::push_back/64", repeat([] { return 0; }, [](int)
+        {
+            ChSmallVector<int, 8> values;
+            for (int i = 0; i < 64; ++i)
+            {
+                values.push_back(i);
+            }
+            return values.size();
+        }));
+        suite.add("ChSmallVector<int, 8>::ChSmallVector(const ChSmallVector &)/8", repeat([] { return ChSmallVector<int, 8>({1, 2, 3, 4, 5, 6, 7, 8}); }, [](const ChSmallVector<int, 8> &values)
+        {
+            return ChSmallVector<int, 8>(values);
+        }));
+        suite.add("ChSmallVector<int, 8>::removeDuplicates/8", repeatOnCopy([] { return ChSmallVector<int, 8>({3, 1, 3, 2, 1, 4, 2, 5}); }, [](ChSmallVector<int, 8> &values)
+        {
+            values.removeDuplicates();
+        }));
+    }
+
+    void addFrontVector(ChBenchmarkSuite &suite)
+    {
+        suite.add("ChVector<int>::prepend/10000 single", repeat([] { return 0; }, [](int)
+        {
+            ChVector<int> values;
+            for (int i = 0; i < 10000; ++i)
+            {
+                values.prepend({i});
+            }
+            return values.size();
+        }));
+        suite.add("ChFrontVector<int>::prepend/10000 single", repeat([] { return 0; }, [](int)
+        {
+            ChFrontVector<int> values;
+            for (int i = 0; i < 10000; ++i)
+            {
+                values.prepend({i});
+            }
+            return values.size();
+        }));
+        suite.add("ChFrontVector<int>::push_front/10000", repeat([] { return 0; }, [](int)
+        {
+            ChFrontVector<int> values;
+            for (int i = 0; i < 10000; ++i)
+            {
+                values.push_front(i);
+            }
+            return values.size();
+        }));
+        suite.add("ChFrontVector<int>::push_back/pop_front/10000 queue", repeat([] { return 0; }, [](int)
+        {
+            ChFrontVector<int> values;
+            int64_t total = 0;
+            for (int i = 0; i < 10000; ++i)
+            {
+                values.push_back(i);
+                if (values.size() > 64)
+                {
+                    total += values.front();
+                    values.pop_front();
+                }
+            }
+            return total;
+        }));
+        suite.add("ChFrontVector<int>::sum/100000", repeat([] { ChFrontVector<int> values; for (int i = 0; i < 100000; ++i) { values.push_front(i); } return values; }, [](const ChFrontVector<int> &values)
+        {
+            return values.sum();
+        }));
+    }
+
+    void addTupleVector(ChBenchmarkSuite &suite)
+    {
+        // Summing one field of a table of records, interleaved against one column per field
+        const size_t rows = 100000;
+        suite.add("ChVector<Particle> field sum/100000", repeat([rows]
+        {
+            ChVector<Particle> particles;
+            for (size_t i = 0; i < rows; ++i)
+            {
+                particles.push_back({static_cast<int>(i), 1.0 + i % 7, 0, 0, 0, 1});
+            }
+            return particles;
+        }, [](ChVector<Particle> &particles)
+        {
+            double total = 0;
+            for (const Particle &particle : particles)
+            {
+                total += particle.mass;
+            }
+            return total;
+        }));
+        auto table = [rows]
+        {
+            ChTupleVector<int, double, double, double, double, unsigned char> particles;
+            particles.reserve(rows);
+            for (size_t i = 0; i < rows; ++i)
+            {
+                particles.emplace_back(static_cast<int>(i), 1.0 + i % 7, 0.0, 0.0, 0.0, 1);
+            }
+            return particles;
+        };
+        suite.add("ChTupleVector column<1>().sum()/100000", repeat(table, [](const auto &particles) { return particles.template column<1>().sum(); }));
+        suite.add("ChTupleVector row proxy sum/100000", repeat(table, [](const auto &particles)
+        {
+            double total = 0;
+            for (auto row : particles)
+            {
+                total += row.template get<1>();
+            }
+            return total;
+        }));
+        suite.add("ChTupleVector::emplace_back/100000", repeat([] { return 0; }, [rows](int)
+        {
+            ChTupleVector<int, double, float> particles;
+            for (size_t i = 0; i < rows; ++i)
+            {
+                particles.emplace_back(static_cast<int>(i), 1.0, 0.5f);
+            }
+            return particles.size();
+        }));
+    }
+
+    void addFiles(ChBenchmarkSuite &suite)
+    {
+        const std::string path = (std::filesystem::temp_directory_path() / "ChBenchmarks.vector.bin").string();
+        auto values = []
+        {
+            ChVector<double> result;
+            result.resize(1 << 20, 1.5);
+            return result;
+        };
+        suite.add("ChVectorFile::save/8MiB", repeat(values, [path](const ChVector<double> &vector) { ChVectorFile::save(path, vector); }));
+        suite.add("ChVectorFile::map/8MiB", repeat([path, values] { ChVectorFile::save(path, values()); return 0; }, [path](int) { return ChVectorFile::map<double>(path).size(); }));
+        suite.add("ChVectorFile::map unverified/8MiB", repeat([path, values] { ChVectorFile::save(path, values()); return 0; }, [path](int) { return ChVectorFile::map<double>(path, false).size(); }));
+        suite.add("ChVectorFile::load/8MiB", repeat([path, values] { ChVectorFile::save(path, values()); return 0; }, [path](int) { return ChVectorFile::load<double>(path).size(); }));
+        suite.add("ChVectorFile::checksum/8MiB", repeat(values, [](const ChVector<double> &vector) { return ChVectorFile::checksum(vector.data(), vector.size() * sizeof(double)); }));
+    }
+}
+
+void addContainerBenchmarks(ChBenchmarkSuite &suite)
+{
+    addAllocators(suite);
+    addSmallVector(suite);
+    addFrontVector(suite);
+    addTupleVector(suite);
+    addFiles(suite);
+}
\ No newline at end of file
@@ -0,0 +1,349 @@
+#include "ChBenchmarks.h"
+#include "ChConcurrentHashMap.cpp"
+#include "ChHashMap.cpp"
+#include "ChThreadPool.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using ChBenchmark::repeat;
+using ChBenchmark::repeatOnCopy;
+
+namespace
+{
+    // Both tables get this many slots or buckets up front, and are then filled to the load factor under test
+    const size_t tableSlots = 1 << 20;
+
+    const float loadFactors[] = {0.5f, 0.75f, 0.9f};
+
+    using Keys = std::vector<uint64_t>;
+
+    /**
+     * @brief Returns `size` pseudo-random keys (a SplitMix64 sequence), the same for the same `seed`.
+     */
+    Keys randomKeys(size_t size, uint64_t seed)
+    {
+        Keys keys(size);
+        for (uint64_t &key : keys)
+        {
+            seed += 0x9E3779B97F4A7C15ull;
+            uint64_t value = seed;
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+            key = value ^ (value >> 31);
+        }
+        return keys;
+    }
+
+    ChHashMap<uint64_t, uint64_t> fillChHashMap(const Keys &keys)
+    {
+        ChHashMap<uint64_t, uint64_t> map;
+        map.setMaxLoadFactor(0.95f);
+        map.rehash(tableSlots);
+        for (uint64_t key : keys)
+        {
+            map.try_emplace(key, key);
+        }
+        return map;
+    }
+
+    std::unordered_map<uint64_t, uint64_t> fillUnorderedMap(const Keys &keys)
+    {
+        std::unordered_map<uint64_t, uint64_t> map;
+        map.rehash(tableSlots);
+        for (uint64_t key : keys)
+        {
+            map.try_emplace(key, key);
+        }
+        return map;
+    }
+
+    /**
+     * @brief Adds the insert, lookup and erase benchmarks of one map type at each of the load factors.
+     */
+    template <typename Map>
+    void addIntegerMap(ChBenchmarkSuite &suite, const std::string &name, Map (*fill)(const Keys &))
+    {
+        for (float load : loadFactors)
+        {
+            const size_t count = static_cast<size_t>(tableSlots * load);
+            char suffix[64];
+            std::snprintf(suffix, sizeof(suffix), "/load %.2f/%zu", load, count);
+
+            auto keys = [count] { return randomKeys(count, 1); };
+            auto filled = [count, fill]
+            {
+                Keys present = randomKeys(count, 1);
+                Map map = fill(present);
+                return std::make_pair(std::move(map), std::move(present));
+            };
+
+            // Inserting includes allocating the reserved table and freeing it again
+            suite.add(name + "::insert" + suffix, repeat(keys, [fill](const Keys &present) { return fill(present).size(); }));
+            suite.add(name + "::find hit" + suffix, repeat(filled, [](const std::pair<Map, Keys> &input)
+            {
+                uint64_t total = 0;
+                for (uint64_t key : input.second)
+                {
+                    total += input.first.find(key)->second;
+                }
+                return total;
+            }));
+            suite.add(name + "::find miss" + suffix, repeat([count, fill]
+            {
+                return std::make_pair(fill(randomKeys(count, 1)), randomKeys(count, 2));
+            }, [](const std::pair<Map, Keys> &input)
+            {
+                size_t found = 0;
+                for (uint64_t key : input.second)
+                {
+                    found += input.first.count(key);
+                }
+                return found;
+            }));
+            suite.add(name + "::erase" + suffix, repeatOnCopy(filled, [](std::pair<Map, Keys> &input)
+            {
+                for (uint64_t key : input.second)
+                {
+                    input.first.erase(key);
+                }
+                return input.first.size();
+            }));
+        }
+    }
+
+    /**
+     * @brief Returns `size` distinct keys too long for the small string buffer, so building a std::string allocates.
+     */
+    std::vector<std::string> stringKeys(size_t size)
+    {
+        std::vector<std::string> keys;
+        keys.reserve(size);
+        for (uint64_t key : randomKeys(size, 3))
+        {
+            keys.push_back("benchmark/key/" + std::to_string(key));
+        }
+        return keys;
+    }
+
+    void addStringKeys(ChBenchmarkSuite &suite)
+    {
+        const size_t count = 100000;
+        auto chHashMap = [count]
+        {
+            std::vector<std::string> keys = stringKeys(count);
+            ChHashMap<std::string, size_t> map(keys.size());
+            for (size_t i = 0; i < keys.size(); ++i)
+            {
+                map.try_emplace(keys[i], i);
+            }
+            return std::make_pair(std::move(map), std::move(keys));
+        };
+        auto unorderedMap = [count]
+        {
+            std::vector<std::string> keys = stringKeys(count);
+            std::unordered_map<std::string, size_t> map(keys.size());
+            for (size_t i = 0; i < keys.size(); ++i)
+            {
+                map.try_emplace(keys[i], i);
+            }
+            return std::make_pair(std::move(map), std::move(keys));
+        };
+
+        // Keys that arrive as views, e.g. parsed out of a buffer, can be looked up in ChHashMap as they are
+        suite.add("ChHashMap<std::string>::find(std::string)/100000", repeat(chHashMap, [](const auto &input)
+        {
+            size_t total = 0;
+            for (const std::string &key : input.second)
+            {
+                total += input.first.find(key)->second;
+            }
+            return total;
+        }));
+        suite.add("ChHashMap<std::string>::find(std::string_view)/100000", repeat(chHashMap, [](const auto &input)
+        {
+            size_t total = 0;
+            for (const std::string &key : input.second)
+            {
+                total += input.first.find(std::string_view(key))->second;
+            }
+            return total;
+        }));
+        suite.add("std::unordered_map<std::string>::find(std::string)/100000", repeat(unorderedMap, [](const auto &input)
+        {
+            size_t total = 0;
+            for (const std::string &key : input.second)
+            {
+                total += input.first.find(key)->second;
+            }
+            return total;
+        }));
+        suite.add("std::unordered_map<std::string>::find(std::string(view))/100000", repeat(unorderedMap, [](const auto &input)
+        {
+            size_t total = 0;
+            for (const std::string &key : input.second)
+            {
+                total += input.first.find(std::string(std::string_view(key)))->second;
+            }
+            return total;
+        }));
+    }
+
+    // The shared table of the scaling benchmarks and the total number of operations, split evenly over the threads
+    const size_t sharedKeys = 1 << 18;
+    const size_t sharedOperations = 1 << 19;
+
+    const size_t threadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+
+    /**
+     * @brief std::unordered_map behind one mutex, the setup the concurrent map replaces.
+     */
+    struct LockedUnorderedMap
+    {
+        std::unordered_map<uint64_t, uint64_t> map;
+        std::mutex mutex;
+
+        bool find(uint64_t key, uint64_t &value)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = map.find(key);
+            if (it == map.end())
+            {
+                return false;
+            }
+            value = it->second;
+            return true;
+        }
+
+        void insertOrAssign(uint64_t key, uint64_t value)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            map.insert_or_assign(key, value);
+        }
+    };
+
+    /**
+     * @brief std::unordered_map behind one reader-writer lock.
+     */
+    struct SharedLockedUnorderedMap
+    {
+        std::unordered_map<uint64_t, uint64_t> map;
+        std::shared_mutex mutex;
+
+        bool find(uint64_t key, uint64_t &value)
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto it = map.find(key);
+            if (it == map.end())
+            {
+                return false;
+            }
+            value = it->second;
+            return true;
+        }
+
+        void insertOrAssign(uint64_t key, uint64_t value)
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            map.insert_or_assign(key, value);
+        }
+    };
+
+    /**
+     * @brief Adapts ChConcurrentHashMap to the interface of the locked maps.
+     */
+    struct ConcurrentMap
+    {
+        ChConcurrentHashMap<uint64_t, uint64_t> map;
+
+        bool find(uint64_t key, uint64_t &value)
+        {
+            std::optional<uint64_t> found = map.find(key);
+            if (!found)
+            {
+                return false;
+            }
+            value = *found;
+            return true;
+        }
+
+        void insertOrAssign(uint64_t key, uint64_t value)
+        {
+            map.insertOrAssign(key, value);
+        }
+    };
+
+    template <typename Map>
+    struct SharedInput
+    {
+        std::unique_ptr<ChThreadPool> pool;
+        std::unique_ptr<Map> map;
+        Keys keys;
+        size_t threads;
+    };
+
+    /**
+     * @brief Adds a benchmark per thread count in which the threads share one map and each runs its part of a mix of
+     * 90% lookups and 10% updates of random existing keys.
+     */
+    template <typename Map>
+    void addSharedMap(ChBenchmarkSuite &suite, const std::string &name)
+    {
+        for (size_t threads : threadCounts)
+        {
+            auto setup = [threads]
+            {
+                SharedInput<Map> input{std::make_unique<ChThreadPool>(threads), std::make_unique<Map>(), randomKeys(sharedKeys, 1), threads};
+                for (uint64_t key : input.keys)
+                {
+                    input.map->insertOrAssign(key, key);
+                }
+                return input;
+            };
+            suite.add(name + " 90% find/threads " + std::to_string(threads) + "/" + std::to_string(sharedOperations), repeat(setup, [](SharedInput<Map> &input)
+            {
+                std::atomic<uint64_t> total(0);
+                input.pool->run(input.threads, [&](size_t thread)
+                {
+                    uint64_t random = 0x9E3779B97F4A7C15ull * (thread + 1);
+                    uint64_t sum = 0;
+                    for (size_t i = 0; i < sharedOperations / input.threads; ++i)
+                    {
+                        random = random * 6364136223846793005ull + 1442695040888963407ull;
+                        uint64_t key = input.keys[(random >> 33) % input.keys.size()];
+                        uint64_t value = 0;
+                        if ((random >> 29) % 10 == 0)
+                        {
+                            input.map->insertOrAssign(key, i);
+                        }
+                        else if (input.map->find(key, value))
+                        {
+                            sum += value;
+                        }
+                    }
+                    total.fetch_add(sum, std::memory_order_relaxed);
+                });
+                return total.load();
+            }));
+        }
+    }
+}
+
+void addHashMapBenchmarks(ChBenchmarkSuite &suite)
+{
+    addIntegerMap(suite, "ChHashMap<uint64_t>", fillChHashMap);
+    addIntegerMap(suite, "std::unordered_map<uint64_t>", fillUnorderedMap);
+    addStringKeys(suite);
+    addSharedMap<ConcurrentMap>(suite, "ChConcurrentHashMap<uint64_t>");
+    addSharedMap<LockedUnorderedMap>(suite, "std::unordered_map<uint64_t> + std::mutex");
+    addSharedMap<SharedLockedUnorderedMap>(suite, "std::unordered_map<uint64_t> + std::shared_mutex");
+}
\ No newline at end of file
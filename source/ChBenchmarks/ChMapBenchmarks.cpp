@@ -0,0 +1,180 @@
+#include "ChBenchmarks.h"
+#include "ChMap.cpp"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+using ChBenchmark::repeat;
+using ChBenchmark::repeatOnCopy;
+
+namespace
+{
+    const size_t entryCount = 100000;
+
+    // The number of short range scans and the number of entries each one reads
+    const size_t rangeCount = 1000;
+    const size_t rangeLength = 64;
+
+    using Keys = std::vector<uint64_t>;
+
+    /**
+     * @brief Returns `size` pseudo-random keys (a SplitMix64 sequence), the same for the same `seed`.
+     */
+    Keys randomKeys(size_t size, uint64_t seed)
+    {
+        Keys keys(size);
+        for (uint64_t &key : keys)
+        {
+            seed += 0x9E3779B97F4A7C15ull;
+            uint64_t value = seed;
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+            key = value ^ (value >> 31);
+        }
+        return keys;
+    }
+
+    template <typename Map>
+    Map fill(const Keys &keys)
+    {
+        Map map;
+        for (uint64_t key : keys)
+        {
+            map.try_emplace(key, key);
+        }
+        return map;
+    }
+
+    /**
+     * @brief Adds a benchmark that inserts one entry per iteration into a map that grows to `iterations()` entries,
+     * so that its bytes per operation are the memory the map takes per entry.
+     */
+    template <typename Map>
+    void addMemoryPerEntry(ChBenchmarkSuite &suite, const std::string &name, bool ascending)
+    {
+        suite.add(name + (ascending ? "::insert ascending/per entry" : "::insert random/per entry"), [ascending](ChBenchmarkState &state)
+        {
+            Keys keys = randomKeys(state.iterations(), 1);
+            if (ascending)
+            {
+                std::sort(keys.begin(), keys.end());
+            }
+            Map map;
+            state.resetTiming();
+            for (uint64_t key : keys)
+            {
+                map.try_emplace(key, key);
+            }
+            ChBenchmark::doNotOptimize(map.size());
+        });
+    }
+
+    /**
+     * @brief Adds the lookup, scan and erase benchmarks of one map type.
+     */
+    template <typename Map>
+    void addOrderedMap(ChBenchmarkSuite &suite, const std::string &name)
+    {
+        const std::string suffix = "/" + std::to_string(entryCount);
+        auto filled = []
+        {
+            Keys keys = randomKeys(entryCount, 1);
+            Map map = fill<Map>(keys);
+            return std::make_pair(std::move(map), std::move(keys));
+        };
+
+        addMemoryPerEntry<Map>(suite, name, false);
+        addMemoryPerEntry<Map>(suite, name, true);
+
+        suite.add(name + "::find hit" + suffix, repeat(filled, [](const std::pair<Map, Keys> &input)
+        {
+            uint64_t total = 0;
+            for (uint64_t key : input.second)
+            {
+                total += input.first.find(key)->second;
+            }
+            return total;
+        }));
+        suite.add(name + "::iterate" + suffix, repeat(filled, [](const std::pair<Map, Keys> &input)
+        {
+            uint64_t total = 0;
+            for (const auto &entry : input.first)
+            {
+                total += entry.second;
+            }
+            return total;
+        }));
+        suite.add(name + "::lower_bound + " + std::to_string(rangeLength) + " entries/" + std::to_string(rangeCount) + " ranges", repeat([]
+        {
+            Map map = fill<Map>(randomKeys(entryCount, 1));
+            return std::make_pair(std::move(map), randomKeys(rangeCount, 2));
+        }, [](const std::pair<Map, Keys> &input)
+        {
+            uint64_t total = 0;
+            for (uint64_t from : input.second)
+            {
+                auto it = input.first.lower_bound(from);
+                for (size_t i = 0; i < rangeLength && it != input.first.end(); ++i, ++it)
+                {
+                    total += it->second;
+                }
+            }
+            return total;
+        }));
+        suite.add(name + "::erase" + suffix, repeatOnCopy(filled, [](std::pair<Map, Keys> &input)
+        {
+            for (uint64_t key : input.second)
+            {
+                input.first.erase(key);
+            }
+            return input.first.size();
+        }));
+    }
+
+    /**
+     * @brief Adds the benchmarks of building a map from sorted entries.
+     */
+    void addBulkLoad(ChBenchmarkSuite &suite)
+    {
+        const std::string suffix = "/" + std::to_string(entryCount);
+        auto sorted = []
+        {
+            Keys keys = randomKeys(entryCount, 1);
+            std::sort(keys.begin(), keys.end());
+            std::vector<std::pair<uint64_t, uint64_t>> entries;
+            entries.reserve(keys.size());
+            for (uint64_t key : keys)
+            {
+                entries.emplace_back(key, key);
+            }
+            return entries;
+        };
+
+        suite.add("ChMap<uint64_t>::assignSorted" + suffix, repeat(sorted, [](const std::vector<std::pair<uint64_t, uint64_t>> &entries)
+        {
+            ChMap<uint64_t, uint64_t> map;
+            map.assignSorted(entries.begin(), entries.end());
+            return map.size();
+        }));
+        suite.add("std::map<uint64_t>::insert(end(), sorted)" + suffix, repeat(sorted, [](const std::vector<std::pair<uint64_t, uint64_t>> &entries)
+        {
+            std::map<uint64_t, uint64_t> map;
+            for (const auto &entry : entries)
+            {
+                map.insert(map.end(), entry);
+            }
+            return map.size();
+        }));
+    }
+}
+
+void addMapBenchmarks(ChBenchmarkSuite &suite)
+{
+    addOrderedMap<ChMap<uint64_t, uint64_t>>(suite, "ChMap<uint64_t>");
+    addOrderedMap<std::map<uint64_t, uint64_t>>(suite, "std::map<uint64_t>");
+    addBulkLoad(suite);
+}
\ No newline at end of file
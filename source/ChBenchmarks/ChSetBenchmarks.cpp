@@ -0,0 +1,235 @@
+#include "ChBenchmarks.h"
+#include "ChSet.cpp"
+#include "ChVector.cpp"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using ChBenchmark::repeat;
+
+namespace
+{
+    // The lookups run against sets that fit into the L2 cache, the last level cache, and none of them
+    const size_t lookupSetSizes[] = {1 << 16, 1 << 20, 1 << 23};
+    const size_t lookupCount = 1 << 20;
+
+    // std::set takes about ten times the memory of the arrays, so it only runs on the smaller sets
+    const size_t stdSetMaximumSize = 1 << 20;
+
+    const size_t mergeCount = 100000;
+    const size_t skewedSmallCount = 1000;
+    const size_t skewedLargeCount = 1000000;
+
+    using Values = std::vector<uint32_t>;
+
+    /**
+     * @brief Returns `size` pseudo-random values below `range` (from a SplitMix64 sequence), the same for the same
+     * `seed`.
+     */
+    Values randomValues(size_t size, uint32_t range, uint64_t seed)
+    {
+        Values values(size);
+        for (uint32_t &value : values)
+        {
+            seed += 0x9E3779B97F4A7C15ull;
+            uint64_t mixed = seed;
+            mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+            mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+            value = static_cast<uint32_t>((mixed ^ (mixed >> 31)) % range);
+        }
+        return values;
+    }
+
+    ChSet<uint32_t> makeChSet(const Values &values)
+    {
+        ChVector<uint32_t> elements;
+        elements.assign(values.begin(), values.end());
+        return ChSet<uint32_t>(std::move(elements));
+    }
+
+    Values makeSortedVector(Values values)
+    {
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        return values;
+    }
+
+    /**
+     * @brief Adds the benchmarks of looking up random values, about 40% of which are in the set.
+     */
+    void addLookups(ChBenchmarkSuite &suite, size_t setSize)
+    {
+        const std::string suffix = "/" + std::to_string(setSize);
+        // Values are drawn from twice the size of the set, which leaves it with about 80% of that size
+        const uint32_t range = static_cast<uint32_t>(2 * setSize);
+
+        suite.add("ChSet<uint32_t>::contains" + suffix, repeat([setSize, range]
+        {
+            return std::make_pair(makeChSet(randomValues(setSize, range, 1)), randomValues(lookupCount, range, 2));
+        }, [](const std::pair<ChSet<uint32_t>, Values> &input)
+        {
+            size_t found = 0;
+            for (uint32_t value : input.second)
+            {
+                found += input.first.contains(value);
+            }
+            return found;
+        }));
+        suite.add("ChSet<uint32_t>::lower_bound" + suffix, repeat([setSize, range]
+        {
+            return std::make_pair(makeChSet(randomValues(setSize, range, 1)), randomValues(lookupCount, range, 2));
+        }, [](const std::pair<ChSet<uint32_t>, Values> &input)
+        {
+            size_t total = 0;
+            for (uint32_t value : input.second)
+            {
+                total += static_cast<size_t>(input.first.lower_bound(value) - input.first.begin());
+            }
+            return total;
+        }));
+        suite.add("std::binary_search(sorted std::vector<uint32_t>)" + suffix, repeat([setSize, range]
+        {
+            return std::make_pair(makeSortedVector(randomValues(setSize, range, 1)), randomValues(lookupCount, range, 2));
+        }, [](const std::pair<Values, Values> &input)
+        {
+            size_t found = 0;
+            for (uint32_t value : input.second)
+            {
+                found += std::binary_search(input.first.begin(), input.first.end(), value);
+            }
+            return found;
+        }));
+        if (setSize > stdSetMaximumSize)
+        {
+            return;
+        }
+        suite.add("std::set<uint32_t>::count" + suffix, repeat([setSize, range]
+        {
+            Values values = randomValues(setSize, range, 1);
+            return std::make_pair(std::set<uint32_t>(values.begin(), values.end()), randomValues(lookupCount, range, 2));
+        }, [](const std::pair<std::set<uint32_t>, Values> &input)
+        {
+            size_t found = 0;
+            for (uint32_t value : input.second)
+            {
+                found += input.first.count(value);
+            }
+            return found;
+        }));
+    }
+
+    /**
+     * @brief Adds the benchmarks of the set algebra on two sets of `aCount` and `bCount` random values.
+     */
+    void addAlgebra(ChBenchmarkSuite &suite, size_t aCount, size_t bCount)
+    {
+        const std::string suffix = "/" + std::to_string(aCount) + " & " + std::to_string(bCount);
+        // Both sets draw from a range twice the size of the larger one, so they share about a quarter of the values
+        const uint32_t range = static_cast<uint32_t>(2 * std::max(aCount, bCount));
+        auto chSets = [aCount, bCount, range]
+        {
+            return std::make_pair(makeChSet(randomValues(aCount, range, 1)), makeChSet(randomValues(bCount, range, 2)));
+        };
+        auto vectors = [aCount, bCount, range]
+        {
+            return std::make_pair(makeSortedVector(randomValues(aCount, range, 1)), makeSortedVector(randomValues(bCount, range, 2)));
+        };
+        auto stdSets = [aCount, bCount, range]
+        {
+            Values a = randomValues(aCount, range, 1);
+            Values b = randomValues(bCount, range, 2);
+            return std::make_pair(std::set<uint32_t>(a.begin(), a.end()), std::set<uint32_t>(b.begin(), b.end()));
+        };
+        using ChSets = std::pair<ChSet<uint32_t>, ChSet<uint32_t>>;
+        using Vectors = std::pair<Values, Values>;
+        using StdSets = std::pair<std::set<uint32_t>, std::set<uint32_t>>;
+
+        suite.add("ChSet<uint32_t>::setIntersection" + suffix, repeat(chSets, [](const ChSets &input)
+        {
+            return input.first.setIntersection(input.second).size();
+        }));
+        suite.add("ChSet<uint32_t>::intersectionSize" + suffix, repeat(chSets, [](const ChSets &input)
+        {
+            return input.first.intersectionSize(input.second);
+        }));
+        suite.add("std::set_intersection(sorted std::vector<uint32_t>)" + suffix, repeat(vectors, [](const Vectors &input)
+        {
+            Values result;
+            std::set_intersection(input.first.begin(), input.first.end(), input.second.begin(), input.second.end(), std::back_inserter(result));
+            return result.size();
+        }));
+        suite.add("std::set_intersection(std::set<uint32_t>)" + suffix, repeat(stdSets, [](const StdSets &input)
+        {
+            std::set<uint32_t> result;
+            std::set_intersection(input.first.begin(), input.first.end(), input.second.begin(), input.second.end(), std::inserter(result, result.end()));
+            return result.size();
+        }));
+
+        suite.add("ChSet<uint32_t>::setUnion" + suffix, repeat(chSets, [](const ChSets &input)
+        {
+            return input.first.setUnion(input.second).size();
+        }));
+        suite.add("std::set_union(sorted std::vector<uint32_t>)" + suffix, repeat(vectors, [](const Vectors &input)
+        {
+            Values result;
+            std::set_union(input.first.begin(), input.first.end(), input.second.begin(), input.second.end(), std::back_inserter(result));
+            return result.size();
+        }));
+        suite.add("std::set_union(std::set<uint32_t>)" + suffix, repeat(stdSets, [](const StdSets &input)
+        {
+            std::set<uint32_t> result;
+            std::set_union(input.first.begin(), input.first.end(), input.second.begin(), input.second.end(), std::inserter(result, result.end()));
+            return result.size();
+        }));
+
+        suite.add("ChSet<uint32_t>::setDifference" + suffix, repeat(chSets, [](const ChSets &input)
+        {
+            return input.first.setDifference(input.second).size();
+        }));
+        suite.add("std::set_difference(sorted std::vector<uint32_t>)" + suffix, repeat(vectors, [](const Vectors &input)
+        {
+            Values result;
+            std::set_difference(input.first.begin(), input.first.end(), input.second.begin(), input.second.end(), std::back_inserter(result));
+            return result.size();
+        }));
+        suite.add("std::set_difference(std::set<uint32_t>)" + suffix, repeat(stdSets, [](const StdSets &input)
+        {
+            std::set<uint32_t> result;
+            std::set_difference(input.first.begin(), input.first.end(), input.second.begin(), input.second.end(), std::inserter(result, result.end()));
+            return result.size();
+        }));
+    }
+
+    /**
+     * @brief Adds the benchmarks of building a set from unsorted values.
+     */
+    void addBuild(ChBenchmarkSuite &suite)
+    {
+        const std::string suffix = "/" + std::to_string(stdSetMaximumSize);
+        auto values = [] { return randomValues(stdSetMaximumSize, static_cast<uint32_t>(2 * stdSetMaximumSize), 1); };
+
+        suite.add("ChSet<uint32_t>(ChVector)" + suffix, repeat(values, [](const Values &input)
+        {
+            return makeChSet(input).size();
+        }));
+        suite.add("std::set<uint32_t>(first, last)" + suffix, repeat(values, [](const Values &input)
+        {
+            return std::set<uint32_t>(input.begin(), input.end()).size();
+        }));
+    }
+}
+
+void addSetBenchmarks(ChBenchmarkSuite &suite)
+{
+    for (size_t setSize : lookupSetSizes)
+    {
+        addLookups(suite, setSize);
+    }
+    addAlgebra(suite, mergeCount, mergeCount);
+    addAlgebra(suite, skewedSmallCount, skewedLargeCount);
+    addBuild(suite);
+}
\ No newline at end of file
@@ -0,0 +1,645 @@
+#include "ChBenchmarks.h"
+#include "ChRope.h"
+#include "ChSharedString.h"
+#include "ChString.h"
+#include "ChStringBuilder.h"
+#include "ChStringCursor.h"
+#include "ChStringMatcher.h"
+#include "ChStringPool.h"
+#include "ChStringSplitter.h"
+#include <algorithm>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using ChBenchmark::repeat;
+using ChBenchmark::repeatOnCopy;
+
+namespace
+{
+    const char *const words[] = {"lorem", "Ipsum", "dolor", "SIT", "amet", "consectetur", "adipiscing", "Elit", "sed", "do"};
+
+    /**
+     * @brief Returns about `size` bytes of mixed-case words. Every seventh gap is three spaces wide, and the text
+     * starts and ends with spaces, so that the space removal functions have work to do.
+     */
+    std::string makeWords(size_t size)
+    {
+        std::string text = "  ";
+        for (size_t i = 0; text.size() < size; ++i)
+        {
+            text += words[i % 10];
+            text += i % 7 == 6 ? "   " : " ";
+        }
+        text += "  ";
+        return text;
+    }
+
+    /**
+     * @brief Returns about `size` bytes of UTF-8 text in which every fourth word holds two-byte characters.
+     */
+    std::string makeUtf8(size_t size)
+    {
+        std::string text;
+        for (size_t i = 0; text.size() < size; ++i)
+        {
+            text += i % 4 == 3 ? "gr\xC3\xBC\xC3\x9F" : words[i % 10];
+            text += ' ';
+        }
+        return text;
+    }
+
+    /**
+     * @brief Returns about `size` bytes of comma separated words.
+     */
+    std::string makeCsv(size_t size)
+    {
+        std::string text;
+        for (size_t i = 0; text.size() < size; ++i)
+        {
+            text += words[i % 10];
+            text += i % 5 == 4 ? ",," : ",";
+        }
+        return text;
+    }
+
+    ChString text16()
+    {
+        return ChString("  Lorem  ipsum ");
+    }
+
+    ChString text1k()
+    {
+        return ChString(makeWords(1024));
+    }
+
+    ChString utf1k()
+    {
+        return ChString(makeUtf8(1024));
+    }
+
+    ChString csv1k()
+    {
+        return ChString(makeCsv(1024));
+    }
+
+    ChString integerText()
+    {
+        return ChString("-1234567");
+    }
+
+    ChString floatText()
+    {
+        return ChString("3.14159265");
+    }
+
+    void addConstruction(ChBenchmarkSuite &suite)
+    {
+        suite.add("ChString::ChString(const char *)/16B", repeat([] { return 0; }, [](int) { return ChString("Lorem ipsum dolo"); }));
+        suite.add("ChString::ChString(const std::string &)/1KiB", repeat([] { return makeWords(1024); }, [](const std::string &text) { return ChString(text); }));
+        suite.add("ChString::ChString(std::string &&)/1KiB", repeatOnCopy([] { return makeWords(1024); }, [](std::string &text) { return ChString(std::move(text)); }));
+        suite.add("ChString::ChString(size_t, char)/1KiB", repeat([] { return 0; }, [](int) { return ChString(1024, 'x'); }));
+        suite.add("ChString::ChString(const ChString &)/1KiB", repeat(text1k, [](const ChString &text) { return ChString(text); }));
+        suite.add("ChString::ChString(ChString &&)/1KiB", repeatOnCopy(text1k, [](ChString &text) { return ChString(std::move(text)); }));
+        suite.add("ChString::operator=(const ChString &)/1KiB", repeat([] { return std::make_pair(text1k(), ChString()); }, [](std::pair<ChString, ChString> &texts)
+        {
+            texts.second = texts.first;
+        }));
+        suite.add("ChString::operator=(ChString &&)/1KiB", repeatOnCopy([] { return std::make_pair(text1k(), ChString()); }, [](std::pair<ChString, ChString> &texts)
+        {
+            texts.second = std::move(texts.first);
+        }));
+        suite.add("ChString::operator std::string &/1KiB", repeat(text1k, [](ChString &text) { return static_cast<std::string &>(text).size(); }));
+        suite.add("ChString::getData/1KiB", repeat(text1k, [](const ChString &text) { return text.getData().size(); }));
+        suite.add("ChString::size/1KiB", repeat(text1k, [](const ChString &text) { return text.size(); }));
+    }
+
+    // The number of values each conversion throughput benchmark converts
+    const size_t conversionCount = 1000;
+
+    /**
+     * @brief Returns `conversionCount` integers spread over several magnitudes and their decimal texts.
+     */
+    std::pair<std::vector<int>, std::vector<ChString>> integers()
+    {
+        std::pair<std::vector<int>, std::vector<ChString>> values;
+        for (size_t i = 0; i < conversionCount; ++i)
+        {
+            int value = static_cast<int>((i * 2654435761u) % 2000000001u) - 1000000000;
+            value /= (1 << (i % 24));
+            values.first.push_back(value);
+            values.second.push_back(ChString(std::to_string(value)));
+        }
+        return values;
+    }
+
+    /**
+     * @brief Returns `conversionCount` doubles spread over several magnitudes and their shortest decimal texts.
+     */
+    std::pair<std::vector<double>, std::vector<ChString>> doubles()
+    {
+        std::pair<std::vector<double>, std::vector<ChString>> values;
+        for (size_t i = 0; i < conversionCount; ++i)
+        {
+            double value = static_cast<double>((i * 2654435761u) % 1000003u) / 997.0 * (i % 3 == 0 ? 1e-5 : 1e5);
+            ChString text;
+            text.fromNumber(value);
+            values.first.push_back(value);
+            values.second.push_back(text);
+        }
+        return values;
+    }
+
+    /**
+     * @brief Parses `text` the way ChString did before it used std::from_chars: strip the spaces from a copy and call
+     * `parse` (std::stoi or std::stod), which throws on bad input.
+     */
+    template <typename T, typename Parse>
+    T parseWithStd(const std::string &text, Parse parse, bool &valid)
+    {
+        std::string copy = text;
+        copy.erase(std::remove(copy.begin(), copy.end(), ' '), copy.end());
+        try
+        {
+            size_t position = 0;
+            T result = parse(copy, &position);
+            valid = position == copy.size();
+            return result;
+        }
+        catch (...)
+        {
+            valid = false;
+            return T();
+        }
+    }
+
+    /**
+     * @brief Adds the throughput benchmarks of converting `conversionCount` numbers with ChString, next to
+     * std::to_string, std::ostringstream (the formatting ChString used before) and std::stoi/std::stod. Dividing
+     * 10^12 by the time per operation gives conversions per second.
+     */
+    void addConversionThroughput(ChBenchmarkSuite &suite)
+    {
+        const std::string suffix = "/" + std::to_string(conversionCount) + " values";
+        using Integers = std::pair<std::vector<int>, std::vector<ChString>>;
+        using Doubles = std::pair<std::vector<double>, std::vector<ChString>>;
+
+        suite.add("ChString::fromNumber(int)" + suffix, repeat(integers, [](const Integers &input)
+        {
+            size_t total = 0;
+            ChString text;
+            for (int value : input.first)
+            {
+                text.fromNumber(value);
+                total += text.size();
+            }
+            return total;
+        }));
+        suite.add("std::to_string(int)" + suffix, repeat(integers, [](const Integers &input)
+        {
+            size_t total = 0;
+            for (int value : input.first)
+            {
+                total += std::to_string(value).size();
+            }
+            return total;
+        }));
+        suite.add("std::ostringstream << int" + suffix, repeat(integers, [](const Integers &input)
+        {
+            size_t total = 0;
+            for (int value : input.first)
+            {
+                std::ostringstream stream;
+                stream << value;
+                total += stream.str().size();
+            }
+            return total;
+        }));
+        suite.add("ChString::fromNumber(double)" + suffix, repeat(doubles, [](const Doubles &input)
+        {
+            size_t total = 0;
+            ChString text;
+            for (double value : input.first)
+            {
+                text.fromNumber(value);
+                total += text.size();
+            }
+            return total;
+        }));
+        suite.add("std::to_string(double)" + suffix, repeat(doubles, [](const Doubles &input)
+        {
+            size_t total = 0;
+            for (double value : input.first)
+            {
+                total += std::to_string(value).size();
+            }
+            return total;
+        }));
+        suite.add("std::ostringstream << double" + suffix, repeat(doubles, [](const Doubles &input)
+        {
+            size_t total = 0;
+            for (double value : input.first)
+            {
+                std::ostringstream stream;
+                stream << value;
+                total += stream.str().size();
+            }
+            return total;
+        }));
+
+        suite.add("ChString::toInteger" + suffix, repeat(integers, [](const Integers &input)
+        {
+            long long total = 0;
+            bool valid;
+            for (const ChString &text : input.second)
+            {
+                total += text.toInteger(valid);
+            }
+            return total;
+        }));
+        suite.add("std::stoi" + suffix, repeat(integers, [](const Integers &input)
+        {
+            long long total = 0;
+            bool valid;
+            for (const ChString &text : input.second)
+            {
+                total += parseWithStd<int>(text.getData(), [](const std::string &copy, size_t *position) { return std::stoi(copy, position); }, valid);
+            }
+            return total;
+        }));
+        suite.add("ChString::toDouble" + suffix, repeat(doubles, [](const Doubles &input)
+        {
+            double total = 0;
+            bool valid;
+            for (const ChString &text : input.second)
+            {
+                total += text.toDouble(valid);
+            }
+            return total;
+        }));
+        suite.add("std::stod" + suffix, repeat(doubles, [](const Doubles &input)
+        {
+            double total = 0;
+            bool valid;
+            for (const ChString &text : input.second)
+            {
+                total += parseWithStd<double>(text.getData(), [](const std::string &copy, size_t *position) { return std::stod(copy, position); }, valid);
+            }
+            return total;
+        }));
+    }
+
+    void addNumbers(ChBenchmarkSuite &suite)
+    {
+        suite.add("ChString::fromNumber(int)", repeat([] { return ChString(); }, [](ChString &text) { text.fromNumber(-1234567); }));
+        suite.add("ChString::fromNumber(unsigned int)", repeat([] { return ChString(); }, [](ChString &text) { text.fromNumber(1234567u); }));
+        suite.add("ChString::fromNumber(long)", repeat([] { return ChString(); }, [](ChString &text) { text.fromNumber(-1234567890l); }));
+        suite.add("ChString::fromNumber(unsigned long)", repeat([] { return ChString(); }, [](ChString &text) { text.fromNumber(1234567890ul); }));
+        suite.add("ChString::fromNumber(long long)", repeat([] { return ChString(); }, [](ChString &text) { text.fromNumber(-1234567890123ll); }));
+        suite.add("ChString::fromNumber(unsigned long long)", repeat([] { return ChString(); }, [](ChString &text) { text.fromNumber(1234567890123ull); }));
+        suite.add("ChString::fromNumber(float)", repeat([] { return ChString(); }, [](ChString &text) { text.fromNumber(3.14159f); }));
+        suite.add("ChString::fromNumber(double)", repeat([] { return ChString(); }, [](ChString &text) { text.fromNumber(3.14159265358979); }));
+        suite.add("ChString::appendNumber(int)", repeatOnCopy(text16, [](ChString &text) { return text.appendNumber(-1234567).size(); }));
+        suite.add("ChString::appendNumber(unsigned int)", repeatOnCopy(text16, [](ChString &text) { return text.appendNumber(1234567u).size(); }));
+        suite.add("ChString::appendNumber(long)", repeatOnCopy(text16, [](ChString &text) { return text.appendNumber(-1234567890l).size(); }));
+        suite.add("ChString::appendNumber(unsigned long)", repeatOnCopy(text16, [](ChString &text) { return text.appendNumber(1234567890ul).size(); }));
+        suite.add("ChString::appendNumber(long long)", repeatOnCopy(text16, [](ChString &text) { return text.appendNumber(-1234567890123ll).size(); }));
+        suite.add("ChString::appendNumber(unsigned long long)", repeatOnCopy(text16, [](ChString &text) { return text.appendNumber(1234567890123ull).size(); }));
+        suite.add("ChString::appendNumber(float)", repeatOnCopy(text16, [](ChString &text) { return text.appendNumber(3.14159f).size(); }));
+        suite.add("ChString::appendNumber(double)", repeatOnCopy(text16, [](ChString &text) { return text.appendNumber(3.14159265358979).size(); }));
+
+        suite.add("ChString::toInteger", repeat(integerText, [](const ChString &text) { bool valid; return text.toInteger(valid); }));
+        suite.add("ChString::toUnsignedInteger", repeat([] { return ChString("1234567"); }, [](const ChString &text) { bool valid; return text.toUnsignedInteger(valid); }));
+        suite.add("ChString::toLong", repeat(integerText, [](const ChString &text) { bool valid; return text.toLong(valid); }));
+        suite.add("ChString::toUnsignedLong", repeat([] { return ChString("1234567"); }, [](const ChString &text) { bool valid; return text.toUnsignedLong(valid); }));
+        suite.add("ChString::toLongLong", repeat(integerText, [](const ChString &text) { bool valid; return text.toLongLong(valid); }));
+        suite.add("ChString::toUnsignedLongLong", repeat([] { return ChString("1234567"); }, [](const ChString &text) { bool valid; return text.toUnsignedLongLong(valid); }));
+        suite.add("ChString::toFloat", repeat(floatText, [](const ChString &text) { bool valid; return text.toFloat(valid); }));
+        suite.add("ChString::toDouble", repeat(floatText, [](const ChString &text) { bool valid; return text.toDouble(valid); }));
+    }
+
+    void addEditing(ChBenchmarkSuite &suite)
+    {
+        suite.add("ChString::concat/1KiB", repeat(text1k, [](const ChString &text) { return text.concat(text); }));
+        suite.add("ChString::substring/1KiB", repeat(text1k, [](const ChString &text) { return text.substring(100, 500); }));
+        suite.add("ChString::erase/1KiB", repeat(text1k, [](const ChString &text) { return text.erase(100, 600); }));
+        suite.add("ChString::removeExtraSpacesInPlace/1KiB", repeatOnCopy(text1k, [](ChString &text) { return text.removeExtraSpacesInPlace().size(); }));
+        suite.add("ChString::removeLeadingSpacesInPlace/1KiB", repeatOnCopy(text1k, [](ChString &text) { return text.removeLeadingSpacesInPlace().size(); }));
+        suite.add("ChString::removeTrailingSpacesInPlace/1KiB", repeatOnCopy(text1k, [](ChString &text) { return text.removeTrailingSpacesInPlace().size(); }));
+        suite.add("ChString::removeTrailingAndLeadingSpacesInPlace/1KiB", repeatOnCopy(text1k, [](ChString &text) { return text.removeTrailingAndLeadingSpacesInPlace().size(); }));
+        suite.add("ChString::viewWithoutLeadingSpaces/1KiB", repeat(text1k, [](const ChString &text) { return text.viewWithoutLeadingSpaces(); }));
+        suite.add("ChString::viewWithoutTrailingSpaces/1KiB", repeat(text1k, [](const ChString &text) { return text.viewWithoutTrailingSpaces(); }));
+        suite.add("ChString::viewWithoutTrailingAndLeadingSpaces/1KiB", repeat(text1k, [](const ChString &text) { return text.viewWithoutTrailingAndLeadingSpaces(); }));
+        suite.add("ChString::removeAll/1KiB", repeat(text1k, [](ChString &text) { return text.removeAll(' '); }));
+        suite.add("ChString::removeFirst(ChString)/1KiB", repeat(text1k, [](const ChString &text) { return text.removeFirst(ChString("Elit")); }));
+        suite.add("ChString::removeFirst(const char *)/1KiB", repeat(text1k, [](const ChString &text) { return text.removeFirst("Elit"); }));
+        suite.add("ChString::removeLast(ChString)/1KiB", repeat(text1k, [](const ChString &text) { return text.removeLast(ChString("Elit")); }));
+        suite.add("ChString::removeLast(const char *)/1KiB", repeat(text1k, [](const ChString &text) { return text.removeLast("Elit"); }));
+        suite.add("ChString::first/1KiB", repeat(text1k, [](const ChString &text) { return text.first(); }));
+        suite.add("ChString::last/1KiB", repeat(text1k, [](const ChString &text) { return text.last(); }));
+        suite.add("ChString::popFirst/1KiB", repeatOnCopy(text1k, [](ChString &text) { return text.popFirst(); }));
+        suite.add("ChString::popLast/1KiB", repeatOnCopy(text1k, [](ChString &text) { return text.popLast(); }));
+        suite.add("ChString::leftJustified/16B", repeat(text16, [](const ChString &text) { return text.leftJustified(40, '.'); }));
+        suite.add("ChString::rightJustified/16B", repeat(text16, [](const ChString &text) { return text.rightJustified(40, '.'); }));
+    }
+
+    /**
+     * @brief Adds the benchmarks of the space removal functions at 1 KiB to 1 MiB, each next to the std::regex_replace
+     * calls they replaced.
+     */
+    void addSpaceRemoval(ChBenchmarkSuite &suite)
+    {
+        const std::pair<size_t, const char *> sizes[] = {{1024, "/1KiB"}, {65536, "/64KiB"}, {1 << 20, "/1MiB"}};
+        for (const auto &size : sizes)
+        {
+            const size_t bytes = size.first;
+            const std::string suffix = size.second;
+            auto text = [bytes] { return ChString(makeWords(bytes)); };
+            auto plain = [bytes] { return makeWords(bytes); };
+
+            suite.add("ChString::removeExtraSpaces" + suffix, repeat(text, [](ChString &input) { return input.removeExtraSpaces(); }));
+            suite.add("std::regex_replace(removeExtraSpaces)" + suffix, repeat(plain, [](const std::string &input)
+            {
+                return std::regex_replace(input, std::regex("^ +| +$|( ) +"), "$1");
+            }));
+            suite.add("ChString::removeLeadingSpaces" + suffix, repeat(text, [](ChString &input) { return input.removeLeadingSpaces(); }));
+            suite.add("std::regex_replace(removeLeadingSpaces)" + suffix, repeat(plain, [](const std::string &input)
+            {
+                return std::regex_replace(input, std::regex("^ +"), "");
+            }));
+            suite.add("ChString::removeTrailingSpaces" + suffix, repeat(text, [](ChString &input) { return input.removeTrailingSpaces(); }));
+            suite.add("std::regex_replace(removeTrailingSpaces)" + suffix, repeat(plain, [](const std::string &input)
+            {
+                return std::regex_replace(input, std::regex(" +$"), "");
+            }));
+            suite.add("ChString::removeTrailingAndLeadingSpaces" + suffix, repeat(text, [](ChString &input) { return input.removeTrailingAndLeadingSpaces(); }));
+            suite.add("std::regex_replace(removeTrailingAndLeadingSpaces)" + suffix, repeat(plain, [](const std::string &input)
+            {
+                return std::regex_replace(std::regex_replace(input, std::regex("^ +"), ""), std::regex(" +$"), "");
+            }));
+        }
+    }
+
+    void addSearching(ChBenchmarkSuite &suite)
+    {
+        suite.add("ChString::contains(ChString)/1KiB", repeat(text1k, [](const ChString &text) { return text.contains(ChString("ELIT SED DO LOREM X")); }));
+        suite.add("ChString::contains(ChString, caseSensitive)/1KiB", repeat(text1k, [](const ChString &text) { return text.contains(ChString("Elit sed do lorem X"), true); }));
+        suite.add("ChString::contains(const char *)/1KiB", repeat(text1k, [](const ChString &text) { return text.contains("ELIT SED DO LOREM X"); }));
+        suite.add("ChString::contains(ChStringMatcher)/1KiB", repeat([] { return std::make_pair(text1k(), ChStringMatcher("ELIT SED DO LOREM X")); }, [](const std::pair<ChString, ChStringMatcher> &input)
+        {
+            return input.first.contains(input.second);
+        }));
+        suite.add("ChString::count(ChString)/1KiB", repeat(text1k, [](const ChString &text) { return text.count(ChString("lorem")); }));
+        suite.add("ChString::count(const char *)/1KiB", repeat(text1k, [](const ChString &text) { return text.count("lorem"); }));
+        suite.add("ChString::count(ChStringMatcher)/1KiB", repeat([] { return std::make_pair(text1k(), ChStringMatcher("lorem")); }, [](const std::pair<ChString, ChStringMatcher> &input)
+        {
+            return input.first.count(input.second);
+        }));
+        suite.add("ChString::beginsWith(ChString)/1KiB", repeat(text1k, [](const ChString &text) { return text.beginsWith(ChString("  lorem")); }));
+        suite.add("ChString::beginsWith(const char *)/1KiB", repeat(text1k, [](const ChString &text) { return text.beginsWith("  lorem"); }));
+        suite.add("ChString::beginsWith(char)/1KiB", repeat(text1k, [](const ChString &text) { return text.beginsWith(' '); }));
+        suite.add("ChString::endsWith(ChString)/1KiB", repeat(text1k, [](const ChString &text) { return text.endsWith(ChString("do  ")); }));
+        suite.add("ChString::endsWith(const char *)/1KiB", repeat(text1k, [](const ChString &text) { return text.endsWith("do  "); }));
+        suite.add("ChString::endsWith(char)/1KiB", repeat(text1k, [](const ChString &text) { return text.endsWith(' '); }));
+    }
+
+    void addCase(ChBenchmarkSuite &suite)
+    {
+        suite.add("ChString::toLower/1KiB", repeat(text1k, [](const ChString &text) { return text.toLower(); }));
+        suite.add("ChString::toUpper/1KiB", repeat(text1k, [](const ChString &text) { return text.toUpper(); }));
+        suite.add("ChString::capitalize/1KiB", repeat(text1k, [](const ChString &text) { return text.capitalize(); }));
+        suite.add("ChString::toLowerInPlace/1KiB", repeatOnCopy(text1k, [](ChString &text) { return text.toLowerInPlace().size(); }));
+        suite.add("ChString::toUpperInPlace/1KiB", repeatOnCopy(text1k, [](ChString &text) { return text.toUpperInPlace().size(); }));
+        suite.add("ChString::capitalizeInPlace/1KiB", repeatOnCopy(text1k, [](ChString &text) { return text.capitalizeInPlace().size(); }));
+    }
+
+    void addSplitting(ChBenchmarkSuite &suite)
+    {
+        suite.add("ChString::split(ChString)/1KiB", repeat(csv1k, [](const ChString &text) { return text.split(ChString(",")).size(); }));
+        suite.add("ChString::split(char)/1KiB", repeat(csv1k, [](const ChString &text) { return text.split(',').size(); }));
+        suite.add("ChString::splitView(ChString)/1KiB", repeat(csv1k, [](const ChString &text) { return text.splitView(ChString(",")).size(); }));
+        suite.add("ChString::splitView(char)/1KiB", repeat(csv1k, [](const ChString &text) { return text.splitView(',').size(); }));
+        suite.add("ChString::splitLazy(ChString)/1KiB", repeat(csv1k, [](const ChString &text)
+        {
+            size_t parts = 0;
+            for (std::string_view part : text.splitLazy(ChString(",")))
+            {
+                parts += part.size();
+            }
+            return parts;
+        }));
+        suite.add("ChString::splitLazy(char)/1KiB", repeat(csv1k, [](const ChString &text)
+        {
+            size_t parts = 0;
+            for (std::string_view part : text.splitLazy(','))
+            {
+                parts += part.size();
+            }
+            return parts;
+        }));
+    }
+
+    void addUtf8(ChBenchmarkSuite &suite)
+    {
+        suite.add("ChString::isAscii/1KiB", repeat(utf1k, [](const ChString &text) { return text.isAscii(); }));
+        suite.add("ChString::isValidUtf8/1KiB", repeat(utf1k, [](const ChString &text) { return text.isValidUtf8(); }));
+        suite.add("ChString::codePointCount/1KiB", repeat(utf1k, [](const ChString &text) { return text.codePointCount(); }));
+        suite.add("ChString::utf8Substring/1KiB", repeat(utf1k, [](const ChString &text) { return text.utf8Substring(100, 500); }));
+        suite.add("ChString::utf8LeftJustified/1KiB", repeat(utf1k, [](const ChString &text) { return text.utf8LeftJustified(1200, '.'); }));
+        suite.add("ChString::utf8RightJustified/1KiB", repeat(utf1k, [](const ChString &text) { return text.utf8RightJustified(1200, '.'); }));
+        suite.add("ChString::utf8First/1KiB", repeat(utf1k, [](const ChString &text) { return text.utf8First(); }));
+        suite.add("ChString::utf8Last/1KiB", repeat(utf1k, [](const ChString &text) { return text.utf8Last(); }));
+        suite.add("ChString::utf8PopFirst/1KiB", repeatOnCopy(utf1k, [](ChString &text) { return text.utf8PopFirst(); }));
+        suite.add("ChString::utf8PopLast/1KiB", repeatOnCopy(utf1k, [](ChString &text) { return text.utf8PopLast(); }));
+    }
+
+    /**
+     * @brief Adds the benchmarks of one storage type on a token or a document of `bytes` bytes, so that each one can
+     * be read next to ChString on the same input. Bytes per operation of the construction and copy benchmarks are the
+     * memory each string takes.
+     */
+    template <typename Storage>
+    void addStorage(ChBenchmarkSuite &suite, const std::string &name, size_t bytes, const std::string &suffix)
+    {
+        auto text = [bytes] { return Storage(makeWords(bytes)); };
+        suite.add(name + "::" + name + "(const std::string &)" + suffix, repeat([bytes] { return makeWords(bytes); }, [](const std::string &input) { return Storage(input); }));
+        suite.add(name + "::" + name + "(const " + name + " &)" + suffix, repeat(text, [](const Storage &input) { return Storage(input); }));
+        suite.add(name + "::substring" + suffix, repeat(text, [bytes](const Storage &input) { return input.substring(bytes / 4, bytes / 2); }));
+    }
+
+    /**
+     * @brief Adds the benchmarks of ChSharedString and ChRope next to the same operations on ChString, for short
+     * tokens and for large documents.
+     */
+    void addStorageModes(ChBenchmarkSuite &suite)
+    {
+        const std::pair<size_t, const char *> sizes[] = {{32, "/32B"}, {1 << 20, "/1MiB"}};
+        for (const auto &size : sizes)
+        {
+            addStorage<ChString>(suite, "ChString", size.first, size.second);
+            addStorage<ChSharedString>(suite, "ChSharedString", size.first, size.second);
+            addStorage<ChRope>(suite, "ChRope", size.first, size.second);
+        }
+
+        // Editing a document in the middle copies all of a ChString, and only a path of nodes of a rope
+        const size_t document = 1 << 20;
+        auto chString = [document] { return ChString(makeWords(document)); };
+        auto rope = [document] { return ChRope(makeWords(document)); };
+        suite.add("ChString::concat/1MiB", repeat(chString, [](const ChString &text) { return text.concat(text); }));
+        suite.add("ChRope::concat/1MiB", repeat(rope, [](const ChRope &text) { return text.concat(text); }));
+        suite.add("ChString::erase/1MiB middle", repeat(chString, [document](const ChString &text) { return text.erase(document / 2, document / 2 + 63); }));
+        suite.add("ChRope::erase/1MiB middle", repeatOnCopy(rope, [document](ChRope &text) { return text.erase(document / 2, 64).size(); }));
+        suite.add("ChString::operator[]/1MiB", repeat(chString, [document](const ChString &text)
+        {
+            const std::string &data = text.getData();
+            size_t total = 0;
+            for (size_t i = 0; i < document; i += 4096)
+            {
+                total += static_cast<unsigned char>(data[i]);
+            }
+            return total;
+        }));
+        suite.add("ChRope::operator[]/1MiB", repeat(rope, [document](const ChRope &text)
+        {
+            size_t total = 0;
+            for (size_t i = 0; i < document; i += 4096)
+            {
+                total += static_cast<unsigned char>(text[i]);
+            }
+            return total;
+        }));
+    }
+
+    void addCompanions(ChBenchmarkSuite &suite)
+    {
+        suite.add("ChStringBuilder::append/100 words", repeat([] { return 0; }, [](int)
+        {
+            ChStringBuilder builder;
+            for (size_t i = 0; i < 100; ++i)
+            {
+                builder.append(words[i % 10]).append(' ');
+            }
+            return builder.build();
+        }));
+        suite.add("ChStringBuilder::appendNumber/100 numbers", repeat([] { return 0; }, [](int)
+        {
+            ChStringBuilder builder(1024);
+            for (int i = 0; i < 100; ++i)
+            {
+                builder.appendNumber(i * 7919).append(',');
+            }
+            return builder.build();
+        }));
+        suite.add("ChStringBuilder::appendRightJustified/100 fields", repeat([] { return 0; }, [](int)
+        {
+            ChStringBuilder builder(2048);
+            for (size_t i = 0; i < 100; ++i)
+            {
+                builder.appendRightJustified(words[i % 10], 12);
+            }
+            return builder.build();
+        }));
+        suite.add("ChString::concat chain/100 words", repeat([] { return 0; }, [](int)
+        {
+            ChString result;
+            for (size_t i = 0; i < 100; ++i)
+            {
+                result = result.concat(ChString(words[i % 10])).concat(ChString(" "));
+            }
+            return result;
+        }));
+
+        // Draining a ChString is quadratic: at 1 MiB one drain takes about ten seconds, so it only runs on the smaller
+        // inputs
+        const std::pair<size_t, const char *> drainSizes[] = {{1024, "/1KiB drain"}, {65536, "/64KiB drain"}, {1 << 20, "/1MiB drain"}};
+        for (const auto &size : drainSizes)
+        {
+            const size_t bytes = size.first;
+            suite.add(std::string("ChStringCursor::popFirst") + size.second, repeatOnCopy([bytes] { return ChStringCursor(makeWords(bytes)); }, [](ChStringCursor &cursor)
+            {
+                size_t total = 0;
+                while (!cursor.isEmpty())
+                {
+                    total += static_cast<unsigned char>(cursor.popFirst());
+                }
+                return total;
+            }));
+            if (bytes > 65536)
+            {
+                continue;
+            }
+            suite.add(std::string("ChString::popFirst") + size.second, repeatOnCopy([bytes] { return ChString(makeWords(bytes)); }, [](ChString &text)
+            {
+                size_t total = 0;
+                while (text.size() > 0)
+                {
+                    total += static_cast<unsigned char>(text.popFirst());
+                }
+                return total;
+            }));
+        }
+        suite.add("ChStringCursor::skip/1KiB tokens", repeatOnCopy([] { return ChStringCursor(makeCsv(1024)); }, [](ChStringCursor &cursor)
+        {
+            size_t tokens = 0;
+            while (!cursor.isEmpty())
+            {
+                size_t comma = cursor.indexOf(',');
+                cursor.skip(comma == std::string_view::npos ? cursor.size() : comma + 1);
+                ++tokens;
+            }
+            return tokens;
+        }));
+
+        suite.add("ChRope::append/100 words", repeat([] { return 0; }, [](int)
+        {
+            ChRope rope;
+            for (size_t i = 0; i < 100; ++i)
+            {
+                rope.append(ChRope(words[i % 10]));
+            }
+            return rope.size();
+        }));
+        suite.add("ChRope::insert/64KiB middle", repeatOnCopy([] { return ChRope(makeWords(65536)); }, [](ChRope &rope)
+        {
+            return rope.insert(rope.size() / 2, ChRope("inserted")).size();
+        }));
+        suite.add("ChRope::toChString/64KiB", repeat([] { return ChRope(makeWords(65536)); }, [](const ChRope &rope) { return rope.toChString(); }));
+
+        suite.add("ChStringPool::intern/existing", repeat([] { return ChStringPool::global().intern("consectetur"); }, [](const ChInternedString &) { return ChStringPool::global().intern("consectetur"); }));
+        suite.add("ChStringPool::find/existing", repeat([] { return ChStringPool::global().intern("adipiscing"); }, [](const ChInternedString &) { return ChStringPool::global().find("adipiscing"); }));
+        suite.add("ChInternedString::operator==", repeat([] { return ChStringPool::global().intern("adipiscing"); }, [](const ChInternedString &interned) { return interned == ChStringPool::global().fromId(interned.id()); }));
+
+        suite.add("ChStringMatcher::countIn/1KiB", repeat([] { return std::make_pair(makeWords(1024), ChStringMatcher("lorem")); }, [](const std::pair<std::string, ChStringMatcher> &input)
+        {
+            return input.second.countIn(input.first);
+        }));
+        suite.add("ChStringSplitter::next/1KiB", repeat([] { return makeCsv(1024); }, [](const std::string &text)
+        {
+            ChStringSplitter splitter(text, ',');
+            std::string_view part;
+            size_t parts = 0;
+            while (splitter.next(part))
+            {
+                ++parts;
+            }
+            return parts;
+        }));
+    }
+}
+
+void addStringBenchmarks(ChBenchmarkSuite &suite)
+{
+    addConstruction(suite);
+    addNumbers(suite);
+    addConversionThroughput(suite);
+    addEditing(suite);
+    addSpaceRemoval(suite);
+    addSearching(suite);
+    addCase(suite);
+    addSplitting(suite);
+    addUtf8(suite);
+    addStorageModes(suite);
+    addCompanions(suite);
+}
\ No newline at end of file
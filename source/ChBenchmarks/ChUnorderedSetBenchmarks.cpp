@@ -0,0 +1,209 @@
+#include "ChBenchmarks.h"
+#include "ChUnorderedSet.cpp"
+#include "ChVector.cpp"
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using ChBenchmark::repeat;
+
+namespace
+{
+    // The lookups run against sets that fit into the L2 cache and sets that only fit into memory
+    const size_t setSizes[] = {1 << 16, 1 << 20};
+    const size_t lookupCount = 1 << 20;
+
+    /**
+     * @brief Returns `size` pseudo-random values (a SplitMix64 sequence), the same for the same `seed`.
+     */
+    std::vector<uint64_t> randomKeys(size_t size, uint64_t seed)
+    {
+        std::vector<uint64_t> keys(size);
+        for (uint64_t &key : keys)
+        {
+            seed += 0x9E3779B97F4A7C15ull;
+            uint64_t value = seed;
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+            key = value ^ (value >> 31);
+        }
+        return keys;
+    }
+
+    /**
+     * @brief The elements of a set, and values to look up in it that it holds and does not hold.
+     */
+    template <typename T>
+    struct Workload
+    {
+        std::vector<T> elements;
+        std::vector<T> hits;
+        std::vector<T> misses;
+    };
+
+    /**
+     * @brief Dense integers: the even numbers below `2 * size`, which take two bits each in a bitset.
+     */
+    Workload<uint32_t> evenNumbers(size_t size)
+    {
+        Workload<uint32_t> workload;
+        for (size_t i = 0; i < size; ++i)
+        {
+            workload.elements.push_back(static_cast<uint32_t>(i * 2));
+        }
+        for (uint64_t key : randomKeys(lookupCount, 2))
+        {
+            workload.hits.push_back(static_cast<uint32_t>(key % size) * 2);
+            workload.misses.push_back(static_cast<uint32_t>(key % size) * 2 + 1);
+        }
+        return workload;
+    }
+
+    /**
+     * @brief Sparse integers: random 64-bit values.
+     */
+    Workload<uint64_t> randomIntegers(size_t size)
+    {
+        Workload<uint64_t> workload;
+        workload.elements = randomKeys(size, 1);
+        for (uint64_t key : randomKeys(lookupCount, 2))
+        {
+            workload.hits.push_back(workload.elements[key % size]);
+        }
+        workload.misses = randomKeys(lookupCount, 3);
+        return workload;
+    }
+
+    /**
+     * @brief Strings of 12 to 20 characters made from random values.
+     */
+    Workload<std::string> randomStrings(size_t size)
+    {
+        Workload<std::string> workload;
+        for (uint64_t key : randomKeys(size, 1))
+        {
+            workload.elements.push_back("key:" + std::to_string(key >> 8));
+        }
+        for (uint64_t key : randomKeys(lookupCount, 2))
+        {
+            workload.hits.push_back(workload.elements[key % size]);
+        }
+        for (uint64_t key : randomKeys(lookupCount, 3))
+        {
+            workload.misses.push_back("key:" + std::to_string(key >> 8));
+        }
+        return workload;
+    }
+
+    template <typename Set, typename T>
+    Set insertAll(const std::vector<T> &elements)
+    {
+        Set set;
+        for (const T &element : elements)
+        {
+            set.insert(element);
+        }
+        return set;
+    }
+
+    template <typename Set, typename T>
+    Set freeze(const std::vector<T> &elements)
+    {
+        ChVector<T> values;
+        values.assign(elements.begin(), elements.end());
+        return Set::frozen(std::move(values));
+    }
+
+    /**
+     * @brief Adds the lookup and memory benchmarks of one set type on one workload. `make` builds the set from the
+     * elements of the workload.
+     */
+    template <typename Set, typename T>
+    void addSet(ChBenchmarkSuite &suite, const std::string &name, Workload<T> (*workload)(size_t), Set (*make)(const std::vector<T> &))
+    {
+        for (size_t size : setSizes)
+        {
+            const std::string suffix = "/" + std::to_string(size);
+            auto setup = [workload, make, size]
+            {
+                Workload<T> input = workload(size);
+                Set set = make(input.elements);
+                return std::make_pair(std::move(set), std::move(input));
+            };
+
+            suite.add(name + "::contains hit" + suffix, repeat(setup, [](const std::pair<Set, Workload<T>> &input)
+            {
+                size_t found = 0;
+                for (const T &value : input.second.hits)
+                {
+                    found += input.first.count(value);
+                }
+                return found;
+            }));
+            suite.add(name + "::contains miss" + suffix, repeat(setup, [](const std::pair<Set, Workload<T>> &input)
+            {
+                size_t found = 0;
+                for (const T &value : input.second.misses)
+                {
+                    found += input.first.count(value);
+                }
+                return found;
+            }));
+        }
+
+        // Copying a set allocates exactly what it holds on to, so the bytes per operation of a copy of a set of
+        // `iterations()` elements are the memory the set takes per element
+        suite.add(name + "::copy/per element", [workload, make](ChBenchmarkState &state)
+        {
+            Set set = make(workload(state.iterations()).elements);
+            state.resetTiming();
+            Set copy(set);
+            ChBenchmark::doNotOptimize(copy.size());
+        });
+    }
+
+    /**
+     * @brief Adds the benchmarks of building a set of each workload, as a frozen set and by inserting the elements.
+     */
+    template <typename T>
+    void addBuild(ChBenchmarkSuite &suite, const std::string &name, Workload<T> (*workload)(size_t))
+    {
+        const size_t size = setSizes[1];
+        const std::string suffix = "/" + std::to_string(size);
+        auto elements = [workload, size] { return workload(size).elements; };
+
+        suite.add("ChUnorderedSet<" + name + ">::frozen" + suffix, repeat(elements, [](const std::vector<T> &input)
+        {
+            return freeze<ChUnorderedSet<T>>(input).size();
+        }));
+        suite.add("ChUnorderedSet<" + name + ">::insert" + suffix, repeat(elements, [](const std::vector<T> &input)
+        {
+            return insertAll<ChUnorderedSet<T>>(input).size();
+        }));
+        suite.add("std::unordered_set<" + name + ">::insert" + suffix, repeat(elements, [](const std::vector<T> &input)
+        {
+            return insertAll<std::unordered_set<T>>(input).size();
+        }));
+    }
+}
+
+void addUnorderedSetBenchmarks(ChBenchmarkSuite &suite)
+{
+    // Bitset
+    addSet<ChUnorderedSet<uint32_t>>(suite, "ChUnorderedSet<uint32_t> dense", evenNumbers, insertAll<ChUnorderedSet<uint32_t>, uint32_t>);
+    addSet<std::unordered_set<uint32_t>>(suite, "std::unordered_set<uint32_t> dense", evenNumbers, insertAll<std::unordered_set<uint32_t>, uint32_t>);
+
+    // Hash table and perfect hash
+    addSet<ChUnorderedSet<uint64_t>>(suite, "ChUnorderedSet<uint64_t> sparse", randomIntegers, insertAll<ChUnorderedSet<uint64_t>, uint64_t>);
+    addSet<ChUnorderedSet<uint64_t>>(suite, "ChUnorderedSet<uint64_t> sparse frozen", randomIntegers, freeze<ChUnorderedSet<uint64_t>, uint64_t>);
+    addSet<std::unordered_set<uint64_t>>(suite, "std::unordered_set<uint64_t> sparse", randomIntegers, insertAll<std::unordered_set<uint64_t>, uint64_t>);
+
+    addSet<ChUnorderedSet<std::string>>(suite, "ChUnorderedSet<std::string>", randomStrings, insertAll<ChUnorderedSet<std::string>, std::string>);
+    addSet<ChUnorderedSet<std::string>>(suite, "ChUnorderedSet<std::string> frozen", randomStrings, freeze<ChUnorderedSet<std::string>, std::string>);
+    addSet<std::unordered_set<std::string>>(suite, "std::unordered_set<std::string>", randomStrings, insertAll<std::unordered_set<std::string>, std::string>);
+
+    addBuild<uint64_t>(suite, "uint64_t", randomIntegers);
+    addBuild<std::string>(suite, "std::string", randomStrings);
+}
\ No newline at end of file
@@ -0,0 +1,380 @@
+#include "ChBenchmarks.h"
+#include "ChVector.cpp"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using ChBenchmark::repeat;
+using ChBenchmark::repeatOnCopy;
+
+namespace
+{
+    const size_t count = 100000;
+
+    /**
+     * @brief Returns `size` pseudo-random integers below `range`, the same on every call.
+     */
+    ChVector<int> randomIntegers(size_t size, int range)
+    {
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int> distribution(0, range - 1);
+        ChVector<int> result;
+        result.reserve(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            result.push_back(distribution(random));
+        }
+        return result;
+    }
+
+    ChVector<double> randomDoubles(size_t size)
+    {
+        std::mt19937 random(42);
+        std::uniform_real_distribution<double> distribution(-1000.0, 1000.0);
+        ChVector<double> result;
+        result.reserve(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            result.push_back(distribution(random));
+        }
+        return result;
+    }
+
+    ChVector<int> integers()
+    {
+        return randomIntegers(count, 1 << 30);
+    }
+
+    ChVector<int> sortedIntegers()
+    {
+        ChVector<int> result = integers();
+        result.sort();
+        return result;
+    }
+
+    // Many repeated values, the input removeDuplicates is meant for
+    ChVector<int> duplicates()
+    {
+        return randomIntegers(count, 1000);
+    }
+
+    ChVector<double> doubles()
+    {
+        return randomDoubles(count);
+    }
+
+    ChVector<std::string> strings()
+    {
+        ChVector<int> values = randomIntegers(count, 20000);
+        ChVector<std::string> result;
+        for (int value : values)
+        {
+            result.push_back("item-" + std::to_string(value));
+        }
+        return result;
+    }
+
+    std::string policyName(ChExecutionPolicy policy)
+    {
+        switch (policy)
+        {
+        case ChExecutionPolicy::Sequential:
+            return "sequential";
+        case ChExecutionPolicy::Parallel:
+            return "parallel";
+        default:
+            return "parallelVectorized";
+        }
+    }
+
+    void addElementAccess(ChBenchmarkSuite &suite)
+    {
+        suite.add("ChVector<int>::ChVector(const ChVector &)/100000", repeat(integers, [](const ChVector<int> &values) { return ChVector<int>(values); }));
+        suite.add("ChVector<int>::ChVector(ChVector &&)/100000", repeatOnCopy(integers, [](ChVector<int> &values) { return ChVector<int>(std::move(values)); }));
+        suite.add("ChVector<int>::operator=(const ChVector &)/100000", repeat([] { return std::make_pair(integers(), ChVector<int>()); }, [](std::pair<ChVector<int>, ChVector<int>> &values)
+        {
+            values.second = values.first;
+        }));
+        suite.add("ChVector<int>::operator std::vector &/100000", repeat(integers, [](ChVector<int> &values) { return static_cast<std::vector<int> &>(values).size(); }));
+        suite.add("ChVector<int>::operator[]/100000", repeat(integers, [](const ChVector<int> &values)
+        {
+            int64_t total = 0;
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                total += values[i];
+            }
+            return total;
+        }));
+        suite.add("ChVector<int>::at/100000", repeat(integers, [](const ChVector<int> &values)
+        {
+            int64_t total = 0;
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                total += values.at(i);
+            }
+            return total;
+        }));
+        suite.add("ChVector<int>::begin/end/100000", repeat(integers, [](ChVector<int> &values)
+        {
+            int64_t total = 0;
+            for (int value : values)
+            {
+                total += value;
+            }
+            return total;
+        }));
+        suite.add("ChVector<int>::rbegin/rend/100000", repeat(integers, [](ChVector<int> &values)
+        {
+            int64_t total = 0;
+            for (auto it = values.rbegin(); it != values.rend(); ++it)
+            {
+                total += *it;
+            }
+            return total;
+        }));
+        suite.add("ChVector<int>::cbegin/cend/100000", repeat(integers, [](ChVector<int> &values)
+        {
+            int64_t total = 0;
+            for (auto it = values.cbegin(); it != values.cend(); ++it)
+            {
+                total += *it;
+            }
+            return total;
+        }));
+        suite.add("ChVector<int>::crbegin/crend/100000", repeat(integers, [](ChVector<int> &values)
+        {
+            int64_t total = 0;
+            for (auto it = values.crbegin(); it != values.crend(); ++it)
+            {
+                total += *it;
+            }
+            return total;
+        }));
+        suite.add("ChVector<int>::front/back", repeat(integers, [](ChVector<int> &values) { return values.front() + values.back(); }));
+        suite.add("ChVector<int>::data", repeat(integers, [](ChVector<int> &values) { return values.data(); }));
+        suite.add("ChVector<int>::size/isEmpty/capacity", repeat(integers, [](const ChVector<int> &values) { return values.size() + values.isEmpty() + values.capacity() + values.max_size(); }));
+        suite.add("ChVector<int>::allocator", repeat(integers, [](const ChVector<int> &values) { return values.allocator() == std::allocator<int>(); }));
+    }
+
+    void addModifiers(ChBenchmarkSuite &suite)
+    {
+        suite.add("ChVector<int>::push_back/100000", repeat([] { return 0; }, [](int)
+        {
+            ChVector<int> values;
+            for (size_t i = 0; i < count; ++i)
+            {
+                values.push_back(static_cast<int>(i));
+            }
+            return values.size();
+        }));
+        suite.add("ChVector<int>::push_back reserved/100000", repeat([] { return 0; }, [](int)
+        {
+            ChVector<int> values;
+            values.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                values.push_back(static_cast<int>(i));
+            }
+            return values.size();
+        }));
+        suite.add("ChVector<std::string>::push_back(T &&)/1000", repeat([] { return 0; }, [](int)
+        {
+            ChVector<std::string> values;
+            for (size_t i = 0; i < 1000; ++i)
+            {
+                values.push_back(std::string(24, 'x'));
+            }
+            return values.size();
+        }));
+        suite.add("ChVector<std::string>::emplace_back/1000", repeat([] { return 0; }, [](int)
+        {
+            ChVector<std::string> values;
+            for (size_t i = 0; i < 1000; ++i)
+            {
+                values.emplace_back(24, 'x');
+            }
+            return values.size();
+        }));
+        suite.add("ChVector<int>::pop_back/100000", repeatOnCopy(integers, [](ChVector<int> &values)
+        {
+            while (!values.isEmpty())
+            {
+                values.pop_back();
+            }
+        }));
+        suite.add("ChVector<int>::insert(pos, value)/middle of 100000", repeatOnCopy(integers, [](ChVector<int> &values) { return values.insert(values.begin() + count / 2, 7); }));
+        suite.add("ChVector<int>::insert(pos, count, value)/middle of 100000", repeatOnCopy(integers, [](ChVector<int> &values) { return values.insert(values.begin() + count / 2, 100, 7); }));
+        suite.add("ChVector<int>::insert(pos, first, last)/middle of 100000", repeatOnCopy(integers, [](ChVector<int> &values)
+        {
+            int block[100] = {};
+            return values.insert(values.begin() + count / 2, block, block + 100);
+        }));
+        suite.add("ChVector<int>::insert(pos, ilist)/middle of 100000", repeatOnCopy(integers, [](ChVector<int> &values) { return values.insert(values.begin() + count / 2, {1, 2, 3, 4}); }));
+        suite.add("ChVector<int>::emplace/middle of 100000", repeatOnCopy(integers, [](ChVector<int> &values) { return values.emplace(values.cbegin() + count / 2, 7); }));
+        suite.add("ChVector<int>::erase(pos)/middle of 100000", repeatOnCopy(integers, [](ChVector<int> &values) { return values.erase(values.begin() + count / 2); }));
+        suite.add("ChVector<int>::erase(first, last)/middle of 100000", repeatOnCopy(integers, [](ChVector<int> &values) { return values.erase(values.begin() + count / 4, values.begin() + count / 2); }));
+        suite.add("ChVector<int>::prepend/100000", repeatOnCopy(integers, [](ChVector<int> &values) { values.prepend({1, 2, 3, 4}); }));
+        suite.add("ChVector<int>::concat/100000", repeatOnCopy(integers, [](ChVector<int> &values) { values.concat(values); }));
+        suite.add("ChVector<int>::assign(count, value)/100000", repeat([] { return ChVector<int>(); }, [](ChVector<int> &values) { values.assign(count, 7); }));
+        suite.add("ChVector<int>::assign(first, last)/100000", repeat([] { return std::make_pair(integers(), ChVector<int>()); }, [](std::pair<ChVector<int>, ChVector<int>> &values)
+        {
+            values.second.assign(values.first.begin(), values.first.end());
+        }));
+        suite.add("ChVector<int>::assign(ilist)", repeat([] { return ChVector<int>(); }, [](ChVector<int> &values) { values.assign({1, 2, 3, 4, 5, 6, 7, 8}); }));
+        suite.add("ChVector<int>::resize/100000", repeat([] { return ChVector<int>(); }, [](ChVector<int> &values)
+        {
+            values.resize(count);
+            values.resize(0);
+        }));
+        suite.add("ChVector<int>::resize(n, value)/100000", repeat([] { return ChVector<int>(); }, [](ChVector<int> &values)
+        {
+            values.resize(count, 7);
+            values.resize(0, 7);
+        }));
+        suite.add("ChVector<int>::reserve/shrink/100000", repeat([] { return ChVector<int>(); }, [](ChVector<int> &values)
+        {
+            values.reserve(count);
+            values.shrink();
+        }));
+        suite.add("ChVector<int>::swap", repeat([] { return std::make_pair(integers(), ChVector<int>()); }, [](std::pair<ChVector<int>, ChVector<int>> &values)
+        {
+            values.first.swap(values.second);
+        }));
+        suite.add("ChVector<int>::clear/100000", repeatOnCopy(integers, [](ChVector<int> &values) { values.clear(); }));
+    }
+
+    void addSearches(ChBenchmarkSuite &suite)
+    {
+        // The searched value is absent, so every search scans all elements
+        suite.add("ChVector<int>::contains/100000", repeat(integers, [](const ChVector<int> &values) { return values.contains(-1); }));
+        suite.add("ChVector<int>::count/100000", repeat(integers, [](ChVector<int> &values) { return values.count(-1); }));
+        suite.add("ChVector<int>::find/100000", repeat(integers, [](ChVector<int> &values) { return values.find(-1) == values.end(); }));
+        suite.add("ChVector<int>::indexOf/100000", repeat(integers, [](const ChVector<int> &values) { return values.indexOf(-1); }));
+        suite.add("ChVector<int>::lastIndexOf/100000", repeat(integers, [](const ChVector<int> &values) { return values.lastIndexOf(-1); }));
+        suite.add("ChVector<double>::indexOf/100000", repeat(doubles, [](const ChVector<double> &values) { return values.indexOf(5000.0); }));
+        suite.add("ChVector<std::string>::contains/100000", repeat(strings, [](const ChVector<std::string> &values) { return values.contains("absent"); }));
+        suite.add("ChVector<int>::minimum/100000", repeat(integers, [](const ChVector<int> &values) { return values.minimum(); }));
+        suite.add("ChVector<int>::maximum/100000", repeat(integers, [](const ChVector<int> &values) { return values.maximum(); }));
+        suite.add("ChVector<int>::argMin/100000", repeat(integers, [](const ChVector<int> &values) { return values.argMin(); }));
+        suite.add("ChVector<int>::argMax/100000", repeat(integers, [](const ChVector<int> &values) { return values.argMax(); }));
+        // Plain standard library loops over the same data, as the baseline of the vector kernels
+        suite.add("std::find<int> baseline/100000", repeat(integers, [](const ChVector<int> &values) { return std::find(values.data(), values.data() + values.size(), -1); }));
+        suite.add("std::min_element<int> baseline/100000", repeat(integers, [](const ChVector<int> &values) { return std::min_element(values.data(), values.data() + values.size()); }));
+        suite.add("ChVector<double>::minimum/100000", repeat(doubles, [](const ChVector<double> &values) { return values.minimum(); }));
+        suite.add("ChVector<double>::argMax/100000", repeat(doubles, [](const ChVector<double> &values) { return values.argMax(); }));
+    }
+
+    void addArithmetic(ChBenchmarkSuite &suite)
+    {
+        suite.add("ChVector<int>::sum/100000", repeat(integers, [](const ChVector<int> &values) { return values.sum(); }));
+        suite.add("ChVector<double>::sum/100000", repeat(doubles, [](const ChVector<double> &values) { return values.sum(); }));
+        suite.add("std::accumulate<double> baseline/100000", repeat(doubles, [](const ChVector<double> &values) { return std::accumulate(values.data(), values.data() + values.size(), 0.0); }));
+        suite.add("ChVector<double>::sum(Kahan)/100000", repeat(doubles, [](const ChVector<double> &values) { return values.sum(ChSummation::Kahan); }));
+        suite.add("ChVector<double>::sum(Pairwise)/100000", repeat(doubles, [](const ChVector<double> &values) { return values.sum(ChSummation::Pairwise); }));
+        suite.add("ChVector<double>::average/100000", repeat(doubles, [](const ChVector<double> &values) { return values.average(); }));
+        suite.add("ChVector<double>::average(Kahan)/100000", repeat(doubles, [](const ChVector<double> &values) { return values.average(ChSummation::Kahan); }));
+        suite.add("ChVector<double>::dot/100000", repeat(doubles, [](const ChVector<double> &values) { return values.dot(values); }));
+        suite.add("ChVector<int>::dot/100000", repeat(integers, [](const ChVector<int> &values) { return values.dot(values); }));
+        suite.add("ChVector<int>::map/100000", repeat(integers, [](const ChVector<int> &values) { return values.map([](int value) { return value * 2; }); }));
+        suite.add("ChVector<int>::view().map().filter().sum()/100000", repeat(integers, [](const ChVector<int> &values)
+        {
+            return values.view().map([](int value) { return static_cast<int64_t>(value) * 2; }).filter([](int64_t value) { return value % 3 == 0; }).sum();
+        }));
+        suite.add("ChVector<int>::view().take().collect()/100000", repeat(integers, [](const ChVector<int> &values)
+        {
+            return values.view().take(1000).collect();
+        }));
+        suite.add("ChVector<int>::view().enumerate().forEach()/100000", repeat(integers, [](const ChVector<int> &values)
+        {
+            int64_t total = 0;
+            values.view().enumerate().forEach([&total](const auto &pair) { total += pair.first ^ pair.second; });
+            return total;
+        }));
+        suite.add("zip(ChVector<int>, ChVector<double>).collect()/100000", repeat([] { return std::make_pair(integers(), doubles()); }, [](const std::pair<ChVector<int>, ChVector<double>> &values)
+        {
+            ChVector<std::pair<int, double>> zipped = zip(values.first, values.second);
+            return zipped.size();
+        }));
+    }
+
+    void addOrdering(ChBenchmarkSuite &suite)
+    {
+        suite.add("ChVector<int>::sort/100000", repeatOnCopy(integers, [](ChVector<int> &values) { values.sort(); }));
+        suite.add("ChVector<double>::sort/100000", repeatOnCopy(doubles, [](ChVector<double> &values) { values.sort(); }));
+        suite.add("ChVector<std::string>::sort/100000", repeatOnCopy(strings, [](ChVector<std::string> &values) { values.sort(); }));
+        suite.add("ChVector<int>::reverse/100000", repeat(integers, [](ChVector<int> &values) { values.reverse(); }));
+        suite.add("ChVector<int>::shuffle/100000", repeat(integers, [](ChVector<int> &values) { values.shuffle(); }));
+        suite.add("ChVector<int>::unique/100000 sorted", repeatOnCopy([] { ChVector<int> values = duplicates(); values.sort(); return values; }, [](ChVector<int> &values) { values.unique(); }));
+        suite.add("ChVector<int>::remove/100000", repeatOnCopy(duplicates, [](ChVector<int> &values) { values.remove(7); }));
+        suite.add("ChVector<int>::removeDuplicates/100000", repeatOnCopy(duplicates, [](ChVector<int> &values) { values.removeDuplicates(); }));
+        suite.add("ChVector<int>::removeDuplicatesSorted/100000", repeatOnCopy(duplicates, [](ChVector<int> &values) { values.removeDuplicatesSorted(); }));
+        suite.add("ChVector<std::string>::removeDuplicates/100000", repeatOnCopy(strings, [](ChVector<std::string> &values) { values.removeDuplicates(); }));
+        suite.add("ChVector<int>::removeDuplicates/100000 distinct", repeatOnCopy(sortedIntegers, [](ChVector<int> &values) { values.removeDuplicates(); }));
+    }
+
+    /**
+     * @brief Adds the benchmarks of removeDuplicates at 10^4 to 10^8 elements, a tenth of them distinct, next to the
+     * std::set round trip it replaced. The std::set baseline stops at 10^6 elements, past which it takes seconds.
+     */
+    void addDuplicateRemoval(ChBenchmarkSuite &suite)
+    {
+        const size_t stdSetMaximumSize = 1000000;
+        for (size_t size = 10000; size <= 100000000; size *= 10)
+        {
+            const std::string suffix = "/" + std::to_string(size) + " tenth distinct";
+            auto values = [size] { return randomIntegers(size, static_cast<int>(size / 10)); };
+            suite.add("ChVector<int>::removeDuplicates" + suffix, repeatOnCopy(values, [](ChVector<int> &input) { input.removeDuplicates(); }));
+            suite.add("ChVector<int>::removeDuplicatesSorted" + suffix, repeatOnCopy(values, [](ChVector<int> &input) { input.removeDuplicatesSorted(); }));
+            if (size > stdSetMaximumSize)
+            {
+                continue;
+            }
+            suite.add("std::set<int> round trip" + suffix, repeatOnCopy(values, [](ChVector<int> &input)
+            {
+                std::set<int> unique(input.begin(), input.end());
+                input.assign(unique.begin(), unique.end());
+            }));
+        }
+    }
+
+    void addPolicies(ChBenchmarkSuite &suite)
+    {
+        // The same bulk operations under every execution policy, on a vector large enough to spread over threads
+        const size_t large = 4000000;
+        for (ChExecutionPolicy policy : {ChExecutionPolicy::Sequential, ChExecutionPolicy::Parallel, ChExecutionPolicy::ParallelVectorized})
+        {
+            const std::string suffix = "/" + std::to_string(large) + " " + policyName(policy);
+            auto largeIntegers = [large] { return randomIntegers(large, 1 << 30); };
+            auto largeDoubles = [large] { return randomDoubles(large); };
+            suite.add("ChVector<int>::contains(policy)" + suffix, repeat(largeIntegers, [policy](const ChVector<int> &values) { return values.contains(policy, -1); }));
+            suite.add("ChVector<int>::count(policy)" + suffix, repeat(largeIntegers, [policy](const ChVector<int> &values) { return values.count(policy, -1); }));
+            suite.add("ChVector<double>::sum(policy)" + suffix, repeat(largeDoubles, [policy](const ChVector<double> &values) { return values.sum(policy); }));
+            suite.add("ChVector<double>::sum(policy, deterministic)" + suffix, repeat(largeDoubles, [policy](const ChVector<double> &values) { return values.sum(policy, true); }));
+            // Summing into a wider type converts every element, in every block and chunk, before it is added
+            suite.add("ChVector<int>::sum<int64_t>(policy)" + suffix, repeat(largeIntegers, [policy](const ChVector<int> &values) { return values.sum<int64_t>(policy); }));
+            suite.add("ChVector<int>::sum<int64_t>(policy, deterministic)" + suffix, repeat(largeIntegers, [policy](const ChVector<int> &values) { return values.sum<int64_t>(policy, true); }));
+            suite.add("ChVector<double>::average(policy)" + suffix, repeat(largeDoubles, [policy](const ChVector<double> &values) { return values.average(policy); }));
+            suite.add("ChVector<int>::map(policy)" + suffix, repeat(largeIntegers, [policy](const ChVector<int> &values) { return values.map(policy, [](int value) { return value / 3; }); }));
+            // bool results land in a packed std::vector<bool>, which has to be filled by a single thread
+            suite.add("ChVector<int>::map(policy) to bool" + suffix, repeat(largeIntegers, [policy](const ChVector<int> &values) { return values.map(policy, [](int value) { return value % 2 == 0; }); }));
+            suite.add("ChVector<int>::reverse(policy)" + suffix, repeat(largeIntegers, [policy](ChVector<int> &values) { values.reverse(policy); }));
+            suite.add("ChVector<int>::remove(policy)" + suffix, repeatOnCopy(largeIntegers, [policy](ChVector<int> &values) { values.remove(policy, 7); }));
+            suite.add("ChVector<int>::sort(policy)" + suffix, repeatOnCopy(largeIntegers, [policy](ChVector<int> &values) { values.sort(policy); }));
+        }
+    }
+}
+
+void addVectorBenchmarks(ChBenchmarkSuite &suite)
+{
+    addElementAccess(suite);
+    addModifiers(suite);
+    addSearches(suite);
+    addArithmetic(suite);
+    addOrdering(suite);
+    addDuplicateRemoval(suite);
+    addPolicies(suite);
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#ifndef CHBITS
+#define CHBITS
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Bit scanning helpers shared by the string and vector kernels, the hash tables and the sets. Not part of the
+ * public interface.
+ */
+namespace ChBits
+{
+    /**
+     * @brief Returns the number of trailing zero bits of a non-zero mask.
+     */
+    inline unsigned countTrailingZeros(uint32_t mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    /**
+     * @brief Returns the number of trailing zero bits of a non-zero mask.
+     */
+    inline unsigned countTrailingZeros(uint64_t mask)
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+        if (static_cast<uint32_t>(mask) != 0)
+        {
+            return countTrailingZeros(static_cast<uint32_t>(mask));
+        }
+        return countTrailingZeros(static_cast<uint32_t>(mask >> 32)) + 32;
+#else
+        return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+    }
+
+    /**
+     * @brief Returns the index of the highest set bit of a non-zero mask.
+     */
+    inline unsigned highestSetBit(uint32_t mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return 31u - static_cast<unsigned>(__builtin_clz(mask));
+#endif
+    }
+
+    /**
+     * @brief Returns the index of the highest set bit of a non-zero mask.
+     */
+    inline unsigned highestSetBit(uint64_t mask)
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long index;
+        _BitScanReverse64(&index, mask);
+        return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+        if ((mask >> 32) != 0)
+        {
+            return highestSetBit(static_cast<uint32_t>(mask >> 32)) + 32;
+        }
+        return highestSetBit(static_cast<uint32_t>(mask));
+#else
+        return 63u - static_cast<unsigned>(__builtin_clzll(mask));
+#endif
+    }
+
+    /**
+     * @brief Returns the number of set bits of a mask.
+     */
+    inline unsigned popCount(uint32_t mask)
+    {
+        mask = mask - ((mask >> 1) & 0x55555555u);
+        mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+        return (((mask + (mask >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+    }
+}
+
+#endif
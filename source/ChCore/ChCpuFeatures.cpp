@@ -0,0 +1,110 @@
+#include "ChCpuFeatures.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CHCPUFEATURES_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace
+{
+    struct Features
+    {
+        bool sse2;
+        bool sse42;
+        bool avx2;
+        bool avx512f;
+    };
+
+#if defined(CHCPUFEATURES_X86)
+    void cpuid(unsigned leaf, unsigned subleaf, unsigned registers[4])
+    {
+#if defined(_MSC_VER)
+        int values[4];
+        __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+        for (int i = 0; i < 4; ++i)
+        {
+            registers[i] = static_cast<unsigned>(values[i]);
+        }
+#else
+        __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+    }
+
+    unsigned long long readExtendedControlRegister()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        unsigned low;
+        unsigned high;
+        __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+        return (static_cast<unsigned long long>(high) << 32) | low;
+#endif
+    }
+#endif
+
+    Features detect()
+    {
+        Features features = {false, false, false, false};
+
+#if defined(CHCPUFEATURES_X86)
+        unsigned registers[4];
+        cpuid(0, 0, registers);
+        unsigned maxLeaf = registers[0];
+        if (maxLeaf < 1)
+        {
+            return features;
+        }
+
+        cpuid(1, 0, registers);
+        features.sse2 = (registers[3] & (1u << 26)) != 0;
+        features.sse42 = (registers[2] & (1u << 20)) != 0;
+
+        // The wide registers are only usable when the operating system saves them on context switches
+        bool osSavesAvx = (registers[2] & (1u << 27)) != 0 && (registers[2] & (1u << 28)) != 0;
+        if (!osSavesAvx || maxLeaf < 7)
+        {
+            return features;
+        }
+        unsigned long long enabled = readExtendedControlRegister();
+        bool ymmEnabled = (enabled & 0x6) == 0x6;
+        bool zmmEnabled = (enabled & 0xE6) == 0xE6;
+
+        cpuid(7, 0, registers);
+        features.avx2 = ymmEnabled && (registers[1] & (1u << 5)) != 0;
+        features.avx512f = zmmEnabled && (registers[1] & (1u << 16)) != 0;
+#endif
+
+        return features;
+    }
+
+    const Features &features()
+    {
+        static const Features detected = detect();
+        return detected;
+    }
+}
+
+bool ChCpuFeatures::hasSse2()
+{
+    return features().sse2;
+}
+
+bool ChCpuFeatures::hasSse42()
+{
+    return features().sse42;
+}
+
+bool ChCpuFeatures::hasAvx2()
+{
+    return features().avx2;
+}
+
+bool ChCpuFeatures::hasAvx512f()
+{
+    return features().avx512f;
+}
@@ -0,0 +1,37 @@
+#ifndef CHCPUFEATURES
+#define CHCPUFEATURES
+
+/**
+ * @brief Reports the instruction set extensions available on the running processor.
+ *
+ * The answers are detected once and cached, so the queries are cheap enough to drive runtime dispatch between
+ * kernels compiled for different instruction sets. Every query returns false on non-x86 processors.
+ */
+class ChCpuFeatures
+{
+public:
+    /**
+     * @brief Checks whether SSE2 instructions are available.
+     */
+    static bool hasSse2();
+
+    /**
+     * @brief Checks whether SSE4.2 instructions are available.
+     */
+    static bool hasSse42();
+
+    /**
+     * @brief Checks whether AVX2 instructions are available and enabled by the operating system.
+     */
+    static bool hasAvx2();
+
+    /**
+     * @brief Checks whether AVX-512 Foundation instructions are available and enabled by the operating system.
+     */
+    static bool hasAvx512f();
+
+private:
+    ChCpuFeatures();
+};
+
+#endif
@@ -0,0 +1,586 @@
+#include "ChConcurrentHashMap.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <tuple>
+
+/**
+ * @brief Holds the write lock of a shard. Before the first change it makes the sequence number of the shard odd, and
+ * on release it makes it even again, so that optimistic readers notice the change. Not part of the public interface.
+ */
+template <typename K, typename V, typename Hash, typename KeyEqual>
+class ChConcurrentHashMap<K, V, Hash, KeyEqual>::WriteLock
+{
+public:
+    explicit WriteLock(Shard &shard) : shard_(shard), lock_(shard.lock), changing_(false) {}
+
+    ~WriteLock()
+    {
+        if (changing_)
+        {
+            shard_.sequence.store(shard_.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+    }
+
+    WriteLock(const WriteLock &) = delete;
+    WriteLock &operator=(const WriteLock &) = delete;
+
+    /**
+     * @brief Marks the shard as being changed. Must be called before any write to the table of the shard.
+     */
+    void beginChange()
+    {
+        if (!changing_)
+        {
+            changing_ = true;
+            shard_.sequence.store(shard_.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+    }
+
+    Shard &shard()
+    {
+        return shard_;
+    }
+
+    Table *table()
+    {
+        return shard_.table.load(std::memory_order_relaxed);
+    }
+
+private:
+    Shard &shard_;
+    std::unique_lock<std::shared_mutex> lock_;
+    bool changing_;
+};
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+ChConcurrentHashMap<K, V, Hash, KeyEqual>::ChConcurrentHashMap(size_t shardCount, const Hash &hash, const KeyEqual &equal)
+    : shardCount_(1), shardBits_(0), hash_(hash), equal_(equal)
+{
+    if (shardCount == 0)
+    {
+        shardCount = std::max<size_t>(1, std::thread::hardware_concurrency()) * 4;
+    }
+    while (shardCount_ < shardCount)
+    {
+        shardCount_ *= 2;
+        ++shardBits_;
+    }
+    shards_.reset(new Shard[shardCount_]);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+ChConcurrentHashMap<K, V, Hash, KeyEqual>::~ChConcurrentHashMap()
+{
+    for (size_t i = 0; i < shardCount_; ++i)
+    {
+        Table *table = shards_[i].table.load(std::memory_order_relaxed);
+        if (table != nullptr)
+        {
+            for (size_t slot = 0; slot < table->capacity; ++slot)
+            {
+                if (table->control[slot] >= 0)
+                {
+                    table->slots[slot].~value_type();
+                }
+            }
+        }
+
+        // The entries of the retired tables have been moved to their successors already
+        while (table != nullptr)
+        {
+            Table *retired = table->retired;
+            freeTable(table);
+            table = retired;
+        }
+    }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+size_t ChConcurrentHashMap<K, V, Hash, KeyEqual>::size() const noexcept
+{
+    size_t total = 0;
+    for (size_t i = 0; i < shardCount_; ++i)
+    {
+        total += shards_[i].size.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+bool ChConcurrentHashMap<K, V, Hash, KeyEqual>::isEmpty() const noexcept
+{
+    for (size_t i = 0; i < shardCount_; ++i)
+    {
+        if (shards_[i].size.load(std::memory_order_relaxed) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+size_t ChConcurrentHashMap<K, V, Hash, KeyEqual>::shardCount() const noexcept
+{
+    return shardCount_;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChConcurrentHashMap<K, V, Hash, KeyEqual>::reserve(size_t count)
+{
+    // Keys do not spread perfectly evenly, so leave each shard some headroom
+    size_t perShard = (count + shardCount_ - 1) / shardCount_;
+    perShard += perShard / 8;
+    size_t capacity = ChHashTable::minCapacity;
+    while (capacity - capacity / 5 < perShard)
+    {
+        capacity *= 2;
+    }
+
+    for (size_t i = 0; i < shardCount_; ++i)
+    {
+        WriteLock writer(shards_[i]);
+        Table *table = writer.table();
+        if (table == nullptr || table->capacity < capacity)
+        {
+            grow(writer, capacity);
+        }
+    }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+std::optional<V> ChConcurrentHashMap<K, V, Hash, KeyEqual>::find(const K &key) const
+{
+    std::optional<V> result;
+    read(key, [&](const V &value) { result.emplace(value); });
+    return result;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q, typename>
+std::optional<V> ChConcurrentHashMap<K, V, Hash, KeyEqual>::find(const Q &key) const
+{
+    std::optional<V> result;
+    read(key, [&](const V &value) { result.emplace(value); });
+    return result;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+bool ChConcurrentHashMap<K, V, Hash, KeyEqual>::contains(const K &key) const
+{
+    return read(key, [](const V &) {});
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q, typename>
+bool ChConcurrentHashMap<K, V, Hash, KeyEqual>::contains(const Q &key) const
+{
+    return read(key, [](const V &) {});
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Fn>
+bool ChConcurrentHashMap<K, V, Hash, KeyEqual>::visit(const K &key, Fn fn) const
+{
+    const uint64_t hash = hashOf(key);
+    Shard &shard = shardOf(hash);
+    std::shared_lock<std::shared_mutex> lock(shard.lock);
+    const Table *table = shard.table.load(std::memory_order_relaxed);
+    size_t slot = findSlot(table, key, hash);
+    if (slot == notFound)
+    {
+        return false;
+    }
+    fn(static_cast<const V &>(table->slots[slot].second));
+    return true;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename M>
+bool ChConcurrentHashMap<K, V, Hash, KeyEqual>::insert(const K &key, M &&value)
+{
+    const uint64_t hash = hashOf(key);
+    WriteLock writer(shardOf(hash));
+    if (findSlot(writer.table(), key, hash) != notFound)
+    {
+        return false;
+    }
+    insertSlot(writer, hash, [&](value_type *slot) { ::new (static_cast<void *>(slot)) value_type(key, std::forward<M>(value)); });
+    return true;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename M>
+bool ChConcurrentHashMap<K, V, Hash, KeyEqual>::insertOrAssign(const K &key, M &&value)
+{
+    const uint64_t hash = hashOf(key);
+    WriteLock writer(shardOf(hash));
+    Table *table = writer.table();
+    size_t slot = findSlot(table, key, hash);
+    if (slot != notFound)
+    {
+        writer.beginChange();
+        table->slots[slot].second = std::forward<M>(value);
+        return false;
+    }
+    insertSlot(writer, hash, [&](value_type *entry) { ::new (static_cast<void *>(entry)) value_type(key, std::forward<M>(value)); });
+    return true;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Fn>
+V ChConcurrentHashMap<K, V, Hash, KeyEqual>::computeIfAbsent(const K &key, Fn make)
+{
+    // Most calls find the key, which does not need the write lock
+    std::optional<V> existing = find(key);
+    if (existing)
+    {
+        return std::move(*existing);
+    }
+
+    const uint64_t hash = hashOf(key);
+    WriteLock writer(shardOf(hash));
+    Table *table = writer.table();
+    size_t slot = findSlot(table, key, hash);
+    if (slot != notFound)
+    {
+        return table->slots[slot].second;
+    }
+
+    // The value is computed before the shard's sequence number turns odd, so lock-free readers of other keys in the
+    // shard keep going while `make` runs; the write lock still keeps other callers for this key out
+    V value = make();
+    value_type *entry = insertSlot(writer, hash, [&](value_type *target)
+    {
+        ::new (static_cast<void *>(target)) value_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::move(value)));
+    });
+    return entry->second;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+bool ChConcurrentHashMap<K, V, Hash, KeyEqual>::erase(const K &key)
+{
+    return eraseKey(key);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q, typename>
+bool ChConcurrentHashMap<K, V, Hash, KeyEqual>::erase(const Q &key)
+{
+    return eraseKey(key);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Pred>
+bool ChConcurrentHashMap<K, V, Hash, KeyEqual>::eraseIf(const K &key, Pred pred)
+{
+    const uint64_t hash = hashOf(key);
+    WriteLock writer(shardOf(hash));
+    Table *table = writer.table();
+    size_t slot = findSlot(table, key, hash);
+    if (slot == notFound || !pred(static_cast<const V &>(table->slots[slot].second)))
+    {
+        return false;
+    }
+    eraseSlot(writer, slot);
+    return true;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Pred>
+size_t ChConcurrentHashMap<K, V, Hash, KeyEqual>::eraseIf(Pred pred)
+{
+    size_t erased = 0;
+    for (size_t i = 0; i < shardCount_; ++i)
+    {
+        WriteLock writer(shards_[i]);
+        Table *table = writer.table();
+        if (table == nullptr)
+        {
+            continue;
+        }
+
+        // Go once around the table starting after an empty slot. Erasing only moves entries backwards within a run,
+        // and no run crosses that slot, so an entry that moves into the current slot has not been looked at yet.
+        const size_t mask = table->capacity - 1;
+        const size_t start = ChHashTable::findEmptySlot(table->control, mask, 0);
+        for (size_t step = 1; step <= mask;)
+        {
+            size_t slot = (start + step) & mask;
+            const value_type &entry = table->slots[slot];
+            if (table->control[slot] >= 0 && pred(entry.first, static_cast<const V &>(entry.second)))
+            {
+                eraseSlot(writer, slot);
+                ++erased;
+            }
+            else
+            {
+                ++step;
+            }
+        }
+    }
+    return erased;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Fn>
+void ChConcurrentHashMap<K, V, Hash, KeyEqual>::forEach(Fn fn) const
+{
+    for (size_t i = 0; i < shardCount_; ++i)
+    {
+        std::shared_lock<std::shared_mutex> lock(shards_[i].lock);
+        const Table *table = shards_[i].table.load(std::memory_order_relaxed);
+        if (table == nullptr)
+        {
+            continue;
+        }
+        for (size_t slot = 0; slot < table->capacity; ++slot)
+        {
+            if (table->control[slot] >= 0)
+            {
+                fn(table->slots[slot].first, static_cast<const V &>(table->slots[slot].second));
+            }
+        }
+    }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChConcurrentHashMap<K, V, Hash, KeyEqual>::clear()
+{
+    for (size_t i = 0; i < shardCount_; ++i)
+    {
+        WriteLock writer(shards_[i]);
+        Table *table = writer.table();
+        if (table == nullptr || shards_[i].size.load(std::memory_order_relaxed) == 0)
+        {
+            continue;
+        }
+        writer.beginChange();
+        for (size_t slot = 0; slot < table->capacity; ++slot)
+        {
+            if (table->control[slot] >= 0)
+            {
+                table->slots[slot].~value_type();
+            }
+        }
+        std::memset(table->control, ChHashTable::emptyControl, ChHashTable::controlSize(table->capacity));
+        shards_[i].size.store(0, std::memory_order_relaxed);
+    }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q>
+uint64_t ChConcurrentHashMap<K, V, Hash, KeyEqual>::hashOf(const Q &key) const
+{
+    return ChHashTable::mix(static_cast<uint64_t>(hash_(key)));
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+typename ChConcurrentHashMap<K, V, Hash, KeyEqual>::Shard &ChConcurrentHashMap<K, V, Hash, KeyEqual>::shardOf(uint64_t hash) const
+{
+    // The top bits pick the shard; the tables take the control byte and the home slot from the low bits
+    return shards_[shardBits_ == 0 ? 0 : static_cast<size_t>(hash >> (64 - shardBits_))];
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q>
+size_t ChConcurrentHashMap<K, V, Hash, KeyEqual>::findSlot(const Table *table, const Q &key, uint64_t hash) const
+{
+    if (table == nullptr)
+    {
+        return notFound;
+    }
+    return ChHashTable::findSlot(table->control, table->capacity - 1, hash, [&](size_t slot) { return equal_(table->slots[slot].first, key); });
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q, typename Fn>
+bool ChConcurrentHashMap<K, V, Hash, KeyEqual>::read(const Q &key, Fn fn) const
+{
+    const uint64_t hash = hashOf(key);
+    Shard &shard = shardOf(hash);
+
+    if constexpr (optimisticReads)
+    {
+        for (int attempt = 0; attempt < optimisticAttempts; ++attempt)
+        {
+            const uint64_t before = shard.sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            // A writer may change the slots while they are read, so keys and values are copied out as bytes and only
+            // trusted once the unchanged sequence number shows that nobody wrote. Old tables stay allocated, so even
+            // a stale table pointer is safe to read through.
+            // The value bytes start zeroed: GCC cannot tell that they are only used once a slot was found and
+            // copied, and otherwise reports them as maybe uninitialized in every caller.
+            const Table *table = shard.table.load(std::memory_order_acquire);
+            alignas(V) unsigned char value[sizeof(V)] = {};
+            size_t slot = notFound;
+            if (table != nullptr)
+            {
+                slot = ChHashTable::findSlot(table->control, table->capacity - 1, hash, [&](size_t candidate)
+                {
+                    alignas(K) unsigned char bytes[sizeof(K)];
+                    std::memcpy(bytes, static_cast<const void *>(&table->slots[candidate].first), sizeof(K));
+                    return equal_(*reinterpret_cast<const K *>(bytes), key);
+                });
+                if (slot != notFound)
+                {
+                    std::memcpy(value, static_cast<const void *>(&table->slots[slot].second), sizeof(V));
+                }
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (shard.sequence.load(std::memory_order_relaxed) == before)
+            {
+                if (slot != notFound)
+                {
+                    fn(*reinterpret_cast<const V *>(value));
+                }
+                return slot != notFound;
+            }
+        }
+    }
+
+    std::shared_lock<std::shared_mutex> lock(shard.lock);
+    const Table *table = shard.table.load(std::memory_order_relaxed);
+    size_t slot = findSlot(table, key, hash);
+    if (slot == notFound)
+    {
+        return false;
+    }
+    fn(static_cast<const V &>(table->slots[slot].second));
+    return true;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Construct>
+typename ChConcurrentHashMap<K, V, Hash, KeyEqual>::value_type *ChConcurrentHashMap<K, V, Hash, KeyEqual>::insertSlot(WriteLock &writer, uint64_t hash, Construct construct)
+{
+    Shard &shard = writer.shard();
+    Table *table = writer.table();
+    const size_t size = shard.size.load(std::memory_order_relaxed);
+    if (table == nullptr || size >= table->growthLimit)
+    {
+        grow(writer, table == nullptr ? ChHashTable::minCapacity : table->capacity * 2);
+        table = writer.table();
+    }
+
+    // The control byte is set after the entry is constructed, so a throwing constructor leaves the shard unchanged
+    const size_t mask = table->capacity - 1;
+    size_t slot = ChHashTable::findEmptySlot(table->control, mask, ChHashTable::homeSlot(hash, mask));
+    writer.beginChange();
+    construct(table->slots + slot);
+    ChHashTable::setControl(table->control, table->capacity, slot, ChHashTable::controlByte(hash));
+    shard.size.store(size + 1, std::memory_order_relaxed);
+    return table->slots + slot;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q>
+bool ChConcurrentHashMap<K, V, Hash, KeyEqual>::eraseKey(const Q &key)
+{
+    const uint64_t hash = hashOf(key);
+    WriteLock writer(shardOf(hash));
+    size_t slot = findSlot(writer.table(), key, hash);
+    if (slot == notFound)
+    {
+        return false;
+    }
+    eraseSlot(writer, slot);
+    return true;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChConcurrentHashMap<K, V, Hash, KeyEqual>::eraseSlot(WriteLock &writer, size_t slot)
+{
+    Table *table = writer.table();
+    const size_t mask = table->capacity - 1;
+    writer.beginChange();
+    table->slots[slot].~value_type();
+    ChHashTable::eraseSlot(table->control, table->capacity, slot, [&](size_t from)
+    {
+        return ChHashTable::homeSlot(hashOf(table->slots[from].first), mask);
+    }, [&](size_t from, size_t to)
+    {
+        relocate(table->slots + from, table->slots + to);
+    });
+    writer.shard().size.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChConcurrentHashMap<K, V, Hash, KeyEqual>::grow(WriteLock &writer, size_t capacity)
+{
+    Table *table = allocateTable(capacity);
+    Table *old = writer.table();
+    writer.beginChange();
+
+    if (old != nullptr)
+    {
+        const size_t mask = capacity - 1;
+        for (size_t slot = 0; slot < old->capacity; ++slot)
+        {
+            if (old->control[slot] >= 0)
+            {
+                uint64_t hash = hashOf(old->slots[slot].first);
+                size_t target = ChHashTable::findEmptySlot(table->control, mask, ChHashTable::homeSlot(hash, mask));
+                relocate(old->slots + slot, table->slots + target);
+                ChHashTable::setControl(table->control, capacity, target, ChHashTable::controlByte(hash));
+            }
+        }
+    }
+    writer.shard().table.store(table, std::memory_order_release);
+
+    // Without optimistic readers nobody can still be looking at the old table
+    if constexpr (optimisticReads)
+    {
+        table->retired = old;
+    }
+    else if (old != nullptr)
+    {
+        freeTable(old);
+    }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+typename ChConcurrentHashMap<K, V, Hash, KeyEqual>::Table *ChConcurrentHashMap<K, V, Hash, KeyEqual>::allocateTable(size_t capacity)
+{
+    std::unique_ptr<Table> table(new Table());
+    table->capacity = capacity;
+    table->growthLimit = capacity - capacity / 5;
+    table->retired = nullptr;
+    table->control = static_cast<int8_t *>(::operator new(ChHashTable::controlSize(capacity)));
+    try
+    {
+        table->slots = std::allocator<value_type>().allocate(capacity);
+    }
+    catch (...)
+    {
+        ::operator delete(table->control);
+        throw;
+    }
+    std::memset(table->control, ChHashTable::emptyControl, ChHashTable::controlSize(capacity));
+    return table.release();
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChConcurrentHashMap<K, V, Hash, KeyEqual>::freeTable(Table *table) noexcept
+{
+    std::allocator<value_type>().deallocate(table->slots, table->capacity);
+    ::operator delete(table->control);
+    delete table;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChConcurrentHashMap<K, V, Hash, KeyEqual>::relocate(value_type *from, value_type *to) noexcept
+{
+    // The key is const only towards the users of the map, and the moved-from entry is destroyed right away
+    ::new (static_cast<void *>(to)) value_type(std::move(const_cast<K &>(from->first)), std::move(from->second));
+    from->~value_type();
+}
\ No newline at end of file
@@ -0,0 +1,292 @@
+#ifndef CHCONCURRENTHASHMAP
+#define CHCONCURRENTHASHMAP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+
+#include "ChHash.h"
+#include "ChHashTable.h"
+
+/**
+ * @brief A hash map from keys of type K to values of type V that many threads can use at the same time.
+ *
+ * The map is split into shards by the hash of the key, and each shard is an open-addressing table like ChHashMap
+ * with its own reader-writer lock, so threads working on different keys rarely wait for each other.
+ *
+ * If K and V are trivially copyable, `find` and `contains` take no lock at all. Every shard carries a sequence
+ * number that writers make odd while they change the shard. A reader notes the number, probes the table, copies the
+ * value out, and accepts the result only if the number has not changed in the meantime; otherwise it retries a few
+ * times and then falls back to the read lock. Because a reader may still be looking at the slots of a table that a
+ * writer has just replaced, a shard that grows keeps its old slot arrays until the map is destroyed. They take less
+ * memory than the current table together. Other key and value types are always read under the shard's read lock.
+ *
+ * The map hands out copies of values rather than references, since an entry may be changed or erased by another
+ * thread right after the call returns. Every member function is atomic with respect to the others for the key it
+ * works on. `eraseIf(pred)`, `forEach` and `clear` work on one shard at a time, so they see each shard in a
+ * consistent state but not the whole map at one instant. Callbacks run while the shard of the key is locked and
+ * must not call back into the map.
+ *
+ * @code
+ * ChConcurrentHashMap<uint64_t, uint32_t> routes;
+ * routes.insertOrAssign(client, backend);
+ * uint32_t target = routes.computeIfAbsent(client, [&] { return pickBackend(client); });
+ * if (std::optional<uint32_t> cached = routes.find(client))
+ * {
+ *     forward(*cached);
+ * }
+ * @endcode
+ *
+ * @tparam K The type of the keys.
+ * @tparam V The type of the values.
+ * @tparam Hash The hash function of the keys.
+ * @tparam KeyEqual The comparison of the keys.
+ */
+template <typename K, typename V, typename Hash = ChHash<K>, typename KeyEqual = std::equal_to<>>
+class ChConcurrentHashMap
+{
+    static_assert(std::is_nothrow_move_constructible<K>::value && std::is_nothrow_move_constructible<V>::value,
+                  "ChConcurrentHashMap needs nothrow move constructible keys and values");
+
+    // Enables the heterogeneous overloads for key types other than K
+    template <typename Q>
+    using EnableIfTransparent = typename std::enable_if<ChHashTable::IsTransparent<Hash, KeyEqual>::value && !std::is_same<Q, K>::value>::type;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<const K, V>;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+    /**
+     * @brief Whether `find` and `contains` read without taking a lock.
+     */
+    static constexpr bool optimisticReads = std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value;
+
+    /**
+     * @brief Constructs an empty map.
+     *
+     * @param shardCount The number of shards, rounded up to a power of two, or 0 for four per hardware thread.
+     * @param hash The hash function to use.
+     * @param equal The key comparison to use.
+     */
+    explicit ChConcurrentHashMap(size_t shardCount = 0, const Hash &hash = Hash(), const KeyEqual &equal = KeyEqual());
+
+    /**
+     * @brief Destructor. Destroys the entries and frees the tables. No other thread may use the map any more.
+     */
+    ~ChConcurrentHashMap();
+
+    ChConcurrentHashMap(const ChConcurrentHashMap &) = delete;
+    ChConcurrentHashMap &operator=(const ChConcurrentHashMap &) = delete;
+
+    /**
+     * @brief Returns the number of entries in the map. While other threads write, the count is only a snapshot.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Checks whether the map is empty. While other threads write, the answer is only a snapshot.
+     */
+    bool isEmpty() const noexcept;
+
+    /**
+     * @brief Returns the number of shards of the map.
+     */
+    size_t shardCount() const noexcept;
+
+    /**
+     * @brief Makes room for about `count` entries, spread evenly over the shards.
+     *
+     * @param count The number of entries to reserve room for.
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Returns a copy of the value with key `key`, or nothing if there is none.
+     *
+     * @param key The key to search for.
+     */
+    std::optional<V> find(const K &key) const;
+
+    /**
+     * @brief Heterogeneous version of `find`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    std::optional<V> find(const Q &key) const;
+
+    /**
+     * @brief Checks whether the map has an entry with key `key`.
+     *
+     * @param key The key to search for.
+     */
+    bool contains(const K &key) const;
+
+    /**
+     * @brief Heterogeneous version of `contains`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    bool contains(const Q &key) const;
+
+    /**
+     * @brief Calls `fn(value)` with the value with key `key` while holding the read lock of its shard, which is how
+     * to read values that are expensive or impossible to copy.
+     *
+     * @param key The key to search for.
+     * @param fn The function to call with a const reference to the value.
+     * @return Whether the map has an entry with the key.
+     */
+    template <typename Fn>
+    bool visit(const K &key, Fn fn) const;
+
+    /**
+     * @brief Inserts `value` with key `key` unless the map already has an entry with that key.
+     *
+     * @param key The key of the entry.
+     * @param value The value to insert.
+     * @return Whether the entry was inserted.
+     */
+    template <typename M>
+    bool insert(const K &key, M &&value);
+
+    /**
+     * @brief Inserts `value` with key `key`, or assigns it to the existing entry with that key.
+     *
+     * @param key The key of the entry.
+     * @param value The value to insert or assign.
+     * @return Whether the entry was inserted.
+     */
+    template <typename M>
+    bool insertOrAssign(const K &key, M &&value);
+
+    /**
+     * @brief Returns a copy of the value with key `key`, first inserting the value returned by `make()` if there is
+     * none.
+     *
+     * `make` is called at most once, only if the key is missing, while the shard is locked, so concurrent callers
+     * for the same key never both compute a value. Lock-free reads of the shard are not held up while it runs.
+     *
+     * @param key The key of the entry.
+     * @param make The function computing the value to insert.
+     * @return The value with the key.
+     */
+    template <typename Fn>
+    V computeIfAbsent(const K &key, Fn make);
+
+    /**
+     * @brief Removes the entry with key `key`, if there is one.
+     *
+     * @param key The key of the entry to remove.
+     * @return Whether an entry was removed.
+     */
+    bool erase(const K &key);
+
+    /**
+     * @brief Heterogeneous version of `erase`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    bool erase(const Q &key);
+
+    /**
+     * @brief Removes the entry with key `key` if `pred(value)` returns true for its value.
+     *
+     * @param key The key of the entry to remove.
+     * @param pred The predicate, called with a const reference to the value.
+     * @return Whether an entry was removed.
+     */
+    template <typename Pred>
+    bool eraseIf(const K &key, Pred pred);
+
+    /**
+     * @brief Removes every entry for which `pred(key, value)` returns true, one shard at a time.
+     *
+     * @param pred The predicate, called with const references to the key and the value of each entry.
+     * @return The number of entries removed.
+     */
+    template <typename Pred>
+    size_t eraseIf(Pred pred);
+
+    /**
+     * @brief Calls `fn(key, value)` for every entry, holding the read lock of one shard at a time.
+     *
+     * @param fn The function to call with const references to the key and the value of each entry.
+     */
+    template <typename Fn>
+    void forEach(Fn fn) const;
+
+    /**
+     * @brief Removes all entries from the map, one shard at a time. The tables are kept.
+     */
+    void clear();
+
+private:
+    static const size_t notFound = ChHashTable::noSlot;
+
+    // Number of lock-free attempts of a read before it takes the read lock
+    static const int optimisticAttempts = 4;
+
+    struct Table
+    {
+        size_t capacity;
+        size_t growthLimit;
+        int8_t *control;
+        value_type *slots;
+
+        // The table this one replaced, kept for readers that may still look at it
+        Table *retired;
+    };
+
+    // Shards sit on their own cache lines so that writers to neighbouring shards do not slow each other down
+    struct alignas(64) Shard
+    {
+        mutable std::shared_mutex lock;
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<Table *> table{nullptr};
+        std::atomic<size_t> size{0};
+    };
+
+    class WriteLock;
+
+    template <typename Q>
+    uint64_t hashOf(const Q &key) const;
+
+    Shard &shardOf(uint64_t hash) const;
+
+    template <typename Q>
+    size_t findSlot(const Table *table, const Q &key, uint64_t hash) const;
+
+    template <typename Q, typename Fn>
+    bool read(const Q &key, Fn fn) const;
+
+    template <typename Construct>
+    value_type *insertSlot(WriteLock &writer, uint64_t hash, Construct construct);
+
+    template <typename Q>
+    bool eraseKey(const Q &key);
+
+    void eraseSlot(WriteLock &writer, size_t slot);
+
+    void grow(WriteLock &writer, size_t capacity);
+
+    static Table *allocateTable(size_t capacity);
+
+    static void freeTable(Table *table) noexcept;
+
+    static void relocate(value_type *from, value_type *to) noexcept;
+
+    std::unique_ptr<Shard[]> shards_;
+    size_t shardCount_;
+    unsigned shardBits_;
+    Hash hash_;
+    KeyEqual equal_;
+};
+
+#endif
\ No newline at end of file
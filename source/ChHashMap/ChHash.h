@@ -0,0 +1,39 @@
+#ifndef CHHASH
+#define CHHASH
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief The default hash function of the Ch hash containers. It is std::hash unless specialized.
+ *
+ * The specializations for strings are transparent: they hash anything convertible to std::string_view the same way,
+ * so that a container keyed by std::string can be searched with a string literal or a std::string_view without
+ * building a temporary std::string.
+ *
+ * @tparam T The type of the keys to hash.
+ */
+template <typename T>
+struct ChHash : std::hash<T>
+{
+};
+
+template <>
+struct ChHash<std::string>
+{
+    using is_transparent = void;
+
+    size_t operator()(std::string_view value) const noexcept
+    {
+        return std::hash<std::string_view>()(value);
+    }
+};
+
+template <>
+struct ChHash<std::string_view> : ChHash<std::string>
+{
+};
+
+#endif
\ No newline at end of file
@@ -1,9 +1,725 @@
 #include "ChHashMap.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <tuple>
 
-ChHashMap::ChHashMap()
+template <typename K, typename V, typename Hash, typename KeyEqual>
+ChHashMap<K, V, Hash, KeyEqual>::ChHashMap()
+    : control_(nullptr), slots_(nullptr), capacity_(0), size_(0), growthLimit_(0), start_(0), maxLoadFactor_(0.8f), hash_(), equal_()
 {
 }
 
-ChHashMap::~ChHashMap()
+template <typename K, typename V, typename Hash, typename KeyEqual>
+ChHashMap<K, V, Hash, KeyEqual>::ChHashMap(size_t count, const Hash &hash, const KeyEqual &equal)
+    : control_(nullptr), slots_(nullptr), capacity_(0), size_(0), growthLimit_(0), start_(0), maxLoadFactor_(0.8f), hash_(hash), equal_(equal)
 {
+    reserve(count);
 }
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+ChHashMap<K, V, Hash, KeyEqual>::ChHashMap(std::initializer_list<value_type> values) : ChHashMap(values.size())
+{
+    insert(values.begin(), values.end());
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+ChHashMap<K, V, Hash, KeyEqual>::ChHashMap(const ChHashMap &other)
+    : control_(nullptr), slots_(nullptr), capacity_(0), size_(0), growthLimit_(0), start_(0), maxLoadFactor_(other.maxLoadFactor_), hash_(other.hash_), equal_(other.equal_)
+{
+    if (other.size_ == 0)
+    {
+        return;
+    }
+
+    // Copy slot by slot into a table of the same size, which keeps every entry at the same position and needs no
+    // hashing. The control byte of a slot is only set once its entry exists, so a failed copy destroys just those.
+    rehashTo(other.capacity_);
+    try
+    {
+        for (size_t slot = 0; slot < capacity_; ++slot)
+        {
+            if (other.control_[slot] >= 0)
+            {
+                ::new (static_cast<void *>(slots_ + slot)) value_type(other.slots_[slot]);
+                setControl(slot, other.control_[slot]);
+                ++size_;
+            }
+        }
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }
+    start_ = other.start_;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+ChHashMap<K, V, Hash, KeyEqual>::ChHashMap(ChHashMap &&other) noexcept : ChHashMap()
+{
+    swap(other);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+ChHashMap<K, V, Hash, KeyEqual>::~ChHashMap()
+{
+    release();
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+ChHashMap<K, V, Hash, KeyEqual> &ChHashMap<K, V, Hash, KeyEqual>::operator=(const ChHashMap &other)
+{
+    if (this != &other)
+    {
+        ChHashMap copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+ChHashMap<K, V, Hash, KeyEqual> &ChHashMap<K, V, Hash, KeyEqual>::operator=(ChHashMap &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        swap(other);
+    }
+    return *this;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+typename ChHashMap<K, V, Hash, KeyEqual>::iterator ChHashMap<K, V, Hash, KeyEqual>::begin() noexcept
+{
+    return size_ == 0 ? end() : iterator(this, nextSlot(start_));
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+typename ChHashMap<K, V, Hash, KeyEqual>::const_iterator ChHashMap<K, V, Hash, KeyEqual>::begin() const noexcept
+{
+    return size_ == 0 ? end() : const_iterator(this, nextSlot(start_));
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+typename ChHashMap<K, V, Hash, KeyEqual>::iterator ChHashMap<K, V, Hash, KeyEqual>::end() noexcept
+{
+    return iterator(this, start_);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+typename ChHashMap<K, V, Hash, KeyEqual>::const_iterator ChHashMap<K, V, Hash, KeyEqual>::end() const noexcept
+{
+    return const_iterator(this, start_);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+typename ChHashMap<K, V, Hash, KeyEqual>::const_iterator ChHashMap<K, V, Hash, KeyEqual>::cbegin() const noexcept
+{
+    return begin();
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+typename ChHashMap<K, V, Hash, KeyEqual>::const_iterator ChHashMap<K, V, Hash, KeyEqual>::cend() const noexcept
+{
+    return end();
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+size_t ChHashMap<K, V, Hash, KeyEqual>::size() const noexcept
+{
+    return size_;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+bool ChHashMap<K, V, Hash, KeyEqual>::isEmpty() const noexcept
+{
+    return size_ == 0;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+size_t ChHashMap<K, V, Hash, KeyEqual>::capacity() const noexcept
+{
+    return growthLimit_;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+size_t ChHashMap<K, V, Hash, KeyEqual>::slotCount() const noexcept
+{
+    return capacity_;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+float ChHashMap<K, V, Hash, KeyEqual>::loadFactor() const noexcept
+{
+    return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / static_cast<float>(capacity_);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+float ChHashMap<K, V, Hash, KeyEqual>::maxLoadFactor() const noexcept
+{
+    return maxLoadFactor_;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChHashMap<K, V, Hash, KeyEqual>::setMaxLoadFactor(float factor)
+{
+    // A probe stops at the first empty slot, so the table must never fill up completely
+    if (!(factor >= 0.25f && factor <= 0.95f))
+    {
+        throw std::invalid_argument("ChHashMap maximum load factor must be in [0.25, 0.95]");
+    }
+    maxLoadFactor_ = factor;
+    if (capacity_ != 0)
+    {
+        growthLimit_ = static_cast<size_t>(static_cast<double>(capacity_) * maxLoadFactor_);
+        if (size_ > growthLimit_)
+        {
+            rehashTo(slotsFor(size_));
+        }
+    }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChHashMap<K, V, Hash, KeyEqual>::reserve(size_t count)
+{
+    if (count > growthLimit_)
+    {
+        rehashTo(slotsFor(count));
+    }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChHashMap<K, V, Hash, KeyEqual>::rehash(size_t slots)
+{
+    if (slots == 0 && size_ == 0)
+    {
+        release();
+        return;
+    }
+
+    size_t target = slotsFor(size_);
+    while (target < slots)
+    {
+        target *= 2;
+    }
+    if (target != capacity_)
+    {
+        rehashTo(target);
+    }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+typename ChHashMap<K, V, Hash, KeyEqual>::iterator ChHashMap<K, V, Hash, KeyEqual>::find(const K &key)
+{
+    size_t slot = findSlot(key, hashOf(key));
+    return slot == notFound ? end() : iterator(this, slot);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+typename ChHashMap<K, V, Hash, KeyEqual>::const_iterator ChHashMap<K, V, Hash, KeyEqual>::find(const K &key) const
+{
+    size_t slot = findSlot(key, hashOf(key));
+    return slot == notFound ? end() : const_iterator(this, slot);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q, typename>
+typename ChHashMap<K, V, Hash, KeyEqual>::iterator ChHashMap<K, V, Hash, KeyEqual>::find(const Q &key)
+{
+    size_t slot = findSlot(key, hashOf(key));
+    return slot == notFound ? end() : iterator(this, slot);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q, typename>
+typename ChHashMap<K, V, Hash, KeyEqual>::const_iterator ChHashMap<K, V, Hash, KeyEqual>::find(const Q &key) const
+{
+    size_t slot = findSlot(key, hashOf(key));
+    return slot == notFound ? end() : const_iterator(this, slot);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+bool ChHashMap<K, V, Hash, KeyEqual>::contains(const K &key) const
+{
+    return findSlot(key, hashOf(key)) != notFound;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q, typename>
+bool ChHashMap<K, V, Hash, KeyEqual>::contains(const Q &key) const
+{
+    return findSlot(key, hashOf(key)) != notFound;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+size_t ChHashMap<K, V, Hash, KeyEqual>::count(const K &key) const
+{
+    return contains(key) ? 1 : 0;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q, typename>
+size_t ChHashMap<K, V, Hash, KeyEqual>::count(const Q &key) const
+{
+    return contains(key) ? 1 : 0;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+V &ChHashMap<K, V, Hash, KeyEqual>::at(const K &key)
+{
+    size_t slot = findSlot(key, hashOf(key));
+    if (slot == notFound)
+    {
+        throw std::out_of_range("ChHashMap has no entry with the key");
+    }
+    return slots_[slot].second;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+const V &ChHashMap<K, V, Hash, KeyEqual>::at(const K &key) const
+{
+    size_t slot = findSlot(key, hashOf(key));
+    if (slot == notFound)
+    {
+        throw std::out_of_range("ChHashMap has no entry with the key");
+    }
+    return slots_[slot].second;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q, typename>
+V &ChHashMap<K, V, Hash, KeyEqual>::at(const Q &key)
+{
+    size_t slot = findSlot(key, hashOf(key));
+    if (slot == notFound)
+    {
+        throw std::out_of_range("ChHashMap has no entry with the key");
+    }
+    return slots_[slot].second;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q, typename>
+const V &ChHashMap<K, V, Hash, KeyEqual>::at(const Q &key) const
+{
+    size_t slot = findSlot(key, hashOf(key));
+    if (slot == notFound)
+    {
+        throw std::out_of_range("ChHashMap has no entry with the key");
+    }
+    return slots_[slot].second;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+V &ChHashMap<K, V, Hash, KeyEqual>::operator[](const K &key)
+{
+    return try_emplace(key).first->second;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+V &ChHashMap<K, V, Hash, KeyEqual>::operator[](K &&key)
+{
+    return try_emplace(std::move(key)).first->second;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+std::pair<typename ChHashMap<K, V, Hash, KeyEqual>::iterator, bool> ChHashMap<K, V, Hash, KeyEqual>::insert(const value_type &value)
+{
+    return insertUnique(value.first, [&](value_type *slot) { ::new (static_cast<void *>(slot)) value_type(value); });
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+std::pair<typename ChHashMap<K, V, Hash, KeyEqual>::iterator, bool> ChHashMap<K, V, Hash, KeyEqual>::insert(value_type &&value)
+{
+    return insertUnique(value.first, [&](value_type *slot) { ::new (static_cast<void *>(slot)) value_type(std::move(value)); });
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename InputIt>
+void ChHashMap<K, V, Hash, KeyEqual>::insert(InputIt first, InputIt last)
+{
+    if constexpr (std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>::value)
+    {
+        reserve(size_ + static_cast<size_t>(std::distance(first, last)));
+    }
+    for (; first != last; ++first)
+    {
+        insert(*first);
+    }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename M>
+std::pair<typename ChHashMap<K, V, Hash, KeyEqual>::iterator, bool> ChHashMap<K, V, Hash, KeyEqual>::insert_or_assign(const K &key, M &&value)
+{
+    std::pair<iterator, bool> result = insertUnique(key, [&](value_type *slot)
+    {
+        ::new (static_cast<void *>(slot)) value_type(key, std::forward<M>(value));
+    });
+    if (!result.second)
+    {
+        result.first->second = std::forward<M>(value);
+    }
+    return result;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename M>
+std::pair<typename ChHashMap<K, V, Hash, KeyEqual>::iterator, bool> ChHashMap<K, V, Hash, KeyEqual>::insert_or_assign(K &&key, M &&value)
+{
+    std::pair<iterator, bool> result = insertUnique(key, [&](value_type *slot)
+    {
+        ::new (static_cast<void *>(slot)) value_type(std::move(key), std::forward<M>(value));
+    });
+    if (!result.second)
+    {
+        result.first->second = std::forward<M>(value);
+    }
+    return result;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename... Args>
+std::pair<typename ChHashMap<K, V, Hash, KeyEqual>::iterator, bool> ChHashMap<K, V, Hash, KeyEqual>::emplace(Args &&...args)
+{
+    value_type value(std::forward<Args>(args)...);
+    return insertUnique(value.first, [&](value_type *slot)
+    {
+        ::new (static_cast<void *>(slot)) value_type(std::move(const_cast<K &>(value.first)), std::move(value.second));
+    });
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename... Args>
+std::pair<typename ChHashMap<K, V, Hash, KeyEqual>::iterator, bool> ChHashMap<K, V, Hash, KeyEqual>::try_emplace(const K &key, Args &&...args)
+{
+    return insertUnique(key, [&](value_type *slot)
+    {
+        ::new (static_cast<void *>(slot)) value_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+    });
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename... Args>
+std::pair<typename ChHashMap<K, V, Hash, KeyEqual>::iterator, bool> ChHashMap<K, V, Hash, KeyEqual>::try_emplace(K &&key, Args &&...args)
+{
+    return insertUnique(key, [&](value_type *slot)
+    {
+        ::new (static_cast<void *>(slot)) value_type(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+    });
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+typename ChHashMap<K, V, Hash, KeyEqual>::iterator ChHashMap<K, V, Hash, KeyEqual>::erase(const_iterator pos)
+{
+    size_t slot = pos.slot_;
+    eraseSlot(slot);
+
+    // An entry from further along the run may have moved into the slot; it has not been visited yet
+    if (control_[slot] >= 0)
+    {
+        return iterator(this, slot);
+    }
+    return iterator(this, nextSlot(slot));
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+typename ChHashMap<K, V, Hash, KeyEqual>::iterator ChHashMap<K, V, Hash, KeyEqual>::erase(iterator pos)
+{
+    return erase(const_iterator(pos));
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+size_t ChHashMap<K, V, Hash, KeyEqual>::erase(const K &key)
+{
+    size_t slot = findSlot(key, hashOf(key));
+    if (slot == notFound)
+    {
+        return 0;
+    }
+    eraseSlot(slot);
+    return 1;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q, typename>
+size_t ChHashMap<K, V, Hash, KeyEqual>::erase(const Q &key)
+{
+    size_t slot = findSlot(key, hashOf(key));
+    if (slot == notFound)
+    {
+        return 0;
+    }
+    eraseSlot(slot);
+    return 1;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Pred>
+size_t ChHashMap<K, V, Hash, KeyEqual>::eraseIf(Pred pred)
+{
+    size_t erased = 0;
+    for (iterator it = begin(); it != end();)
+    {
+        if (pred(static_cast<const value_type &>(*it)))
+        {
+            it = erase(it);
+            ++erased;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return erased;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChHashMap<K, V, Hash, KeyEqual>::clear() noexcept
+{
+    if (capacity_ == 0)
+    {
+        return;
+    }
+    destroyAll();
+    std::memset(control_, ChHashTable::emptyControl, ChHashTable::controlSize(capacity_));
+    size_ = 0;
+    start_ = 0;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChHashMap<K, V, Hash, KeyEqual>::swap(ChHashMap &other) noexcept
+{
+    std::swap(control_, other.control_);
+    std::swap(slots_, other.slots_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(size_, other.size_);
+    std::swap(growthLimit_, other.growthLimit_);
+    std::swap(start_, other.start_);
+    std::swap(maxLoadFactor_, other.maxLoadFactor_);
+    std::swap(hash_, other.hash_);
+    std::swap(equal_, other.equal_);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+Hash ChHashMap<K, V, Hash, KeyEqual>::hash_function() const
+{
+    return hash_;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+KeyEqual ChHashMap<K, V, Hash, KeyEqual>::key_eq() const
+{
+    return equal_;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q>
+uint64_t ChHashMap<K, V, Hash, KeyEqual>::hashOf(const Q &key) const
+{
+    return ChHashTable::mix(static_cast<uint64_t>(hash_(key)));
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q>
+size_t ChHashMap<K, V, Hash, KeyEqual>::findSlot(const Q &key, uint64_t hash) const
+{
+    if (size_ == 0)
+    {
+        return notFound;
+    }
+    return ChHashTable::findSlot(control_, capacity_ - 1, hash, [&](size_t slot) { return equal_(slots_[slot].first, key); });
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <typename Q, typename Construct>
+std::pair<typename ChHashMap<K, V, Hash, KeyEqual>::iterator, bool> ChHashMap<K, V, Hash, KeyEqual>::insertUnique(const Q &key, Construct construct)
+{
+    const uint64_t hash = hashOf(key);
+    size_t slot = findSlot(key, hash);
+    if (slot != notFound)
+    {
+        return std::make_pair(iterator(this, slot), false);
+    }
+
+    if (size_ >= growthLimit_)
+    {
+        rehashTo(capacity_ == 0 ? ChHashTable::minCapacity : capacity_ * 2);
+    }
+
+    // The control byte is set after the entry is constructed, so a throwing constructor leaves the map unchanged
+    slot = ChHashTable::findEmptySlot(control_, capacity_ - 1, ChHashTable::homeSlot(hash, capacity_ - 1));
+    construct(slots_ + slot);
+    setControl(slot, ChHashTable::controlByte(hash));
+    ++size_;
+    if (slot == start_)
+    {
+        updateStart();
+    }
+    return std::make_pair(iterator(this, slot), true);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChHashMap<K, V, Hash, KeyEqual>::eraseSlot(size_t slot)
+{
+    slots_[slot].~value_type();
+    --size_;
+    ChHashTable::eraseSlot(control_, capacity_, slot, [this](size_t from)
+    {
+        return ChHashTable::homeSlot(hashOf(slots_[from].first), capacity_ - 1);
+    }, [this](size_t from, size_t to)
+    {
+        relocate(slots_ + from, slots_ + to);
+    });
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChHashMap<K, V, Hash, KeyEqual>::setControl(size_t slot, int8_t control)
+{
+    ChHashTable::setControl(control_, capacity_, slot, control);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+size_t ChHashMap<K, V, Hash, KeyEqual>::nextSlot(size_t slot) const
+{
+    const size_t mask = capacity_ - 1;
+    do
+    {
+        slot = (slot + 1) & mask;
+    } while (slot != start_ && control_[slot] < 0);
+    return slot;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChHashMap<K, V, Hash, KeyEqual>::updateStart()
+{
+    // The table is never full, so there is an empty slot to start the iteration after
+    start_ = ChHashTable::findEmptySlot(control_, capacity_ - 1, start_);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChHashMap<K, V, Hash, KeyEqual>::relocate(value_type *from, value_type *to) noexcept
+{
+    // The key is const only towards the users of the map, and the moved-from entry is destroyed right away
+    ::new (static_cast<void *>(to)) value_type(std::move(const_cast<K &>(from->first)), std::move(from->second));
+    from->~value_type();
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChHashMap<K, V, Hash, KeyEqual>::rehashTo(size_t slots)
+{
+    int8_t *control = static_cast<int8_t *>(::operator new(ChHashTable::controlSize(slots)));
+    value_type *entries;
+    try
+    {
+        entries = std::allocator<value_type>().allocate(slots);
+    }
+    catch (...)
+    {
+        ::operator delete(control);
+        throw;
+    }
+    std::memset(control, ChHashTable::emptyControl, ChHashTable::controlSize(slots));
+
+    int8_t *oldControl = control_;
+    value_type *oldSlots = slots_;
+    size_t oldCapacity = capacity_;
+    control_ = control;
+    slots_ = entries;
+    capacity_ = slots;
+    growthLimit_ = static_cast<size_t>(static_cast<double>(slots) * maxLoadFactor_);
+
+    // Moving the entries cannot throw, so from here on the rehash cannot fail half way
+    for (size_t slot = 0; slot < oldCapacity; ++slot)
+    {
+        if (oldControl[slot] >= 0)
+        {
+            uint64_t hash = hashOf(oldSlots[slot].first);
+            size_t target = ChHashTable::findEmptySlot(control_, capacity_ - 1, ChHashTable::homeSlot(hash, capacity_ - 1));
+            relocate(oldSlots + slot, slots_ + target);
+            setControl(target, ChHashTable::controlByte(hash));
+        }
+    }
+
+    if (oldCapacity != 0)
+    {
+        std::allocator<value_type>().deallocate(oldSlots, oldCapacity);
+        ::operator delete(oldControl);
+    }
+    start_ = 0;
+    updateStart();
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+size_t ChHashMap<K, V, Hash, KeyEqual>::slotsFor(size_t count) const
+{
+    size_t slots = ChHashTable::minCapacity;
+    while (static_cast<size_t>(static_cast<double>(slots) * maxLoadFactor_) < count)
+    {
+        if (slots > std::allocator_traits<std::allocator<value_type>>::max_size(std::allocator<value_type>()) / 2)
+        {
+            throw std::length_error("ChHashMap cannot hold that many entries");
+        }
+        slots *= 2;
+    }
+    return slots;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChHashMap<K, V, Hash, KeyEqual>::destroyAll() noexcept
+{
+    if (!std::is_trivially_destructible<value_type>::value)
+    {
+        for (size_t slot = 0; slot < capacity_; ++slot)
+        {
+            if (control_[slot] >= 0)
+            {
+                slots_[slot].~value_type();
+            }
+        }
+    }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void ChHashMap<K, V, Hash, KeyEqual>::release() noexcept
+{
+    if (capacity_ != 0)
+    {
+        destroyAll();
+        std::allocator<value_type>().deallocate(slots_, capacity_);
+        ::operator delete(control_);
+    }
+    control_ = nullptr;
+    slots_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+    growthLimit_ = 0;
+    start_ = 0;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+bool operator==(const ChHashMap<K, V, Hash, KeyEqual> &a, const ChHashMap<K, V, Hash, KeyEqual> &b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (const auto &entry : a)
+    {
+        auto it = b.find(entry.first);
+        if (it == b.end() || !(it->second == entry.second))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+bool operator!=(const ChHashMap<K, V, Hash, KeyEqual> &a, const ChHashMap<K, V, Hash, KeyEqual> &b)
+{
+    return !(a == b);
+}
\ No newline at end of file
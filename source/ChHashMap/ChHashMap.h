@@ -1,10 +1,580 @@
 #ifndef CHHASHMAP
 #define CHHASHMAP
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "ChHash.h"
+#include "ChHashTable.h"
+
+/**
+ * @brief An unordered map from keys of type K to values of type V, stored in one flat array of slots.
+ *
+ * std::unordered_map allocates a node per entry and reaches it through a bucket pointer, so every lookup in a large
+ * map costs a couple of cache misses. ChHashMap stores the entries in the slots themselves (open addressing with
+ * linear probing) and keeps a control byte per slot holding seven bits of the hash of its key. A lookup loads a group
+ * of 16 control bytes (8 without SSE2), compares them with the hash in one instruction, and only compares the keys
+ * whose bits match, so a miss rarely touches a slot at all.
+ *
+ * Erasing does not leave tombstones behind. The entries that follow the erased one in its probe run are shifted back
+ * instead (backward shift deletion), so a table that sees many insertions and erasures never fills up with deleted
+ * markers and never needs a cleanup rehash. The flip side is that erasing moves other entries:
+ *
+ * - Inserting invalidates all iterators, and also references to entries if the table grows.
+ * - Erasing invalidates iterators and references to the erased entry and to the entries after it in its run.
+ *   `erase(iterator)` returns an iterator from which iteration can go on, so erasing inside an iteration loop
+ *   visits every entry exactly once.
+ *
+ * The table grows when it becomes fuller than `maxLoadFactor()`, 0.8 by default. `reserve` and `rehash` size it up
+ * front. If the hash function and the key comparison both define `is_transparent`, as the default ones do for
+ * std::string keys, `find`, `contains`, `count`, `at` and `erase` accept any key type they accept.
+ *
+ * @code
+ * ChHashMap<std::string, int> ages;
+ * ages["Ada"] = 36;
+ * ages.try_emplace("Alan", 41);
+ * if (auto it = ages.find(std::string_view("Ada")); it != ages.end())
+ * {
+ *     ++it->second;
+ * }
+ * @endcode
+ *
+ * Entries are moved when the table grows and when neighbours are erased, so K and V must be nothrow move
+ * constructible.
+ *
+ * @tparam K The type of the keys.
+ * @tparam V The type of the values.
+ * @tparam Hash The hash function of the keys.
+ * @tparam KeyEqual The comparison of the keys.
+ */
+template <typename K, typename V, typename Hash = ChHash<K>, typename KeyEqual = std::equal_to<>>
 class ChHashMap
 {
+    static_assert(std::is_nothrow_move_constructible<K>::value && std::is_nothrow_move_constructible<V>::value,
+                  "ChHashMap needs nothrow move constructible keys and values");
+
+    template <bool Const>
+    class Iterator;
+
+    // Enables the heterogeneous overloads for key types other than K
+    template <typename Q>
+    using EnableIfTransparent = typename std::enable_if<ChHashTable::IsTransparent<Hash, KeyEqual>::value && !std::is_same<Q, K>::value>::type;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<const K, V>;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    /**
+     * @brief Default constructor. Constructs an empty map that has not allocated any slots.
+     */
     ChHashMap();
+
+    /**
+     * @brief Constructs an empty map with room for `count` entries.
+     *
+     * @param count The number of entries to reserve room for.
+     * @param hash The hash function to use.
+     * @param equal The key comparison to use.
+     */
+    explicit ChHashMap(size_t count, const Hash &hash = Hash(), const KeyEqual &equal = KeyEqual());
+
+    /**
+     * @brief Constructs the map with the given entries. Of entries with equal keys, the first one is kept.
+     *
+     * @param values The entries to initialize the map with.
+     */
+    ChHashMap(std::initializer_list<value_type> values);
+
+    /**
+     * @brief Copy constructor. Constructs the map with the copy of the contents of `other`.
+     *
+     * @param other Another ChHashMap object to copy the entries from.
+     */
+    ChHashMap(const ChHashMap &other);
+
+    /**
+     * @brief Move constructor. Takes over the slots of `other`.
+     *
+     * @param other Another ChHashMap object to move the entries from. `other` is left empty.
+     */
+    ChHashMap(ChHashMap &&other) noexcept;
+
+    /**
+     * @brief Destructor. Destroys the entries and frees the slots.
+     */
     ~ChHashMap();
+
+    /**
+     * @brief Copy assignment operator. Replaces the contents of the map with a copy of the contents of `other`.
+     *
+     * @param other Another ChHashMap object to copy the entries from.
+     * @return *this
+     */
+    ChHashMap &operator=(const ChHashMap &other);
+
+    /**
+     * @brief Move assignment operator. Replaces the contents of the map with the contents of `other`.
+     *
+     * @param other Another ChHashMap object to move the entries from. `other` is left empty.
+     * @return *this
+     */
+    ChHashMap &operator=(ChHashMap &&other) noexcept;
+
+    /**
+     * @brief Returns an iterator to the first entry of the map. The order of the entries is unspecified.
+     */
+    iterator begin() noexcept;
+
+    /**
+     * @brief Returns a const iterator to the first entry of the map. The order of the entries is unspecified.
+     */
+    const_iterator begin() const noexcept;
+
+    /**
+     * @brief Returns an iterator past the last entry of the map.
+     */
+    iterator end() noexcept;
+
+    /**
+     * @brief Returns a const iterator past the last entry of the map.
+     */
+    const_iterator end() const noexcept;
+
+    /**
+     * @brief Returns a const iterator to the first entry of the map.
+     */
+    const_iterator cbegin() const noexcept;
+
+    /**
+     * @brief Returns a const iterator past the last entry of the map.
+     */
+    const_iterator cend() const noexcept;
+
+    /**
+     * @brief Returns the number of entries in the map.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Checks whether the map is empty.
+     */
+    bool isEmpty() const noexcept;
+
+    /**
+     * @brief Returns the number of entries the map can hold before it has to grow.
+     */
+    size_t capacity() const noexcept;
+
+    /**
+     * @brief Returns the number of slots of the table.
+     */
+    size_t slotCount() const noexcept;
+
+    /**
+     * @brief Returns the fraction of the slots that hold an entry.
+     */
+    float loadFactor() const noexcept;
+
+    /**
+     * @brief Returns the load factor above which the table grows.
+     */
+    float maxLoadFactor() const noexcept;
+
+    /**
+     * @brief Sets the load factor above which the table grows, and rehashes if the map is already fuller than that.
+     *
+     * Lower values trade memory for shorter probes, especially for lookups of missing keys and for erasing.
+     *
+     * @param factor The new maximum load factor.
+     * @throws std::invalid_argument if `factor` is not in the range [0.25, 0.95].
+     */
+    void setMaxLoadFactor(float factor);
+
+    /**
+     * @brief Makes room for at least `count` entries without exceeding the maximum load factor.
+     *
+     * @param count The number of entries to reserve room for.
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Rebuilds the table with at least `slots` slots, or with as few as the entries need if that is more.
+     *
+     * `rehash(0)` shrinks the table to fit the entries, and frees it if the map is empty.
+     *
+     * @param slots The minimum number of slots.
+     */
+    void rehash(size_t slots);
+
+    /**
+     * @brief Returns an iterator to the entry with key `key`, or `end()` if there is none.
+     *
+     * @param key The key to search for.
+     */
+    iterator find(const K &key);
+
+    /**
+     * @brief Returns a const iterator to the entry with key `key`, or `end()` if there is none.
+     *
+     * @param key The key to search for.
+     */
+    const_iterator find(const K &key) const;
+
+    /**
+     * @brief Heterogeneous version of `find`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    iterator find(const Q &key);
+
+    /**
+     * @brief Heterogeneous version of `find`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    const_iterator find(const Q &key) const;
+
+    /**
+     * @brief Checks whether the map has an entry with key `key`.
+     *
+     * @param key The key to search for.
+     */
+    bool contains(const K &key) const;
+
+    /**
+     * @brief Heterogeneous version of `contains`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    bool contains(const Q &key) const;
+
+    /**
+     * @brief Returns the number of entries with key `key`, which is 0 or 1.
+     *
+     * @param key The key to search for.
+     */
+    size_t count(const K &key) const;
+
+    /**
+     * @brief Heterogeneous version of `count`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    size_t count(const Q &key) const;
+
+    /**
+     * @brief Returns a reference to the value with key `key`.
+     *
+     * @param key The key to search for.
+     * @throws std::out_of_range if the map has no entry with key `key`.
+     */
+    V &at(const K &key);
+
+    /**
+     * @brief Returns a const reference to the value with key `key`.
+     *
+     * @param key The key to search for.
+     * @throws std::out_of_range if the map has no entry with key `key`.
+     */
+    const V &at(const K &key) const;
+
+    /**
+     * @brief Heterogeneous version of `at`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    V &at(const Q &key);
+
+    /**
+     * @brief Heterogeneous version of `at`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    const V &at(const Q &key) const;
+
+    /**
+     * @brief Returns a reference to the value with key `key`, inserting a value-initialized one if there is none.
+     *
+     * @param key The key of the value.
+     */
+    V &operator[](const K &key);
+
+    /**
+     * @brief Returns a reference to the value with key `key`, inserting a value-initialized one if there is none.
+     *
+     * @param key The key of the value. It is moved from only if it is inserted.
+     */
+    V &operator[](K &&key);
+
+    /**
+     * @brief Inserts a copy of `value` unless the map already has an entry with its key.
+     *
+     * @param value The entry to insert.
+     * @return An iterator to the entry with the key, and whether it was inserted.
+     */
+    std::pair<iterator, bool> insert(const value_type &value);
+
+    /**
+     * @brief Moves `value` into the map unless the map already has an entry with its key.
+     *
+     * @param value The entry to insert.
+     * @return An iterator to the entry with the key, and whether it was inserted.
+     */
+    std::pair<iterator, bool> insert(value_type &&value);
+
+    /**
+     * @brief Inserts the entries in the range [first, last). Of entries with equal keys, the first one is kept.
+     *
+     * @param first Iterator to the first entry to insert.
+     * @param last Iterator past the last entry to insert.
+     */
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last);
+
+    /**
+     * @brief Inserts `value` with key `key`, or assigns it to the existing entry with that key.
+     *
+     * @param key The key of the entry.
+     * @param value The value to insert or assign.
+     * @return An iterator to the entry with the key, and whether it was inserted.
+     */
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const K &key, M &&value);
+
+    /**
+     * @brief Inserts `value` with key `key`, or assigns it to the existing entry with that key.
+     *
+     * @param key The key of the entry. It is moved from only if it is inserted.
+     * @param value The value to insert or assign.
+     * @return An iterator to the entry with the key, and whether it was inserted.
+     */
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(K &&key, M &&value);
+
+    /**
+     * @brief Constructs an entry from `args` and inserts it unless the map already has an entry with its key.
+     *
+     * The entry is constructed before the lookup; `try_emplace` avoids that when the key is at hand.
+     *
+     * @param args The arguments to construct the entry from.
+     * @return An iterator to the entry with the key, and whether it was inserted.
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args &&...args);
+
+    /**
+     * @brief Inserts an entry with key `key` and a value constructed from `args`, unless the map already has an
+     * entry with that key, in which case nothing is constructed.
+     *
+     * @param key The key of the entry.
+     * @param args The arguments to construct the value from.
+     * @return An iterator to the entry with the key, and whether it was inserted.
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const K &key, Args &&...args);
+
+    /**
+     * @brief Inserts an entry with key `key` and a value constructed from `args`, unless the map already has an
+     * entry with that key, in which case nothing is constructed and `key` is not moved from.
+     *
+     * @param key The key of the entry.
+     * @param args The arguments to construct the value from.
+     * @return An iterator to the entry with the key, and whether it was inserted.
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&...args);
+
+    /**
+     * @brief Removes the entry at `pos`.
+     *
+     * @param pos Iterator to the entry to remove.
+     * @return Iterator to the next entry that the iteration has not visited yet.
+     */
+    iterator erase(const_iterator pos);
+
+    /**
+     * @brief Removes the entry at `pos`.
+     *
+     * @param pos Iterator to the entry to remove.
+     * @return Iterator to the next entry that the iteration has not visited yet.
+     */
+    iterator erase(iterator pos);
+
+    /**
+     * @brief Removes the entry with key `key`, if there is one.
+     *
+     * @param key The key of the entry to remove.
+     * @return The number of entries removed, which is 0 or 1.
+     */
+    size_t erase(const K &key);
+
+    /**
+     * @brief Heterogeneous version of `erase`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    size_t erase(const Q &key);
+
+    /**
+     * @brief Removes every entry for which `pred(entry)` returns true.
+     *
+     * @param pred The predicate, called once with a const reference to each entry.
+     * @return The number of entries removed.
+     */
+    template <typename Pred>
+    size_t eraseIf(Pred pred);
+
+    /**
+     * @brief Removes all entries from the map. The slots are kept.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Exchanges the contents of the map with those of `other`.
+     *
+     * @param other The map to exchange the contents with.
+     */
+    void swap(ChHashMap &other) noexcept;
+
+    /**
+     * @brief Returns the hash function of the map.
+     */
+    Hash hash_function() const;
+
+    /**
+     * @brief Returns the key comparison of the map.
+     */
+    KeyEqual key_eq() const;
+
+private:
+    static const size_t notFound = ChHashTable::noSlot;
+
+    template <typename Q>
+    uint64_t hashOf(const Q &key) const;
+
+    template <typename Q>
+    size_t findSlot(const Q &key, uint64_t hash) const;
+
+    template <typename Q, typename Construct>
+    std::pair<iterator, bool> insertUnique(const Q &key, Construct construct);
+
+    size_t insertNew(uint64_t hash, const K &key);
+
+    void eraseSlot(size_t slot);
+
+    void setControl(size_t slot, int8_t control);
+
+    size_t nextSlot(size_t slot) const;
+
+    void updateStart();
+
+    static void relocate(value_type *from, value_type *to) noexcept;
+
+    void rehashTo(size_t slots);
+
+    size_t slotsFor(size_t count) const;
+
+    void destroyAll() noexcept;
+
+    void release() noexcept;
+
+    int8_t *control_;
+    value_type *slots_;
+    size_t capacity_;
+    size_t size_;
+    size_t growthLimit_;
+    size_t start_;
+    float maxLoadFactor_;
+    Hash hash_;
+    KeyEqual equal_;
 };
 
+/**
+ * @brief Forward iterator over the entries of a ChHashMap.
+ *
+ * Iteration starts just after an empty slot and goes once around the table. Entries only ever move backwards within
+ * a run of full slots when a neighbour is erased, and no run crosses that empty slot, so erasing during an iteration
+ * neither skips entries nor visits them twice.
+ */
+template <typename K, typename V, typename Hash, typename KeyEqual>
+template <bool Const>
+class ChHashMap<K, V, Hash, KeyEqual>::Iterator
+{
+    using Map = typename std::conditional<Const, const ChHashMap, ChHashMap>::type;
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ChHashMap::value_type;
+    using reference = typename std::conditional<Const, const value_type &, value_type &>::type;
+    using pointer = typename std::conditional<Const, const value_type *, value_type *>::type;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() : map_(nullptr), slot_(0) {}
+
+    Iterator(Map *map, size_t slot) : map_(map), slot_(slot) {}
+
+    template <bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+    Iterator(const Iterator<OtherConst> &other) : map_(other.map_), slot_(other.slot_) {}
+
+    reference operator*() const
+    {
+        return map_->slots_[slot_];
+    }
+
+    pointer operator->() const
+    {
+        return map_->slots_ + slot_;
+    }
+
+    Iterator &operator++()
+    {
+        slot_ = map_->nextSlot(slot_);
+        return *this;
+    }
+
+    Iterator operator++(int)
+    {
+        Iterator previous = *this;
+        slot_ = map_->nextSlot(slot_);
+        return previous;
+    }
+
+    bool operator==(const Iterator &other) const
+    {
+        return slot_ == other.slot_;
+    }
+
+    bool operator!=(const Iterator &other) const
+    {
+        return slot_ != other.slot_;
+    }
+
+private:
+    template <bool>
+    friend class Iterator;
+
+    friend class ChHashMap;
+
+    Map *map_;
+    size_t slot_;
+};
+
+/**
+ * @brief Checks whether two maps have the same keys with equal values.
+ */
+template <typename K, typename V, typename Hash, typename KeyEqual>
+bool operator==(const ChHashMap<K, V, Hash, KeyEqual> &a, const ChHashMap<K, V, Hash, KeyEqual> &b);
+
+/**
+ * @brief Checks whether two maps differ in a key or a value.
+ */
+template <typename K, typename V, typename Hash, typename KeyEqual>
+bool operator!=(const ChHashMap<K, V, Hash, KeyEqual> &a, const ChHashMap<K, V, Hash, KeyEqual> &b);
+
 #endif
\ No newline at end of file
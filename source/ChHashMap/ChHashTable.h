@@ -0,0 +1,258 @@
+#ifndef CHHASHTABLE
+#define CHHASHTABLE
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "ChBits.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CHHASHTABLE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Low level helpers shared by the open-addressing hash tables. Not part of the public interface.
+ *
+ * A table keeps one control byte per slot next to the slots themselves. An empty slot has the control byte
+ * `emptyControl`; a full slot stores the low seven bits of the hash of its key, so that a lookup can compare a whole
+ * group of control bytes against the hash at once and only looks at the keys whose bits match.
+ */
+namespace ChHashTable
+{
+    /**
+     * @brief Whether a table may be searched with keys of other types than its own: both the hash function and the
+     * key comparison must define `is_transparent`.
+     */
+    template <typename Hash, typename KeyEqual, typename = void>
+    struct IsTransparent : std::false_type
+    {
+    };
+
+    template <typename Hash, typename KeyEqual>
+    struct IsTransparent<Hash, KeyEqual, std::void_t<typename Hash::is_transparent, typename KeyEqual::is_transparent>> : std::true_type
+    {
+    };
+
+    // The control byte of an empty slot. Full slots have the high bit clear.
+    const int8_t emptyControl = -128;
+
+    // The smallest number of slots of a table that has any
+    const size_t minCapacity = 16;
+
+    /**
+     * @brief Spreads the bits of a hash value over the whole word (the MurmurHash3 finalizer).
+     *
+     * std::hash is the identity for integers on common implementations, and both the control byte and the home slot
+     * are taken from the hash, so they need well mixed high and low bits.
+     */
+    inline uint64_t mix(uint64_t hash)
+    {
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    /**
+     * @brief Returns the control byte of a full slot holding a key with the mixed hash `hash`.
+     */
+    inline int8_t controlByte(uint64_t hash)
+    {
+        return static_cast<int8_t>(hash & 0x7F);
+    }
+
+    /**
+     * @brief Returns the slot at which a probe for the mixed hash `hash` starts, in a table of `mask + 1` slots.
+     */
+    inline size_t homeSlot(uint64_t hash, size_t mask)
+    {
+        return static_cast<size_t>(hash >> 7) & mask;
+    }
+
+    /**
+     * @brief The control bytes of `width` consecutive slots, loaded so that they can be matched all at once.
+     *
+     * With SSE2 a group is 16 bytes and a match sets one bit per slot. Elsewhere a group is 8 bytes held in a
+     * 64-bit word and a match sets the high bit of the byte of each slot. Either way `index` turns a set bit into the
+     * offset of its slot within the group.
+     */
+    class Group
+    {
+    public:
+#if defined(CHHASHTABLE_USE_SSE2)
+        static const size_t width = 16;
+#else
+        static const size_t width = 8;
+#endif
+
+        /**
+         * @brief Loads the control bytes starting at `control`. The bytes do not need to be aligned.
+         */
+        explicit Group(const int8_t *control)
+        {
+#if defined(CHHASHTABLE_USE_SSE2)
+            bytes_ = _mm_loadu_si128(reinterpret_cast<const __m128i *>(control));
+#else
+            std::memcpy(&bytes_, control, sizeof(bytes_));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            bytes_ = __builtin_bswap64(bytes_);
+#endif
+#endif
+        }
+
+        /**
+         * @brief Returns a mask of the slots whose control byte equals `control`.
+         *
+         * The portable version may report a slot next to a true match as matching too; callers compare the keys
+         * anyway.
+         */
+        uint64_t match(int8_t control) const
+        {
+#if defined(CHHASHTABLE_USE_SSE2)
+            return static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes_, _mm_set1_epi8(control))));
+#else
+            const uint64_t lows = 0x0101010101010101ull;
+            uint64_t difference = bytes_ ^ (lows * static_cast<uint8_t>(control));
+            return (difference - lows) & ~difference & (lows << 7);
+#endif
+        }
+
+        /**
+         * @brief Returns a mask of the empty slots.
+         */
+        uint64_t matchEmpty() const
+        {
+#if defined(CHHASHTABLE_USE_SSE2)
+            return static_cast<uint64_t>(_mm_movemask_epi8(bytes_));
+#else
+            return bytes_ & 0x8080808080808080ull;
+#endif
+        }
+
+        /**
+         * @brief Returns the offset within the group of the slot of the lowest set bit of a non-zero mask.
+         */
+        static size_t index(uint64_t mask)
+        {
+#if defined(CHHASHTABLE_USE_SSE2)
+            return ChBits::countTrailingZeros(mask);
+#else
+            return ChBits::countTrailingZeros(mask) >> 3;
+#endif
+        }
+
+    private:
+#if defined(CHHASHTABLE_USE_SSE2)
+        __m128i bytes_;
+#else
+        uint64_t bytes_;
+#endif
+    };
+
+    /**
+     * @brief Returns the number of control bytes of a table of `capacity` slots.
+     *
+     * The first `Group::width - 1` control bytes are repeated after the last one, so that a group can be loaded at
+     * any slot without wrapping around.
+     */
+    inline size_t controlSize(size_t capacity)
+    {
+        return capacity + Group::width - 1;
+    }
+
+    // Returned by the probes when there is no slot to report
+    const size_t noSlot = static_cast<size_t>(-1);
+
+    /**
+     * @brief Sets the control byte of `slot` in a table of `capacity` slots, including its copy past the end.
+     */
+    inline void setControl(int8_t *control, size_t capacity, size_t slot, int8_t byte)
+    {
+        control[slot] = byte;
+        if (slot < Group::width - 1)
+        {
+            control[capacity + slot] = byte;
+        }
+    }
+
+    /**
+     * @brief Returns the first full slot on the probe sequence of `hash` for which `matches(slot)` is true, or
+     * `noSlot`.
+     *
+     * Every slot between the home slot of a key and the slot of its entry is full, so the probe stops at the first
+     * group with an empty slot. It also stops after one round of the table, which only matters to readers that may
+     * see the control bytes while a writer changes them.
+     */
+    template <typename Matches>
+    size_t findSlot(const int8_t *control, size_t mask, uint64_t hash, Matches matches)
+    {
+        const int8_t byte = controlByte(hash);
+        size_t position = homeSlot(hash, mask);
+        for (size_t probed = 0; probed <= mask; probed += Group::width)
+        {
+            Group group(control + position);
+            for (uint64_t bits = group.match(byte); bits != 0; bits &= bits - 1)
+            {
+                size_t slot = (position + Group::index(bits)) & mask;
+                if (matches(slot))
+                {
+                    return slot;
+                }
+            }
+            if (group.matchEmpty() != 0)
+            {
+                return noSlot;
+            }
+            position = (position + Group::width) & mask;
+        }
+        return noSlot;
+    }
+
+    /**
+     * @brief Returns the first empty slot at or after `slot`. The table must have an empty slot.
+     */
+    inline size_t findEmptySlot(const int8_t *control, size_t mask, size_t slot)
+    {
+        while (true)
+        {
+            uint64_t empty = Group(control + slot).matchEmpty();
+            if (empty != 0)
+            {
+                return (slot + Group::index(empty)) & mask;
+            }
+            slot = (slot + Group::width) & mask;
+        }
+    }
+
+    /**
+     * @brief Closes the gap left by the entry that was in `slot`, which the caller has already destroyed, by shifting
+     * the rest of its run back (backward shift deletion), and marks the slot left over at the end empty.
+     *
+     * An entry is moved back only if its home slot is not between the gap and the entry, so that no entry ends up
+     * behind an empty slot on the way from its home slot. `homeOf(slot)` returns the home slot of the entry in
+     * `slot`, and `move(from, to)` moves the entry from one slot into the empty slot `to` and destroys the original.
+     */
+    template <typename HomeOf, typename Move>
+    void eraseSlot(int8_t *control, size_t capacity, size_t slot, HomeOf homeOf, Move move)
+    {
+        const size_t mask = capacity - 1;
+        size_t hole = slot;
+        for (size_t next = (slot + 1) & mask; control[next] >= 0; next = (next + 1) & mask)
+        {
+            if (((next - homeOf(next)) & mask) >= ((next - hole) & mask))
+            {
+                move(next, hole);
+                setControl(control, capacity, hole, control[next]);
+                hole = next;
+            }
+        }
+        setControl(control, capacity, hole, emptyControl);
+    }
+}
+
+#endif
\ No newline at end of file
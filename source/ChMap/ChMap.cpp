@@ -1,9 +1,1172 @@
 #include "ChMap.h"
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <tuple>
 
-ChMap::ChMap()
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+ChMap<K, V, Compare, NodeBytes>::ChMap() : root_(nullptr), first_(nullptr), last_(nullptr), size_(0), height_(0), compare_()
 {
 }
 
-ChMap::~ChMap()
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+ChMap<K, V, Compare, NodeBytes>::ChMap(const Compare &compare)
+    : root_(nullptr), first_(nullptr), last_(nullptr), size_(0), height_(0), compare_(compare)
 {
 }
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+ChMap<K, V, Compare, NodeBytes>::ChMap(std::initializer_list<value_type> values) : ChMap()
+{
+    insert(values.begin(), values.end());
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+ChMap<K, V, Compare, NodeBytes>::ChMap(const ChMap &other) : ChMap(other.compare_)
+{
+    // The entries of `other` are already in order, so appending them one by one builds a tree of full nodes
+    try
+    {
+        for (const value_type &entry : other)
+        {
+            append(entry);
+        }
+    }
+    catch (...)
+    {
+        clear();
+        throw;
+    }
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+ChMap<K, V, Compare, NodeBytes>::ChMap(ChMap &&other) noexcept : ChMap(other.compare_)
+{
+    swap(other);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+ChMap<K, V, Compare, NodeBytes>::~ChMap()
+{
+    clear();
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+ChMap<K, V, Compare, NodeBytes> &ChMap<K, V, Compare, NodeBytes>::operator=(const ChMap &other)
+{
+    if (this != &other)
+    {
+        ChMap copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+ChMap<K, V, Compare, NodeBytes> &ChMap<K, V, Compare, NodeBytes>::operator=(ChMap &&other) noexcept
+{
+    if (this != &other)
+    {
+        clear();
+        swap(other);
+    }
+    return *this;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::begin() noexcept
+{
+    return iterator(first_, 0);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::const_iterator ChMap<K, V, Compare, NodeBytes>::begin() const noexcept
+{
+    return const_iterator(first_, 0);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::end() noexcept
+{
+    return iterator(last_, last_ != nullptr ? last_->count : 0);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::const_iterator ChMap<K, V, Compare, NodeBytes>::end() const noexcept
+{
+    return const_iterator(last_, last_ != nullptr ? last_->count : 0);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::const_iterator ChMap<K, V, Compare, NodeBytes>::cbegin() const noexcept
+{
+    return begin();
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::const_iterator ChMap<K, V, Compare, NodeBytes>::cend() const noexcept
+{
+    return end();
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::reverse_iterator ChMap<K, V, Compare, NodeBytes>::rbegin() noexcept
+{
+    return reverse_iterator(end());
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::const_reverse_iterator ChMap<K, V, Compare, NodeBytes>::rbegin() const noexcept
+{
+    return const_reverse_iterator(end());
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::reverse_iterator ChMap<K, V, Compare, NodeBytes>::rend() noexcept
+{
+    return reverse_iterator(begin());
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::const_reverse_iterator ChMap<K, V, Compare, NodeBytes>::rend() const noexcept
+{
+    return const_reverse_iterator(begin());
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+size_t ChMap<K, V, Compare, NodeBytes>::size() const noexcept
+{
+    return size_;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+bool ChMap<K, V, Compare, NodeBytes>::isEmpty() const noexcept
+{
+    return size_ == 0;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+size_t ChMap<K, V, Compare, NodeBytes>::height() const noexcept
+{
+    return height_;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::find(const K &key)
+{
+    return findKey(key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::const_iterator ChMap<K, V, Compare, NodeBytes>::find(const K &key) const
+{
+    return findKey(key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q, typename>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::find(const Q &key)
+{
+    return findKey(key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q, typename>
+typename ChMap<K, V, Compare, NodeBytes>::const_iterator ChMap<K, V, Compare, NodeBytes>::find(const Q &key) const
+{
+    return findKey(key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+bool ChMap<K, V, Compare, NodeBytes>::contains(const K &key) const
+{
+    return const_iterator(findKey(key)) != end();
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q, typename>
+bool ChMap<K, V, Compare, NodeBytes>::contains(const Q &key) const
+{
+    return const_iterator(findKey(key)) != end();
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+size_t ChMap<K, V, Compare, NodeBytes>::count(const K &key) const
+{
+    return contains(key) ? 1 : 0;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q, typename>
+size_t ChMap<K, V, Compare, NodeBytes>::count(const Q &key) const
+{
+    return contains(key) ? 1 : 0;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::lower_bound(const K &key)
+{
+    return lowerBound(key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::const_iterator ChMap<K, V, Compare, NodeBytes>::lower_bound(const K &key) const
+{
+    return lowerBound(key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q, typename>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::lower_bound(const Q &key)
+{
+    return lowerBound(key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q, typename>
+typename ChMap<K, V, Compare, NodeBytes>::const_iterator ChMap<K, V, Compare, NodeBytes>::lower_bound(const Q &key) const
+{
+    return lowerBound(key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::upper_bound(const K &key)
+{
+    return upperBound(key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::const_iterator ChMap<K, V, Compare, NodeBytes>::upper_bound(const K &key) const
+{
+    return upperBound(key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q, typename>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::upper_bound(const Q &key)
+{
+    return upperBound(key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q, typename>
+typename ChMap<K, V, Compare, NodeBytes>::const_iterator ChMap<K, V, Compare, NodeBytes>::upper_bound(const Q &key) const
+{
+    return upperBound(key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+std::pair<typename ChMap<K, V, Compare, NodeBytes>::iterator, typename ChMap<K, V, Compare, NodeBytes>::iterator>
+ChMap<K, V, Compare, NodeBytes>::equal_range(const K &key)
+{
+    iterator it = findKey(key);
+    return it == end() ? std::make_pair(lowerBound(key), lowerBound(key)) : std::make_pair(it, std::next(it));
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+std::pair<typename ChMap<K, V, Compare, NodeBytes>::const_iterator, typename ChMap<K, V, Compare, NodeBytes>::const_iterator>
+ChMap<K, V, Compare, NodeBytes>::equal_range(const K &key) const
+{
+    return const_cast<ChMap *>(this)->equal_range(key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q, typename>
+std::pair<typename ChMap<K, V, Compare, NodeBytes>::iterator, typename ChMap<K, V, Compare, NodeBytes>::iterator>
+ChMap<K, V, Compare, NodeBytes>::equal_range(const Q &key)
+{
+    iterator it = findKey(key);
+    return it == end() ? std::make_pair(lowerBound(key), lowerBound(key)) : std::make_pair(it, std::next(it));
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q, typename>
+std::pair<typename ChMap<K, V, Compare, NodeBytes>::const_iterator, typename ChMap<K, V, Compare, NodeBytes>::const_iterator>
+ChMap<K, V, Compare, NodeBytes>::equal_range(const Q &key) const
+{
+    return const_cast<ChMap *>(this)->equal_range(key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+V &ChMap<K, V, Compare, NodeBytes>::at(const K &key)
+{
+    iterator it = findKey(key);
+    if (it == end())
+    {
+        throw std::out_of_range("ChMap::at: key not found");
+    }
+    return it->second;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+const V &ChMap<K, V, Compare, NodeBytes>::at(const K &key) const
+{
+    return const_cast<ChMap *>(this)->at(key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+V &ChMap<K, V, Compare, NodeBytes>::operator[](const K &key)
+{
+    return try_emplace(key).first->second;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+V &ChMap<K, V, Compare, NodeBytes>::operator[](K &&key)
+{
+    return try_emplace(std::move(key)).first->second;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+std::pair<typename ChMap<K, V, Compare, NodeBytes>::iterator, bool> ChMap<K, V, Compare, NodeBytes>::insert(const value_type &value)
+{
+    return insertUnique(value.first, [&](value_type *entry)
+    {
+        ::new (static_cast<void *>(entry)) value_type(value);
+    });
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+std::pair<typename ChMap<K, V, Compare, NodeBytes>::iterator, bool> ChMap<K, V, Compare, NodeBytes>::insert(value_type &&value)
+{
+    return insertUnique(value.first, [&](value_type *entry)
+    {
+        ::new (static_cast<void *>(entry)) value_type(std::move(value));
+    });
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename InputIt>
+void ChMap<K, V, Compare, NodeBytes>::insert(InputIt first, InputIt last)
+{
+    for (; first != last; ++first)
+    {
+        insert(*first);
+    }
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename M>
+std::pair<typename ChMap<K, V, Compare, NodeBytes>::iterator, bool> ChMap<K, V, Compare, NodeBytes>::insert_or_assign(const K &key, M &&value)
+{
+    auto result = try_emplace(key, std::forward<M>(value));
+    if (!result.second)
+    {
+        result.first->second = std::forward<M>(value);
+    }
+    return result;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename M>
+std::pair<typename ChMap<K, V, Compare, NodeBytes>::iterator, bool> ChMap<K, V, Compare, NodeBytes>::insert_or_assign(K &&key, M &&value)
+{
+    auto result = try_emplace(std::move(key), std::forward<M>(value));
+    if (!result.second)
+    {
+        result.first->second = std::forward<M>(value);
+    }
+    return result;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename... Args>
+std::pair<typename ChMap<K, V, Compare, NodeBytes>::iterator, bool> ChMap<K, V, Compare, NodeBytes>::emplace(Args &&...args)
+{
+    value_type value(std::forward<Args>(args)...);
+    return insert(std::move(value));
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename... Args>
+std::pair<typename ChMap<K, V, Compare, NodeBytes>::iterator, bool> ChMap<K, V, Compare, NodeBytes>::try_emplace(const K &key, Args &&...args)
+{
+    return insertUnique(key, [&](value_type *entry)
+    {
+        ::new (static_cast<void *>(entry)) value_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+    });
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename... Args>
+std::pair<typename ChMap<K, V, Compare, NodeBytes>::iterator, bool> ChMap<K, V, Compare, NodeBytes>::try_emplace(K &&key, Args &&...args)
+{
+    return insertUnique(key, [&](value_type *entry)
+    {
+        ::new (static_cast<void *>(entry)) value_type(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+    });
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename InputIt>
+void ChMap<K, V, Compare, NodeBytes>::assignSorted(InputIt first, InputIt last)
+{
+    // Build the new tree on the side, so that out of order keys leave the map as it was
+    ChMap sorted(compare_);
+    for (; first != last; ++first)
+    {
+        const value_type &entry = *first;
+        if (sorted.last_ != nullptr && !compare_(sorted.last_->entries()[sorted.last_->count - 1].first, entry.first))
+        {
+            throw std::invalid_argument("ChMap::assignSorted: keys are not in strictly increasing order");
+        }
+        sorted.append(*first);
+    }
+    swap(sorted);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::erase(const_iterator pos)
+{
+    return eraseAt(pos.leaf_, pos.index_);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::erase(iterator pos)
+{
+    return eraseAt(pos.leaf_, pos.index_);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::erase(const_iterator first, const_iterator last)
+{
+    // Erasing may merge nodes, which invalidates `last`, so count the entries to remove first
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    iterator it(first.leaf_, first.index_);
+    for (; count > 0; --count)
+    {
+        it = eraseAt(it.leaf_, it.index_);
+    }
+    return it;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+size_t ChMap<K, V, Compare, NodeBytes>::erase(const K &key)
+{
+    iterator it = findKey(key);
+    if (it == end())
+    {
+        return 0;
+    }
+    eraseAt(it.leaf_, it.index_);
+    return 1;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q, typename>
+size_t ChMap<K, V, Compare, NodeBytes>::erase(const Q &key)
+{
+    iterator it = findKey(key);
+    if (it == end())
+    {
+        return 0;
+    }
+    eraseAt(it.leaf_, it.index_);
+    return 1;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Pred>
+size_t ChMap<K, V, Compare, NodeBytes>::eraseIf(Pred pred)
+{
+    size_t removed = 0;
+    for (iterator it = begin(); it != end();)
+    {
+        if (pred(static_cast<const value_type &>(*it)))
+        {
+            it = eraseAt(it.leaf_, it.index_);
+            ++removed;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+void ChMap<K, V, Compare, NodeBytes>::clear() noexcept
+{
+    if (root_ != nullptr)
+    {
+        destroy(root_);
+    }
+    root_ = nullptr;
+    first_ = nullptr;
+    last_ = nullptr;
+    size_ = 0;
+    height_ = 0;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+void ChMap<K, V, Compare, NodeBytes>::swap(ChMap &other) noexcept
+{
+    using std::swap;
+    swap(root_, other.root_);
+    swap(first_, other.first_);
+    swap(last_, other.last_);
+    swap(size_, other.size_);
+    swap(height_, other.height_);
+    swap(compare_, other.compare_);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+Compare ChMap<K, V, Compare, NodeBytes>::key_comp() const
+{
+    return compare_;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <bool OrEqual, typename T, typename KeyOf, typename Q>
+size_t ChMap<K, V, Compare, NodeBytes>::rank(const T *items, size_t count, KeyOf keyOf, const Q &key) const
+{
+    if (std::is_arithmetic<K>::value)
+    {
+        // Comparing every key of the node without a branch is faster for cheap keys than a binary search, whose
+        // branches go either way at random
+        size_t rank = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            rank += OrEqual ? !compare_(key, keyOf(items[i])) : compare_(keyOf(items[i]), key);
+        }
+        return rank;
+    }
+
+    size_t low = 0;
+    while (count > 0)
+    {
+        size_t half = count / 2;
+        if (OrEqual ? !compare_(key, keyOf(items[low + half])) : compare_(keyOf(items[low + half]), key))
+        {
+            low += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+    return low;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q>
+typename ChMap<K, V, Compare, NodeBytes>::Leaf *ChMap<K, V, Compare, NodeBytes>::findLeaf(const Q &key) const
+{
+    // Go down to the first child whose separating key is greater than `key`
+    Node *node = root_;
+    while (!node->leaf)
+    {
+        Inner *inner = static_cast<Inner *>(node);
+        node = inner->children[rank<true>(inner->keys(), inner->count, [](const K &separator) -> const K & { return separator; }, key)];
+    }
+    return static_cast<Leaf *>(node);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q>
+size_t ChMap<K, V, Compare, NodeBytes>::lowerIndex(Leaf *leaf, const Q &key) const
+{
+    return rank<false>(leaf->entries(), leaf->count, [](const value_type &entry) -> const K & { return entry.first; }, key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q>
+size_t ChMap<K, V, Compare, NodeBytes>::upperIndex(Leaf *leaf, const Q &key) const
+{
+    return rank<true>(leaf->entries(), leaf->count, [](const value_type &entry) -> const K & { return entry.first; }, key);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::findKey(const Q &key) const
+{
+    if (root_ == nullptr)
+    {
+        return iterator();
+    }
+    Leaf *leaf = findLeaf(key);
+    size_t index = lowerIndex(leaf, key);
+    if (index == leaf->count || compare_(key, leaf->entries()[index].first))
+    {
+        return iterator(last_, last_->count);
+    }
+    return iterator(leaf, index);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::lowerBound(const Q &key) const
+{
+    if (root_ == nullptr)
+    {
+        return iterator();
+    }
+    Leaf *leaf = findLeaf(key);
+    return makeIterator(leaf, lowerIndex(leaf, key));
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Q>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::upperBound(const Q &key) const
+{
+    if (root_ == nullptr)
+    {
+        return iterator();
+    }
+    Leaf *leaf = findLeaf(key);
+    return makeIterator(leaf, upperIndex(leaf, key));
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::makeIterator(Leaf *leaf, size_t index) const noexcept
+{
+    // A position just past the entries of a leaf is the first entry of the next one, unless this is the last leaf
+    if (index == leaf->count && leaf->next != nullptr)
+    {
+        return iterator(leaf->next, 0);
+    }
+    return iterator(leaf, index);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Construct>
+std::pair<typename ChMap<K, V, Compare, NodeBytes>::iterator, bool> ChMap<K, V, Compare, NodeBytes>::insertUnique(const K &key, Construct construct)
+{
+    if (root_ == nullptr)
+    {
+        root_ = first_ = last_ = newLeaf();
+        height_ = 1;
+    }
+
+    Leaf *leaf = findLeaf(key);
+    size_t index = lowerIndex(leaf, key);
+    if (index < leaf->count && !compare_(key, leaf->entries()[index].first))
+    {
+        return {iterator(leaf, index), false};
+    }
+
+    if (leaf->count == leafSlots)
+    {
+        std::tie(leaf, index) = splitLeaf(leaf, index, key);
+    }
+
+    // The split above already left a valid tree, so a failed construction only has to close the gap again
+    value_type *entries = leaf->entries();
+    moveRange(entries + index, leaf->count - index, entries + index + 1);
+    try
+    {
+        construct(entries + index);
+    }
+    catch (...)
+    {
+        moveRange(entries + index + 1, leaf->count - index, entries + index);
+        throw;
+    }
+    ++leaf->count;
+    ++size_;
+    return {iterator(leaf, index), true};
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename Entry>
+void ChMap<K, V, Compare, NodeBytes>::append(Entry &&entry)
+{
+    if (root_ == nullptr)
+    {
+        root_ = first_ = last_ = newLeaf();
+        height_ = 1;
+    }
+
+    Leaf *leaf = last_;
+    size_t index = leaf->count;
+    if (index == leafSlots)
+    {
+        std::tie(leaf, index) = splitLeaf(leaf, index, entry.first);
+    }
+    ::new (static_cast<void *>(leaf->entries() + index)) value_type(std::forward<Entry>(entry));
+    ++leaf->count;
+    ++size_;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+std::pair<typename ChMap<K, V, Compare, NodeBytes>::Leaf *, size_t> ChMap<K, V, Compare, NodeBytes>::splitLeaf(Leaf *leaf, size_t index, const K &key)
+{
+    // A new entry after the largest key starts a new leaf and leaves this one full, so that keys inserted in
+    // increasing order fill every leaf. Any other split moves the upper half of the entries to the new leaf.
+    const bool appending = index == leafSlots && leaf == last_;
+    const size_t split = appending ? leafSlots : (leafSlots + 1) / 2;
+
+    // Allocate every node the split needs up front: the new leaf, a new inner node for every full ancestor, and a
+    // new root if the root splits too. Copy the key that will separate the two leaves as well. If any of that throws,
+    // the tree is still untouched, and after it nothing can throw.
+    size_t needed = 0;
+    Inner *parent = leaf->parent;
+    while (parent != nullptr && parent->count == innerSlots)
+    {
+        ++needed;
+        parent = parent->parent;
+    }
+    if (parent == nullptr)
+    {
+        ++needed;
+    }
+
+    Inner *spares[maxHeight];
+    size_t spareCount = 0;
+    Leaf *right = nullptr;
+    try
+    {
+        right = newLeaf();
+        for (; spareCount < needed; ++spareCount)
+        {
+            spares[spareCount] = newInner();
+        }
+        K separator(index == split ? key : leaf->entries()[split].first);
+
+        moveRange(leaf->entries() + split, leafSlots - split, right->entries());
+        right->count = static_cast<uint16_t>(leafSlots - split);
+        leaf->count = static_cast<uint16_t>(split);
+
+        right->previous = leaf;
+        right->next = leaf->next;
+        if (leaf->next != nullptr)
+        {
+            leaf->next->previous = right;
+        }
+        else
+        {
+            last_ = right;
+        }
+        leaf->next = right;
+
+        insertIntoParent(leaf, std::move(separator), right, spares, spareCount);
+    }
+    catch (...)
+    {
+        delete right;
+        while (spareCount > 0)
+        {
+            delete spares[--spareCount];
+        }
+        throw;
+    }
+
+    if (index < split)
+    {
+        return {leaf, index};
+    }
+    return {right, index - split};
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+void ChMap<K, V, Compare, NodeBytes>::insertIntoParent(Node *left, K &&separator, Node *right, Inner **spares, size_t &spareCount) noexcept
+{
+    Inner *parent = left->parent;
+    if (parent == nullptr)
+    {
+        Inner *root = spares[--spareCount];
+        ::new (static_cast<void *>(root->keys())) K(std::move(separator));
+        root->count = 1;
+        root->children[0] = left;
+        root->children[1] = right;
+        left->parent = right->parent = root;
+        left->position = 0;
+        right->position = 1;
+        root_ = root;
+        ++height_;
+        return;
+    }
+
+    const size_t position = left->position + 1u;
+    if (parent->count < innerSlots)
+    {
+        insertChild(parent, position, std::move(separator), right);
+        return;
+    }
+
+    // A new child after the last one of the rightmost node on its level starts a new node that only takes the last
+    // child along, so that appending in key order leaves full inner nodes behind, as it does for leaves
+    Inner *sibling = spares[--spareCount];
+    K *keys = parent->keys();
+    if (position == innerSlots + 1u && isRightmost(parent))
+    {
+        K up(std::move(keys[innerSlots - 1]));
+        keys[innerSlots - 1].~K();
+        ::new (static_cast<void *>(sibling->keys())) K(std::move(separator));
+        Node *moved = parent->children[innerSlots];
+        sibling->children[0] = moved;
+        sibling->children[1] = right;
+        moved->parent = right->parent = sibling;
+        moved->position = 0;
+        right->position = 1;
+        sibling->count = 1;
+        parent->count = static_cast<uint16_t>(innerSlots - 1);
+        insertIntoParent(parent, std::move(up), sibling, spares, spareCount);
+        return;
+    }
+
+    // Otherwise the children up to `middle` stay, the ones after it move to the new node, and the key between them
+    // moves up
+    const size_t middle = innerSlots / 2;
+    K up(std::move(keys[middle]));
+    keys[middle].~K();
+    moveRange(keys + middle + 1, innerSlots - middle - 1, sibling->keys());
+    for (size_t child = middle + 1; child <= innerSlots; ++child)
+    {
+        Node *moved = parent->children[child];
+        sibling->children[child - middle - 1] = moved;
+        moved->parent = sibling;
+        moved->position = static_cast<uint16_t>(child - middle - 1);
+    }
+    parent->count = static_cast<uint16_t>(middle);
+    sibling->count = static_cast<uint16_t>(innerSlots - middle - 1);
+
+    if (position <= middle + 1)
+    {
+        insertChild(parent, position, std::move(separator), right);
+    }
+    else
+    {
+        insertChild(sibling, position - middle - 1, std::move(separator), right);
+    }
+    insertIntoParent(parent, std::move(up), sibling, spares, spareCount);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+void ChMap<K, V, Compare, NodeBytes>::insertChild(Inner *node, size_t index, K &&separator, Node *child) noexcept
+{
+    K *keys = node->keys();
+    moveRange(keys + index - 1, node->count - (index - 1), keys + index);
+    ::new (static_cast<void *>(keys + index - 1)) K(std::move(separator));
+    for (size_t i = node->count + 1u; i > index; --i)
+    {
+        node->children[i] = node->children[i - 1];
+        node->children[i]->position = static_cast<uint16_t>(i);
+    }
+    node->children[index] = child;
+    child->parent = node;
+    child->position = static_cast<uint16_t>(index);
+    ++node->count;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+void ChMap<K, V, Compare, NodeBytes>::removeChild(Inner *node, size_t index) noexcept
+{
+    // Removes child `index` and the key in front of it
+    K *keys = node->keys();
+    keys[index - 1].~K();
+    moveRange(keys + index, node->count - index, keys + index - 1);
+    for (size_t i = index; i < node->count; ++i)
+    {
+        node->children[i] = node->children[i + 1];
+        node->children[i]->position = static_cast<uint16_t>(i);
+    }
+    --node->count;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+bool ChMap<K, V, Compare, NodeBytes>::isRightmost(const Node *node) noexcept
+{
+    for (; node->parent != nullptr; node = node->parent)
+    {
+        if (node->position != node->parent->count)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::iterator ChMap<K, V, Compare, NodeBytes>::eraseAt(Leaf *leaf, size_t index) noexcept
+{
+    value_type *entries = leaf->entries();
+    entries[index].~value_type();
+    moveRange(entries + index + 1, leaf->count - index - 1, entries + index);
+    --leaf->count;
+    --size_;
+
+    if (leaf == root_)
+    {
+        if (leaf->count == 0)
+        {
+            clear();
+            return iterator();
+        }
+        return makeIterator(leaf, index);
+    }
+
+    // Merge a leaf that dropped below half full into a neighbour if they fit into one leaf, and follow the position
+    // of the next entry
+    Inner *parent = leaf->parent;
+    if (leaf->count < leafSlots / 2)
+    {
+        Leaf *left = leaf->position > 0 ? static_cast<Leaf *>(parent->children[leaf->position - 1]) : nullptr;
+        Leaf *right = leaf->position < parent->count ? static_cast<Leaf *>(parent->children[leaf->position + 1]) : nullptr;
+        if (left != nullptr && left->count + leaf->count <= leafSlots)
+        {
+            index += left->count;
+            mergeLeaves(left, leaf);
+            leaf = left;
+            rebalance(parent);
+        }
+        else if (right != nullptr && leaf->count + right->count <= leafSlots)
+        {
+            mergeLeaves(leaf, right);
+            rebalance(parent);
+        }
+    }
+    return makeIterator(leaf, index);
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+void ChMap<K, V, Compare, NodeBytes>::mergeLeaves(Leaf *left, Leaf *right) noexcept
+{
+    moveRange(right->entries(), right->count, left->entries() + left->count);
+    left->count = static_cast<uint16_t>(left->count + right->count);
+    left->next = right->next;
+    if (right->next != nullptr)
+    {
+        right->next->previous = left;
+    }
+    else
+    {
+        last_ = left;
+    }
+    removeChild(right->parent, right->position);
+    delete right;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+void ChMap<K, V, Compare, NodeBytes>::mergeInners(Inner *left, Inner *right) noexcept
+{
+    // The key between the two nodes comes down between their children
+    Inner *parent = left->parent;
+    K *keys = left->keys();
+    ::new (static_cast<void *>(keys + left->count)) K(std::move(parent->keys()[left->position]));
+    moveRange(right->keys(), right->count, keys + left->count + 1);
+    for (size_t child = 0; child <= right->count; ++child)
+    {
+        Node *moved = right->children[child];
+        const size_t position = left->count + 1u + child;
+        left->children[position] = moved;
+        moved->parent = left;
+        moved->position = static_cast<uint16_t>(position);
+    }
+    left->count = static_cast<uint16_t>(left->count + 1 + right->count);
+    removeChild(parent, right->position);
+    delete right;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+void ChMap<K, V, Compare, NodeBytes>::borrowFromLeft(Inner *left, Inner *node) noexcept
+{
+    // The last child of `left` becomes the first child of `node`, and the keys rotate through the parent
+    K &separator = node->parent->keys()[left->position];
+    K *keys = node->keys();
+    moveRange(keys, node->count, keys + 1);
+    ::new (static_cast<void *>(keys)) K(std::move(separator));
+    separator.~K();
+    ::new (static_cast<void *>(&separator)) K(std::move(left->keys()[left->count - 1]));
+    left->keys()[left->count - 1].~K();
+    for (size_t i = node->count + 1u; i > 0; --i)
+    {
+        node->children[i] = node->children[i - 1];
+        node->children[i]->position = static_cast<uint16_t>(i);
+    }
+    Node *moved = left->children[left->count];
+    node->children[0] = moved;
+    moved->parent = node;
+    moved->position = 0;
+    --left->count;
+    ++node->count;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+void ChMap<K, V, Compare, NodeBytes>::borrowFromRight(Inner *node, Inner *right) noexcept
+{
+    // The first child of `right` becomes the last child of `node`, and the keys rotate through the parent
+    K &separator = node->parent->keys()[node->position];
+    ::new (static_cast<void *>(node->keys() + node->count)) K(std::move(separator));
+    separator.~K();
+    ::new (static_cast<void *>(&separator)) K(std::move(right->keys()[0]));
+    right->keys()[0].~K();
+    moveRange(right->keys() + 1, right->count - 1u, right->keys());
+    Node *moved = right->children[0];
+    node->children[node->count + 1] = moved;
+    moved->parent = node;
+    moved->position = static_cast<uint16_t>(node->count + 1);
+    for (size_t i = 0; i < right->count; ++i)
+    {
+        right->children[i] = right->children[i + 1];
+        right->children[i]->position = static_cast<uint16_t>(i);
+    }
+    --right->count;
+    ++node->count;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+void ChMap<K, V, Compare, NodeBytes>::rebalance(Inner *node) noexcept
+{
+    while (node != root_)
+    {
+        if (node->count >= innerSlots / 2)
+        {
+            return;
+        }
+        Inner *parent = node->parent;
+        Inner *left = node->position > 0 ? static_cast<Inner *>(parent->children[node->position - 1]) : nullptr;
+        Inner *right = node->position < parent->count ? static_cast<Inner *>(parent->children[node->position + 1]) : nullptr;
+        if (left != nullptr && left->count + 1u + node->count <= innerSlots)
+        {
+            mergeInners(left, node);
+        }
+        else if (right != nullptr && node->count + 1u + right->count <= innerSlots)
+        {
+            mergeInners(node, right);
+        }
+        else
+        {
+            // The neighbours are too full to merge with, so take a child from the fuller one. Without this, a
+            // node could end up with a single child, and a leaf below it with no neighbour to merge into.
+            if (left != nullptr && (right == nullptr || left->count >= right->count))
+            {
+                borrowFromLeft(left, node);
+            }
+            else
+            {
+                borrowFromRight(node, right);
+            }
+            return;
+        }
+        node = parent;
+    }
+
+    // A root left with a single child hands the root over to it
+    if (node->count == 0)
+    {
+        root_ = node->children[0];
+        root_->parent = nullptr;
+        root_->position = 0;
+        delete node;
+        --height_;
+    }
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+void ChMap<K, V, Compare, NodeBytes>::relocate(value_type *from, value_type *to) noexcept
+{
+    // The key is const only towards the users of the map, and the moved-from entry is destroyed right away
+    ::new (static_cast<void *>(to)) value_type(std::move(const_cast<K &>(from->first)), std::move(from->second));
+    from->~value_type();
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+void ChMap<K, V, Compare, NodeBytes>::relocate(K *from, K *to) noexcept
+{
+    ::new (static_cast<void *>(to)) K(std::move(*from));
+    from->~K();
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <typename T>
+void ChMap<K, V, Compare, NodeBytes>::moveRange(T *first, size_t count, T *to) noexcept
+{
+    // Moves `count` objects to the uninitialized or overlapping range at `to`, leaving the source destroyed
+    if (std::is_trivially_copyable<K>::value && (std::is_same<T, K>::value || std::is_trivially_copyable<V>::value))
+    {
+        if (count > 0)
+        {
+            std::memmove(static_cast<void *>(to), static_cast<const void *>(first), count * sizeof(T));
+        }
+    }
+    else if (to < first)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            relocate(first + i, to + i);
+        }
+    }
+    else
+    {
+        for (size_t i = count; i > 0; --i)
+        {
+            relocate(first + i - 1, to + i - 1);
+        }
+    }
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::Leaf *ChMap<K, V, Compare, NodeBytes>::newLeaf()
+{
+    Leaf *leaf = new Leaf;
+    leaf->parent = nullptr;
+    leaf->position = 0;
+    leaf->count = 0;
+    leaf->leaf = true;
+    leaf->previous = nullptr;
+    leaf->next = nullptr;
+    return leaf;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+typename ChMap<K, V, Compare, NodeBytes>::Inner *ChMap<K, V, Compare, NodeBytes>::newInner()
+{
+    Inner *inner = new Inner;
+    inner->parent = nullptr;
+    inner->position = 0;
+    inner->count = 0;
+    inner->leaf = false;
+    return inner;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+void ChMap<K, V, Compare, NodeBytes>::destroy(Node *node) noexcept
+{
+    if (node->leaf)
+    {
+        Leaf *leaf = static_cast<Leaf *>(node);
+        for (size_t i = 0; i < leaf->count; ++i)
+        {
+            leaf->entries()[i].~value_type();
+        }
+        delete leaf;
+        return;
+    }
+    Inner *inner = static_cast<Inner *>(node);
+    for (size_t i = 0; i <= inner->count; ++i)
+    {
+        destroy(inner->children[i]);
+    }
+    for (size_t i = 0; i < inner->count; ++i)
+    {
+        inner->keys()[i].~K();
+    }
+    delete inner;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+bool operator==(const ChMap<K, V, Compare, NodeBytes> &a, const ChMap<K, V, Compare, NodeBytes> &b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    auto other = b.begin();
+    for (const auto &entry : a)
+    {
+        if (!(entry.first == other->first) || !(entry.second == other->second))
+        {
+            return false;
+        }
+        ++other;
+    }
+    return true;
+}
+
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+bool operator!=(const ChMap<K, V, Compare, NodeBytes> &a, const ChMap<K, V, Compare, NodeBytes> &b)
+{
+    return !(a == b);
+}
\ No newline at end of file
@@ -1,10 +1,753 @@
 #ifndef CHMAP
 #define CHMAP
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief An ordered map from keys of type K to values of type V, stored in a B+ tree with wide nodes.
+ *
+ * std::map is a red-black tree with one allocation per entry, and a lookup follows a pointer into a different cache
+ * line at every one of its roughly log2(n) levels. ChMap keeps up to a few dozen entries side by side in every node
+ * instead: a lookup visits log(n) / log(fan-out) nodes and searches the keys inside each one, which sit next to each
+ * other in memory. All entries live in the leaves, and the leaves are linked in key order, so iterating over the map or
+ * over a range of it walks through contiguous arrays. A node has about `NodeBytes` bytes, 256 by default, i.e. four
+ * cache lines.
+ *
+ * Leaves that a split leaves half empty are the usual state of a B+ tree. Two cases fill them completely: entries
+ * appended after the largest key, which is what inserting keys in increasing order does, and `assignSorted`, which
+ * builds the whole tree from sorted input in linear time. Erasing merges a node that drops below half full into a
+ * neighbour whenever the two fit into one node; an inner node that cannot merge borrows a child from a neighbour.
+ *
+ * Entries move between nodes when nodes split and merge, so unlike std::map:
+ *
+ * - Inserting invalidates all iterators and references.
+ * - Erasing invalidates all iterators and references. `erase(iterator)` returns an iterator to the entry that followed
+ *   the erased one, so erasing inside an iteration loop visits every entry exactly once.
+ *
+ * If the comparison defines `is_transparent`, as the default std::less<> does, `find`, `contains`, `count`,
+ * `lower_bound`, `upper_bound`, `equal_range` and `erase` accept any key type it accepts.
+ *
+ * @code
+ * ChMap<uint64_t, Order> orders;
+ * orders.try_emplace(id, order);
+ * for (auto it = orders.lower_bound(from); it != orders.end() && it->first < to; ++it)
+ * {
+ *     process(it->second);
+ * }
+ * @endcode
+ *
+ * Inner nodes hold copies of some of the keys, so K must be copy constructible. Entries are moved within and between
+ * nodes, so K and V must be nothrow move constructible.
+ *
+ * @tparam K The type of the keys.
+ * @tparam V The type of the values.
+ * @tparam Compare The ordering of the keys.
+ * @tparam NodeBytes The approximate size of a node in bytes.
+ */
+template <typename K, typename V, typename Compare = std::less<>, size_t NodeBytes = 256>
 class ChMap
 {
+    static_assert(std::is_nothrow_move_constructible<K>::value && std::is_nothrow_move_constructible<V>::value,
+                  "ChMap needs nothrow move constructible keys and values");
+    static_assert(std::is_copy_constructible<K>::value, "ChMap needs copy constructible keys");
+
+    template <bool Const>
+    class Iterator;
+
+    template <typename C, typename = void>
+    struct IsTransparent : std::false_type
+    {
+    };
+
+    template <typename C>
+    struct IsTransparent<C, std::void_t<typename C::is_transparent>> : std::true_type
+    {
+    };
+
+    // Enables the heterogeneous overloads for key types other than K
+    template <typename Q>
+    using EnableIfTransparent = typename std::enable_if<IsTransparent<Compare>::value && !std::is_same<Q, K>::value>::type;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<const K, V>;
+    using key_compare = Compare;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    /**
+     * @brief The number of entries a leaf holds.
+     */
+    static constexpr size_t leafSlots = std::max<size_t>(4, (NodeBytes - 4 * sizeof(void *)) / sizeof(value_type));
+
+    /**
+     * @brief The number of keys an inner node holds. It has one child more than keys.
+     */
+    static constexpr size_t innerSlots = std::max<size_t>(4, (NodeBytes - 3 * sizeof(void *)) / (sizeof(K) + sizeof(void *)));
+
+    /**
+     * @brief Default constructor. Constructs an empty map that has not allocated any nodes.
+     */
     ChMap();
+
+    /**
+     * @brief Constructs an empty map that orders its keys with `compare`.
+     *
+     * @param compare The ordering of the keys.
+     */
+    explicit ChMap(const Compare &compare);
+
+    /**
+     * @brief Constructs the map with the given entries. Of entries with equal keys, the first one is kept.
+     *
+     * @param values The entries to initialize the map with.
+     */
+    ChMap(std::initializer_list<value_type> values);
+
+    /**
+     * @brief Copy constructor. Builds a tree of full nodes holding copies of the entries of `other`.
+     *
+     * @param other Another ChMap object to copy the entries from.
+     */
+    ChMap(const ChMap &other);
+
+    /**
+     * @brief Move constructor. Takes over the nodes of `other`.
+     *
+     * @param other Another ChMap object to move the entries from. `other` is left empty.
+     */
+    ChMap(ChMap &&other) noexcept;
+
+    /**
+     * @brief Destructor. Destroys the entries and frees the nodes.
+     */
     ~ChMap();
+
+    /**
+     * @brief Copy assignment operator. Replaces the contents of the map with a copy of the contents of `other`.
+     *
+     * @param other Another ChMap object to copy the entries from.
+     * @return *this
+     */
+    ChMap &operator=(const ChMap &other);
+
+    /**
+     * @brief Move assignment operator. Replaces the contents of the map with the contents of `other`.
+     *
+     * @param other Another ChMap object to move the entries from. `other` is left empty.
+     * @return *this
+     */
+    ChMap &operator=(ChMap &&other) noexcept;
+
+    /**
+     * @brief Returns an iterator to the entry with the smallest key.
+     */
+    iterator begin() noexcept;
+
+    /**
+     * @brief Returns a const iterator to the entry with the smallest key.
+     */
+    const_iterator begin() const noexcept;
+
+    /**
+     * @brief Returns an iterator past the entry with the largest key.
+     */
+    iterator end() noexcept;
+
+    /**
+     * @brief Returns a const iterator past the entry with the largest key.
+     */
+    const_iterator end() const noexcept;
+
+    /**
+     * @brief Returns a const iterator to the entry with the smallest key.
+     */
+    const_iterator cbegin() const noexcept;
+
+    /**
+     * @brief Returns a const iterator past the entry with the largest key.
+     */
+    const_iterator cend() const noexcept;
+
+    /**
+     * @brief Returns a reverse iterator to the entry with the largest key.
+     */
+    reverse_iterator rbegin() noexcept;
+
+    /**
+     * @brief Returns a const reverse iterator to the entry with the largest key.
+     */
+    const_reverse_iterator rbegin() const noexcept;
+
+    /**
+     * @brief Returns a reverse iterator past the entry with the smallest key.
+     */
+    reverse_iterator rend() noexcept;
+
+    /**
+     * @brief Returns a const reverse iterator past the entry with the smallest key.
+     */
+    const_reverse_iterator rend() const noexcept;
+
+    /**
+     * @brief Returns the number of entries in the map.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Checks whether the map is empty.
+     */
+    bool isEmpty() const noexcept;
+
+    /**
+     * @brief Returns the number of levels of the tree, 0 for a map without nodes.
+     */
+    size_t height() const noexcept;
+
+    /**
+     * @brief Returns an iterator to the entry with key `key`, or `end()` if there is none.
+     *
+     * @param key The key to search for.
+     */
+    iterator find(const K &key);
+
+    /**
+     * @brief Returns a const iterator to the entry with key `key`, or `end()` if there is none.
+     *
+     * @param key The key to search for.
+     */
+    const_iterator find(const K &key) const;
+
+    /**
+     * @brief Heterogeneous version of `find`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    iterator find(const Q &key);
+
+    /**
+     * @brief Heterogeneous version of `find`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    const_iterator find(const Q &key) const;
+
+    /**
+     * @brief Checks whether the map has an entry with key `key`.
+     *
+     * @param key The key to search for.
+     */
+    bool contains(const K &key) const;
+
+    /**
+     * @brief Heterogeneous version of `contains`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    bool contains(const Q &key) const;
+
+    /**
+     * @brief Returns the number of entries with key `key`, which is 0 or 1.
+     *
+     * @param key The key to search for.
+     */
+    size_t count(const K &key) const;
+
+    /**
+     * @brief Heterogeneous version of `count`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    size_t count(const Q &key) const;
+
+    /**
+     * @brief Returns an iterator to the first entry whose key is not less than `key`, or `end()` if there is none.
+     *
+     * @param key The key to compare with.
+     */
+    iterator lower_bound(const K &key);
+
+    /**
+     * @brief Returns a const iterator to the first entry whose key is not less than `key`, or `end()` if there is
+     * none.
+     *
+     * @param key The key to compare with.
+     */
+    const_iterator lower_bound(const K &key) const;
+
+    /**
+     * @brief Heterogeneous version of `lower_bound`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    iterator lower_bound(const Q &key);
+
+    /**
+     * @brief Heterogeneous version of `lower_bound`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    const_iterator lower_bound(const Q &key) const;
+
+    /**
+     * @brief Returns an iterator to the first entry whose key is greater than `key`, or `end()` if there is none.
+     *
+     * @param key The key to compare with.
+     */
+    iterator upper_bound(const K &key);
+
+    /**
+     * @brief Returns a const iterator to the first entry whose key is greater than `key`, or `end()` if there is
+     * none.
+     *
+     * @param key The key to compare with.
+     */
+    const_iterator upper_bound(const K &key) const;
+
+    /**
+     * @brief Heterogeneous version of `upper_bound`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    iterator upper_bound(const Q &key);
+
+    /**
+     * @brief Heterogeneous version of `upper_bound`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    const_iterator upper_bound(const Q &key) const;
+
+    /**
+     * @brief Returns the range of entries with key `key`, which is empty or holds one entry.
+     *
+     * @param key The key to search for.
+     */
+    std::pair<iterator, iterator> equal_range(const K &key);
+
+    /**
+     * @brief Returns the range of entries with key `key`, which is empty or holds one entry.
+     *
+     * @param key The key to search for.
+     */
+    std::pair<const_iterator, const_iterator> equal_range(const K &key) const;
+
+    /**
+     * @brief Heterogeneous version of `equal_range`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    std::pair<iterator, iterator> equal_range(const Q &key);
+
+    /**
+     * @brief Heterogeneous version of `equal_range`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    std::pair<const_iterator, const_iterator> equal_range(const Q &key) const;
+
+    /**
+     * @brief Returns a reference to the value with key `key`.
+     *
+     * @param key The key to search for.
+     * @throws std::out_of_range if the map has no entry with key `key`.
+     */
+    V &at(const K &key);
+
+    /**
+     * @brief Returns a const reference to the value with key `key`.
+     *
+     * @param key The key to search for.
+     * @throws std::out_of_range if the map has no entry with key `key`.
+     */
+    const V &at(const K &key) const;
+
+    /**
+     * @brief Returns a reference to the value with key `key`, inserting a value-initialized one if there is none.
+     *
+     * @param key The key of the value.
+     */
+    V &operator[](const K &key);
+
+    /**
+     * @brief Returns a reference to the value with key `key`, inserting a value-initialized one if there is none.
+     *
+     * @param key The key of the value. It is moved from only if it is inserted.
+     */
+    V &operator[](K &&key);
+
+    /**
+     * @brief Inserts a copy of `value` unless the map already has an entry with its key.
+     *
+     * @param value The entry to insert.
+     * @return An iterator to the entry with the key, and whether it was inserted.
+     */
+    std::pair<iterator, bool> insert(const value_type &value);
+
+    /**
+     * @brief Moves `value` into the map unless the map already has an entry with its key.
+     *
+     * @param value The entry to insert.
+     * @return An iterator to the entry with the key, and whether it was inserted.
+     */
+    std::pair<iterator, bool> insert(value_type &&value);
+
+    /**
+     * @brief Inserts the entries in the range [first, last). Of entries with equal keys, the first one is kept.
+     *
+     * @param first Iterator to the first entry to insert.
+     * @param last Iterator past the last entry to insert.
+     */
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last);
+
+    /**
+     * @brief Inserts `value` with key `key`, or assigns it to the existing entry with that key.
+     *
+     * @param key The key of the entry.
+     * @param value The value to insert or assign.
+     * @return An iterator to the entry with the key, and whether it was inserted.
+     */
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const K &key, M &&value);
+
+    /**
+     * @brief Inserts `value` with key `key`, or assigns it to the existing entry with that key.
+     *
+     * @param key The key of the entry. It is moved from only if it is inserted.
+     * @param value The value to insert or assign.
+     * @return An iterator to the entry with the key, and whether it was inserted.
+     */
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(K &&key, M &&value);
+
+    /**
+     * @brief Constructs an entry from `args` and inserts it unless the map already has an entry with its key.
+     *
+     * The entry is constructed before the lookup; `try_emplace` avoids that when the key is at hand.
+     *
+     * @param args The arguments to construct the entry from.
+     * @return An iterator to the entry with the key, and whether it was inserted.
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args &&...args);
+
+    /**
+     * @brief Inserts an entry with key `key` and a value constructed from `args`, unless the map already has an
+     * entry with that key, in which case nothing is constructed.
+     *
+     * @param key The key of the entry.
+     * @param args The arguments to construct the value from.
+     * @return An iterator to the entry with the key, and whether it was inserted.
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const K &key, Args &&...args);
+
+    /**
+     * @brief Inserts an entry with key `key` and a value constructed from `args`, unless the map already has an
+     * entry with that key, in which case nothing is constructed and `key` is not moved from.
+     *
+     * @param key The key of the entry.
+     * @param args The arguments to construct the value from.
+     * @return An iterator to the entry with the key, and whether it was inserted.
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&...args);
+
+    /**
+     * @brief Replaces the contents of the map with the entries in the range [first, last), whose keys must be in
+     * strictly increasing order.
+     *
+     * The entries are appended one after the other without any searching, which fills every node but the last one
+     * on each level, so building a map from n sorted entries takes O(n) time. If the keys are out of order, the map
+     * keeps its old contents.
+     *
+     * @param first Iterator to the first entry.
+     * @param last Iterator past the last entry.
+     * @throws std::invalid_argument if a key is not greater than the one before it.
+     */
+    template <typename InputIt>
+    void assignSorted(InputIt first, InputIt last);
+
+    /**
+     * @brief Removes the entry at `pos`.
+     *
+     * @param pos Iterator to the entry to remove.
+     * @return Iterator to the entry that followed the removed one.
+     */
+    iterator erase(const_iterator pos);
+
+    /**
+     * @brief Removes the entry at `pos`.
+     *
+     * @param pos Iterator to the entry to remove.
+     * @return Iterator to the entry that followed the removed one.
+     */
+    iterator erase(iterator pos);
+
+    /**
+     * @brief Removes the entries in the range [first, last).
+     *
+     * @param first Iterator to the first entry to remove.
+     * @param last Iterator past the last entry to remove.
+     * @return Iterator to the entry that followed the removed ones.
+     */
+    iterator erase(const_iterator first, const_iterator last);
+
+    /**
+     * @brief Removes the entry with key `key`, if there is one.
+     *
+     * @param key The key of the entry to remove.
+     * @return The number of entries removed, which is 0 or 1.
+     */
+    size_t erase(const K &key);
+
+    /**
+     * @brief Heterogeneous version of `erase`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    size_t erase(const Q &key);
+
+    /**
+     * @brief Removes every entry for which `pred(entry)` returns true.
+     *
+     * @param pred The predicate, called once with a const reference to each entry, in key order.
+     * @return The number of entries removed.
+     */
+    template <typename Pred>
+    size_t eraseIf(Pred pred);
+
+    /**
+     * @brief Removes all entries from the map and frees the nodes.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Exchanges the contents of the map with those of `other`.
+     *
+     * @param other The map to exchange the contents with.
+     */
+    void swap(ChMap &other) noexcept;
+
+    /**
+     * @brief Returns the ordering of the keys.
+     */
+    Compare key_comp() const;
+
+private:
+    struct Inner;
+
+    // The header shared by both kinds of nodes
+    struct Node
+    {
+        Inner *parent;
+        uint16_t position; // Index of the node among the children of its parent
+        uint16_t count;    // Number of entries of a leaf, or of keys of an inner node
+        bool leaf;
+    };
+
+    struct Leaf : Node
+    {
+        Leaf *previous;
+        Leaf *next;
+        alignas(value_type) unsigned char storage[leafSlots * sizeof(value_type)];
+
+        value_type *entries() noexcept
+        {
+            return reinterpret_cast<value_type *>(storage);
+        }
+    };
+
+    // Child i holds the keys that are not less than key i - 1 and less than key i
+    struct Inner : Node
+    {
+        Node *children[innerSlots + 1];
+        alignas(K) unsigned char storage[innerSlots * sizeof(K)];
+
+        K *keys() noexcept
+        {
+            return reinterpret_cast<K *>(storage);
+        }
+    };
+
+    static_assert(leafSlots <= UINT16_MAX && innerSlots < UINT16_MAX, "ChMap nodes are too large");
+
+    // Bounds the height of any tree that fits into memory, since every inner node but the root has two children
+    static const size_t maxHeight = 64;
+
+    template <bool OrEqual, typename T, typename KeyOf, typename Q>
+    size_t rank(const T *items, size_t count, KeyOf keyOf, const Q &key) const;
+
+    template <typename Q>
+    Leaf *findLeaf(const Q &key) const;
+
+    template <typename Q>
+    size_t lowerIndex(Leaf *leaf, const Q &key) const;
+
+    template <typename Q>
+    size_t upperIndex(Leaf *leaf, const Q &key) const;
+
+    template <typename Q>
+    iterator findKey(const Q &key) const;
+
+    template <typename Q>
+    iterator lowerBound(const Q &key) const;
+
+    template <typename Q>
+    iterator upperBound(const Q &key) const;
+
+    iterator makeIterator(Leaf *leaf, size_t index) const noexcept;
+
+    template <typename Construct>
+    std::pair<iterator, bool> insertUnique(const K &key, Construct construct);
+
+    template <typename Entry>
+    void append(Entry &&entry);
+
+    std::pair<Leaf *, size_t> splitLeaf(Leaf *leaf, size_t index, const K &key);
+
+    void insertIntoParent(Node *left, K &&separator, Node *right, Inner **spares, size_t &spareCount) noexcept;
+
+    static void insertChild(Inner *node, size_t index, K &&separator, Node *child) noexcept;
+
+    static void removeChild(Inner *node, size_t index) noexcept;
+
+    static bool isRightmost(const Node *node) noexcept;
+
+    iterator eraseAt(Leaf *leaf, size_t index) noexcept;
+
+    void mergeLeaves(Leaf *left, Leaf *right) noexcept;
+
+    void mergeInners(Inner *left, Inner *right) noexcept;
+
+    void borrowFromLeft(Inner *left, Inner *node) noexcept;
+
+    void borrowFromRight(Inner *node, Inner *right) noexcept;
+
+    void rebalance(Inner *node) noexcept;
+
+    static void relocate(value_type *from, value_type *to) noexcept;
+
+    static void relocate(K *from, K *to) noexcept;
+
+    template <typename T>
+    static void moveRange(T *first, size_t count, T *to) noexcept;
+
+    static Leaf *newLeaf();
+
+    static Inner *newInner();
+
+    static void destroy(Node *node) noexcept;
+
+    Node *root_;
+    Leaf *first_;
+    Leaf *last_;
+    size_t size_;
+    size_t height_;
+    Compare compare_;
 };
 
+/**
+ * @brief Bidirectional iterator over the entries of a ChMap in key order.
+ *
+ * An iterator is a leaf and an index into it. The end iterator points just past the last entry of the last leaf, so
+ * that it can be decremented like any other.
+ */
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+template <bool Const>
+class ChMap<K, V, Compare, NodeBytes>::Iterator
+{
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = ChMap::value_type;
+    using reference = typename std::conditional<Const, const value_type &, value_type &>::type;
+    using pointer = typename std::conditional<Const, const value_type *, value_type *>::type;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() : leaf_(nullptr), index_(0) {}
+
+    Iterator(Leaf *leaf, size_t index) : leaf_(leaf), index_(index) {}
+
+    template <bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+    Iterator(const Iterator<OtherConst> &other) : leaf_(other.leaf_), index_(other.index_) {}
+
+    reference operator*() const
+    {
+        return leaf_->entries()[index_];
+    }
+
+    pointer operator->() const
+    {
+        return leaf_->entries() + index_;
+    }
+
+    Iterator &operator++()
+    {
+        if (++index_ == leaf_->count && leaf_->next != nullptr)
+        {
+            leaf_ = leaf_->next;
+            index_ = 0;
+        }
+        return *this;
+    }
+
+    Iterator operator++(int)
+    {
+        Iterator previous = *this;
+        ++*this;
+        return previous;
+    }
+
+    Iterator &operator--()
+    {
+        if (index_ == 0)
+        {
+            leaf_ = leaf_->previous;
+            index_ = leaf_->count;
+        }
+        --index_;
+        return *this;
+    }
+
+    Iterator operator--(int)
+    {
+        Iterator next = *this;
+        --*this;
+        return next;
+    }
+
+    bool operator==(const Iterator &other) const
+    {
+        return leaf_ == other.leaf_ && index_ == other.index_;
+    }
+
+    bool operator!=(const Iterator &other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    template <bool>
+    friend class Iterator;
+
+    friend class ChMap;
+
+    Leaf *leaf_;
+    size_t index_;
+};
+
+/**
+ * @brief Checks whether two maps have the same keys with equal values.
+ */
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+bool operator==(const ChMap<K, V, Compare, NodeBytes> &a, const ChMap<K, V, Compare, NodeBytes> &b);
+
+/**
+ * @brief Checks whether two maps differ in a key or a value.
+ */
+template <typename K, typename V, typename Compare, size_t NodeBytes>
+bool operator!=(const ChMap<K, V, Compare, NodeBytes> &a, const ChMap<K, V, Compare, NodeBytes> &b);
+
 #endif
\ No newline at end of file
@@ -1,9 +1,757 @@
 #include "ChSet.h"
+#include "ChBits.h"
+#include <algorithm>
+#include <stdexcept>
 
-ChSet::ChSet()
+template <typename T, typename Compare>
+ChSet<T, Compare>::ChSet() {}
+
+template <typename T, typename Compare>
+ChSet<T, Compare>::ChSet(const Compare &compare) : compare_(compare) {}
+
+template <typename T, typename Compare>
+ChSet<T, Compare>::ChSet(std::initializer_list<T> values, const Compare &compare) : compare_(compare)
+{
+    ChVector<T> elements;
+    elements.assign(values.begin(), values.end());
+    assignValues(std::move(elements));
+}
+
+template <typename T, typename Compare>
+ChSet<T, Compare>::ChSet(ChVector<T> values, const Compare &compare) : compare_(compare)
+{
+    assignValues(std::move(values));
+}
+
+template <typename T, typename Compare>
+template <typename InputIt>
+ChSet<T, Compare>::ChSet(InputIt first, InputIt last, const Compare &compare) : compare_(compare)
+{
+    ChVector<T> elements;
+    for (; first != last; ++first)
+    {
+        elements.push_back(*first);
+    }
+    assignValues(std::move(elements));
+}
+
+template <typename T, typename Compare>
+void ChSet<T, Compare>::assignSorted(ChVector<T> values)
+{
+    for (size_t i = 1; i < values.size(); ++i)
+    {
+        if (!compare_(values[i - 1], values[i]))
+        {
+            throw std::invalid_argument("ChSet::assignSorted: values are not in strictly increasing order");
+        }
+    }
+    build(std::move(values));
+}
+
+template <typename T, typename Compare>
+typename ChSet<T, Compare>::const_iterator ChSet<T, Compare>::begin() const noexcept
+{
+    return elements_.data();
+}
+
+template <typename T, typename Compare>
+typename ChSet<T, Compare>::const_iterator ChSet<T, Compare>::end() const noexcept
+{
+    return elements_.data() + elements_.size();
+}
+
+template <typename T, typename Compare>
+typename ChSet<T, Compare>::const_iterator ChSet<T, Compare>::cbegin() const noexcept
 {
+    return begin();
 }
 
-ChSet::~ChSet()
+template <typename T, typename Compare>
+typename ChSet<T, Compare>::const_iterator ChSet<T, Compare>::cend() const noexcept
 {
+    return end();
 }
+
+template <typename T, typename Compare>
+typename ChSet<T, Compare>::const_reverse_iterator ChSet<T, Compare>::rbegin() const noexcept
+{
+    return const_reverse_iterator(end());
+}
+
+template <typename T, typename Compare>
+typename ChSet<T, Compare>::const_reverse_iterator ChSet<T, Compare>::rend() const noexcept
+{
+    return const_reverse_iterator(begin());
+}
+
+template <typename T, typename Compare>
+size_t ChSet<T, Compare>::size() const noexcept
+{
+    return elements_.size();
+}
+
+template <typename T, typename Compare>
+bool ChSet<T, Compare>::isEmpty() const noexcept
+{
+    return elements_.isEmpty();
+}
+
+template <typename T, typename Compare>
+const T &ChSet<T, Compare>::operator[](size_t index) const
+{
+    return elements_[index];
+}
+
+template <typename T, typename Compare>
+const ChVector<T> &ChSet<T, Compare>::values() const noexcept
+{
+    return elements_;
+}
+
+template <typename T, typename Compare>
+bool ChSet<T, Compare>::contains(const T &value) const
+{
+    return containsKey(value);
+}
+
+template <typename T, typename Compare>
+template <typename Q, typename>
+bool ChSet<T, Compare>::contains(const Q &value) const
+{
+    return containsKey(value);
+}
+
+template <typename T, typename Compare>
+size_t ChSet<T, Compare>::count(const T &value) const
+{
+    return containsKey(value) ? 1 : 0;
+}
+
+template <typename T, typename Compare>
+template <typename Q, typename>
+size_t ChSet<T, Compare>::count(const Q &value) const
+{
+    return containsKey(value) ? 1 : 0;
+}
+
+template <typename T, typename Compare>
+typename ChSet<T, Compare>::const_iterator ChSet<T, Compare>::find(const T &value) const
+{
+    return findKey(value);
+}
+
+template <typename T, typename Compare>
+template <typename Q, typename>
+typename ChSet<T, Compare>::const_iterator ChSet<T, Compare>::find(const Q &value) const
+{
+    return findKey(value);
+}
+
+template <typename T, typename Compare>
+typename ChSet<T, Compare>::const_iterator ChSet<T, Compare>::lower_bound(const T &value) const
+{
+    return lowerBound(elements_.data(), elements_.size(), value);
+}
+
+template <typename T, typename Compare>
+template <typename Q, typename>
+typename ChSet<T, Compare>::const_iterator ChSet<T, Compare>::lower_bound(const Q &value) const
+{
+    return lowerBound(elements_.data(), elements_.size(), value);
+}
+
+template <typename T, typename Compare>
+typename ChSet<T, Compare>::const_iterator ChSet<T, Compare>::upper_bound(const T &value) const
+{
+    return upperBound(elements_.data(), elements_.size(), value);
+}
+
+template <typename T, typename Compare>
+template <typename Q, typename>
+typename ChSet<T, Compare>::const_iterator ChSet<T, Compare>::upper_bound(const Q &value) const
+{
+    return upperBound(elements_.data(), elements_.size(), value);
+}
+
+template <typename T, typename Compare>
+std::pair<typename ChSet<T, Compare>::const_iterator, bool> ChSet<T, Compare>::insert(const T &value)
+{
+    return insert(T(value));
+}
+
+template <typename T, typename Compare>
+std::pair<typename ChSet<T, Compare>::const_iterator, bool> ChSet<T, Compare>::insert(T &&value)
+{
+    const T *position = lowerBound(elements_.data(), elements_.size(), value);
+    if (position != end() && !compare_(value, *position))
+    {
+        return {position, false};
+    }
+    const size_t index = static_cast<size_t>(position - elements_.data());
+    if constexpr (usesEytzinger)
+    {
+        // Reserving first leaves nothing that can throw after the element is inserted
+        if (elements_.size() + 1 >= eytzingerMinimumSize)
+        {
+            eytzinger_.reserve(elements_.size() + 1);
+        }
+    }
+    elements_.insert(elements_.cbegin() + index, std::move(value));
+    refreshEytzinger();
+    return {elements_.data() + index, true};
+}
+
+template <typename T, typename Compare>
+template <typename InputIt>
+void ChSet<T, Compare>::insert(InputIt first, InputIt last)
+{
+    ChSet added(first, last, compare_);
+    if (!added.isEmpty())
+    {
+        *this = setUnion(added);
+    }
+}
+
+template <typename T, typename Compare>
+size_t ChSet<T, Compare>::erase(const T &value)
+{
+    const_iterator position = findKey(value);
+    if (position == end())
+    {
+        return 0;
+    }
+    erase(position);
+    return 1;
+}
+
+template <typename T, typename Compare>
+typename ChSet<T, Compare>::const_iterator ChSet<T, Compare>::erase(const_iterator pos)
+{
+    const size_t index = static_cast<size_t>(pos - elements_.data());
+    elements_.erase(elements_.cbegin() + index);
+    refreshEytzinger();
+    return elements_.data() + index;
+}
+
+template <typename T, typename Compare>
+void ChSet<T, Compare>::clear() noexcept
+{
+    elements_.clear();
+    eytzinger_.clear();
+}
+
+template <typename T, typename Compare>
+void ChSet<T, Compare>::swap(ChSet &other) noexcept
+{
+    using std::swap;
+    elements_.swap(other.elements_);
+    eytzinger_.swap(other.eytzinger_);
+    swap(compare_, other.compare_);
+}
+
+template <typename T, typename Compare>
+Compare ChSet<T, Compare>::key_comp() const
+{
+    return compare_;
+}
+
+template <typename T, typename Compare>
+ChSet<T, Compare> ChSet<T, Compare>::setUnion(const ChSet &other) const
+{
+    const T *a = elements_.data();
+    const T *b = other.elements_.data();
+    const size_t aCount = elements_.size();
+    const size_t bCount = other.elements_.size();
+    ChVector<T> result;
+    if (aCount * skewRatio < bCount || bCount * skewRatio < aCount)
+    {
+        // Copy the runs of the large set between the elements of the small one as a whole
+        const bool smallIsThis = aCount < bCount;
+        const T *small = smallIsThis ? a : b;
+        const T *large = smallIsThis ? b : a;
+        const size_t smallCount = smallIsThis ? aCount : bCount;
+        const T *largeEnd = large + (smallIsThis ? bCount : aCount);
+        std::vector<T> &elements = result;
+        elements.reserve(aCount + bCount);
+        for (size_t i = 0; i < smallCount; ++i)
+        {
+            const T *next = lowerBound(large, static_cast<size_t>(largeEnd - large), small[i]);
+            elements.insert(elements.end(), large, next);
+            const bool equivalent = next != largeEnd && !compare_(small[i], *next);
+            elements.push_back(equivalent && !smallIsThis ? *next : small[i]);
+            large = equivalent ? next + 1 : next;
+        }
+        elements.insert(elements.end(), large, largeEnd);
+    }
+    else if constexpr (usesBranchFreeMerge)
+    {
+        result.resize(aCount + bCount);
+        result.resize(uniteMerge(a, aCount, b, bCount, result.data()));
+    }
+    else
+    {
+        std::vector<T> &elements = result;
+        elements.reserve(aCount + bCount);
+        std::set_union(a, a + aCount, b, b + bCount, std::back_inserter(elements), compare_);
+    }
+    return fromSorted(std::move(result));
+}
+
+template <typename T, typename Compare>
+ChSet<T, Compare> ChSet<T, Compare>::setIntersection(const ChSet &other) const
+{
+    ChVector<T> result;
+    intersect<true>(other, &result);
+    return fromSorted(std::move(result));
+}
+
+template <typename T, typename Compare>
+ChSet<T, Compare> ChSet<T, Compare>::setDifference(const ChSet &other) const
+{
+    const T *a = elements_.data();
+    const T *b = other.elements_.data();
+    const size_t aCount = elements_.size();
+    const size_t bCount = other.elements_.size();
+    ChVector<T> result;
+    if (aCount * skewRatio < bCount)
+    {
+        // Few elements to keep or drop: look each one up in the other set
+        result.reserve(aCount);
+        const T *position = b;
+        for (size_t i = 0; i < aCount; ++i)
+        {
+            position = lowerBound(position, static_cast<size_t>(b + bCount - position), a[i]);
+            if (position == b + bCount || compare_(a[i], *position))
+            {
+                result.push_back(a[i]);
+            }
+        }
+    }
+    else if constexpr (usesBranchFreeMerge)
+    {
+        result.resize(aCount);
+        result.resize(subtractMerge(a, aCount, b, bCount, result.data()));
+    }
+    else
+    {
+        std::vector<T> &elements = result;
+        std::set_difference(a, a + aCount, b, b + bCount, std::back_inserter(elements), compare_);
+    }
+    return fromSorted(std::move(result));
+}
+
+template <typename T, typename Compare>
+size_t ChSet<T, Compare>::intersectionSize(const ChSet &other) const
+{
+    return intersect<false>(other, nullptr);
+}
+
+template <typename T, typename Compare>
+bool ChSet<T, Compare>::intersects(const ChSet &other) const
+{
+    const T *a = elements_.data();
+    const T *b = other.elements_.data();
+    size_t aCount = elements_.size();
+    size_t bCount = other.elements_.size();
+    if (aCount > bCount)
+    {
+        std::swap(a, b);
+        std::swap(aCount, bCount);
+    }
+    if (aCount * skewRatio < bCount)
+    {
+        const T *position = b;
+        for (size_t i = 0; i < aCount; ++i)
+        {
+            position = lowerBound(position, static_cast<size_t>(b + bCount - position), a[i]);
+            if (position == b + bCount)
+            {
+                return false;
+            }
+            if (!compare_(a[i], *position))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    size_t i = 0;
+    size_t j = 0;
+    while (i < aCount && j < bCount)
+    {
+        if (compare_(a[i], b[j]))
+        {
+            ++i;
+        }
+        else if (compare_(b[j], a[i]))
+        {
+            ++j;
+        }
+        else
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T, typename Compare>
+void ChSet<T, Compare>::assignValues(ChVector<T> &&values)
+{
+    T *first = values.data();
+    T *last = first + values.size();
+    if (!std::is_sorted(first, last, compare_))
+    {
+        // Stable, so that the first of equivalent elements stays in front and survives the removal of duplicates
+        std::stable_sort(first, last, compare_);
+    }
+    T *unique = std::unique(first, last, [this](const T &previous, const T &next) { return !compare_(previous, next); });
+    values.erase(values.cbegin() + (unique - first), values.cend());
+    build(std::move(values));
+}
+
+template <typename T, typename Compare>
+void ChSet<T, Compare>::build(ChVector<T> &&sorted)
+{
+    if constexpr (usesEytzinger)
+    {
+        if (sorted.size() >= eytzingerMinimumSize)
+        {
+            eytzinger_.reserve(sorted.size());
+        }
+    }
+    elements_.swap(sorted);
+    refreshEytzinger();
+}
+
+template <typename T, typename Compare>
+void ChSet<T, Compare>::refreshEytzinger() noexcept
+{
+    if constexpr (usesEytzinger)
+    {
+        if (elements_.size() < eytzingerMinimumSize)
+        {
+            eytzinger_.clear();
+            return;
+        }
+        // The capacity has been reserved beforehand, so resizing does not allocate
+        eytzinger_.resize(elements_.size());
+        fillEytzinger(elements_.data(), elements_.size(), eytzinger_.data(), 0, 1);
+    }
+}
+
+template <typename T, typename Compare>
+size_t ChSet<T, Compare>::fillEytzinger(const T *sorted, size_t count, T *out, size_t sortedIndex, size_t node) noexcept
+{
+    // An in-order walk of the implicit tree in which node k has the children 2k and 2k + 1 visits the nodes in
+    // increasing order of their elements
+    if (node <= count)
+    {
+        sortedIndex = fillEytzinger(sorted, count, out, sortedIndex, 2 * node);
+        out[node - 1] = sorted[sortedIndex++];
+        sortedIndex = fillEytzinger(sorted, count, out, sortedIndex, 2 * node + 1);
+    }
+    return sortedIndex;
+}
+
+template <typename T, typename Compare>
+template <typename Q>
+bool ChSet<T, Compare>::containsKey(const Q &value) const
+{
+    if constexpr (usesEytzinger)
+    {
+        if (!eytzinger_.isEmpty())
+        {
+            // The 16 descendants four levels below node k are the nodes 16k to 16k + 15, which share a cache line
+            // for 4 byte elements. Larger elements prefetch fewer levels ahead.
+            constexpr size_t prefetchStride = sizeof(T) >= 64 ? 1 : 64 / sizeof(T);
+            const T *nodes = eytzinger_.data();
+            const size_t count = eytzinger_.size();
+            // Every path passes through all complete levels, so that loop runs a fixed number of times and its exit
+            // is predicted correctly. A path that would end above the incomplete last level takes a right step there
+            // instead, which the shift below drops again.
+            const unsigned completeLevels = ChBits::highestSetBit(static_cast<uint64_t>(count + 1));
+            size_t node = 1;
+            for (unsigned level = 0; level < completeLevels; ++level)
+            {
+                prefetch(nodes + std::min(node * prefetchStride, count) - 1);
+                node = 2 * node + static_cast<size_t>(compare_(nodes[node - 1], value));
+            }
+            if (count + 1 != (size_t(1) << completeLevels))
+            {
+                const bool inside = node <= count;
+                node = 2 * node + static_cast<size_t>(compare_(nodes[std::min(node, count) - 1], value) || !inside);
+            }
+            // The path ends with a step to the left child at the lower bound, followed by steps to the right only:
+            // dropping those and that one step leaves the node of the lower bound, or 0 if there is none
+            node >>= ChBits::countTrailingZeros(~static_cast<uint64_t>(node)) + 1;
+            return node != 0 && !compare_(value, nodes[node - 1]);
+        }
+    }
+    const T *position = lowerBound(elements_.data(), elements_.size(), value);
+    return position != end() && !compare_(value, *position);
+}
+
+template <typename T, typename Compare>
+template <typename Q>
+const T *ChSet<T, Compare>::lowerBound(const T *first, size_t count, const Q &value) const
+{
+    if (count == 0)
+    {
+        return first;
+    }
+    // The lower bound is always within [first, first + count]; every step drops the half that cannot hold it with a
+    // conditional move instead of a branch
+    while (count > 1)
+    {
+        const size_t half = count / 2;
+        first = compare_(first[half], value) ? first + half : first;
+        count -= half;
+    }
+    return first + static_cast<size_t>(compare_(*first, value));
+}
+
+template <typename T, typename Compare>
+template <typename Q>
+const T *ChSet<T, Compare>::upperBound(const T *first, size_t count, const Q &value) const
+{
+    if (count == 0)
+    {
+        return first;
+    }
+    while (count > 1)
+    {
+        const size_t half = count / 2;
+        first = compare_(value, first[half]) ? first : first + half;
+        count -= half;
+    }
+    return first + static_cast<size_t>(!compare_(value, *first));
+}
+
+template <typename T, typename Compare>
+template <typename Q>
+typename ChSet<T, Compare>::const_iterator ChSet<T, Compare>::findKey(const Q &value) const
+{
+    const T *position = lowerBound(elements_.data(), elements_.size(), value);
+    return (position != end() && !compare_(value, *position)) ? position : end();
+}
+
+template <typename T, typename Compare>
+template <bool Write>
+size_t ChSet<T, Compare>::intersect(const ChSet &other, ChVector<T> *out) const
+{
+    const T *a = elements_.data();
+    const T *b = other.elements_.data();
+    const size_t aCount = elements_.size();
+    const size_t bCount = other.elements_.size();
+    if (aCount == 0 || bCount == 0)
+    {
+        return 0;
+    }
+    if (bCount * skewRatio < aCount)
+    {
+        return intersectSkewed<Write>(b, bCount, a, aCount, false, out);
+    }
+    if (aCount * skewRatio < bCount)
+    {
+        return intersectSkewed<Write>(a, aCount, b, bCount, true, out);
+    }
+    if constexpr (usesBranchFreeMerge)
+    {
+        if constexpr (Write)
+        {
+            out->resize(std::min(aCount, bCount) + 4);
+            const size_t count = intersectMerge<true>(a, aCount, b, bCount, out->data());
+            out->resize(count);
+            return count;
+        }
+        else
+        {
+            return intersectMerge<false>(a, aCount, b, bCount, nullptr);
+        }
+    }
+    else
+    {
+        size_t i = 0;
+        size_t j = 0;
+        size_t count = 0;
+        while (i < aCount && j < bCount)
+        {
+            if (compare_(a[i], b[j]))
+            {
+                ++i;
+            }
+            else if (compare_(b[j], a[i]))
+            {
+                ++j;
+            }
+            else
+            {
+                if constexpr (Write)
+                {
+                    out->push_back(a[i]);
+                }
+                ++count;
+                ++i;
+                ++j;
+            }
+        }
+        return count;
+    }
+}
+
+template <typename T, typename Compare>
+template <bool Write>
+size_t ChSet<T, Compare>::intersectSkewed(const T *small, size_t smallCount, const T *large, size_t largeCount, bool keepSmall, ChVector<T> *out) const
+{
+    if constexpr (Write)
+    {
+        out->reserve(smallCount);
+    }
+    size_t count = 0;
+    const T *position = large;
+    const T *largeEnd = large + largeCount;
+    for (size_t i = 0; i < smallCount; ++i)
+    {
+        // The elements of the small set are increasing, so every search starts where the previous one ended
+        position = lowerBound(position, static_cast<size_t>(largeEnd - position), small[i]);
+        if (position == largeEnd)
+        {
+            break;
+        }
+        if (!compare_(small[i], *position))
+        {
+            if constexpr (Write)
+            {
+                out->push_back(keepSmall ? small[i] : *position);
+            }
+            ++count;
+            ++position;
+        }
+    }
+    return count;
+}
+
+template <typename T, typename Compare>
+template <bool Write>
+size_t ChSet<T, Compare>::intersectMerge(const T *a, size_t aCount, const T *b, size_t bCount, T *out)
+{
+    // Every step writes its candidate to the next free slot and only moves past it on a match. A block step writes
+    // four candidates at once, so `out` needs room for min(aCount, bCount) + 4 elements.
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+#ifdef CHSET_USE_SSE2
+    if constexpr (std::is_integral<T>::value && sizeof(T) == 4)
+    {
+        // Compares four elements of each set against all four rotations of the other block. Elements are unique
+        // within a set, so every element of a block matches at most once. The block with the smaller last element
+        // cannot match anything further on and is skipped, or both when their last elements are equal.
+        while (i + 4 <= aCount && j + 4 <= bCount)
+        {
+            const __m128i blockA = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+            const __m128i blockB = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j));
+            const __m128i equal = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi32(blockA, blockB), _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(0, 3, 2, 1)))),
+                _mm_or_si128(_mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(1, 0, 3, 2))),
+                             _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(2, 1, 0, 3)))));
+            const unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(equal)));
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                if constexpr (Write)
+                {
+                    out[count] = a[i + lane];
+                }
+                count += (mask >> lane) & 1;
+            }
+            const T lastA = a[i + 3];
+            const T lastB = b[j + 3];
+            i += static_cast<size_t>(lastA <= lastB) * 4;
+            j += static_cast<size_t>(lastB <= lastA) * 4;
+        }
+    }
+#endif
+    while (i < aCount && j < bCount)
+    {
+        const T x = a[i];
+        const T y = b[j];
+        if constexpr (Write)
+        {
+            out[count] = x;
+        }
+        count += static_cast<size_t>(x == y);
+        i += static_cast<size_t>(!(y < x));
+        j += static_cast<size_t>(!(x < y));
+    }
+    return count;
+}
+
+template <typename T, typename Compare>
+size_t ChSet<T, Compare>::uniteMerge(const T *a, size_t aCount, const T *b, size_t bCount, T *out)
+{
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+    while (i < aCount && j < bCount)
+    {
+        const T x = a[i];
+        const T y = b[j];
+        const bool takeA = !(y < x);
+        out[count++] = takeA ? x : y;
+        i += static_cast<size_t>(takeA);
+        j += static_cast<size_t>(!(x < y));
+    }
+    T *next = std::copy(a + i, a + aCount, out + count);
+    next = std::copy(b + j, b + bCount, next);
+    return static_cast<size_t>(next - out);
+}
+
+template <typename T, typename Compare>
+size_t ChSet<T, Compare>::subtractMerge(const T *a, size_t aCount, const T *b, size_t bCount, T *out)
+{
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+    while (i < aCount && j < bCount)
+    {
+        const T x = a[i];
+        const T y = b[j];
+        out[count] = x;
+        count += static_cast<size_t>(x < y);
+        i += static_cast<size_t>(!(y < x));
+        j += static_cast<size_t>(!(x < y));
+    }
+    return static_cast<size_t>(std::copy(a + i, a + aCount, out + count) - out);
+}
+
+template <typename T, typename Compare>
+ChSet<T, Compare> ChSet<T, Compare>::fromSorted(ChVector<T> &&sorted) const
+{
+    ChSet result(compare_);
+    result.build(std::move(sorted));
+    return result;
+}
+
+template <typename T, typename Compare>
+void ChSet<T, Compare>::prefetch(const void *address)
+{
+#if defined(CHSET_USE_SSE2)
+    _mm_prefetch(static_cast<const char *>(address), _MM_HINT_T0);
+#elif defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+template <typename T, typename Compare>
+bool operator==(const ChSet<T, Compare> &lhs, const ChSet<T, Compare> &rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T, typename Compare>
+bool operator!=(const ChSet<T, Compare> &lhs, const ChSet<T, Compare> &rhs)
+{
+    return !(lhs == rhs);
+}
\ No newline at end of file
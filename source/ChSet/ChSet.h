@@ -1,10 +1,430 @@
 #ifndef CHSET
 #define CHSET
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "ChVector.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CHSET_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief An ordered set of unique elements of type T, stored as a sorted contiguous array.
+ *
+ * ChSet is meant for sets that are built once, or rarely, and then queried heavily. The elements sit next to each
+ * other in one ChVector, so iterating over the set reads memory sequentially, and the set algebra (`setUnion`,
+ * `setIntersection`, `setDifference`, `intersectionSize`) runs as a linear merge of two arrays:
+ *
+ * - For arithmetic elements ordered by std::less, the merges are branch-free: every step writes its candidate and
+ *   advances the positions by the results of the comparisons, so the cost does not depend on how the two sets
+ *   interleave.
+ * - The intersection of sets of 32-bit integers compares blocks of four elements of each set against each other with
+ *   SSE2, where it is available.
+ * - When one set is more than 32 times larger than the other, the elements of the smaller one are searched for in the
+ *   larger one instead, and a union copies the runs of the larger set between them as a whole. An intersection then
+ *   costs O(small * log(large)).
+ *
+ * Building a set from a ChVector takes linear time if the elements are already sorted, and O(n log n) otherwise.
+ * Inserting or erasing a single element moves the elements after it and takes linear time, so build larger sets with
+ * the range constructor, `insert(first, last)` or `assignSorted`.
+ *
+ * Sets of more than 4 MiB of elements that are trivially copyable and default constructible also keep a second copy of
+ * the elements in Eytzinger (breadth first) order, in which the elements a lookup compares against next are close to
+ * each other in memory. `contains` and `count` search that copy without branches and prefetch the cache line that the
+ * lookup needs four steps later, so a lookup in a set larger than the caches waits for memory far less often than a
+ * binary search does. The copy doubles the memory of such sets. Smaller sets, and `find`, `lower_bound` and
+ * `upper_bound`, use a branch-free binary search on the sorted array, which is as fast while the set fits in the caches.
+ *
+ * The iterators are pointers into the sorted array. Any change of the set invalidates them.
+ *
+ * If the comparison defines `is_transparent`, as the default std::less<> does, `contains`, `count`, `find`,
+ * `lower_bound` and `upper_bound` accept any type it accepts.
+ *
+ * @code
+ * ChSet<uint32_t> wanted{7, 3, 11};
+ * ChSet<uint32_t> matched = wanted.setIntersection(document.tags());
+ * @endcode
+ *
+ * @tparam T The type of the elements.
+ * @tparam Compare The ordering of the elements.
+ */
+template <typename T, typename Compare = std::less<>>
 class ChSet
 {
+    template <typename C, typename = void>
+    struct IsTransparent : std::false_type
+    {
+    };
+
+    template <typename C>
+    struct IsTransparent<C, std::void_t<typename C::is_transparent>> : std::true_type
+    {
+    };
+
+    // Enables the heterogeneous overloads for types other than T
+    template <typename Q>
+    using EnableIfTransparent = typename std::enable_if<IsTransparent<Compare>::value && !std::is_same<Q, T>::value>::type;
+
+    // Whether the elements are kept in Eytzinger order too, once there are at least eytzingerMinimumSize of them.
+    // Below about 4 MiB of elements, which stay in the caches, the binary search is as fast.
+    static constexpr bool usesEytzinger = std::is_trivially_copyable<T>::value && std::is_default_constructible<T>::value;
+    static constexpr size_t eytzingerMinimumSize = std::max<size_t>(1, (size_t(4) << 20) / sizeof(T));
+
+    // Whether the set algebra can use the branch-free merges, which need the natural order of arithmetic elements
+    static constexpr bool usesBranchFreeMerge = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+                                                (std::is_same<Compare, std::less<>>::value || std::is_same<Compare, std::less<T>>::value);
+
+public:
+    using key_type = T;
+    using value_type = T;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using reference = const T &;
+    using const_reference = const T &;
+    using iterator = const T *;
+    using const_iterator = const T *;
+    using reverse_iterator = std::reverse_iterator<const_iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    /**
+     * @brief Default constructor. Constructs an empty set.
+     */
     ChSet();
-    ~ChSet();
+
+    /**
+     * @brief Constructs an empty set that orders its elements with `compare`.
+     *
+     * @param compare The ordering of the elements.
+     */
+    explicit ChSet(const Compare &compare);
+
+    /**
+     * @brief Constructs the set with the given elements. Of equivalent elements, the first one is kept.
+     *
+     * @param values The elements to initialize the set with.
+     * @param compare The ordering of the elements.
+     */
+    ChSet(std::initializer_list<T> values, const Compare &compare = Compare());
+
+    /**
+     * @brief Constructs the set from the elements of `values`, which it takes over. Of equivalent elements, the first
+     * one is kept.
+     *
+     * Takes linear time if `values` is already sorted, and O(n log n) otherwise.
+     *
+     * @param values The elements to initialize the set with.
+     * @param compare The ordering of the elements.
+     */
+    explicit ChSet(ChVector<T> values, const Compare &compare = Compare());
+
+    /**
+     * @brief Constructs the set from the elements in the range [first, last). Of equivalent elements, the first one is
+     * kept.
+     *
+     * @param first The beginning of the range.
+     * @param last The end of the range.
+     * @param compare The ordering of the elements.
+     */
+    template <typename InputIt>
+    ChSet(InputIt first, InputIt last, const Compare &compare = Compare());
+
+    /**
+     * @brief Replaces the contents of the set with the elements of `values`, which must be strictly increasing.
+     * Takes linear time.
+     *
+     * @param values The elements of the set, in increasing order without equivalent elements.
+     * @throws std::invalid_argument if `values` is not strictly increasing. The set is left unchanged.
+     */
+    void assignSorted(ChVector<T> values);
+
+    /**
+     * @brief Returns an iterator to the smallest element.
+     */
+    const_iterator begin() const noexcept;
+
+    /**
+     * @brief Returns an iterator past the largest element.
+     */
+    const_iterator end() const noexcept;
+
+    /**
+     * @brief Returns an iterator to the smallest element.
+     */
+    const_iterator cbegin() const noexcept;
+
+    /**
+     * @brief Returns an iterator past the largest element.
+     */
+    const_iterator cend() const noexcept;
+
+    /**
+     * @brief Returns a reverse iterator to the largest element.
+     */
+    const_reverse_iterator rbegin() const noexcept;
+
+    /**
+     * @brief Returns a reverse iterator past the smallest element.
+     */
+    const_reverse_iterator rend() const noexcept;
+
+    /**
+     * @brief Returns the number of elements.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Returns whether the set has no elements.
+     */
+    bool isEmpty() const noexcept;
+
+    /**
+     * @brief Returns the element at position `index` in increasing order, i.e. the element with `index` smaller ones.
+     *
+     * @param index The position of the element, less than `size()`.
+     * @return The element at `index`.
+     */
+    const T &operator[](size_t index) const;
+
+    /**
+     * @brief Returns the elements in increasing order.
+     */
+    const ChVector<T> &values() const noexcept;
+
+    /**
+     * @brief Returns whether the set holds an element equivalent to `value`.
+     *
+     * @param value The value to look for.
+     * @return True if the value is in the set.
+     */
+    bool contains(const T &value) const;
+
+    /**
+     * @brief Returns whether the set holds an element equivalent to `value`.
+     *
+     * @param value The value to look for, of a type the transparent comparison accepts.
+     * @return True if the value is in the set.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    bool contains(const Q &value) const;
+
+    /**
+     * @brief Returns the number of elements equivalent to `value`, 0 or 1.
+     *
+     * @param value The value to count.
+     * @return 1 if the value is in the set, and 0 otherwise.
+     */
+    size_t count(const T &value) const;
+
+    /**
+     * @brief Returns the number of elements equivalent to `value`, 0 or 1.
+     *
+     * @param value The value to count, of a type the transparent comparison accepts.
+     * @return 1 if the value is in the set, and 0 otherwise.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    size_t count(const Q &value) const;
+
+    /**
+     * @brief Finds the element equivalent to `value`.
+     *
+     * @param value The value to look for.
+     * @return An iterator to the element, or `end()` if there is none.
+     */
+    const_iterator find(const T &value) const;
+
+    /**
+     * @brief Finds the element equivalent to `value`.
+     *
+     * @param value The value to look for, of a type the transparent comparison accepts.
+     * @return An iterator to the element, or `end()` if there is none.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    const_iterator find(const Q &value) const;
+
+    /**
+     * @brief Returns an iterator to the first element that is not less than `value`.
+     *
+     * @param value The value to compare the elements with.
+     * @return An iterator to the element, or `end()` if all elements are less than `value`.
+     */
+    const_iterator lower_bound(const T &value) const;
+
+    /**
+     * @brief Returns an iterator to the first element that is not less than `value`.
+     *
+     * @param value The value to compare the elements with, of a type the transparent comparison accepts.
+     * @return An iterator to the element, or `end()` if all elements are less than `value`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    const_iterator lower_bound(const Q &value) const;
+
+    /**
+     * @brief Returns an iterator to the first element that is greater than `value`.
+     *
+     * @param value The value to compare the elements with.
+     * @return An iterator to the element, or `end()` if no element is greater than `value`.
+     */
+    const_iterator upper_bound(const T &value) const;
+
+    /**
+     * @brief Returns an iterator to the first element that is greater than `value`.
+     *
+     * @param value The value to compare the elements with, of a type the transparent comparison accepts.
+     * @return An iterator to the element, or `end()` if no element is greater than `value`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    const_iterator upper_bound(const Q &value) const;
+
+    /**
+     * @brief Inserts `value` unless the set already holds an equivalent element. Takes linear time.
+     *
+     * @param value The value to insert.
+     * @return An iterator to the element equivalent to `value`, and whether it was inserted.
+     */
+    std::pair<const_iterator, bool> insert(const T &value);
+
+    /**
+     * @brief Inserts `value` unless the set already holds an equivalent element. Takes linear time.
+     *
+     * @param value The value to insert.
+     * @return An iterator to the element equivalent to `value`, and whether it was inserted.
+     */
+    std::pair<const_iterator, bool> insert(T &&value);
+
+    /**
+     * @brief Inserts the elements in the range [first, last) that the set does not hold yet. Sorts the new elements
+     * and merges them with the set, in O(m log m + n) for m new elements.
+     *
+     * @param first The beginning of the range.
+     * @param last The end of the range.
+     */
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last);
+
+    /**
+     * @brief Erases the element equivalent to `value`, if there is one. Takes linear time.
+     *
+     * @param value The value to erase.
+     * @return The number of erased elements, 0 or 1.
+     */
+    size_t erase(const T &value);
+
+    /**
+     * @brief Erases the element at `pos`. Takes linear time.
+     *
+     * @param pos An iterator to the element to erase.
+     * @return An iterator to the element that followed the erased one.
+     */
+    const_iterator erase(const_iterator pos);
+
+    /**
+     * @brief Erases all elements.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Swaps the contents of the set with those of `other`.
+     *
+     * @param other The set to swap with.
+     */
+    void swap(ChSet &other) noexcept;
+
+    /**
+     * @brief Returns the ordering of the elements.
+     */
+    Compare key_comp() const;
+
+    /**
+     * @brief Returns the set of elements that are in this set, in `other`, or in both.
+     *
+     * @param other The set to unite with.
+     * @return The union of both sets. Of equivalent elements, the one of this set is kept.
+     */
+    ChSet setUnion(const ChSet &other) const;
+
+    /**
+     * @brief Returns the set of elements that are in both this set and `other`.
+     *
+     * @param other The set to intersect with.
+     * @return The intersection of both sets, with the elements of this set.
+     */
+    ChSet setIntersection(const ChSet &other) const;
+
+    /**
+     * @brief Returns the set of elements of this set that are not in `other`.
+     *
+     * @param other The set of elements to leave out.
+     * @return The difference of both sets.
+     */
+    ChSet setDifference(const ChSet &other) const;
+
+    /**
+     * @brief Returns the number of elements that are in both this set and `other`, without building the intersection.
+     *
+     * @param other The set to intersect with.
+     * @return The size of the intersection of both sets.
+     */
+    size_t intersectionSize(const ChSet &other) const;
+
+    /**
+     * @brief Returns whether this set and `other` have an element in common.
+     *
+     * @param other The set to compare with.
+     * @return True if the intersection of both sets is not empty.
+     */
+    bool intersects(const ChSet &other) const;
+
+private:
+    // One set more than this many times larger than the other is searched instead of merged
+    static constexpr size_t skewRatio = 32;
+
+    void assignValues(ChVector<T> &&values);
+    void build(ChVector<T> &&sorted);
+    void refreshEytzinger() noexcept;
+    static size_t fillEytzinger(const T *sorted, size_t count, T *out, size_t sortedIndex, size_t node) noexcept;
+    template <typename Q>
+    bool containsKey(const Q &value) const;
+    template <typename Q>
+    const T *lowerBound(const T *first, size_t count, const Q &value) const;
+    template <typename Q>
+    const T *upperBound(const T *first, size_t count, const Q &value) const;
+    template <typename Q>
+    const_iterator findKey(const Q &value) const;
+    template <bool Write>
+    size_t intersect(const ChSet &other, ChVector<T> *out) const;
+    template <bool Write>
+    size_t intersectSkewed(const T *small, size_t smallCount, const T *large, size_t largeCount, bool keepSmall, ChVector<T> *out) const;
+    template <bool Write>
+    static size_t intersectMerge(const T *a, size_t aCount, const T *b, size_t bCount, T *out);
+    static size_t uniteMerge(const T *a, size_t aCount, const T *b, size_t bCount, T *out);
+    static size_t subtractMerge(const T *a, size_t aCount, const T *b, size_t bCount, T *out);
+    ChSet fromSorted(ChVector<T> &&sorted) const;
+    static void prefetch(const void *address);
+
+    ChVector<T> elements_;
+    ChVector<T> eytzinger_;
+    Compare compare_;
 };
 
+/**
+ * @brief Returns whether both sets hold equivalent elements.
+ */
+template <typename T, typename Compare>
+bool operator==(const ChSet<T, Compare> &lhs, const ChSet<T, Compare> &rhs);
+
+/**
+ * @brief Returns whether the sets differ.
+ */
+template <typename T, typename Compare>
+bool operator!=(const ChSet<T, Compare> &lhs, const ChSet<T, Compare> &rhs);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include "ChRope.h"
+
+#include <algorithm>
+#include <cassert>
+
+struct ChRope::Node
+{
+    NodePtr left;
+    NodePtr right;
+    std::string chunk;
+    size_t length;
+    int height;
+};
+
+namespace
+{
+    // Leaves never grow beyond this size, so small appends copy at most one chunk
+    const size_t maxChunkSize = 1024;
+}
+
+ChRope::ChRope()
+{
+}
+
+ChRope::ChRope(std::string_view value) : root_(build(value))
+{
+}
+
+ChRope::ChRope(const std::string &value) : root_(build(value))
+{
+}
+
+ChRope::ChRope(const ChString &value) : root_(build(value.getData()))
+{
+}
+
+ChRope::ChRope(const char *value) : root_(build(value))
+{
+}
+
+ChRope::ChRope(NodePtr root) : root_(std::move(root))
+{
+}
+
+size_t ChRope::size() const
+{
+    return lengthOf(root_);
+}
+
+bool ChRope::isEmpty() const
+{
+    return !root_;
+}
+
+char ChRope::operator[](size_t index) const
+{
+    assert(index < size());
+    const Node *node = root_.get();
+    while (node->left)
+    {
+        if (index < node->left->length)
+        {
+            node = node->left.get();
+        }
+        else
+        {
+            index -= node->left->length;
+            node = node->right.get();
+        }
+    }
+    return node->chunk[index];
+}
+
+ChRope ChRope::concat(const ChRope &other) const
+{
+    return ChRope(join(root_, other.root_));
+}
+
+ChRope &ChRope::append(const ChRope &other)
+{
+    root_ = join(root_, other.root_);
+    return *this;
+}
+
+ChRope &ChRope::insert(size_t position, const ChRope &other)
+{
+    NodePtr left;
+    NodePtr right;
+    split(root_, position, left, right);
+    root_ = join(join(left, other.root_), right);
+    return *this;
+}
+
+ChRope &ChRope::erase(size_t position, size_t count)
+{
+    NodePtr left;
+    NodePtr rest;
+    NodePtr removed;
+    NodePtr right;
+    split(root_, position, left, rest);
+    split(rest, std::min(count, lengthOf(rest)), removed, right);
+    root_ = join(left, right);
+    return *this;
+}
+
+ChRope ChRope::substring(size_t start, size_t size) const
+{
+    NodePtr left;
+    NodePtr rest;
+    NodePtr middle;
+    NodePtr right;
+    split(root_, start, left, rest);
+    split(rest, std::min(size, lengthOf(rest)), middle, right);
+    return ChRope(middle);
+}
+
+void ChRope::forEachChunk(const std::function<void(std::string_view)> &visitor) const
+{
+    // The tree is balanced, so the explicit stack stays logarithmic in size
+    std::vector<const Node *> pending;
+    const Node *node = root_.get();
+    while (node || !pending.empty())
+    {
+        while (node)
+        {
+            pending.push_back(node);
+            node = node->left.get();
+        }
+        node = pending.back();
+        pending.pop_back();
+        if (!node->left)
+        {
+            visitor(node->chunk);
+        }
+        node = node->right.get();
+    }
+}
+
+ChString ChRope::toChString() const
+{
+    std::string result;
+    result.reserve(size());
+    forEachChunk([&result](std::string_view chunk)
+                 { result.append(chunk); });
+    return ChString(result);
+}
+
+int ChRope::height() const
+{
+    return heightOf(root_);
+}
+
+ChRope::NodePtr ChRope::makeLeaf(std::string_view value)
+{
+    if (value.empty())
+    {
+        return NodePtr();
+    }
+    auto node = std::make_shared<Node>();
+    node->chunk.assign(value.data(), value.size());
+    node->length = value.size();
+    node->height = 1;
+    return node;
+}
+
+ChRope::NodePtr ChRope::makeBranch(const NodePtr &left, const NodePtr &right)
+{
+    auto node = std::make_shared<Node>();
+    node->left = left;
+    node->right = right;
+    node->length = left->length + right->length;
+    node->height = std::max(left->height, right->height) + 1;
+    return node;
+}
+
+ChRope::NodePtr ChRope::build(std::string_view value)
+{
+    if (value.size() <= maxChunkSize)
+    {
+        return makeLeaf(value);
+    }
+
+    // Split on a chunk boundary so every leaf but the last is full
+    size_t chunks = (value.size() + maxChunkSize - 1) / maxChunkSize;
+    size_t middle = (chunks / 2) * maxChunkSize;
+    return makeBranch(build(value.substr(0, middle)), build(value.substr(middle)));
+}
+
+ChRope::NodePtr ChRope::balance(const NodePtr &left, const NodePtr &right)
+{
+    int leftHeight = heightOf(left);
+    int rightHeight = heightOf(right);
+
+    if (leftHeight > rightHeight + 1)
+    {
+        if (heightOf(left->left) >= heightOf(left->right))
+        {
+            return makeBranch(left->left, makeBranch(left->right, right));
+        }
+        const NodePtr &inner = left->right;
+        return makeBranch(makeBranch(left->left, inner->left), makeBranch(inner->right, right));
+    }
+
+    if (rightHeight > leftHeight + 1)
+    {
+        if (heightOf(right->right) >= heightOf(right->left))
+        {
+            return makeBranch(makeBranch(left, right->left), right->right);
+        }
+        const NodePtr &inner = right->left;
+        return makeBranch(makeBranch(left, inner->left), makeBranch(inner->right, right->right));
+    }
+
+    return makeBranch(left, right);
+}
+
+ChRope::NodePtr ChRope::join(const NodePtr &left, const NodePtr &right)
+{
+    if (!left)
+    {
+        return right;
+    }
+    if (!right)
+    {
+        return left;
+    }
+
+    if (!left->left && !right->left && left->length + right->length <= maxChunkSize)
+    {
+        std::string chunk;
+        chunk.reserve(left->length + right->length);
+        chunk.append(left->chunk).append(right->chunk);
+        return makeLeaf(chunk);
+    }
+
+    // Descend along the spine of the taller tree until the heights match, rebalancing on the way back
+    if (left->height > right->height + 1)
+    {
+        return balance(left->left, join(left->right, right));
+    }
+    if (right->height > left->height + 1)
+    {
+        return balance(join(left, right->left), right->right);
+    }
+    return makeBranch(left, right);
+}
+
+void ChRope::split(const NodePtr &node, size_t position, NodePtr &left, NodePtr &right)
+{
+    if (!node || position == 0)
+    {
+        left = NodePtr();
+        right = node;
+        return;
+    }
+    if (position >= node->length)
+    {
+        left = node;
+        right = NodePtr();
+        return;
+    }
+
+    if (!node->left)
+    {
+        std::string_view chunk = node->chunk;
+        left = makeLeaf(chunk.substr(0, position));
+        right = makeLeaf(chunk.substr(position));
+        return;
+    }
+
+    size_t leftLength = node->left->length;
+    if (position < leftLength)
+    {
+        NodePtr middle;
+        split(node->left, position, left, middle);
+        right = join(middle, node->right);
+    }
+    else if (position == leftLength)
+    {
+        left = node->left;
+        right = node->right;
+    }
+    else
+    {
+        NodePtr middle;
+        split(node->right, position - leftLength, middle, right);
+        left = join(node->left, middle);
+    }
+}
+
+size_t ChRope::lengthOf(const NodePtr &node)
+{
+    return node ? node->length : 0;
+}
+
+int ChRope::heightOf(const NodePtr &node)
+{
+    return node ? node->height : 0;
+}
@@ -0,0 +1,154 @@
+#ifndef CHROPE
+#define CHROPE
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <vector>
+#include <cstddef>
+
+#include "ChString.h"
+
+/**
+ * @brief A string stored as a balanced tree of character chunks, intended for very large documents.
+ *
+ * Concatenation, insertion, erasure and substring extraction restructure O(log n) tree nodes instead of moving
+ * characters, and character access walks O(log n) nodes. Nodes are immutable and shared, so copying a ChRope is O(1)
+ * and modifying a copy never affects the original.
+ *
+ * Prefer ChString for small strings; the chunk and node overhead only pays off once strings reach many kilobytes.
+ */
+class ChRope
+{
+public:
+    /**
+     * @brief Default constructor. Constructs an empty rope.
+     */
+    ChRope();
+
+    /**
+     * @brief Constructs the rope with a copy of the characters of `value`.
+     *
+     * @param value The characters to initialize the rope with.
+     */
+    ChRope(std::string_view value);
+
+    /**
+     * @brief Constructs the rope with a copy of the characters of `value`.
+     *
+     * @param value The std::string to initialize the rope with.
+     */
+    ChRope(const std::string &value);
+
+    /**
+     * @brief Constructs the rope with a copy of the contents of `value`.
+     *
+     * @param value The ChString to initialize the rope with.
+     */
+    ChRope(const ChString &value);
+
+    /**
+     * @brief Constructs the rope with a copy of the null-terminated C string `value`.
+     *
+     * @param value The null-terminated C string to initialize the rope with.
+     */
+    ChRope(const char *value);
+
+    /**
+     * @brief Returns the length of the rope.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Checks whether the rope is empty.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Returns the character at `index`, which must be below `size()`. In particular the rope must not be empty:
+     * an empty rope has no nodes to descend into. Only debug builds check this, with an assertion.
+     */
+    char operator[](size_t index) const;
+
+    /**
+     * @brief Concatenates the given rope to the current object and returns the result as a new ChRope object.
+     *
+     * Both operands are left untouched and share their nodes with the result.
+     *
+     * @param other The rope to concatenate to the current object.
+     * @return A new ChRope object that is the result of the concatenation.
+     */
+    ChRope concat(const ChRope &other) const;
+
+    /**
+     * @brief Appends the given rope to the end of the current object.
+     *
+     * @param other The rope to append.
+     * @return A reference to the current object.
+     */
+    ChRope &append(const ChRope &other);
+
+    /**
+     * @brief Inserts the given rope before the character at `position`.
+     *
+     * @param position The index to insert at. It is clamped to the end of the rope.
+     * @param other The rope to insert.
+     * @return A reference to the current object.
+     */
+    ChRope &insert(size_t position, const ChRope &other);
+
+    /**
+     * @brief Removes `count` characters starting at `position`.
+     *
+     * @param position The index of the first character to remove.
+     * @param count The number of characters to remove. It is clamped to the end of the rope.
+     * @return A reference to the current object.
+     */
+    ChRope &erase(size_t position, size_t count);
+
+    /**
+     * @brief Returns a new ChRope object that is a substring of the current object and shares its nodes.
+     *
+     * @param start The starting index of the substring.
+     * @param size The size of the substring. It is clamped to the end of the rope.
+     * @return A new ChRope object that is a substring of the current object.
+     */
+    ChRope substring(size_t start, size_t size = std::string_view::npos) const;
+
+    /**
+     * @brief Calls `visitor` with every chunk of the rope in order.
+     *
+     * @param visitor The function to call with each chunk.
+     */
+    void forEachChunk(const std::function<void(std::string_view)> &visitor) const;
+
+    /**
+     * @brief Returns a ChString holding a copy of all characters of the rope.
+     */
+    ChString toChString() const;
+
+    /**
+     * @brief Returns the height of the underlying tree, for diagnostics.
+     */
+    int height() const;
+
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    explicit ChRope(NodePtr root);
+
+    static NodePtr makeLeaf(std::string_view value);
+    static NodePtr makeBranch(const NodePtr &left, const NodePtr &right);
+    static NodePtr build(std::string_view value);
+    static NodePtr balance(const NodePtr &left, const NodePtr &right);
+    static NodePtr join(const NodePtr &left, const NodePtr &right);
+    static void split(const NodePtr &node, size_t position, NodePtr &left, NodePtr &right);
+    static size_t lengthOf(const NodePtr &node);
+    static int heightOf(const NodePtr &node);
+
+    NodePtr root_;
+};
+
+#endif
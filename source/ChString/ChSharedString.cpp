@@ -0,0 +1,199 @@
+#include "ChSharedString.h"
+
+#include <atomic>
+#include <cstring>
+#include <new>
+
+struct ChSharedString::Buffer
+{
+    std::atomic<size_t> references;
+    char data[1];
+};
+
+namespace
+{
+    const char emptyData[1] = {'\0'};
+}
+
+ChSharedString::ChSharedString() : buffer_(nullptr), data_(emptyData), size_(0)
+{
+}
+
+ChSharedString::ChSharedString(std::string_view value) : buffer_(nullptr), data_(emptyData), size_(value.size())
+{
+    if (size_ == 0)
+    {
+        return;
+    }
+
+    // The header and the characters share a single allocation
+    void *memory = ::operator new(offsetof(Buffer, data) + size_ + 1);
+    buffer_ = new (memory) Buffer;
+    buffer_->references.store(1, std::memory_order_relaxed);
+    std::memcpy(buffer_->data, value.data(), size_);
+    buffer_->data[size_] = '\0';
+    data_ = buffer_->data;
+}
+
+ChSharedString::ChSharedString(const std::string &value) : ChSharedString(std::string_view(value))
+{
+}
+
+ChSharedString::ChSharedString(const ChString &value) : ChSharedString(std::string_view(value.getData()))
+{
+}
+
+ChSharedString::ChSharedString(const char *value) : ChSharedString(std::string_view(value))
+{
+}
+
+ChSharedString::ChSharedString(const ChSharedString &other) : buffer_(other.buffer_), data_(other.data_), size_(other.size_)
+{
+    if (buffer_)
+    {
+        buffer_->references.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+ChSharedString::ChSharedString(ChSharedString &&other) noexcept : buffer_(other.buffer_), data_(other.data_), size_(other.size_)
+{
+    other.buffer_ = nullptr;
+    other.data_ = emptyData;
+    other.size_ = 0;
+}
+
+ChSharedString::~ChSharedString()
+{
+    release();
+}
+
+ChSharedString &ChSharedString::operator=(const ChSharedString &other)
+{
+    if (other.buffer_)
+    {
+        other.buffer_->references.fetch_add(1, std::memory_order_relaxed);
+    }
+    release();
+    buffer_ = other.buffer_;
+    data_ = other.data_;
+    size_ = other.size_;
+    return *this;
+}
+
+ChSharedString &ChSharedString::operator=(ChSharedString &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        buffer_ = other.buffer_;
+        data_ = other.data_;
+        size_ = other.size_;
+        other.buffer_ = nullptr;
+        other.data_ = emptyData;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+bool ChSharedString::operator==(const ChSharedString &other) const
+{
+    if (size_ != other.size_)
+    {
+        return false;
+    }
+    return data_ == other.data_ || std::memcmp(data_, other.data_, size_) == 0;
+}
+
+bool ChSharedString::operator!=(const ChSharedString &other) const
+{
+    return !(*this == other);
+}
+
+char ChSharedString::operator[](size_t index) const
+{
+    return data_[index];
+}
+
+ChSharedString::operator std::string_view() const
+{
+    return view();
+}
+
+std::string_view ChSharedString::view() const
+{
+    return std::string_view(data_, size_);
+}
+
+size_t ChSharedString::size() const
+{
+    return size_;
+}
+
+bool ChSharedString::isEmpty() const
+{
+    return size_ == 0;
+}
+
+ChSharedString ChSharedString::substring(size_t start, size_t size) const
+{
+    ChSharedString result;
+    if (start >= size_)
+    {
+        return result;
+    }
+
+    size_t available = size_ - start;
+    size_t length = size < available ? size : available;
+    if (length == 0)
+    {
+        return result;
+    }
+
+    result.buffer_ = buffer_;
+    result.data_ = data_ + start;
+    result.size_ = length;
+    buffer_->references.fetch_add(1, std::memory_order_relaxed);
+    return result;
+}
+
+bool ChSharedString::beginsWith(std::string_view str) const
+{
+    return size_ >= str.size() && std::memcmp(data_, str.data(), str.size()) == 0;
+}
+
+bool ChSharedString::endsWith(std::string_view str) const
+{
+    return size_ >= str.size() && std::memcmp(data_ + size_ - str.size(), str.data(), str.size()) == 0;
+}
+
+bool ChSharedString::contains(const ChStringMatcher &matcher) const
+{
+    return matcher.containedIn(view());
+}
+
+ChSharedString ChSharedString::compact() const
+{
+    return ChSharedString(view());
+}
+
+ChString ChSharedString::toChString() const
+{
+    return ChString(std::string(data_, size_));
+}
+
+size_t ChSharedString::useCount() const
+{
+    return buffer_ ? buffer_->references.load(std::memory_order_relaxed) : 0;
+}
+
+void ChSharedString::release()
+{
+    if (buffer_ && buffer_->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        buffer_->~Buffer();
+        ::operator delete(buffer_);
+    }
+    buffer_ = nullptr;
+    data_ = emptyData;
+    size_ = 0;
+}
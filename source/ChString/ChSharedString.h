@@ -0,0 +1,177 @@
+#ifndef CHSHAREDSTRING
+#define CHSHAREDSTRING
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+#include "ChString.h"
+
+/**
+ * @brief An immutable string whose characters live in a reference counted buffer.
+ *
+ * Copying a ChSharedString only increments the reference count of the buffer, and substrings are slices that refer to
+ * the same buffer, so neither allocates nor copies characters. This suits workloads that pass the same tokens around
+ * many times. A slice keeps its whole buffer alive; use `compact()` to release a small slice of a large buffer.
+ *
+ * The reference count is atomic, so copies may be shared across threads.
+ */
+class ChSharedString
+{
+public:
+    /**
+     * @brief Default constructor. Constructs an empty string without allocating.
+     */
+    ChSharedString();
+
+    /**
+     * @brief Constructs the string with a copy of the characters of `value` in a new shared buffer.
+     *
+     * @param value The characters to initialize the string with.
+     */
+    ChSharedString(std::string_view value);
+
+    /**
+     * @brief Constructs the string with a copy of the characters of `value` in a new shared buffer.
+     *
+     * @param value The std::string to initialize the string with.
+     */
+    ChSharedString(const std::string &value);
+
+    /**
+     * @brief Constructs the string with a copy of the contents of `value` in a new shared buffer.
+     *
+     * @param value The ChString to initialize the string with.
+     */
+    ChSharedString(const ChString &value);
+
+    /**
+     * @brief Constructs the string with a copy of the null-terminated C string `value` in a new shared buffer.
+     *
+     * @param value The null-terminated C string to initialize the string with.
+     */
+    ChSharedString(const char *value);
+
+    /**
+     * @brief Copy constructor. Shares the buffer of `other` without copying characters.
+     *
+     * @param other Another ChSharedString object whose buffer is shared.
+     */
+    ChSharedString(const ChSharedString &other);
+
+    /**
+     * @brief Move constructor. Takes over the buffer of `other`, which is left empty.
+     *
+     * @param other Another ChSharedString object whose buffer is taken over.
+     */
+    ChSharedString(ChSharedString &&other) noexcept;
+
+    /**
+     * @brief Destructor. Releases the reference to the buffer and frees it if it was the last one.
+     */
+    ~ChSharedString();
+
+    /**
+     * @brief Copy assignment operator. Shares the buffer of `other` without copying characters.
+     *
+     * @param other Another ChSharedString object whose buffer is shared.
+     * @return A reference to the string object.
+     */
+    ChSharedString &operator=(const ChSharedString &other);
+
+    /**
+     * @brief Move assignment operator. Takes over the buffer of `other`, which is left empty.
+     *
+     * @param other Another ChSharedString object whose buffer is taken over.
+     * @return A reference to the string object.
+     */
+    ChSharedString &operator=(ChSharedString &&other) noexcept;
+
+    /**
+     * @brief Compares the characters of both strings. Slices of the same buffer are compared without reading it.
+     */
+    bool operator==(const ChSharedString &other) const;
+
+    /**
+     * @brief Checks whether the characters of both strings differ.
+     */
+    bool operator!=(const ChSharedString &other) const;
+
+    /**
+     * @brief Returns the character at `index`. No bounds checking is performed.
+     */
+    char operator[](size_t index) const;
+
+    /**
+     * @brief Conversion operator to a std::string_view of the characters.
+     */
+    operator std::string_view() const;
+
+    /**
+     * @brief Returns a std::string_view of the characters. The view stays valid as long as any string shares the buffer.
+     */
+    std::string_view view() const;
+
+    /**
+     * @brief Returns the length of the string.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Checks whether the string is empty.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Returns a slice of the string that shares its buffer.
+     *
+     * @param start The starting index of the substring. Values past the end produce an empty string.
+     * @param size The size of the substring. It is clamped to the end of the string.
+     * @return A ChSharedString referring to the same buffer.
+     */
+    ChSharedString substring(size_t start, size_t size = std::string_view::npos) const;
+
+    /**
+     * @brief Check whether the string begins with the specified characters.
+     */
+    bool beginsWith(std::string_view str) const;
+
+    /**
+     * @brief Check whether the string ends with the specified characters.
+     */
+    bool endsWith(std::string_view str) const;
+
+    /**
+     * @brief Check if the string contains the needle of a precompiled matcher.
+     */
+    bool contains(const ChStringMatcher &matcher) const;
+
+    /**
+     * @brief Returns a string with the same characters in a buffer of its own, sized exactly to them.
+     */
+    ChSharedString compact() const;
+
+    /**
+     * @brief Returns a ChString holding a copy of the characters.
+     */
+    ChString toChString() const;
+
+    /**
+     * @brief Returns the number of strings sharing the buffer, or 0 for an empty string without a buffer.
+     */
+    size_t useCount() const;
+
+private:
+    struct Buffer;
+
+    /**
+     * @brief Drops the reference to the current buffer.
+     */
+    void release();
+
+    Buffer *buffer_;
+    const char *data_;
+    size_t size_;
+};
+
+#endif
@@ -1,26 +1,122 @@
 #include "ChString.h"
+#include "ChStringBuilder.h"
+#include "ChStringConversion.h"
+#include "ChStringKernels.h"
+#include "ChStringSimd.h"
 
-#include <sstream>
 #include <cctype>
-#include <regex>
+#include <cstring>
+#include <algorithm>
 
-ChString::ChString() : data_("")
+namespace
+{
+    using ChBits::countTrailingZeros;
+    using ChBits::highestSetBit;
+
+    /**
+     * @brief Returns the index of the first character in [begin, end) that is not a space, or `end` if there is none.
+     */
+    size_t findFirstNotSpace(const char *data, size_t begin, size_t end)
+    {
+#if defined(CHSTRING_USE_SSE2)
+        const __m128i spaces = _mm_set1_epi8(' ');
+        while (end - begin >= 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + begin));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, spaces))) ^ 0xFFFFu;
+            if (mask != 0)
+            {
+                return begin + countTrailingZeros(mask);
+            }
+            begin += 16;
+        }
+#endif
+        while (begin < end && data[begin] == ' ')
+        {
+            ++begin;
+        }
+        return begin;
+    }
+
+    /**
+     * @brief Returns one past the index of the last character in [begin, end) that is not a space, or `begin` if there is none.
+     */
+    size_t findLastNotSpace(const char *data, size_t begin, size_t end)
+    {
+#if defined(CHSTRING_USE_SSE2)
+        const __m128i spaces = _mm_set1_epi8(' ');
+        while (end - begin >= 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + end - 16));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, spaces))) ^ 0xFFFFu;
+            if (mask != 0)
+            {
+                return end - 16 + highestSetBit(mask) + 1;
+            }
+            end -= 16;
+        }
+#endif
+        while (end > begin && data[end - 1] == ' ')
+        {
+            --end;
+        }
+        return end;
+    }
+
+    /**
+     * @brief Copies `src` to `dst` dropping leading and trailing spaces and collapsing every run of spaces into one.
+     *
+     * `dst` may be equal to `src`, which makes the operation in-place. Returns the number of characters written.
+     */
+    size_t collapseSpaces(const char *src, size_t size, char *dst)
+    {
+        size_t end = findLastNotSpace(src, 0, size);
+        size_t pos = findFirstNotSpace(src, 0, end);
+        size_t written = 0;
+
+        while (pos < end)
+        {
+            const void *space = std::memchr(src + pos, ' ', end - pos);
+            size_t wordEnd = space ? static_cast<size_t>(static_cast<const char *>(space) - src) : end;
+
+            std::memmove(dst + written, src + pos, wordEnd - pos);
+            written += wordEnd - pos;
+
+            if (wordEnd == end)
+            {
+                break;
+            }
+
+            // `end` points after a non-space character, so the next word always exists
+            dst[written++] = ' ';
+            pos = findFirstNotSpace(src, wordEnd, end);
+        }
+
+        return written;
+    }
+}
+
+ChString::ChString() : data_(""), asciiState_(AsciiState::Ascii)
+{
+}
+
+ChString::ChString(const std::string &value) : data_(value), asciiState_(AsciiState::Unknown)
 {
 }
 
-ChString::ChString(const std::string &value) : data_(value)
+ChString::ChString(std::string &&value) : data_(std::move(value)), asciiState_(AsciiState::Unknown)
 {
 }
 
-ChString::ChString(const ChString &other) : data_(other.data_)
+ChString::ChString(const ChString &other) : data_(other.data_), asciiState_(other.sharedAsciiState())
 {
 }
 
-ChString::ChString(const char *str) : data_(str)
+ChString::ChString(const char *str) : data_(str), asciiState_(AsciiState::Unknown)
 {
 }
 
-ChString::ChString(size_t size, char ch)
+ChString::ChString(size_t size, char ch) : asciiState_(size == 0 || static_cast<unsigned char>(ch) < 0x80 ? AsciiState::Ascii : AsciiState::NonAscii)
 {
     // Resize the internal string to the specified size
     data_.resize(size);
@@ -29,7 +125,7 @@ ChString::ChString(size_t size, char ch)
     std::fill(data_.begin(), data_.end(), ch);
 }
 
-ChString::ChString(ChString &&other) noexcept : data_(std::move(other.data_))
+ChString::ChString(ChString &&other) noexcept : data_(std::move(other.data_)), asciiState_(other.sharedAsciiState())
 {
 }
 
@@ -40,12 +136,14 @@ ChString::~ChString()
 ChString &ChString::operator=(const ChString &other)
 {
     data_ = other.data_;
+    asciiState_.store(other.sharedAsciiState(), std::memory_order_relaxed);
     return *this;
 }
 
 ChString &ChString::operator=(ChString &&other) noexcept
 {
     data_ = std::move(other.data_);
+    asciiState_.store(other.sharedAsciiState(), std::memory_order_relaxed);
     return *this;
 }
 
@@ -56,6 +154,8 @@ std::ostream& operator<<(std::ostream& os, const ChString& str) {
 
 ChString::operator std::string &()
 {
+    // The caller may now change the bytes behind our back, so the ASCII flag can no longer be trusted
+    asciiState_.store(AsciiState::Untracked, std::memory_order_relaxed);
     return data_;
 }
 
@@ -66,210 +166,162 @@ ChString::operator const std::string &() const
 
 void ChString::fromNumber(int num)
 {
-    std::stringstream ss;
-    ss << num;
-    data_ = ss.str();
+    invalidateAsciiState();
+    data_.clear();
+    ChStringConversion::appendNumber(data_, num);
 }
 
 void ChString::fromNumber(float num)
 {
-    std::stringstream ss;
-    ss << num;
-    data_ = ss.str();
+    invalidateAsciiState();
+    data_.clear();
+    ChStringConversion::appendNumber(data_, num);
 }
 
 void ChString::fromNumber(double num)
 {
-    std::stringstream ss;
-    ss << num;
-    data_ = ss.str();
+    invalidateAsciiState();
+    data_.clear();
+    ChStringConversion::appendNumber(data_, num);
 }
 
 void ChString::fromNumber(unsigned int num)
 {
-    std::stringstream ss;
-    ss << num;
-    data_ = ss.str();
+    invalidateAsciiState();
+    data_.clear();
+    ChStringConversion::appendNumber(data_, num);
 }
 
 void ChString::fromNumber(long num)
 {
-    std::stringstream ss;
-    ss << num;
-    data_ = ss.str();
+    invalidateAsciiState();
+    data_.clear();
+    ChStringConversion::appendNumber(data_, num);
 }
 
 void ChString::fromNumber(unsigned long num)
 {
-    std::stringstream ss;
-    ss << num;
-    data_ = ss.str();
+    invalidateAsciiState();
+    data_.clear();
+    ChStringConversion::appendNumber(data_, num);
 }
 
 void ChString::fromNumber(long long num)
 {
-    std::stringstream ss;
-    ss << num;
-    data_ = ss.str();
+    invalidateAsciiState();
+    data_.clear();
+    ChStringConversion::appendNumber(data_, num);
 }
 
 void ChString::fromNumber(unsigned long long num)
 {
-    std::stringstream ss;
-    ss << num;
-    data_ = ss.str();
+    invalidateAsciiState();
+    data_.clear();
+    ChStringConversion::appendNumber(data_, num);
 }
 
-double ChString::toDouble(bool &valid) const
+ChString &ChString::appendNumber(int num)
 {
-    std::string str = data_;
-
-    std::string::iterator end_pos = std::remove(str.begin(), str.end(), ' ');
-    str.erase(end_pos, str.end());
+    invalidateAsciiState();
+    ChStringConversion::appendNumber(data_, num);
+    return *this;
+}
 
-    try
-    {
-        size_t pos = 0;
-        double result = std::stod(str, &pos);
-        valid = (pos == str.length());
-        return result;
-    }
-    catch (...)
-    {
-        valid = false;
-        return 0.0;
-    }
+ChString &ChString::appendNumber(float num)
+{
+    invalidateAsciiState();
+    ChStringConversion::appendNumber(data_, num);
+    return *this;
 }
 
-int ChString::toInteger(bool &valid) const
+ChString &ChString::appendNumber(double num)
 {
-    std::string str = data_;
+    invalidateAsciiState();
+    ChStringConversion::appendNumber(data_, num);
+    return *this;
+}
 
-    std::string::iterator end_pos = std::remove(str.begin(), str.end(), ' ');
-    str.erase(end_pos, str.end());
+ChString &ChString::appendNumber(unsigned int num)
+{
+    invalidateAsciiState();
+    ChStringConversion::appendNumber(data_, num);
+    return *this;
+}
 
-    try
-    {
-        size_t pos = 0;
-        int result = std::stoi(str, &pos);
-        valid = (pos == str.length());
-        return result;
-    }
-    catch (...)
-    {
-        valid = false;
-        return 0;
-    }
+ChString &ChString::appendNumber(long num)
+{
+    invalidateAsciiState();
+    ChStringConversion::appendNumber(data_, num);
+    return *this;
 }
 
-float ChString::toFloat(bool &valid) const
+ChString &ChString::appendNumber(unsigned long num)
 {
-    std::string str = data_;
+    invalidateAsciiState();
+    ChStringConversion::appendNumber(data_, num);
+    return *this;
+}
 
-    std::string::iterator end_pos = std::remove(str.begin(), str.end(), ' ');
-    str.erase(end_pos, str.end());
+ChString &ChString::appendNumber(long long num)
+{
+    invalidateAsciiState();
+    ChStringConversion::appendNumber(data_, num);
+    return *this;
+}
 
-    try
-    {
-        size_t pos = 0;
-        float result = std::stof(str, &pos);
-        valid = (pos == str.length());
-        return result;
-    }
-    catch (...)
-    {
-        valid = false;
-        return 0.0f;
-    }
+ChString &ChString::appendNumber(unsigned long long num)
+{
+    invalidateAsciiState();
+    ChStringConversion::appendNumber(data_, num);
+    return *this;
 }
 
-long long ChString::toLongLong(bool &valid) const
+double ChString::toDouble(bool &valid) const
 {
-    std::string str = data_;
+    return ChStringConversion::parseNumber<double>(data_, valid);
+}
 
-    std::string::iterator end_pos = std::remove(str.begin(), str.end(), ' ');
-    str.erase(end_pos, str.end());
+int ChString::toInteger(bool &valid) const
+{
+    return ChStringConversion::parseNumber<int>(data_, valid);
+}
 
-    try
-    {
-        size_t pos = 0;
-        long long result = std::stoll(str, &pos);
-        valid = (pos == str.length());
-        return result;
-    }
-    catch (...)
-    {
-        valid = false;
-        return 0;
-    }
+float ChString::toFloat(bool &valid) const
+{
+    return ChStringConversion::parseNumber<float>(data_, valid);
 }
 
-unsigned int ChString::toUnsignedInteger(bool &valid) const
+long ChString::toLong(bool &valid) const
 {
-    std::string str = data_;
+    return ChStringConversion::parseNumber<long>(data_, valid);
+}
 
-    std::string::iterator end_pos = std::remove(str.begin(), str.end(), ' ');
-    str.erase(end_pos, str.end());
+long long ChString::toLongLong(bool &valid) const
+{
+    return ChStringConversion::parseNumber<long long>(data_, valid);
+}
 
-    try
-    {
-        size_t pos;
-        unsigned int result = std::stoul(str, &pos);
-        valid = pos == str.length();
-        return result;
-    }
-    catch (...)
-    {
-        valid = false;
-        return 0;
-    }
+unsigned int ChString::toUnsignedInteger(bool &valid) const
+{
+    return ChStringConversion::parseNumber<unsigned int>(data_, valid);
 }
 
 unsigned long ChString::toUnsignedLong(bool &valid) const
 {
-    std::string str = data_;
-
-    std::string::iterator end_pos = std::remove(str.begin(), str.end(), ' ');
-    str.erase(end_pos, str.end());
-
-    try
-    {
-        size_t pos;
-        unsigned long result = std::stoul(str, &pos);
-        valid = pos == str.length();
-        return result;
-    }
-    catch (...)
-    {
-        valid = false;
-        return 0;
-    }
+    return ChStringConversion::parseNumber<unsigned long>(data_, valid);
 }
 
 unsigned long long ChString::toUnsignedLongLong(bool &valid) const
 {
-    std::string str = data_;
-
-    std::string::iterator end_pos = std::remove(str.begin(), str.end(), ' ');
-    str.erase(end_pos, str.end());
-
-    try
-    {
-        size_t pos;
-        unsigned long long result = std::stoull(str, &pos);
-        valid = pos == str.length();
-        return result;
-    }
-    catch (...)
-    {
-        valid = false;
-        return 0;
-    }
+    return ChStringConversion::parseNumber<unsigned long long>(data_, valid);
 }
 
 ChString ChString::concat(const ChString &str) const
 {
-    return ChString(data_ + str.getData());
+    std::string result;
+    result.reserve(data_.size() + str.data_.size());
+    result.append(data_).append(str.data_);
+    return ChString(std::move(result));
 }
 
 ChString ChString::substring(int start, int size) const
@@ -287,24 +339,70 @@ ChString ChString::substring(int start, int size) const
 
 ChString ChString::removeExtraSpaces()
 {
-    return ChString(std::regex_replace(data_, std::regex("^ +| +$|( ) +"), "$1"));
+    std::string result(data_.size(), '\0');
+    result.resize(collapseSpaces(data_.data(), data_.size(), &result[0]));
+    return ChString(std::move(result));
 }
 
 ChString ChString::removeLeadingSpaces()
 {
-    return ChString(std::regex_replace(data_, std::regex("^ +"), ""));
+    return ChString(std::string(viewWithoutLeadingSpaces()));
 }
 
 ChString ChString::removeTrailingSpaces()
 {
-    return ChString(std::regex_replace(data_, std::regex(" +$"), ""));
+    return ChString(std::string(viewWithoutTrailingSpaces()));
 }
 
 ChString ChString::removeTrailingAndLeadingSpaces()
 {
-    std::string lsr = std::regex_replace(data_, std::regex("^ +"), "");
+    return ChString(std::string(viewWithoutTrailingAndLeadingSpaces()));
+}
+
+ChString &ChString::removeExtraSpacesInPlace()
+{
+    invalidateAsciiState();
+    data_.resize(collapseSpaces(data_.data(), data_.size(), &data_[0]));
+    return *this;
+}
+
+ChString &ChString::removeLeadingSpacesInPlace()
+{
+    invalidateAsciiState();
+    data_.erase(0, findFirstNotSpace(data_.data(), 0, data_.size()));
+    return *this;
+}
+
+ChString &ChString::removeTrailingSpacesInPlace()
+{
+    invalidateAsciiState();
+    data_.resize(findLastNotSpace(data_.data(), 0, data_.size()));
+    return *this;
+}
 
-    return ChString(std::regex_replace(lsr, std::regex(" +$"), ""));
+ChString &ChString::removeTrailingAndLeadingSpacesInPlace()
+{
+    invalidateAsciiState();
+    removeTrailingSpacesInPlace();
+    return removeLeadingSpacesInPlace();
+}
+
+std::string_view ChString::viewWithoutLeadingSpaces() const
+{
+    size_t begin = findFirstNotSpace(data_.data(), 0, data_.size());
+    return std::string_view(data_.data() + begin, data_.size() - begin);
+}
+
+std::string_view ChString::viewWithoutTrailingSpaces() const
+{
+    return std::string_view(data_.data(), findLastNotSpace(data_.data(), 0, data_.size()));
+}
+
+std::string_view ChString::viewWithoutTrailingAndLeadingSpaces() const
+{
+    size_t end = findLastNotSpace(data_.data(), 0, data_.size());
+    size_t begin = findFirstNotSpace(data_.data(), 0, end);
+    return std::string_view(data_.data() + begin, end - begin);
 }
 
 ChString ChString::removeAll(char delim)
@@ -362,6 +460,7 @@ char ChString::last() const
 
 char ChString::popFirst()
 {
+    invalidateAsciiState();
     if (data_.empty())
     {
         return '\0';
@@ -373,6 +472,7 @@ char ChString::popFirst()
 
 char ChString::popLast()
 {
+    invalidateAsciiState();
     if (data_.empty())
     {
         return '\0';
@@ -384,81 +484,74 @@ char ChString::popLast()
 
 bool ChString::contains(const ChString &value, bool isCaseSensitive) const
 {
-    std::string str = data_;
-    std::string subStr = value.getData();
-    if (!isCaseSensitive)
-    {
-        std::transform(str.begin(), str.end(), str.begin(), ::tolower);
-        std::transform(subStr.begin(), subStr.end(), subStr.begin(), ::tolower);
-    }
-    return str.find(subStr) != std::string::npos;
+    return ChStringMatcher::find(data_, value.data_, isCaseSensitive) != std::string_view::npos;
 }
 
 bool ChString::contains(const char *value, bool isCaseSensitive) const
 {
-    return contains(ChString(value), isCaseSensitive);
+    return ChStringMatcher::find(data_, value, isCaseSensitive) != std::string_view::npos;
+}
+
+bool ChString::contains(const ChStringMatcher &matcher) const
+{
+    return matcher.containedIn(data_);
 }
 
 int ChString::count(const ChString &value, bool isCaseSensitive) const
 {
-    std::string str = data_;
-    std::string subStr = value.getData();
-    int count = 0;
-    size_t pos = 0;
-    if (!isCaseSensitive)
-    {
-        std::transform(str.begin(), str.end(), str.begin(), ::tolower);
-        std::transform(subStr.begin(), subStr.end(), subStr.begin(), ::tolower);
-    }
-    while ((pos = str.find(subStr, pos)) != std::string::npos)
-    {
-        ++count;
-        pos += subStr.length();
-    }
-    return count;
+    return static_cast<int>(ChStringMatcher::count(data_, value.data_, isCaseSensitive));
+}
+
+int ChString::count(const ChStringMatcher &matcher) const
+{
+    return static_cast<int>(matcher.countIn(data_));
 }
 
 int ChString::count(const char *value, bool isCaseSensitive) const
 {
-    return count(ChString(value), isCaseSensitive);
+    return static_cast<int>(ChStringMatcher::count(data_, value, isCaseSensitive));
 }
 
 ChString ChString::toLower() const
 {
     std::string result = data_;
-    std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c)
-                   { return std::tolower(c); });
-    return result;
+    ChStringKernels::toLower(&result[0], result.size());
+    return ChString(std::move(result));
 }
 
 ChString ChString::toUpper() const
 {
     std::string result = data_;
-    std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c)
-                   { return std::toupper(c); });
-    return result;
+    ChStringKernels::toUpper(&result[0], result.size());
+    return ChString(std::move(result));
 }
 
 ChString ChString::capitalize() const
 {
     std::string result = data_;
-    bool newWord = true;
-    for (auto &c : result)
-    {
-        if (std::isalpha(c))
-        {
-            if (newWord)
-            {
-                c = std::toupper(c);
-                newWord = false;
-            }
-        }
-        else
-        {
-            newWord = true;
-        }
-    }
-    return result;
+    ChStringKernels::capitalize(&result[0], result.size());
+    return ChString(std::move(result));
+}
+
+ChString &ChString::toLowerInPlace()
+{
+    invalidateAsciiState();
+    ChStringKernels::toLower(&data_[0], data_.size());
+    return *this;
+}
+
+ChString &ChString::toUpperInPlace()
+{
+    invalidateAsciiState();
+    ChStringKernels::toUpper(&data_[0], data_.size());
+    return *this;
+}
+
+ChString &ChString::capitalizeInPlace()
+{
+    invalidateAsciiState();
+    ChStringKernels::capitalize(&data_[0], data_.size());
+    return *this;
 }
 
 bool ChString::beginsWith(const ChString &str) const
@@ -514,77 +607,207 @@ ChString ChString::erase(int first, int last) const
 
 ChString ChString::leftJustified(size_t width, char fill, bool truncate) const
 {
-    if (data_.size() >= width)
+    ChStringBuilder builder(std::max(width, data_.size()));
+    builder.appendLeftJustified(data_, width, fill, truncate);
+    return builder.build();
+}
+
+ChString ChString::rightJustified(size_t width, char fill, bool truncate) const
+{
+    ChStringBuilder builder(std::max(width, data_.size()));
+    builder.appendRightJustified(data_, width, fill, truncate);
+    return builder.build();
+}
+
+std::list<ChString> ChString::split(const ChString &separator, bool keepEmptyParts, bool caseSensitive) const
+{
+    std::list<ChString> result;
+    ChStringSplitter splitter(data_, separator.data_, keepEmptyParts, caseSensitive);
+    std::string_view part;
+    while (splitter.next(part))
     {
-        if (truncate)
-        {
-            return ChString(data_.substr(0, width));
-        }
-        else
-        {
-            return ChString(data_);
-        }
+        result.emplace_back(std::string(part));
     }
-    else
+    return result;
+}
+
+std::list<ChString> ChString::split(char separator, bool keepEmptyParts, bool caseSensitive) const
+{
+    std::list<ChString> result;
+    ChStringSplitter splitter(data_, separator, keepEmptyParts, caseSensitive);
+    std::string_view part;
+    while (splitter.next(part))
     {
-        return ChString(data_ + std::string(width - data_.size(), fill));
+        result.emplace_back(std::string(part));
     }
+    return result;
 }
 
-ChString ChString::rightJustified(size_t width, char fill, bool truncate) const
+std::vector<std::string_view> ChString::splitView(const ChString &separator, bool keepEmptyParts, bool caseSensitive) const
+{
+    ChStringSplitter splitter(data_, separator.data_, keepEmptyParts, caseSensitive);
+    return std::vector<std::string_view>(splitter.begin(), splitter.end());
+}
+
+std::vector<std::string_view> ChString::splitView(char separator, bool keepEmptyParts, bool caseSensitive) const
+{
+    ChStringSplitter splitter(data_, separator, keepEmptyParts, caseSensitive);
+    return std::vector<std::string_view>(splitter.begin(), splitter.end());
+}
+
+ChStringSplitter ChString::splitLazy(const ChString &separator, bool keepEmptyParts, bool caseSensitive) const
+{
+    return ChStringSplitter(data_, separator.data_, keepEmptyParts, caseSensitive);
+}
+
+ChStringSplitter ChString::splitLazy(char separator, bool keepEmptyParts, bool caseSensitive) const
+{
+    return ChStringSplitter(data_, separator, keepEmptyParts, caseSensitive);
+}
+
+size_t ChString::size() const
+{
+    return data_.size();
+}
+
+bool ChString::isAscii() const
 {
-    if (data_.size() >= width)
+    // Threads reading the same const string may fill in the cache at the same time; they store the same value
+    AsciiState state = asciiState_.load(std::memory_order_relaxed);
+    if (state == AsciiState::Ascii || state == AsciiState::NonAscii)
     {
-        if (truncate)
-        {
-            return ChString(data_.substr(data_.size() - width, width));
-        }
-        else
-        {
-            return ChString(data_);
-        }
+        return state == AsciiState::Ascii;
     }
-    else
+
+    bool ascii = ChStringKernels::isAscii(data_.data(), data_.size());
+    if (state == AsciiState::Unknown)
     {
-        return ChString(std::string(width - data_.size(), fill) + data_);
+        asciiState_.store(ascii ? AsciiState::Ascii : AsciiState::NonAscii, std::memory_order_relaxed);
     }
+    return ascii;
 }
 
-std::list<ChString> ChString::split(const ChString &separator, bool keepEmptyParts, bool caseSensitive) const
+bool ChString::isValidUtf8() const
 {
-    std::list<ChString> result;
-    size_t pos = 0;
-    size_t separatorLength = separator.data_.length();
-    std::string data = data_;
-    std::string sep = separator.data_;
-    while (pos <= data.length() - separatorLength)
+    return isAscii() || ChStringKernels::isValidUtf8(data_.data(), data_.size());
+}
+
+size_t ChString::codePointCount() const
+{
+    if (isAscii())
     {
-        if ((caseSensitive && data.substr(pos, separatorLength) == sep) || (!caseSensitive && ChString(data.substr(pos, separatorLength)).toLower().data_ == separator.toLower().data_))
-        {
-            result.push_back(data.substr(0, pos));
-            data = data.erase(0, pos + separatorLength - 1);
-            pos = 0;
-        }
-        else
-        {
-            ++pos;
-        }
+        return data_.size();
+    }
+    return ChStringKernels::countCodePoints(data_.data(), data_.size());
+}
+
+ChString ChString::utf8Substring(size_t start, size_t count) const
+{
+    if (isAscii())
+    {
+        return start < data_.size() ? ChString(data_.substr(start, count)) : ChString();
     }
-    if (keepEmptyParts || !data.empty())
+
+    size_t begin = ChStringKernels::advanceCodePoints(data_.data(), data_.size(), 0, start);
+    size_t end = ChStringKernels::advanceCodePoints(data_.data(), data_.size(), begin, count);
+    return ChString(data_.substr(begin, end - begin));
+}
+
+ChString ChString::utf8LeftJustified(size_t width, char fill, bool truncate) const
+{
+    size_t length = codePointCount();
+    if (length >= width)
     {
-        result.push_back(*this);
+        return truncate ? utf8Substring(0, width) : *this;
     }
-    return result;
+
+    ChStringBuilder builder(data_.size() + width - length);
+    builder.append(std::string_view(data_));
+    builder.append(fill, width - length);
+    return builder.build();
 }
 
-std::list<ChString> ChString::split(char separator, bool keepEmptyParts, bool caseSensitive) const
+ChString ChString::utf8RightJustified(size_t width, char fill, bool truncate) const
 {
-    return split(ChString(1, separator), keepEmptyParts, caseSensitive);
+    size_t length = codePointCount();
+    if (length >= width)
+    {
+        return truncate ? utf8Substring(length - width) : *this;
+    }
+
+    ChStringBuilder builder(data_.size() + width - length);
+    builder.append(fill, width - length);
+    builder.append(std::string_view(data_));
+    return builder.build();
 }
 
-size_t ChString::size() const
+char32_t ChString::utf8First() const
 {
-    return data_.size();
+    if (data_.empty())
+    {
+        return 0;
+    }
+    size_t length;
+    return ChStringKernels::decodeCodePoint(data_.data(), data_.size(), 0, length);
+}
+
+char32_t ChString::utf8Last() const
+{
+    if (data_.empty())
+    {
+        return 0;
+    }
+    size_t start = ChStringKernels::previousCodePoint(data_.data(), data_.size());
+    size_t length;
+    char32_t codePoint = ChStringKernels::decodeCodePoint(data_.data(), data_.size(), start, length);
+    // A malformed tail decodes as a single byte; report it as one replacement character
+    return start + length == data_.size() ? codePoint : 0xFFFD;
+}
+
+char32_t ChString::utf8PopFirst()
+{
+    if (data_.empty())
+    {
+        return 0;
+    }
+    size_t length;
+    char32_t codePoint = ChStringKernels::decodeCodePoint(data_.data(), data_.size(), 0, length);
+    data_.erase(0, length);
+    invalidateAsciiState();
+    return codePoint;
+}
+
+char32_t ChString::utf8PopLast()
+{
+    if (data_.empty())
+    {
+        return 0;
+    }
+    size_t start = ChStringKernels::previousCodePoint(data_.data(), data_.size());
+    size_t length;
+    char32_t codePoint = ChStringKernels::decodeCodePoint(data_.data(), data_.size(), start, length);
+    if (start + length != data_.size())
+    {
+        start = data_.size() - 1;
+        codePoint = 0xFFFD;
+    }
+    data_.resize(start);
+    invalidateAsciiState();
+    return codePoint;
+}
+
+void ChString::invalidateAsciiState()
+{
+    if (asciiState_.load(std::memory_order_relaxed) != AsciiState::Untracked)
+    {
+        asciiState_.store(AsciiState::Unknown, std::memory_order_relaxed);
+    }
+}
+
+ChString::AsciiState ChString::sharedAsciiState() const
+{
+    AsciiState state = asciiState_.load(std::memory_order_relaxed);
+    return state == AsciiState::Untracked ? AsciiState::Unknown : state;
 }
 
 const std::string &ChString::getData() const
@@ -1,9 +1,15 @@
 #ifndef CHSTRING
 #define CHSTRING
 
+#include <atomic>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <list>
+#include <vector>
+
+#include "ChStringMatcher.h"
+#include "ChStringSplitter.h"
 
 class ChString
 {
@@ -20,6 +26,13 @@ public:
      */
     ChString(const std::string &value);
 
+    /**
+     * @brief Overloaded constructor. Constructs the string by taking over the buffer of `value` without copying it.
+     *
+     * @param value A std::string object whose contents are moved into the string. `value` is left in a valid but unspecified state.
+     */
+    ChString(std::string &&value);
+
     /**
      * @brief Copy constructor. Constructs the string with the copy of the contents of `other`.
      *
@@ -39,7 +52,7 @@ public:
     * @param size The size of the new ChString object to be constructed
     * @param ch The character to be used for initialization of each character in the new ChString object
     */
-    ChString::ChString(size_t size, char ch);
+    ChString(size_t size, char ch);
 
     /**
      * @brief Move constructor. Constructs the string with the contents of `other` using move semantics.
@@ -105,6 +118,8 @@ public:
     /**
     * @brief Converts the given float to a string and assigns it to the data_ member.
     *
+    * The shortest representation that converts back to the same value is used.
+    *
     * @param num The float to be converted to a string.
     */
     void fromNumber(float num);
@@ -112,6 +127,8 @@ public:
     /**
     * @brief Converts the given double to a string and assigns it to the data_ member.
     *
+    * The shortest representation that converts back to the same value is used.
+    *
     * @param num The double to be converted to a string.
     */
     void fromNumber(double num);
@@ -151,6 +168,70 @@ public:
     */
     void fromNumber(unsigned long long num);
 
+    /**
+    * @brief Converts the given integer to a string and appends it to the data_ member without any intermediate buffer allocation.
+    *
+    * @param num The integer to be converted to a string.
+    * @return A reference to the current object.
+    */
+    ChString &appendNumber(int num);
+
+    /**
+    * @brief Converts the given float to a string and appends it to the data_ member without any intermediate buffer allocation.
+    *
+    * @param num The float to be converted to a string.
+    * @return A reference to the current object.
+    */
+    ChString &appendNumber(float num);
+
+    /**
+    * @brief Converts the given double to a string and appends it to the data_ member without any intermediate buffer allocation.
+    *
+    * @param num The double to be converted to a string.
+    * @return A reference to the current object.
+    */
+    ChString &appendNumber(double num);
+
+    /**
+    * @brief Converts the given unsigned integer to a string and appends it to the data_ member without any intermediate buffer allocation.
+    *
+    * @param num The unsigned integer to be converted to a string.
+    * @return A reference to the current object.
+    */
+    ChString &appendNumber(unsigned int num);
+
+    /**
+    * @brief Converts the given long integer to a string and appends it to the data_ member without any intermediate buffer allocation.
+    *
+    * @param num The long integer to be converted to a string.
+    * @return A reference to the current object.
+    */
+    ChString &appendNumber(long num);
+
+    /**
+    * @brief Converts the given unsigned long integer to a string and appends it to the data_ member without any intermediate buffer allocation.
+    *
+    * @param num The unsigned long integer to be converted to a string.
+    * @return A reference to the current object.
+    */
+    ChString &appendNumber(unsigned long num);
+
+    /**
+    * @brief Converts the given long long integer to a string and appends it to the data_ member without any intermediate buffer allocation.
+    *
+    * @param num The long long integer to be converted to a string.
+    * @return A reference to the current object.
+    */
+    ChString &appendNumber(long long num);
+
+    /**
+    * @brief Converts the given unsigned long long integer to a string and appends it to the data_ member without any intermediate buffer allocation.
+    *
+    * @param num The unsigned long long integer to be converted to a string.
+    * @return A reference to the current object.
+    */
+    ChString &appendNumber(unsigned long long num);
+
     /**
     * @brief Attempts to convert the string to an integer value and sets the valid flag accordingly.
     *
@@ -260,6 +341,61 @@ public:
     */
     ChString removeTrailingAndLeadingSpaces();
 
+    /**
+    * @brief Removes leading, trailing and consecutive space characters from the current object without allocating.
+    *
+    * @return A reference to the current object.
+    */
+    ChString &removeExtraSpacesInPlace();
+
+    /**
+    * @brief Removes leading space characters from the current object without allocating.
+    *
+    * @return A reference to the current object.
+    */
+    ChString &removeLeadingSpacesInPlace();
+
+    /**
+    * @brief Removes trailing space characters from the current object without allocating.
+    *
+    * @return A reference to the current object.
+    */
+    ChString &removeTrailingSpacesInPlace();
+
+    /**
+    * @brief Removes leading and trailing space characters from the current object without allocating.
+    *
+    * @return A reference to the current object.
+    */
+    ChString &removeTrailingAndLeadingSpacesInPlace();
+
+    /**
+    * @brief Returns a view of the current object that skips the leading space characters.
+    *
+    * The view refers to the data of the current object and is invalidated by any modification of it.
+    *
+    * @return A std::string_view of the current object without leading space characters.
+    */
+    std::string_view viewWithoutLeadingSpaces() const;
+
+    /**
+    * @brief Returns a view of the current object that skips the trailing space characters.
+    *
+    * The view refers to the data of the current object and is invalidated by any modification of it.
+    *
+    * @return A std::string_view of the current object without trailing space characters.
+    */
+    std::string_view viewWithoutTrailingSpaces() const;
+
+    /**
+    * @brief Returns a view of the current object that skips the leading and trailing space characters.
+    *
+    * The view refers to the data of the current object and is invalidated by any modification of it.
+    *
+    * @return A std::string_view of the current object without leading and trailing space characters.
+    */
+    std::string_view viewWithoutTrailingAndLeadingSpaces() const;
+
     /**
     * @brief Returns a new ChString object that is a substring of the current object that does not contain any delimiter character.
     *
@@ -275,7 +411,7 @@ public:
     * @param str The string to remove.
     * @return A new string with the first occurrence of `str` removed, or the original string if `str` was not found.
     */
-    ChString ChString::removeFirst(ChString str) const;
+    ChString removeFirst(ChString str) const;
 
     /**
     * @brief Remove the first occurrence of the specified string from this string.
@@ -283,7 +419,7 @@ public:
     * @param str The string to remove.
     * @return A new string with the first occurrence of `str` removed, or the original string if `str` was not found.
     */
-    ChString ChString::removeFirst(const char* str) const;
+    ChString removeFirst(const char* str) const;
 
     /**
     * @brief Remove the last occurrence of the specified string from this string.
@@ -291,7 +427,7 @@ public:
     * @param str The string to remove.
     * @return A new string with the last occurrence of `str` removed, or the original string if `str` was not found.
     */
-    ChString ChString::removeLast(ChString str) const;
+    ChString removeLast(ChString str) const;
 
     /**
     * @brief Remove the last occurrence of the specified string from this string.
@@ -299,7 +435,7 @@ public:
     * @param str The string to remove.
     * @return A new string with the last occurrence of `str` removed, or the original string if `str` was not found.
     */
-    ChString ChString::removeLast(const char* str) const;
+    ChString removeLast(const char* str) const;
 
     /**
     * @brief Returns the first character of the ChString
@@ -318,16 +454,18 @@ public:
     /**
     * @brief Removes and returns the first character of the ChString
     * 
+    * Each call moves the remaining characters; use ChStringCursor to consume a string from the front in a loop.
+    *
     * @return The first character of the ChString
     */
-    char ChString::popFirst();
+    char popFirst();
 
     /**
     * @brief Removes and returns the first character of the ChString
     * 
     * @return The last character of the ChString
     */
-    char ChString::popLast();
+    char popLast();
 
     /**
      * @brief Check if the string contains a given value.
@@ -347,6 +485,14 @@ public:
      */
     bool contains(const char* value, bool isCaseSensitive = false) const;
 
+    /**
+     * @brief Check if the string contains the needle of a precompiled matcher.
+     * 
+     * @param matcher The matcher holding the value to search for and its case sensitivity.
+     * @return true if the string contains the value, false otherwise.
+     */
+    bool contains(const ChStringMatcher& matcher) const;
+
     /**
      * @brief Count the number of occurrences of a given value in the string.
      * 
@@ -365,6 +511,14 @@ public:
      */
     int count(const char* value, bool isCaseSensitive = false) const;
 
+    /**
+     * @brief Count the number of occurrences of the needle of a precompiled matcher in the string.
+     * 
+     * @param matcher The matcher holding the value to count occurrences of and its case sensitivity.
+     * @return The number of occurrences of the value in the string.
+     */
+    int count(const ChStringMatcher& matcher) const;
+
     /**
      * @brief Returns the lower case version of the ChString
      * 
@@ -386,6 +540,27 @@ public:
      */
     ChString capitalize() const;
 
+    /**
+     * @brief Converts the ChString to lower case without allocating
+     * 
+     * @return A reference to the ChString
+     */
+    ChString &toLowerInPlace();
+
+    /**
+     * @brief Converts the ChString to upper case without allocating
+     * 
+     * @return A reference to the ChString
+     */
+    ChString &toUpperInPlace();
+
+    /**
+     * @brief Capitalizes the first character of each word in the ChString without allocating
+     * 
+     * @return A reference to the ChString
+     */
+    ChString &capitalizeInPlace();
+
     /**
      * @brief Check whether the ChString object begins with the specified ChString
      * 
@@ -482,6 +657,56 @@ public:
      */
     std::list<ChString> split(char seperator, bool keepEmptyParts = false , bool caseSensitive = false) const;
 
+    /**
+     * @brief Split the ChString object into views of its substrings using the specified separator
+     *
+     * The views refer to the data of the current object and are invalidated by any modification of it.
+     *
+     * @param separator The ChString to use as a separator
+     * @param keepEmptyParts If true, empty substrings will be included in the output vector
+     * @param caseSensitive If true, the separator will be matched case-sensitively
+     * @return A std::vector<std::string_view> containing the substrings of the ChString object
+     */
+    std::vector<std::string_view> splitView(const ChString &separator, bool keepEmptyParts = false, bool caseSensitive = false) const;
+
+    /**
+     * @brief Split the ChString object into views of its substrings using the specified separator
+     *
+     * The views refer to the data of the current object and are invalidated by any modification of it.
+     *
+     * @param separator The character to use as a separator
+     * @param keepEmptyParts If true, empty substrings will be included in the output vector
+     * @param caseSensitive If true, the separator will be matched case-sensitively
+     * @return A std::vector<std::string_view> containing the substrings of the ChString object
+     */
+    std::vector<std::string_view> splitView(char separator, bool keepEmptyParts = false, bool caseSensitive = false) const;
+
+    /**
+     * @brief Returns a splitter that produces the substrings of the ChString object one at a time
+     *
+     * Nothing is scanned until the splitter is advanced. The splitter refers to the data of the current object and is
+     * invalidated by any modification of it.
+     *
+     * @param separator The ChString to use as a separator
+     * @param keepEmptyParts If true, empty substrings will be produced as well
+     * @param caseSensitive If true, the separator will be matched case-sensitively
+     * @return A ChStringSplitter over the ChString object
+     */
+    ChStringSplitter splitLazy(const ChString &separator, bool keepEmptyParts = false, bool caseSensitive = false) const;
+
+    /**
+     * @brief Returns a splitter that produces the substrings of the ChString object one at a time
+     *
+     * Nothing is scanned until the splitter is advanced. The splitter refers to the data of the current object and is
+     * invalidated by any modification of it.
+     *
+     * @param separator The character to use as a separator
+     * @param keepEmptyParts If true, empty substrings will be produced as well
+     * @param caseSensitive If true, the separator will be matched case-sensitively
+     * @return A ChStringSplitter over the ChString object
+     */
+    ChStringSplitter splitLazy(char separator, bool keepEmptyParts = false, bool caseSensitive = false) const;
+
     /**
     * @brief Get the length of the string.
     * 
@@ -489,6 +714,91 @@ public:
     */
     size_t size() const;
 
+    /**
+     * @brief Checks whether the string consists of ASCII bytes only.
+     *
+     * The answer is cached until the string is modified, so the UTF-8 functions below can take byte based shortcuts
+     * for ASCII text at no extra cost.
+     *
+     * @return True if every byte is below 0x80.
+     */
+    bool isAscii() const;
+
+    /**
+     * @brief Checks whether the string is well-formed UTF-8.
+     *
+     * Overlong encodings, surrogates, truncated sequences and code points above U+10FFFF are rejected.
+     *
+     * @return True if the string is valid UTF-8.
+     */
+    bool isValidUtf8() const;
+
+    /**
+     * @brief Get the length of the string in UTF-8 code points.
+     *
+     * Bytes that cannot start a sequence are counted as one code point each if they are not continuation bytes.
+     *
+     * @return The number of code points.
+     */
+    size_t codePointCount() const;
+
+    /**
+     * @brief Returns a substring of the ChString object indexed by code points instead of bytes.
+     *
+     * @param start The index of the first code point of the substring
+     * @param count The number of code points to take, npos for the rest of the string
+     * @return A new ChString object containing the substring, empty if start is past the end
+     */
+    ChString utf8Substring(size_t start, size_t count = std::string::npos) const;
+
+    /**
+     * @brief Returns a string of `width` code points that contains this string padded by the fill character.
+     *
+     * @param width The width of the new string in code points
+     * @param fill The ASCII character used for padding
+     * @param truncate If true, the string is cut to `width` code points when it is longer
+     * @return The left justified ChString object
+     */
+    ChString utf8LeftJustified(size_t width, char fill = ' ', bool truncate = false) const;
+
+    /**
+     * @brief Returns a string of `width` code points that contains the fill character followed by this string.
+     *
+     * @param width The width of the new string in code points
+     * @param fill The ASCII character used for padding
+     * @param truncate If true, only the last `width` code points are kept when the string is longer
+     * @return The right justified ChString object
+     */
+    ChString utf8RightJustified(size_t width, char fill = ' ', bool truncate = false) const;
+
+    /**
+     * @brief Returns the first code point of the string.
+     *
+     * @return The decoded code point, U+FFFD if the first sequence is malformed, or 0 if the string is empty.
+     */
+    char32_t utf8First() const;
+
+    /**
+     * @brief Returns the last code point of the string.
+     *
+     * @return The decoded code point, U+FFFD if the last sequence is malformed, or 0 if the string is empty.
+     */
+    char32_t utf8Last() const;
+
+    /**
+     * @brief Removes the first code point from the string and returns it.
+     *
+     * @return The removed code point, U+FFFD if it was malformed, or 0 if the string is empty.
+     */
+    char32_t utf8PopFirst();
+
+    /**
+     * @brief Removes the last code point from the string and returns it.
+     *
+     * @return The removed code point, U+FFFD if it was malformed, or 0 if the string is empty.
+     */
+    char32_t utf8PopLast();
+
     /**
     * @brief Returns the current string data stored in the ChString object as a std::string object.
     *
@@ -497,7 +807,31 @@ public:
     const std::string& getData() const;
 
 private:
+    /**
+     * @brief What is known about the bytes of data_. Untracked once a mutable reference to data_ was handed out.
+     */
+    enum class AsciiState : unsigned char
+    {
+        Unknown,
+        Ascii,
+        NonAscii,
+        Untracked
+    };
+
+    /**
+     * @brief Forgets the cached ASCII flag after a modification.
+     */
+    void invalidateAsciiState();
+
+    /**
+     * @brief Returns the cached ASCII flag in a form that can be handed to a copy of this string.
+     */
+    AsciiState sharedAsciiState() const;
+
     std::string data_;
+
+    // Written by const methods that fill in the cache, hence atomic: const methods must stay safe to call concurrently
+    mutable std::atomic<AsciiState> asciiState_;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "ChStringBuilder.h"
+#include "ChStringConversion.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Growth is rounded up to whole chunks so that many tiny appends do not trigger many small reallocations
+    const size_t growthChunkSize = 256;
+}
+
+ChStringBuilder::ChStringBuilder()
+{
+}
+
+ChStringBuilder::ChStringBuilder(size_t capacity)
+{
+    buffer_.reserve(capacity);
+}
+
+ChStringBuilder &ChStringBuilder::reserve(size_t capacity)
+{
+    buffer_.reserve(capacity);
+    return *this;
+}
+
+ChStringBuilder &ChStringBuilder::append(const ChString &str)
+{
+    return append(std::string_view(str.getData()));
+}
+
+ChStringBuilder &ChStringBuilder::append(std::string_view str)
+{
+    ensureRoom(str.size());
+    buffer_.append(str.data(), str.size());
+    return *this;
+}
+
+ChStringBuilder &ChStringBuilder::append(const std::string &str)
+{
+    return append(std::string_view(str));
+}
+
+ChStringBuilder &ChStringBuilder::append(const char *str)
+{
+    return append(std::string_view(str));
+}
+
+ChStringBuilder &ChStringBuilder::append(char ch)
+{
+    ensureRoom(1);
+    buffer_.push_back(ch);
+    return *this;
+}
+
+ChStringBuilder &ChStringBuilder::append(char ch, size_t count)
+{
+    ensureRoom(count);
+    buffer_.append(count, ch);
+    return *this;
+}
+
+ChStringBuilder &ChStringBuilder::appendLeftJustified(std::string_view str, size_t width, char fill, bool truncate)
+{
+    if (str.size() >= width)
+    {
+        return append(truncate ? str.substr(0, width) : str);
+    }
+    ensureRoom(width);
+    buffer_.append(str.data(), str.size());
+    buffer_.append(width - str.size(), fill);
+    return *this;
+}
+
+ChStringBuilder &ChStringBuilder::appendLeftJustified(const ChString &str, size_t width, char fill, bool truncate)
+{
+    return appendLeftJustified(std::string_view(str.getData()), width, fill, truncate);
+}
+
+ChStringBuilder &ChStringBuilder::appendLeftJustified(const std::string &str, size_t width, char fill, bool truncate)
+{
+    return appendLeftJustified(std::string_view(str), width, fill, truncate);
+}
+
+ChStringBuilder &ChStringBuilder::appendLeftJustified(const char *str, size_t width, char fill, bool truncate)
+{
+    return appendLeftJustified(std::string_view(str), width, fill, truncate);
+}
+
+ChStringBuilder &ChStringBuilder::appendRightJustified(std::string_view str, size_t width, char fill, bool truncate)
+{
+    if (str.size() >= width)
+    {
+        return append(truncate ? str.substr(str.size() - width) : str);
+    }
+    ensureRoom(width);
+    buffer_.append(width - str.size(), fill);
+    buffer_.append(str.data(), str.size());
+    return *this;
+}
+
+ChStringBuilder &ChStringBuilder::appendRightJustified(const ChString &str, size_t width, char fill, bool truncate)
+{
+    return appendRightJustified(std::string_view(str.getData()), width, fill, truncate);
+}
+
+ChStringBuilder &ChStringBuilder::appendRightJustified(const std::string &str, size_t width, char fill, bool truncate)
+{
+    return appendRightJustified(std::string_view(str), width, fill, truncate);
+}
+
+ChStringBuilder &ChStringBuilder::appendRightJustified(const char *str, size_t width, char fill, bool truncate)
+{
+    return appendRightJustified(std::string_view(str), width, fill, truncate);
+}
+
+ChStringBuilder &ChStringBuilder::appendNumber(int num)
+{
+    ensureRoom(ChStringConversion::maxNumberLength);
+    ChStringConversion::appendNumber(buffer_, num);
+    return *this;
+}
+
+ChStringBuilder &ChStringBuilder::appendNumber(float num)
+{
+    ensureRoom(ChStringConversion::maxNumberLength);
+    ChStringConversion::appendNumber(buffer_, num);
+    return *this;
+}
+
+ChStringBuilder &ChStringBuilder::appendNumber(double num)
+{
+    ensureRoom(ChStringConversion::maxNumberLength);
+    ChStringConversion::appendNumber(buffer_, num);
+    return *this;
+}
+
+ChStringBuilder &ChStringBuilder::appendNumber(unsigned int num)
+{
+    ensureRoom(ChStringConversion::maxNumberLength);
+    ChStringConversion::appendNumber(buffer_, num);
+    return *this;
+}
+
+ChStringBuilder &ChStringBuilder::appendNumber(long num)
+{
+    ensureRoom(ChStringConversion::maxNumberLength);
+    ChStringConversion::appendNumber(buffer_, num);
+    return *this;
+}
+
+ChStringBuilder &ChStringBuilder::appendNumber(unsigned long num)
+{
+    ensureRoom(ChStringConversion::maxNumberLength);
+    ChStringConversion::appendNumber(buffer_, num);
+    return *this;
+}
+
+ChStringBuilder &ChStringBuilder::appendNumber(long long num)
+{
+    ensureRoom(ChStringConversion::maxNumberLength);
+    ChStringConversion::appendNumber(buffer_, num);
+    return *this;
+}
+
+ChStringBuilder &ChStringBuilder::appendNumber(unsigned long long num)
+{
+    ensureRoom(ChStringConversion::maxNumberLength);
+    ChStringConversion::appendNumber(buffer_, num);
+    return *this;
+}
+
+size_t ChStringBuilder::size() const
+{
+    return buffer_.size();
+}
+
+size_t ChStringBuilder::capacity() const
+{
+    return buffer_.capacity();
+}
+
+bool ChStringBuilder::isEmpty() const
+{
+    return buffer_.empty();
+}
+
+std::string_view ChStringBuilder::view() const
+{
+    return buffer_;
+}
+
+void ChStringBuilder::clear()
+{
+    buffer_.clear();
+}
+
+ChString ChStringBuilder::build()
+{
+    ChString result(std::move(buffer_));
+    buffer_.clear();
+    return result;
+}
+
+void ChStringBuilder::ensureRoom(size_t additional)
+{
+    size_t required = buffer_.size() + additional;
+    if (required <= buffer_.capacity())
+    {
+        return;
+    }
+
+    size_t rounded = (required + growthChunkSize - 1) / growthChunkSize * growthChunkSize;
+    buffer_.reserve(std::max(rounded, buffer_.capacity() * 2));
+}
@@ -0,0 +1,231 @@
+#ifndef CHSTRINGBUILDER
+#define CHSTRINGBUILDER
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+#include "ChString.h"
+
+/**
+ * @brief Accumulates pieces of text into a single buffer and hands it over to a ChString at the end.
+ *
+ * Every append writes directly into one growing buffer, so building a string from N pieces costs amortized O(total
+ * length) and a logarithmic number of allocations, or a single allocation when the final size is reserved up front.
+ * `build()` moves the buffer into the resulting ChString without copying it.
+ *
+ * @code
+ * ChStringBuilder builder(64);
+ * builder.append("id=").appendNumber(id).append(' ').appendLeftJustified(name, 16);
+ * ChString line = builder.build();
+ * @endcode
+ */
+class ChStringBuilder
+{
+public:
+    /**
+     * @brief Default constructor. Constructs an empty builder without allocating.
+     */
+    ChStringBuilder();
+
+    /**
+     * @brief Constructs an empty builder with room for `capacity` characters.
+     *
+     * @param capacity The number of characters to reserve.
+     */
+    explicit ChStringBuilder(size_t capacity);
+
+    /**
+     * @brief Makes sure at least `capacity` characters fit without another allocation.
+     *
+     * @param capacity The total number of characters to make room for.
+     * @return A reference to the builder.
+     */
+    ChStringBuilder &reserve(size_t capacity);
+
+    /**
+     * @brief Appends the contents of a ChString.
+     *
+     * @param str The ChString to append.
+     * @return A reference to the builder.
+     */
+    ChStringBuilder &append(const ChString &str);
+
+    /**
+     * @brief Appends a sequence of characters.
+     *
+     * @param str The characters to append.
+     * @return A reference to the builder.
+     */
+    ChStringBuilder &append(std::string_view str);
+
+    /**
+     * @brief Appends the contents of a std::string. Without this overload the call would be ambiguous, because a
+     * std::string converts to both std::string_view and ChString.
+     *
+     * @param str The std::string to append.
+     * @return A reference to the builder.
+     */
+    ChStringBuilder &append(const std::string &str);
+
+    /**
+     * @brief Appends a null-terminated C string.
+     *
+     * @param str The null-terminated C string to append.
+     * @return A reference to the builder.
+     */
+    ChStringBuilder &append(const char *str);
+
+    /**
+     * @brief Appends a single character.
+     *
+     * @param ch The character to append.
+     * @return A reference to the builder.
+     */
+    ChStringBuilder &append(char ch);
+
+    /**
+     * @brief Appends a character repeatedly.
+     *
+     * @param ch The character to append.
+     * @param count The number of times to append it.
+     * @return A reference to the builder.
+     */
+    ChStringBuilder &append(char ch, size_t count);
+
+    /**
+     * @brief Appends `str` left-justified within a field of the specified width.
+     *
+     * @param str The characters to append.
+     * @param width The width of the field to be filled
+     * @param fill The character to use for padding the field
+     * @param truncate Whether to keep only the first `width` characters of `str` if it is longer than the field
+     * @return A reference to the builder.
+     */
+    ChStringBuilder &appendLeftJustified(std::string_view str, size_t width, char fill = ' ', bool truncate = false);
+
+    /**
+     * @brief Overload of `appendLeftJustified` for ChString.
+     */
+    ChStringBuilder &appendLeftJustified(const ChString &str, size_t width, char fill = ' ', bool truncate = false);
+
+    /**
+     * @brief Overload of `appendLeftJustified` for std::string, which converts to both std::string_view and ChString.
+     */
+    ChStringBuilder &appendLeftJustified(const std::string &str, size_t width, char fill = ' ', bool truncate = false);
+
+    /**
+     * @brief Overload of `appendLeftJustified` for null-terminated C strings, which convert to both std::string_view
+     * and ChString.
+     */
+    ChStringBuilder &appendLeftJustified(const char *str, size_t width, char fill = ' ', bool truncate = false);
+
+    /**
+     * @brief Appends `str` right-justified within a field of the specified width.
+     *
+     * @param str The characters to append.
+     * @param width The width of the field to be filled
+     * @param fill The character to use for padding the field
+     * @param truncate Whether to keep only the last `width` characters of `str` if it is longer than the field
+     * @return A reference to the builder.
+     */
+    ChStringBuilder &appendRightJustified(std::string_view str, size_t width, char fill = ' ', bool truncate = false);
+
+    /**
+     * @brief Overload of `appendRightJustified` for ChString.
+     */
+    ChStringBuilder &appendRightJustified(const ChString &str, size_t width, char fill = ' ', bool truncate = false);
+
+    /**
+     * @brief Overload of `appendRightJustified` for std::string, which converts to both std::string_view and ChString.
+     */
+    ChStringBuilder &appendRightJustified(const std::string &str, size_t width, char fill = ' ', bool truncate = false);
+
+    /**
+     * @brief Overload of `appendRightJustified` for null-terminated C strings, which convert to both std::string_view
+     * and ChString.
+     */
+    ChStringBuilder &appendRightJustified(const char *str, size_t width, char fill = ' ', bool truncate = false);
+
+    /**
+     * @brief Appends the decimal representation of an integer.
+     */
+    ChStringBuilder &appendNumber(int num);
+
+    /**
+     * @brief Appends the shortest decimal representation of a float that converts back to the same value.
+     */
+    ChStringBuilder &appendNumber(float num);
+
+    /**
+     * @brief Appends the shortest decimal representation of a double that converts back to the same value.
+     */
+    ChStringBuilder &appendNumber(double num);
+
+    /**
+     * @brief Appends the decimal representation of an unsigned integer.
+     */
+    ChStringBuilder &appendNumber(unsigned int num);
+
+    /**
+     * @brief Appends the decimal representation of a long integer.
+     */
+    ChStringBuilder &appendNumber(long num);
+
+    /**
+     * @brief Appends the decimal representation of an unsigned long integer.
+     */
+    ChStringBuilder &appendNumber(unsigned long num);
+
+    /**
+     * @brief Appends the decimal representation of a long long integer.
+     */
+    ChStringBuilder &appendNumber(long long num);
+
+    /**
+     * @brief Appends the decimal representation of an unsigned long long integer.
+     */
+    ChStringBuilder &appendNumber(unsigned long long num);
+
+    /**
+     * @brief Returns the number of characters appended so far.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the number of characters that fit without another allocation.
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Checks whether nothing has been appended.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Returns a view of the characters appended so far. It is invalidated by the next append.
+     */
+    std::string_view view() const;
+
+    /**
+     * @brief Discards the appended characters and keeps the allocated capacity.
+     */
+    void clear();
+
+    /**
+     * @brief Moves the accumulated characters into a ChString without copying them. The builder is left empty.
+     *
+     * @return A ChString holding the accumulated characters.
+     */
+    ChString build();
+
+private:
+    /**
+     * @brief Grows the buffer so that `additional` more characters fit.
+     */
+    void ensureRoom(size_t additional);
+
+    std::string buffer_;
+};
+
+#endif
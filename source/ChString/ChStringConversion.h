@@ -0,0 +1,107 @@
+#ifndef CHSTRINGCONVERSION
+#define CHSTRINGCONVERSION
+
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+/**
+ * @brief Locale independent, non-throwing number conversions shared by ChString and its companions. Not part of the
+ * public interface.
+ */
+namespace ChStringConversion
+{
+    // Large enough for the shortest round-trip representation of any built-in arithmetic type
+    const size_t maxNumberLength = 64;
+
+    // Inputs longer than this are copied to the heap instead of a stack buffer when their spaces are stripped
+    const size_t maxInlineParseLength = 128;
+
+    /**
+     * @brief Appends the shortest decimal representation of `value` that round-trips to `out`.
+     */
+    template <typename T>
+    inline void appendNumber(std::string &out, T value)
+    {
+        char buffer[maxNumberLength];
+        std::to_chars_result result = std::to_chars(buffer, buffer + maxNumberLength, value);
+        out.append(buffer, result.ptr);
+    }
+
+    /**
+     * @brief Parses the whole of `text` as a decimal number. A single leading '+' is accepted.
+     *
+     * @return true if every character was consumed and the value is representable in T, false otherwise.
+     */
+    template <typename T>
+    inline bool parseExact(std::string_view text, T &value)
+    {
+        if (text.size() > 1 && text[0] == '+' && text[1] != '-')
+        {
+            text.remove_prefix(1);
+        }
+
+        const char *end = text.data() + text.size();
+        std::from_chars_result result;
+        if constexpr (std::is_floating_point<T>::value)
+        {
+            result = std::from_chars(text.data(), end, value, std::chars_format::general);
+        }
+        else
+        {
+            result = std::from_chars(text.data(), end, value);
+        }
+        return result.ec == std::errc() && result.ptr == end && !text.empty();
+    }
+
+    /**
+     * @brief Parses `text` as a decimal number after discarding every space character in it.
+     *
+     * Strings without spaces are parsed in place. Otherwise the remaining characters are gathered on the stack, and
+     * only unusually long inputs are copied to the heap.
+     *
+     * @return The parsed value, or a value-initialized T if `text` is not a valid number; `valid` reports which.
+     */
+    template <typename T>
+    inline T parseNumber(std::string_view text, bool &valid)
+    {
+        T value = T();
+
+        if (text.find(' ') == std::string_view::npos)
+        {
+            valid = parseExact(text, value);
+        }
+        else if (text.size() <= maxInlineParseLength)
+        {
+            char buffer[maxInlineParseLength];
+            size_t length = 0;
+            for (char c : text)
+            {
+                if (c != ' ')
+                {
+                    buffer[length++] = c;
+                }
+            }
+            valid = parseExact(std::string_view(buffer, length), value);
+        }
+        else
+        {
+            std::string compact;
+            compact.reserve(text.size());
+            for (char c : text)
+            {
+                if (c != ' ')
+                {
+                    compact.push_back(c);
+                }
+            }
+            valid = parseExact(std::string_view(compact), value);
+        }
+
+        return valid ? value : T();
+    }
+}
+
+#endif
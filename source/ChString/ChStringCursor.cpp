@@ -0,0 +1,182 @@
+#include "ChStringCursor.h"
+
+#include <algorithm>
+
+ChStringCursor::ChStringCursor() : head_(0)
+{
+}
+
+ChStringCursor::ChStringCursor(std::string_view value) : buffer_(value), head_(0)
+{
+}
+
+ChStringCursor::ChStringCursor(const char *value) : buffer_(value), head_(0)
+{
+}
+
+ChStringCursor::ChStringCursor(const std::string &value) : buffer_(value), head_(0)
+{
+}
+
+ChStringCursor::ChStringCursor(std::string &&value) : buffer_(std::move(value)), head_(0)
+{
+}
+
+ChStringCursor::ChStringCursor(const ChString &value) : buffer_(value.getData()), head_(0)
+{
+}
+
+ChStringCursor::ChStringCursor(ChString &&value) : buffer_(std::move(static_cast<std::string &>(value))), head_(0)
+{
+}
+
+ChStringCursor &ChStringCursor::append(std::string_view value)
+{
+    compactIfWasteful();
+    buffer_.append(value);
+    return *this;
+}
+
+ChStringCursor &ChStringCursor::append(char ch)
+{
+    compactIfWasteful();
+    buffer_.push_back(ch);
+    return *this;
+}
+
+char ChStringCursor::first() const
+{
+    return head_ < buffer_.size() ? buffer_[head_] : '\0';
+}
+
+char ChStringCursor::last() const
+{
+    return head_ < buffer_.size() ? buffer_.back() : '\0';
+}
+
+char ChStringCursor::popFirst()
+{
+    if (head_ == buffer_.size())
+    {
+        return '\0';
+    }
+    return buffer_[head_++];
+}
+
+std::string_view ChStringCursor::popFirst(size_t count)
+{
+    std::string_view result(buffer_.data() + head_, std::min(count, size()));
+    head_ += result.size();
+    return result;
+}
+
+char ChStringCursor::popLast()
+{
+    if (head_ == buffer_.size())
+    {
+        return '\0';
+    }
+    char c = buffer_.back();
+    buffer_.pop_back();
+    return c;
+}
+
+size_t ChStringCursor::skip(size_t count)
+{
+    count = std::min(count, size());
+    head_ += count;
+    return count;
+}
+
+bool ChStringCursor::beginsWith(std::string_view prefix) const
+{
+    return view().substr(0, prefix.size()) == prefix;
+}
+
+bool ChStringCursor::endsWith(std::string_view suffix) const
+{
+    std::string_view remaining = view();
+    return remaining.size() >= suffix.size() && remaining.substr(remaining.size() - suffix.size()) == suffix;
+}
+
+bool ChStringCursor::removePrefix(std::string_view prefix)
+{
+    if (!beginsWith(prefix))
+    {
+        return false;
+    }
+    head_ += prefix.size();
+    return true;
+}
+
+bool ChStringCursor::removeFirst(std::string_view str)
+{
+    if (removePrefix(str))
+    {
+        return true;
+    }
+
+    size_t position = view().find(str);
+    if (position == std::string_view::npos)
+    {
+        return false;
+    }
+    buffer_.erase(head_ + position, str.size());
+    return true;
+}
+
+size_t ChStringCursor::indexOf(char ch, size_t from) const
+{
+    return view().find(ch, from);
+}
+
+char ChStringCursor::operator[](size_t index) const
+{
+    return buffer_[head_ + index];
+}
+
+size_t ChStringCursor::size() const
+{
+    return buffer_.size() - head_;
+}
+
+bool ChStringCursor::isEmpty() const
+{
+    return head_ == buffer_.size();
+}
+
+std::string_view ChStringCursor::view() const
+{
+    return std::string_view(buffer_.data() + head_, buffer_.size() - head_);
+}
+
+size_t ChStringCursor::consumed() const
+{
+    return head_;
+}
+
+void ChStringCursor::compact()
+{
+    buffer_.erase(0, head_);
+    head_ = 0;
+}
+
+void ChStringCursor::clear()
+{
+    buffer_.clear();
+    head_ = 0;
+}
+
+ChString ChStringCursor::toChString() const
+{
+    return ChString(std::string(view()));
+}
+
+void ChStringCursor::compactIfWasteful()
+{
+    // Moving the live characters costs no more than the characters consumed since the last compaction
+    if (head_ > 0 && head_ >= buffer_.size() - head_)
+    {
+        compact();
+    }
+}
@@ -0,0 +1,232 @@
+#ifndef CHSTRINGCURSOR
+#define CHSTRINGCURSOR
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+#include "ChString.h"
+
+/**
+ * @brief A string that is consumed from the front, as done by tokenizers and stream parsers.
+ *
+ * Consumed characters are not erased; the cursor only advances a head offset, so `popFirst`, `skip` and
+ * `removePrefix` are O(1). The consumed bytes are reclaimed lazily when new data is appended and at least half of the
+ * buffer is dead, which keeps appending amortized O(1) as well. Call `compact()` to release them explicitly.
+ *
+ * Views returned by the cursor stay valid while characters are only consumed from the front; appending, compacting
+ * or removing characters elsewhere invalidates them.
+ *
+ * @code
+ * ChStringCursor cursor(std::move(payload));
+ * while (!cursor.isEmpty())
+ * {
+ *     char c = cursor.popFirst();
+ *     ...
+ * }
+ * @endcode
+ */
+class ChStringCursor
+{
+public:
+    /**
+     * @brief Default constructor. Constructs an empty cursor.
+     */
+    ChStringCursor();
+
+    /**
+     * @brief Constructs the cursor with a copy of the characters of `value`.
+     *
+     * @param value The characters to consume.
+     */
+    ChStringCursor(std::string_view value);
+
+    /**
+     * @brief Constructs the cursor with a copy of a null-terminated C string.
+     *
+     * @param value The characters to consume.
+     */
+    ChStringCursor(const char *value);
+
+    /**
+     * @brief Constructs the cursor with a copy of the contents of `value`.
+     *
+     * @param value The std::string to consume.
+     */
+    ChStringCursor(const std::string &value);
+
+    /**
+     * @brief Constructs the cursor by taking over the buffer of `value`.
+     *
+     * @param value The std::string to consume.
+     */
+    ChStringCursor(std::string &&value);
+
+    /**
+     * @brief Constructs the cursor with a copy of the contents of `value`.
+     *
+     * @param value The ChString to consume.
+     */
+    ChStringCursor(const ChString &value);
+
+    /**
+     * @brief Constructs the cursor by taking over the buffer of `value`, which is left empty.
+     *
+     * @param value The ChString to consume.
+     */
+    ChStringCursor(ChString &&value);
+
+    /**
+     * @brief Appends characters behind the unconsumed ones. May compact the buffer first.
+     *
+     * @param value The characters to append.
+     * @return A reference to the cursor.
+     */
+    ChStringCursor &append(std::string_view value);
+
+    /**
+     * @brief Appends a character behind the unconsumed ones. May compact the buffer first.
+     *
+     * @param ch The character to append.
+     * @return A reference to the cursor.
+     */
+    ChStringCursor &append(char ch);
+
+    /**
+     * @brief Returns the first unconsumed character.
+     *
+     * @return The first character, or '\0' if the cursor is empty.
+     */
+    char first() const;
+
+    /**
+     * @brief Returns the last unconsumed character.
+     *
+     * @return The last character, or '\0' if the cursor is empty.
+     */
+    char last() const;
+
+    /**
+     * @brief Consumes and returns the first character in constant time.
+     *
+     * @return The first character, or '\0' if the cursor is empty.
+     */
+    char popFirst();
+
+    /**
+     * @brief Consumes and returns up to `count` characters in constant time.
+     *
+     * @param count The number of characters to consume.
+     * @return A view of the consumed characters.
+     */
+    std::string_view popFirst(size_t count);
+
+    /**
+     * @brief Removes and returns the last character.
+     *
+     * @return The last character, or '\0' if the cursor is empty.
+     */
+    char popLast();
+
+    /**
+     * @brief Consumes up to `count` characters in constant time.
+     *
+     * @param count The number of characters to skip.
+     * @return The number of characters actually skipped.
+     */
+    size_t skip(size_t count);
+
+    /**
+     * @brief Checks whether the unconsumed characters begin with `prefix`.
+     *
+     * @param prefix The prefix to check for.
+     * @return True if the unconsumed characters begin with `prefix`.
+     */
+    bool beginsWith(std::string_view prefix) const;
+
+    /**
+     * @brief Checks whether the unconsumed characters end with `suffix`.
+     *
+     * @param suffix The suffix to check for.
+     * @return True if the unconsumed characters end with `suffix`.
+     */
+    bool endsWith(std::string_view suffix) const;
+
+    /**
+     * @brief Consumes `prefix` if the unconsumed characters begin with it.
+     *
+     * @param prefix The prefix to consume.
+     * @return True if the prefix was consumed.
+     */
+    bool removePrefix(std::string_view prefix);
+
+    /**
+     * @brief Removes the first occurrence of `str` from the unconsumed characters.
+     *
+     * An occurrence at the front is consumed in constant time; one further in is erased from the buffer.
+     *
+     * @param str The string to remove.
+     * @return True if an occurrence was removed.
+     */
+    bool removeFirst(std::string_view str);
+
+    /**
+     * @brief Returns the position of the first occurrence of `ch` among the unconsumed characters.
+     *
+     * @param ch The character to search for.
+     * @param from The position to start the search at.
+     * @return The position, or std::string_view::npos if there is none.
+     */
+    size_t indexOf(char ch, size_t from = 0) const;
+
+    /**
+     * @brief Returns the unconsumed character at `index`. No bounds checking is performed.
+     */
+    char operator[](size_t index) const;
+
+    /**
+     * @brief Returns the number of unconsumed characters.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Checks whether all characters have been consumed.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Returns a view of the unconsumed characters.
+     */
+    std::string_view view() const;
+
+    /**
+     * @brief Returns the number of consumed characters that still occupy the buffer.
+     */
+    size_t consumed() const;
+
+    /**
+     * @brief Releases the consumed characters from the buffer.
+     */
+    void compact();
+
+    /**
+     * @brief Drops all characters, consumed or not. The buffer capacity is kept.
+     */
+    void clear();
+
+    /**
+     * @brief Returns a ChString object containing a copy of the unconsumed characters.
+     */
+    ChString toChString() const;
+
+private:
+    /**
+     * @brief Compacts the buffer when the consumed characters take at least as much room as the unconsumed ones.
+     */
+    void compactIfWasteful();
+
+    std::string buffer_;
+    size_t head_;
+};
+
+#endif
\ No newline at end of file
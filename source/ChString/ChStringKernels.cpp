@@ -0,0 +1,462 @@
+#include "ChStringKernels.h"
+#include "ChStringSimd.h"
+#include "ChCpuFeatures.h"
+
+#include <cctype>
+
+namespace
+{
+    using ChStringSimd::asciiToLower;
+    using ChStringSimd::asciiToUpper;
+    using ChBits::countTrailingZeros;
+
+    using CaseKernel = void (*)(char *, size_t, bool);
+    using CapitalizeKernel = bool (*)(char *, size_t, bool);
+
+    inline bool isAsciiLetter(unsigned char c)
+    {
+        return static_cast<unsigned char>((c | 0x20) - 'a') < 26;
+    }
+
+    void convertCaseScalar(char *data, size_t size, bool upper)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            unsigned char c = static_cast<unsigned char>(data[i]);
+            if (c < 0x80)
+            {
+                data[i] = upper ? asciiToUpper(data[i]) : asciiToLower(data[i]);
+            }
+            else
+            {
+                data[i] = static_cast<char>(upper ? std::toupper(c) : std::tolower(c));
+            }
+        }
+    }
+
+    /**
+     * @brief Capitalizes words starting after a letter if `previousIsLetter` is set. Returns whether the last
+     * character is a letter.
+     */
+    bool capitalizeScalar(char *data, size_t size, bool previousIsLetter)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            unsigned char c = static_cast<unsigned char>(data[i]);
+            bool letter = c < 0x80 ? isAsciiLetter(c) : std::isalpha(c) != 0;
+            if (letter && !previousIsLetter)
+            {
+                data[i] = c < 0x80 ? asciiToUpper(data[i]) : static_cast<char>(std::toupper(c));
+            }
+            previousIsLetter = letter;
+        }
+        return previousIsLetter;
+    }
+
+    /**
+     * @brief Upper cases the word starts among the letters in `letters`, a bit mask of the block at `data`.
+     */
+    inline bool capitalizeStarts(char *data, unsigned letters, unsigned width, bool previousIsLetter)
+    {
+        unsigned starts = letters & ~((letters << 1) | (previousIsLetter ? 1u : 0u));
+        while (starts != 0)
+        {
+            unsigned index = countTrailingZeros(starts);
+            data[index] = asciiToUpper(data[index]);
+            starts &= starts - 1;
+        }
+        return ((letters >> (width - 1)) & 1u) != 0;
+    }
+
+#if defined(CHSTRING_USE_SSE2)
+    void convertCaseSse2(char *data, size_t size, bool upper)
+    {
+        const __m128i below = _mm_set1_epi8(upper ? 'a' - 1 : 'A' - 1);
+        const __m128i above = _mm_set1_epi8(upper ? 'z' + 1 : 'Z' + 1);
+        const __m128i flip = _mm_set1_epi8(0x20);
+
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            if (_mm_movemask_epi8(block) != 0)
+            {
+                convertCaseScalar(data + i, 16, upper);
+                continue;
+            }
+            __m128i inRange = _mm_and_si128(_mm_cmpgt_epi8(block, below), _mm_cmplt_epi8(block, above));
+            block = _mm_xor_si128(block, _mm_and_si128(inRange, flip));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), block);
+        }
+        convertCaseScalar(data + i, size - i, upper);
+    }
+
+    bool capitalizeSse2(char *data, size_t size, bool previousIsLetter)
+    {
+        const __m128i below = _mm_set1_epi8('a' - 1);
+        const __m128i above = _mm_set1_epi8('z' + 1);
+        const __m128i fold = _mm_set1_epi8(0x20);
+
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            if (_mm_movemask_epi8(block) != 0)
+            {
+                previousIsLetter = capitalizeScalar(data + i, 16, previousIsLetter);
+                continue;
+            }
+            __m128i folded = _mm_or_si128(block, fold);
+            __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(folded, below), _mm_cmplt_epi8(folded, above));
+            previousIsLetter = capitalizeStarts(data + i, static_cast<unsigned>(_mm_movemask_epi8(letters)), 16, previousIsLetter);
+        }
+        return capitalizeScalar(data + i, size - i, previousIsLetter);
+    }
+#endif
+
+#if defined(CHSTRING_USE_AVX2_DISPATCH)
+    CHSTRING_TARGET_AVX2 void convertCaseAvx2(char *data, size_t size, bool upper)
+    {
+        const __m256i below = _mm256_set1_epi8(upper ? 'a' - 1 : 'A' - 1);
+        const __m256i above = _mm256_set1_epi8(upper ? 'z' + 1 : 'Z' + 1);
+        const __m256i flip = _mm256_set1_epi8(0x20);
+
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            if (_mm256_movemask_epi8(block) != 0)
+            {
+                convertCaseScalar(data + i, 32, upper);
+                continue;
+            }
+            __m256i inRange = _mm256_and_si256(_mm256_cmpgt_epi8(block, below), _mm256_cmpgt_epi8(above, block));
+            block = _mm256_xor_si256(block, _mm256_and_si256(inRange, flip));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i), block);
+        }
+        convertCaseScalar(data + i, size - i, upper);
+    }
+
+    CHSTRING_TARGET_AVX2 bool capitalizeAvx2(char *data, size_t size, bool previousIsLetter)
+    {
+        const __m256i below = _mm256_set1_epi8('a' - 1);
+        const __m256i above = _mm256_set1_epi8('z' + 1);
+        const __m256i fold = _mm256_set1_epi8(0x20);
+
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            if (_mm256_movemask_epi8(block) != 0)
+            {
+                previousIsLetter = capitalizeScalar(data + i, 32, previousIsLetter);
+                continue;
+            }
+            __m256i folded = _mm256_or_si256(block, fold);
+            __m256i letters = _mm256_and_si256(_mm256_cmpgt_epi8(folded, below), _mm256_cmpgt_epi8(above, folded));
+            previousIsLetter = capitalizeStarts(data + i, static_cast<unsigned>(_mm256_movemask_epi8(letters)), 32, previousIsLetter);
+        }
+        return capitalizeScalar(data + i, size - i, previousIsLetter);
+    }
+#endif
+
+    using AsciiScanKernel = size_t (*)(const char *, size_t, size_t);
+    using CountKernel = size_t (*)(const char *, size_t);
+
+    inline bool isContinuation(unsigned char c)
+    {
+        return (c & 0xC0) == 0x80;
+    }
+
+    size_t skipAsciiScalar(const char *data, size_t from, size_t size)
+    {
+        while (from < size && static_cast<unsigned char>(data[from]) < 0x80)
+        {
+            ++from;
+        }
+        return from;
+    }
+
+    size_t countContinuationsScalar(const char *data, size_t size)
+    {
+        size_t result = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            result += isContinuation(static_cast<unsigned char>(data[i])) ? 1 : 0;
+        }
+        return result;
+    }
+
+#if defined(CHSTRING_USE_SSE2)
+    size_t skipAsciiSse2(const char *data, size_t from, size_t size)
+    {
+        while (size - from >= 16)
+        {
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + from))));
+            if (mask != 0)
+            {
+                return from + countTrailingZeros(mask);
+            }
+            from += 16;
+        }
+        return skipAsciiScalar(data, from, size);
+    }
+
+    size_t countContinuationsSse2(const char *data, size_t size)
+    {
+        // Continuation bytes 0x80-0xBF are exactly the signed bytes below -64
+        const __m128i limit = _mm_set1_epi8(-64);
+        size_t result = 0;
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            result += ChBits::popCount(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(limit, block))));
+        }
+        return result + countContinuationsScalar(data + i, size - i);
+    }
+#endif
+
+#if defined(CHSTRING_USE_AVX2_DISPATCH)
+    CHSTRING_TARGET_AVX2 size_t skipAsciiAvx2(const char *data, size_t from, size_t size)
+    {
+        while (size - from >= 32)
+        {
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + from))));
+            if (mask != 0)
+            {
+                return from + countTrailingZeros(mask);
+            }
+            from += 32;
+        }
+        return skipAsciiScalar(data, from, size);
+    }
+
+    CHSTRING_TARGET_AVX2 size_t countContinuationsAvx2(const char *data, size_t size)
+    {
+        const __m256i limit = _mm256_set1_epi8(-64);
+        size_t result = 0;
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            result += ChBits::popCount(static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(limit, block))));
+        }
+        return result + countContinuationsScalar(data + i, size - i);
+    }
+#endif
+
+    AsciiScanKernel selectAsciiScanKernel()
+    {
+#if defined(CHSTRING_USE_AVX2_DISPATCH)
+        if (ChCpuFeatures::hasAvx2())
+        {
+            return skipAsciiAvx2;
+        }
+#endif
+#if defined(CHSTRING_USE_SSE2)
+        return skipAsciiSse2;
+#else
+        return skipAsciiScalar;
+#endif
+    }
+
+    CountKernel selectCountKernel()
+    {
+#if defined(CHSTRING_USE_AVX2_DISPATCH)
+        if (ChCpuFeatures::hasAvx2())
+        {
+            return countContinuationsAvx2;
+        }
+#endif
+#if defined(CHSTRING_USE_SSE2)
+        return countContinuationsSse2;
+#else
+        return countContinuationsScalar;
+#endif
+    }
+
+    /**
+     * @brief Returns the index of the first byte at or after `from` that is not ASCII, or `size`.
+     */
+    size_t skipAscii(const char *data, size_t from, size_t size)
+    {
+        static const AsciiScanKernel kernel = selectAsciiScanKernel();
+        return kernel(data, from, size);
+    }
+
+    /**
+     * @brief Decodes one sequence at `position`. Returns false for malformed input.
+     */
+    bool decodeSequence(const unsigned char *data, size_t size, size_t position, char32_t &codePoint, size_t &length)
+    {
+        unsigned char lead = data[position];
+        char32_t minimum;
+        if (lead < 0x80)
+        {
+            codePoint = lead;
+            length = 1;
+            return true;
+        }
+        else if ((lead & 0xE0) == 0xC0)
+        {
+            length = 2;
+            minimum = 0x80;
+            codePoint = lead & 0x1F;
+        }
+        else if ((lead & 0xF0) == 0xE0)
+        {
+            length = 3;
+            minimum = 0x800;
+            codePoint = lead & 0x0F;
+        }
+        else if ((lead & 0xF8) == 0xF0)
+        {
+            length = 4;
+            minimum = 0x10000;
+            codePoint = lead & 0x07;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (size - position < length)
+        {
+            return false;
+        }
+        for (size_t i = 1; i < length; ++i)
+        {
+            unsigned char next = data[position + i];
+            if (!isContinuation(next))
+            {
+                return false;
+            }
+            codePoint = (codePoint << 6) | (next & 0x3F);
+        }
+        return codePoint >= minimum && codePoint <= 0x10FFFF && (codePoint < 0xD800 || codePoint > 0xDFFF);
+    }
+
+    CaseKernel selectCaseKernel()
+    {
+#if defined(CHSTRING_USE_AVX2_DISPATCH)
+        if (ChCpuFeatures::hasAvx2())
+        {
+            return convertCaseAvx2;
+        }
+#endif
+#if defined(CHSTRING_USE_SSE2)
+        return convertCaseSse2;
+#else
+        return convertCaseScalar;
+#endif
+    }
+
+    CapitalizeKernel selectCapitalizeKernel()
+    {
+#if defined(CHSTRING_USE_AVX2_DISPATCH)
+        if (ChCpuFeatures::hasAvx2())
+        {
+            return capitalizeAvx2;
+        }
+#endif
+#if defined(CHSTRING_USE_SSE2)
+        return capitalizeSse2;
+#else
+        return capitalizeScalar;
+#endif
+    }
+}
+
+void ChStringKernels::toLower(char *data, size_t size)
+{
+    static const CaseKernel kernel = selectCaseKernel();
+    kernel(data, size, false);
+}
+
+void ChStringKernels::toUpper(char *data, size_t size)
+{
+    static const CaseKernel kernel = selectCaseKernel();
+    kernel(data, size, true);
+}
+
+void ChStringKernels::capitalize(char *data, size_t size)
+{
+    static const CapitalizeKernel kernel = selectCapitalizeKernel();
+    kernel(data, size, false);
+}
+
+bool ChStringKernels::isAscii(const char *data, size_t size)
+{
+    return skipAscii(data, 0, size) == size;
+}
+
+bool ChStringKernels::isValidUtf8(const char *data, size_t size)
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+    size_t position = 0;
+    while (position < size)
+    {
+        if (bytes[position] < 0x80)
+        {
+            position = skipAscii(data, position, size);
+            continue;
+        }
+
+        char32_t codePoint;
+        size_t length;
+        if (!decodeSequence(bytes, size, position, codePoint, length))
+        {
+            return false;
+        }
+        position += length;
+    }
+    return true;
+}
+
+size_t ChStringKernels::countCodePoints(const char *data, size_t size)
+{
+    static const CountKernel kernel = selectCountKernel();
+    return size - kernel(data, size);
+}
+
+size_t ChStringKernels::advanceCodePoints(const char *data, size_t size, size_t from, size_t count)
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+    while (count > 0 && from < size)
+    {
+        ++from;
+        while (from < size && isContinuation(bytes[from]))
+        {
+            ++from;
+        }
+        --count;
+    }
+    return from;
+}
+
+size_t ChStringKernels::previousCodePoint(const char *data, size_t end)
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+    size_t start = end;
+    while (start > 0)
+    {
+        --start;
+        if (!isContinuation(bytes[start]) || end - start == 4)
+        {
+            break;
+        }
+    }
+    return start;
+}
+
+char32_t ChStringKernels::decodeCodePoint(const char *data, size_t size, size_t position, size_t &length)
+{
+    char32_t codePoint;
+    if (decodeSequence(reinterpret_cast<const unsigned char *>(data), size, position, codePoint, length))
+    {
+        return codePoint;
+    }
+    length = 1;
+    return 0xFFFD;
+}
@@ -0,0 +1,65 @@
+#ifndef CHSTRINGKERNELS
+#define CHSTRINGKERNELS
+
+#include <cstddef>
+
+/**
+ * @brief Byte level kernels behind the ChString case conversions and UTF-8 support. Not part of the public interface.
+ *
+ * Every vectorized kernel picks the widest implementation the running processor supports on first use: AVX2, then
+ * SSE2, then scalar. Blocks of pure ASCII are transformed with vector range compares; blocks containing other bytes
+ * fall back to std::tolower / std::toupper / std::isalpha so locale dependent results are preserved.
+ */
+namespace ChStringKernels
+{
+    /**
+     * @brief Converts `size` characters at `data` to lower case in place.
+     */
+    void toLower(char *data, size_t size);
+
+    /**
+     * @brief Converts `size` characters at `data` to upper case in place.
+     */
+    void toUpper(char *data, size_t size);
+
+    /**
+     * @brief Converts the first letter of every word of the `size` characters at `data` to upper case in place.
+     */
+    void capitalize(char *data, size_t size);
+
+    /**
+     * @brief Checks whether all `size` bytes at `data` are below 0x80.
+     */
+    bool isAscii(const char *data, size_t size);
+
+    /**
+     * @brief Checks whether the `size` bytes at `data` are well-formed UTF-8: no overlong encodings, surrogates,
+     * truncated sequences or code points above U+10FFFF.
+     */
+    bool isValidUtf8(const char *data, size_t size);
+
+    /**
+     * @brief Counts the code points of the `size` bytes at `data` by counting the bytes that do not continue a sequence.
+     */
+    size_t countCodePoints(const char *data, size_t size);
+
+    /**
+     * @brief Returns the byte offset reached after stepping over `count` code points starting at byte offset `from`,
+     * clamped to `size`.
+     */
+    size_t advanceCodePoints(const char *data, size_t size, size_t from, size_t count);
+
+    /**
+     * @brief Returns the byte offset at which the code point ending right before byte offset `end` starts.
+     */
+    size_t previousCodePoint(const char *data, size_t end);
+
+    /**
+     * @brief Decodes the code point starting at byte offset `position`, which must be below `size`.
+     *
+     * @return The code point, or U+FFFD for a malformed sequence. `length` is set to the number of bytes consumed.
+     */
+    char32_t decodeCodePoint(const char *data, size_t size, size_t position, size_t &length);
+}
+
+#endif
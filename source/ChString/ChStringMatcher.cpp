@@ -0,0 +1,305 @@
+#include "ChStringMatcher.h"
+#include "ChStringSimd.h"
+#include "ChCpuFeatures.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    using ChStringSimd::asciiToLower;
+    using ChStringSimd::asciiToUpper;
+    using ChBits::countTrailingZeros;
+
+    // Needles at least this long are searched with the Horspool skip table
+    const size_t horspoolThreshold = 16;
+
+    /**
+     * @brief Compares `size` characters of `a` and `b`, folding ASCII letters unless `caseSensitive` is set.
+     */
+    inline bool equalAt(const char *a, const char *b, size_t size, bool caseSensitive)
+    {
+        if (caseSensitive)
+        {
+            return std::memcmp(a, b, size) == 0;
+        }
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (asciiToLower(a[i]) != asciiToLower(b[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Fills the 256 entry Horspool skip table of `needle`.
+     */
+    void buildSkipTable(const char *needle, size_t size, bool caseSensitive, size_t *skip)
+    {
+        std::fill(skip, skip + 256, size);
+        for (size_t i = 0; i + 1 < size; ++i)
+        {
+            unsigned char c = static_cast<unsigned char>(needle[i]);
+            if (caseSensitive)
+            {
+                skip[c] = size - 1 - i;
+            }
+            else
+            {
+                skip[static_cast<unsigned char>(asciiToLower(c))] = size - 1 - i;
+                skip[static_cast<unsigned char>(asciiToUpper(c))] = size - 1 - i;
+            }
+        }
+    }
+
+    /**
+     * @brief Boyer-Moore-Horspool search. Requires `from + size <= haystackSize` for a hit to be possible.
+     */
+    size_t horspoolSearch(const char *haystack, size_t haystackSize, const char *needle, size_t size, bool caseSensitive, size_t from, const size_t *skip)
+    {
+        const char last = asciiToLower(needle[size - 1]);
+        while (from + size <= haystackSize)
+        {
+            char c = haystack[from + size - 1];
+            bool lastMatches = caseSensitive ? (c == needle[size - 1]) : (asciiToLower(c) == last);
+            if (lastMatches && equalAt(haystack + from, needle, size - 1, caseSensitive))
+            {
+                return from;
+            }
+            from += skip[static_cast<unsigned char>(c)];
+        }
+        return std::string_view::npos;
+    }
+
+#if defined(CHSTRING_USE_AVX2_DISPATCH)
+    /**
+     * @brief AVX2 variant of the block loop of filterSearch over 32 positions at a time.
+     *
+     * Advances `from` past every block it has fully examined and returns the first match, or npos if the remaining
+     * positions are fewer than a block.
+     */
+    CHSTRING_TARGET_AVX2 size_t filterBlocksAvx2(const char *haystack, size_t last, const char *needle, size_t size, bool caseSensitive, size_t &from)
+    {
+        const char firstLower = caseSensitive ? needle[0] : asciiToLower(needle[0]);
+        const char firstUpper = caseSensitive ? needle[0] : asciiToUpper(needle[0]);
+        const char lastLower = caseSensitive ? needle[size - 1] : asciiToLower(needle[size - 1]);
+        const char lastUpper = caseSensitive ? needle[size - 1] : asciiToUpper(needle[size - 1]);
+        const size_t middle = size > 2 ? size - 2 : 0;
+
+        const __m256i firstLowerBlock = _mm256_set1_epi8(firstLower);
+        const __m256i firstUpperBlock = _mm256_set1_epi8(firstUpper);
+        const __m256i lastLowerBlock = _mm256_set1_epi8(lastLower);
+        const __m256i lastUpperBlock = _mm256_set1_epi8(lastUpper);
+
+        while (from + 31 <= last)
+        {
+            __m256i heads = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + from));
+            __m256i tails = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + from + size - 1));
+            __m256i headHits = _mm256_or_si256(_mm256_cmpeq_epi8(heads, firstLowerBlock), _mm256_cmpeq_epi8(heads, firstUpperBlock));
+            __m256i tailHits = _mm256_or_si256(_mm256_cmpeq_epi8(tails, lastLowerBlock), _mm256_cmpeq_epi8(tails, lastUpperBlock));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(headHits, tailHits)));
+
+            while (mask != 0)
+            {
+                size_t candidate = from + countTrailingZeros(mask);
+                if (equalAt(haystack + candidate + 1, needle + 1, middle, caseSensitive))
+                {
+                    return candidate;
+                }
+                mask &= mask - 1;
+            }
+            from += 32;
+        }
+        return std::string_view::npos;
+    }
+#endif
+
+    /**
+     * @brief Finds candidate positions by their first and last characters in blocks of 32 or 16 bytes and verifies the middle.
+     *
+     * Requires `size >= 1` and `from + size <= haystackSize`.
+     */
+    size_t filterSearch(const char *haystack, size_t haystackSize, const char *needle, size_t size, bool caseSensitive, size_t from)
+    {
+        const size_t last = haystackSize - size;
+        const char firstLower = caseSensitive ? needle[0] : asciiToLower(needle[0]);
+        const char firstUpper = caseSensitive ? needle[0] : asciiToUpper(needle[0]);
+        const char lastLower = caseSensitive ? needle[size - 1] : asciiToLower(needle[size - 1]);
+        const char lastUpper = caseSensitive ? needle[size - 1] : asciiToUpper(needle[size - 1]);
+        const size_t middle = size > 2 ? size - 2 : 0;
+
+#if defined(CHSTRING_USE_AVX2_DISPATCH)
+        static const bool useAvx2 = ChCpuFeatures::hasAvx2();
+        if (useAvx2)
+        {
+            size_t found = filterBlocksAvx2(haystack, last, needle, size, caseSensitive, from);
+            if (found != std::string_view::npos)
+            {
+                return found;
+            }
+        }
+#endif
+
+#if defined(CHSTRING_USE_SSE2)
+        const __m128i firstLowerBlock = _mm_set1_epi8(firstLower);
+        const __m128i firstUpperBlock = _mm_set1_epi8(firstUpper);
+        const __m128i lastLowerBlock = _mm_set1_epi8(lastLower);
+        const __m128i lastUpperBlock = _mm_set1_epi8(lastUpper);
+
+        // Every one of the 16 positions of a block must be a valid start
+        while (from + 15 <= last)
+        {
+            __m128i heads = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + from));
+            __m128i tails = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + from + size - 1));
+            __m128i headHits = _mm_or_si128(_mm_cmpeq_epi8(heads, firstLowerBlock), _mm_cmpeq_epi8(heads, firstUpperBlock));
+            __m128i tailHits = _mm_or_si128(_mm_cmpeq_epi8(tails, lastLowerBlock), _mm_cmpeq_epi8(tails, lastUpperBlock));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(headHits, tailHits)));
+
+            while (mask != 0)
+            {
+                size_t candidate = from + countTrailingZeros(mask);
+                if (equalAt(haystack + candidate + 1, needle + 1, middle, caseSensitive))
+                {
+                    return candidate;
+                }
+                mask &= mask - 1;
+            }
+            from += 16;
+        }
+#endif
+
+        for (; from <= last; ++from)
+        {
+            char head = haystack[from];
+            char tail = haystack[from + size - 1];
+            if ((head == firstLower || head == firstUpper) && (tail == lastLower || tail == lastUpper) &&
+                equalAt(haystack + from + 1, needle + 1, middle, caseSensitive))
+            {
+                return from;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    /**
+     * @brief Dispatches a search to the kernel suited for the needle. `skip` may be null for long needles, in which
+     * case a temporary table is built.
+     */
+    size_t search(std::string_view haystack, std::string_view needle, bool caseSensitive, size_t from, const size_t *skip)
+    {
+        const size_t size = needle.size();
+        if (from > haystack.size())
+        {
+            return std::string_view::npos;
+        }
+        if (size == 0)
+        {
+            return from;
+        }
+        if (haystack.size() - from < size)
+        {
+            return std::string_view::npos;
+        }
+
+        if (size == 1 && caseSensitive)
+        {
+            const void *hit = std::memchr(haystack.data() + from, needle[0], haystack.size() - from);
+            return hit ? static_cast<size_t>(static_cast<const char *>(hit) - haystack.data()) : std::string_view::npos;
+        }
+
+        if (size >= horspoolThreshold)
+        {
+            size_t localSkip[256];
+            if (!skip)
+            {
+                buildSkipTable(needle.data(), size, caseSensitive, localSkip);
+                skip = localSkip;
+            }
+            return horspoolSearch(haystack.data(), haystack.size(), needle.data(), size, caseSensitive, from, skip);
+        }
+
+        return filterSearch(haystack.data(), haystack.size(), needle.data(), size, caseSensitive, from);
+    }
+
+    /**
+     * @brief Counts the non-overlapping occurrences of `needle`, reusing `skip` when it is provided.
+     */
+    size_t countOccurrences(std::string_view haystack, std::string_view needle, bool caseSensitive, const size_t *skip)
+    {
+        if (needle.empty())
+        {
+            return 0;
+        }
+
+        size_t localSkip[256];
+        if (!skip && needle.size() >= horspoolThreshold)
+        {
+            buildSkipTable(needle.data(), needle.size(), caseSensitive, localSkip);
+            skip = localSkip;
+        }
+
+        size_t result = 0;
+        size_t pos = 0;
+        while ((pos = search(haystack, needle, caseSensitive, pos, skip)) != std::string_view::npos)
+        {
+            ++result;
+            pos += needle.size();
+        }
+        return result;
+    }
+}
+
+ChStringMatcher::ChStringMatcher(std::string_view needle, bool caseSensitive) : needle_(needle), caseSensitive_(caseSensitive)
+{
+    if (!caseSensitive_)
+    {
+        std::transform(needle_.begin(), needle_.end(), needle_.begin(), asciiToLower);
+    }
+    if (needle_.size() >= horspoolThreshold)
+    {
+        skip_.resize(256);
+        buildSkipTable(needle_.data(), needle_.size(), caseSensitive_, skip_.data());
+    }
+}
+
+size_t ChStringMatcher::indexIn(std::string_view haystack, size_t from) const
+{
+    return search(haystack, needle_, caseSensitive_, from, skip_.empty() ? nullptr : skip_.data());
+}
+
+bool ChStringMatcher::containedIn(std::string_view haystack) const
+{
+    return indexIn(haystack) != std::string_view::npos;
+}
+
+size_t ChStringMatcher::countIn(std::string_view haystack) const
+{
+    return countOccurrences(haystack, needle_, caseSensitive_, skip_.empty() ? nullptr : skip_.data());
+}
+
+const std::string &ChStringMatcher::needle() const
+{
+    return needle_;
+}
+
+size_t ChStringMatcher::size() const
+{
+    return needle_.size();
+}
+
+bool ChStringMatcher::isCaseSensitive() const
+{
+    return caseSensitive_;
+}
+
+size_t ChStringMatcher::find(std::string_view haystack, std::string_view needle, bool caseSensitive, size_t from)
+{
+    return search(haystack, needle, caseSensitive, from, nullptr);
+}
+
+size_t ChStringMatcher::count(std::string_view haystack, std::string_view needle, bool caseSensitive)
+{
+    return countOccurrences(haystack, needle, caseSensitive, nullptr);
+}
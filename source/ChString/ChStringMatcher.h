@@ -0,0 +1,97 @@
+#ifndef CHSTRINGMATCHER
+#define CHSTRINGMATCHER
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief A precompiled needle for repeated substring searches.
+ *
+ * The needle is folded and analysed once at construction, so searching the same token across many haystacks does
+ * not copy or fold it again. Haystacks are never copied: case-insensitive matching folds ASCII letters on the fly
+ * while comparing.
+ *
+ * Short needles are located with a vectorized scan for their first and last characters, long needles with a
+ * Boyer-Moore-Horspool skip table.
+ */
+class ChStringMatcher
+{
+public:
+    /**
+     * @brief Constructs a matcher for `needle`.
+     *
+     * @param needle The character sequence to search for. It is copied into the matcher.
+     * @param caseSensitive If true, ASCII letters are matched case-sensitively.
+     */
+    ChStringMatcher(std::string_view needle, bool caseSensitive = false);
+
+    /**
+     * @brief Returns the position of the first occurrence of the needle in `haystack` at or after `from`.
+     *
+     * @param haystack The character sequence to search in.
+     * @param from The position to start the search at.
+     * @return The position of the occurrence, or std::string_view::npos if there is none. An empty needle is found at `from`.
+     */
+    size_t indexIn(std::string_view haystack, size_t from = 0) const;
+
+    /**
+     * @brief Checks whether the needle occurs in `haystack`.
+     *
+     * @param haystack The character sequence to search in.
+     * @return true if the needle occurs in `haystack`, false otherwise.
+     */
+    bool containedIn(std::string_view haystack) const;
+
+    /**
+     * @brief Counts the non-overlapping occurrences of the needle in `haystack`.
+     *
+     * @param haystack The character sequence to search in.
+     * @return The number of occurrences. An empty needle is never counted.
+     */
+    size_t countIn(std::string_view haystack) const;
+
+    /**
+     * @brief Returns the needle, folded to lower case if the matcher is case-insensitive.
+     */
+    const std::string &needle() const;
+
+    /**
+     * @brief Returns the length of the needle.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Checks whether the matcher is case-sensitive.
+     */
+    bool isCaseSensitive() const;
+
+    /**
+     * @brief Finds `needle` in `haystack` without building a matcher or copying either sequence.
+     *
+     * @param haystack The character sequence to search in.
+     * @param needle The character sequence to search for.
+     * @param caseSensitive If true, ASCII letters are matched case-sensitively.
+     * @param from The position to start the search at.
+     * @return The position of the occurrence, or std::string_view::npos if there is none.
+     */
+    static size_t find(std::string_view haystack, std::string_view needle, bool caseSensitive, size_t from = 0);
+
+    /**
+     * @brief Counts the non-overlapping occurrences of `needle` in `haystack` without building a matcher or copying either sequence.
+     *
+     * @param haystack The character sequence to search in.
+     * @param needle The character sequence to search for.
+     * @param caseSensitive If true, ASCII letters are matched case-sensitively.
+     * @return The number of occurrences. An empty needle is never counted.
+     */
+    static size_t count(std::string_view haystack, std::string_view needle, bool caseSensitive);
+
+private:
+    std::string needle_;
+    bool caseSensitive_;
+    std::vector<size_t> skip_;
+};
+
+#endif
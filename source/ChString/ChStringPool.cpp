@@ -0,0 +1,304 @@
+#include "ChStringPool.h"
+
+#include <cstring>
+#include <new>
+
+struct ChStringPoolEntry
+{
+    size_t hash;
+    size_t size;
+    uint32_t id;
+    char data[1];
+};
+
+struct ChStringPool::Table
+{
+    size_t mask;
+    std::atomic<const ChStringPoolEntry *> *slots;
+};
+
+namespace
+{
+    // The first identifier segment holds 2^firstSegmentBits entries, every following one twice as many
+    const unsigned firstSegmentBits = 10;
+    const size_t initialTableCapacity = 64;
+
+    /**
+     * @brief Maps a 1-based identifier to its segment and the position inside the segment.
+     */
+    void locateId(uint32_t id, size_t &segment, size_t &offset)
+    {
+        size_t adjusted = static_cast<size_t>(id - 1) + (size_t(1) << firstSegmentBits);
+        unsigned bit = 0;
+        while ((adjusted >> (bit + 1)) != 0)
+        {
+            ++bit;
+        }
+        segment = bit - firstSegmentBits;
+        offset = adjusted - (size_t(1) << bit);
+    }
+}
+
+ChInternedString::ChInternedString() : entry_(nullptr)
+{
+}
+
+ChInternedString::ChInternedString(const ChStringPoolEntry *entry) : entry_(entry)
+{
+}
+
+uint32_t ChInternedString::id() const
+{
+    return entry_ ? entry_->id : 0;
+}
+
+std::string_view ChInternedString::view() const
+{
+    return entry_ ? std::string_view(entry_->data, entry_->size) : std::string_view();
+}
+
+size_t ChInternedString::size() const
+{
+    return entry_ ? entry_->size : 0;
+}
+
+size_t ChInternedString::hash() const
+{
+    return entry_ ? entry_->hash : 0;
+}
+
+bool ChInternedString::isNull() const
+{
+    return entry_ == nullptr;
+}
+
+ChString ChInternedString::toChString() const
+{
+    return ChString(std::string(view()));
+}
+
+bool ChInternedString::operator==(const ChInternedString &other) const
+{
+    return entry_ == other.entry_;
+}
+
+bool ChInternedString::operator!=(const ChInternedString &other) const
+{
+    return entry_ != other.entry_;
+}
+
+bool ChInternedString::operator<(const ChInternedString &other) const
+{
+    return id() < other.id();
+}
+
+double ChStringPool::Statistics::hitRate() const
+{
+    return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+}
+
+ChStringPool::ChStringPool() : table_(createTable(initialTableCapacity)), size_(0), bytes_(0)
+{
+    for (size_t i = 0; i < segmentCount; ++i)
+    {
+        segments_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    for (Counters &counters : counters_)
+    {
+        counters.lookups.store(0, std::memory_order_relaxed);
+        counters.hits.store(0, std::memory_order_relaxed);
+    }
+}
+
+ChStringPool::~ChStringPool()
+{
+    Table *table = table_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i <= table->mask; ++i)
+    {
+        const ChStringPoolEntry *entry = table->slots[i].load(std::memory_order_relaxed);
+        if (entry)
+        {
+            ::operator delete(const_cast<ChStringPoolEntry *>(entry));
+        }
+    }
+    destroyTable(table);
+
+    for (Table *retired : retiredTables_)
+    {
+        destroyTable(retired);
+    }
+    for (size_t i = 0; i < segmentCount; ++i)
+    {
+        delete[] segments_[i].load(std::memory_order_relaxed);
+    }
+}
+
+ChInternedString ChStringPool::intern(std::string_view value)
+{
+    Counters &counters = countersOfThread();
+    counters.lookups.fetch_add(1, std::memory_order_relaxed);
+
+    size_t hash = std::hash<std::string_view>()(value);
+    const ChStringPoolEntry *entry = lookup(table_.load(std::memory_order_acquire), value, hash);
+    if (entry)
+    {
+        counters.hits.fetch_add(1, std::memory_order_relaxed);
+        return ChInternedString(entry);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Another thread may have interned the string while we were waiting for the lock
+    Table *table = table_.load(std::memory_order_relaxed);
+    entry = lookup(table, value, hash);
+    if (entry)
+    {
+        counters.hits.fetch_add(1, std::memory_order_relaxed);
+        return ChInternedString(entry);
+    }
+
+    size_t size = size_.load(std::memory_order_relaxed);
+    if ((size + 1) * 2 > table->mask + 1)
+    {
+        // Readers may still be probing the old table, so it is retired instead of freed
+        Table *grown = createTable((table->mask + 1) * 2);
+        for (size_t i = 0; i <= table->mask; ++i)
+        {
+            const ChStringPoolEntry *existing = table->slots[i].load(std::memory_order_relaxed);
+            if (existing)
+            {
+                place(grown, existing);
+            }
+        }
+        retiredTables_.push_back(table);
+        table_.store(grown, std::memory_order_release);
+        table = grown;
+    }
+
+    void *memory = ::operator new(offsetof(ChStringPoolEntry, data) + value.size() + 1);
+    ChStringPoolEntry *created = new (memory) ChStringPoolEntry;
+    created->hash = hash;
+    created->size = value.size();
+    created->id = static_cast<uint32_t>(size + 1);
+    std::memcpy(created->data, value.data(), value.size());
+    created->data[value.size()] = '\0';
+
+    record(created);
+    place(table, created);
+    bytes_ += value.size();
+    size_.store(size + 1, std::memory_order_release);
+    return ChInternedString(created);
+}
+
+ChInternedString ChStringPool::find(std::string_view value) const
+{
+    size_t hash = std::hash<std::string_view>()(value);
+    return ChInternedString(lookup(table_.load(std::memory_order_acquire), value, hash));
+}
+
+ChInternedString ChStringPool::fromId(uint32_t id) const
+{
+    if (id == 0 || id > size_.load(std::memory_order_acquire))
+    {
+        return ChInternedString();
+    }
+
+    size_t segment;
+    size_t offset;
+    locateId(id, segment, offset);
+    std::atomic<const ChStringPoolEntry *> *slots = segments_[segment].load(std::memory_order_acquire);
+    return ChInternedString(slots[offset].load(std::memory_order_acquire));
+}
+
+size_t ChStringPool::size() const
+{
+    return size_.load(std::memory_order_acquire);
+}
+
+ChStringPool::Statistics ChStringPool::statistics() const
+{
+    Statistics result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result.size = size_.load(std::memory_order_relaxed);
+        result.bytes = bytes_;
+    }
+    result.lookups = 0;
+    result.hits = 0;
+    for (const Counters &counters : counters_)
+    {
+        result.lookups += counters.lookups.load(std::memory_order_relaxed);
+        result.hits += counters.hits.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+ChStringPool::Counters &ChStringPool::countersOfThread() const
+{
+    static std::atomic<size_t> nextStripe(0);
+    thread_local size_t stripe = nextStripe.fetch_add(1, std::memory_order_relaxed) % counterStripeCount;
+    return counters_[stripe];
+}
+
+ChStringPool &ChStringPool::global()
+{
+    static ChStringPool pool;
+    return pool;
+}
+
+ChStringPool::Table *ChStringPool::createTable(size_t capacity)
+{
+    Table *table = new Table;
+    table->mask = capacity - 1;
+    table->slots = new std::atomic<const ChStringPoolEntry *>[capacity]();
+    return table;
+}
+
+void ChStringPool::destroyTable(Table *table)
+{
+    delete[] table->slots;
+    delete table;
+}
+
+const ChStringPoolEntry *ChStringPool::lookup(const Table *table, std::string_view value, size_t hash)
+{
+    size_t index = hash & table->mask;
+    while (true)
+    {
+        const ChStringPoolEntry *entry = table->slots[index].load(std::memory_order_acquire);
+        if (!entry)
+        {
+            return nullptr;
+        }
+        if (entry->hash == hash && entry->size == value.size() && std::memcmp(entry->data, value.data(), value.size()) == 0)
+        {
+            return entry;
+        }
+        index = (index + 1) & table->mask;
+    }
+}
+
+void ChStringPool::place(Table *table, const ChStringPoolEntry *entry)
+{
+    size_t index = entry->hash & table->mask;
+    while (table->slots[index].load(std::memory_order_relaxed))
+    {
+        index = (index + 1) & table->mask;
+    }
+    table->slots[index].store(entry, std::memory_order_release);
+}
+
+void ChStringPool::record(const ChStringPoolEntry *entry)
+{
+    size_t segment;
+    size_t offset;
+    locateId(entry->id, segment, offset);
+
+    std::atomic<const ChStringPoolEntry *> *slots = segments_[segment].load(std::memory_order_relaxed);
+    if (!slots)
+    {
+        slots = new std::atomic<const ChStringPoolEntry *>[size_t(1) << (segment + firstSegmentBits)]();
+        segments_[segment].store(slots, std::memory_order_release);
+    }
+    slots[offset].store(entry, std::memory_order_release);
+}
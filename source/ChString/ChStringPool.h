@@ -0,0 +1,231 @@
+#ifndef CHSTRINGPOOL
+#define CHSTRINGPOOL
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "ChString.h"
+
+struct ChStringPoolEntry;
+
+/**
+ * @brief A handle to a string interned in a ChStringPool.
+ *
+ * Handles of the same pool compare equal exactly when their strings are equal, so equality is a pointer comparison,
+ * and their hash is computed once at interning time. The characters stay valid and at the same address for the
+ * lifetime of the pool.
+ */
+class ChInternedString
+{
+public:
+    /**
+     * @brief Default constructor. Constructs a null handle that refers to no string.
+     */
+    ChInternedString();
+
+    /**
+     * @brief Returns the compact identifier of the string, unique within its pool, or 0 for a null handle.
+     */
+    uint32_t id() const;
+
+    /**
+     * @brief Returns the characters of the string, or an empty view for a null handle.
+     */
+    std::string_view view() const;
+
+    /**
+     * @brief Returns the length of the string.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the hash of the string that was computed when it was interned.
+     */
+    size_t hash() const;
+
+    /**
+     * @brief Checks whether the handle refers to no string.
+     */
+    bool isNull() const;
+
+    /**
+     * @brief Returns a ChString holding a copy of the characters.
+     */
+    ChString toChString() const;
+
+    /**
+     * @brief Checks whether both handles refer to the same interned string.
+     */
+    bool operator==(const ChInternedString &other) const;
+
+    /**
+     * @brief Checks whether the handles refer to different interned strings.
+     */
+    bool operator!=(const ChInternedString &other) const;
+
+    /**
+     * @brief Orders handles by identifier, which is the order of interning.
+     */
+    bool operator<(const ChInternedString &other) const;
+
+private:
+    friend class ChStringPool;
+
+    explicit ChInternedString(const ChStringPoolEntry *entry);
+
+    const ChStringPoolEntry *entry_;
+};
+
+namespace std
+{
+    template <>
+    struct hash<ChInternedString>
+    {
+        size_t operator()(const ChInternedString &value) const
+        {
+            return value.hash();
+        }
+    };
+}
+
+/**
+ * @brief A thread-safe table that maps strings to pointer-stable ChInternedString handles and compact identifiers.
+ *
+ * Looking up a string that is already interned never takes a lock: readers probe an open-addressing table that is
+ * only ever published whole. Interning a new string takes a mutex. Strings are never removed; all memory is
+ * released when the pool is destroyed.
+ */
+class ChStringPool
+{
+public:
+    /**
+     * @brief Usage counters of a pool.
+     */
+    struct Statistics
+    {
+        size_t size;
+        size_t bytes;
+        uint64_t lookups;
+        uint64_t hits;
+
+        /**
+         * @brief Returns the fraction of `intern` calls that found the string already interned.
+         */
+        double hitRate() const;
+    };
+
+    /**
+     * @brief Constructs an empty pool.
+     */
+    ChStringPool();
+
+    /**
+     * @brief Destroys the pool and every string interned in it. Handles of the pool must not be used afterwards.
+     */
+    ~ChStringPool();
+
+    ChStringPool(const ChStringPool &) = delete;
+    ChStringPool &operator=(const ChStringPool &) = delete;
+
+    /**
+     * @brief Returns the handle of `value`, interning it first if needed.
+     *
+     * @param value The characters to intern.
+     * @return The handle of the interned string.
+     */
+    ChInternedString intern(std::string_view value);
+
+    /**
+     * @brief Returns the handle of `value` if it is already interned, without interning it.
+     *
+     * @param value The characters to look up.
+     * @return The handle of the interned string, or a null handle.
+     */
+    ChInternedString find(std::string_view value) const;
+
+    /**
+     * @brief Returns the handle with the given identifier.
+     *
+     * @param id An identifier returned by ChInternedString::id.
+     * @return The handle, or a null handle if no string has that identifier.
+     */
+    ChInternedString fromId(uint32_t id) const;
+
+    /**
+     * @brief Returns the number of interned strings.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the pool size, the memory held by the strings and the lookup counters. The counters are kept per
+     * thread group and summed here, so while other threads intern they are only approximately consistent.
+     */
+    Statistics statistics() const;
+
+    /**
+     * @brief Returns the process wide pool.
+     */
+    static ChStringPool &global();
+
+private:
+    struct Table;
+
+    /**
+     * @brief The lookup counters of a group of threads, on a cache line of their own.
+     */
+    struct alignas(64) Counters
+    {
+        std::atomic<uint64_t> lookups;
+        std::atomic<uint64_t> hits;
+    };
+
+    static const size_t segmentCount = 22;
+    static const size_t counterStripeCount = 16;
+
+    /**
+     * @brief Allocates a table with `capacity` empty slots. `capacity` must be a power of two.
+     */
+    static Table *createTable(size_t capacity);
+
+    /**
+     * @brief Frees a table but not the entries it refers to.
+     */
+    static void destroyTable(Table *table);
+
+    /**
+     * @brief Probes `table` for `value` without locking.
+     */
+    static const ChStringPoolEntry *lookup(const Table *table, std::string_view value, size_t hash);
+
+    /**
+     * @brief Inserts `entry` into `table`, which must have a free slot. Requires the mutex.
+     */
+    static void place(Table *table, const ChStringPoolEntry *entry);
+
+    /**
+     * @brief Stores `entry` under its identifier so that fromId can find it. Requires the mutex.
+     */
+    void record(const ChStringPoolEntry *entry);
+
+    /**
+     * @brief Returns the counters of the calling thread. Threads are spread over the stripes in turn.
+     */
+    Counters &countersOfThread() const;
+
+    std::atomic<Table *> table_;
+    std::atomic<std::atomic<const ChStringPoolEntry *> *> segments_[segmentCount];
+    std::vector<Table *> retiredTables_;
+    mutable std::mutex mutex_;
+    std::atomic<size_t> size_;
+    size_t bytes_;
+
+    // Spread over cache lines so that threads interning at the same time do not contend on them
+    mutable Counters counters_[counterStripeCount];
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef CHSTRINGSIMD
+#define CHSTRINGSIMD
+
+#include <cstddef>
+
+#include "ChBits.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CHSTRING_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CHSTRING_USE_AVX2_DISPATCH
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define CHSTRING_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CHSTRING_TARGET_AVX2
+#endif
+#endif
+
+/**
+ * @brief Low level helpers shared by the ChString scanning kernels. Not part of the public interface.
+ */
+namespace ChStringSimd
+{
+    /**
+     * @brief Folds an ASCII upper case letter to lower case and leaves every other byte untouched.
+     */
+    inline char asciiToLower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    /**
+     * @brief Folds an ASCII lower case letter to upper case and leaves every other byte untouched.
+     */
+    inline char asciiToUpper(char c)
+    {
+        return (c >= 'a' && c <= 'z') ? static_cast<char>(c - ('a' - 'A')) : c;
+    }
+
+    /**
+     * @brief Returns the index of the first byte in [begin, end) that equals `a` or `b`, or `end` if there is none.
+     */
+    inline size_t findEither(const char *data, size_t begin, size_t end, char a, char b)
+    {
+#if defined(CHSTRING_USE_SSE2)
+        const __m128i first = _mm_set1_epi8(a);
+        const __m128i second = _mm_set1_epi8(b);
+        while (end - begin >= 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + begin));
+            __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, first), _mm_cmpeq_epi8(chunk, second));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+            if (mask != 0)
+            {
+                return begin + ChBits::countTrailingZeros(mask);
+            }
+            begin += 16;
+        }
+#endif
+        while (begin < end && data[begin] != a && data[begin] != b)
+        {
+            ++begin;
+        }
+        return begin;
+    }
+}
+
+#endif
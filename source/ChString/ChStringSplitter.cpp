@@ -0,0 +1,94 @@
+#include "ChStringSplitter.h"
+
+ChStringSplitter::Iterator::Iterator() : splitter_(nullptr)
+{
+}
+
+ChStringSplitter::Iterator::Iterator(ChStringSplitter *splitter) : splitter_(splitter)
+{
+    ++(*this);
+}
+
+ChStringSplitter::Iterator::reference ChStringSplitter::Iterator::operator*() const
+{
+    return part_;
+}
+
+ChStringSplitter::Iterator::pointer ChStringSplitter::Iterator::operator->() const
+{
+    return &part_;
+}
+
+ChStringSplitter::Iterator &ChStringSplitter::Iterator::operator++()
+{
+    if (splitter_ && !splitter_->next(part_))
+    {
+        splitter_ = nullptr;
+    }
+    return *this;
+}
+
+bool ChStringSplitter::Iterator::operator==(const Iterator &other) const
+{
+    return splitter_ == other.splitter_;
+}
+
+bool ChStringSplitter::Iterator::operator!=(const Iterator &other) const
+{
+    return splitter_ != other.splitter_;
+}
+
+ChStringSplitter::ChStringSplitter(std::string_view source, std::string_view separator, bool keepEmptyParts, bool caseSensitive)
+    : source_(source), separator_(separator, caseSensitive), position_(0), finished_(false), keepEmptyParts_(keepEmptyParts)
+{
+}
+
+ChStringSplitter::ChStringSplitter(std::string_view source, char separator, bool keepEmptyParts, bool caseSensitive)
+    : ChStringSplitter(source, std::string_view(&separator, 1), keepEmptyParts, caseSensitive)
+{
+}
+
+bool ChStringSplitter::next(std::string_view &part)
+{
+    while (!finished_)
+    {
+        size_t found = findSeparator(position_);
+        size_t partEnd = (found == std::string_view::npos) ? source_.size() : found;
+        std::string_view candidate = source_.substr(position_, partEnd - position_);
+
+        if (found == std::string_view::npos)
+        {
+            finished_ = true;
+        }
+        else
+        {
+            position_ = found + separator_.size();
+        }
+
+        if (keepEmptyParts_ || !candidate.empty())
+        {
+            part = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+ChStringSplitter::Iterator ChStringSplitter::begin()
+{
+    return Iterator(this);
+}
+
+ChStringSplitter::Iterator ChStringSplitter::end()
+{
+    return Iterator();
+}
+
+size_t ChStringSplitter::findSeparator(size_t from) const
+{
+    if (separator_.size() == 0)
+    {
+        return std::string_view::npos;
+    }
+    return separator_.indexIn(source_, from);
+}
@@ -0,0 +1,134 @@
+#ifndef CHSTRINGSPLITTER
+#define CHSTRINGSPLITTER
+
+#include <string>
+#include <string_view>
+#include <iterator>
+#include <cstddef>
+
+#include "ChStringMatcher.h"
+
+/**
+ * @brief Lazily splits a character sequence into parts separated by a separator.
+ *
+ * The splitter scans the source exactly once and produces the parts on demand as std::string_view slices of the
+ * source, so no part is ever copied. The source must outlive the splitter and the views it produces.
+ *
+ * @code
+ * for (std::string_view line : ChStringSplitter(payload, '\n'))
+ * {
+ *     ...
+ * }
+ * @endcode
+ */
+class ChStringSplitter
+{
+public:
+    /**
+     * @brief Input iterator over the parts produced by a ChStringSplitter.
+     */
+    class Iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view *;
+        using reference = const std::string_view &;
+
+        /**
+         * @brief Constructs the end iterator.
+         */
+        Iterator();
+
+        /**
+         * @brief Constructs an iterator positioned on the next part of `splitter`.
+         *
+         * @param splitter The splitter to draw the parts from.
+         */
+        explicit Iterator(ChStringSplitter *splitter);
+
+        /**
+         * @brief Returns the current part.
+         */
+        reference operator*() const;
+
+        /**
+         * @brief Returns a pointer to the current part.
+         */
+        pointer operator->() const;
+
+        /**
+         * @brief Advances to the next part.
+         *
+         * @return A reference to the iterator.
+         */
+        Iterator &operator++();
+
+        /**
+         * @brief Checks whether both iterators are exhausted or refer to the same splitter.
+         */
+        bool operator==(const Iterator &other) const;
+
+        /**
+         * @brief Checks whether the iterators differ.
+         */
+        bool operator!=(const Iterator &other) const;
+
+    private:
+        ChStringSplitter *splitter_;
+        std::string_view part_;
+    };
+
+    /**
+     * @brief Constructs a splitter over `source` that splits at every occurrence of `separator`.
+     *
+     * @param source The character sequence to split. It is not copied.
+     * @param separator The separator. An empty separator produces the whole source as a single part.
+     * @param keepEmptyParts If true, empty parts are produced as well.
+     * @param caseSensitive If true, the separator is matched case-sensitively.
+     */
+    ChStringSplitter(std::string_view source, std::string_view separator, bool keepEmptyParts = false, bool caseSensitive = false);
+
+    /**
+     * @brief Constructs a splitter over `source` that splits at every occurrence of the `separator` character.
+     *
+     * @param source The character sequence to split. It is not copied.
+     * @param separator The separator character.
+     * @param keepEmptyParts If true, empty parts are produced as well.
+     * @param caseSensitive If true, the separator is matched case-sensitively.
+     */
+    ChStringSplitter(std::string_view source, char separator, bool keepEmptyParts = false, bool caseSensitive = false);
+
+    /**
+     * @brief Produces the next part.
+     *
+     * @param[out] part Set to the next part if there is one.
+     * @return true if a part was produced, false if the source is exhausted.
+     */
+    bool next(std::string_view &part);
+
+    /**
+     * @brief Returns an iterator positioned on the next part.
+     */
+    Iterator begin();
+
+    /**
+     * @brief Returns the end iterator.
+     */
+    Iterator end();
+
+private:
+    /**
+     * @brief Returns the position of the first separator at or after `from`, or std::string_view::npos.
+     */
+    size_t findSeparator(size_t from) const;
+
+    std::string_view source_;
+    ChStringMatcher separator_;
+    size_t position_;
+    bool finished_;
+    bool keepEmptyParts_;
+};
+
+#endif
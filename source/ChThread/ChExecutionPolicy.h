@@ -0,0 +1,28 @@
+#ifndef CHEXECUTIONPOLICY
+#define CHEXECUTIONPOLICY
+
+/**
+ * @brief Selects how a bulk algorithm is executed.
+ *
+ * The parallel policies run on ChThreadPool::global(). Inputs too small to amortize the hand-off to the pool are
+ * processed on the calling thread regardless of the policy.
+ */
+enum class ChExecutionPolicy
+{
+    /**
+     * @brief Runs on the calling thread.
+     */
+    Sequential,
+
+    /**
+     * @brief Splits the work into chunks that run on the thread pool.
+     */
+    Parallel,
+
+    /**
+     * @brief Like Parallel, and additionally lets each chunk reorder operations so they can use vector instructions.
+     */
+    ParallelVectorized
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "ChThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+struct ChThreadPool::Batch
+{
+    const std::function<void(size_t)> *task;
+    size_t count;
+    std::atomic<size_t> next;
+
+    // Threads currently executing tasks of the batch, guarded by the pool mutex. The batch may only be destroyed once
+    // this drops to zero.
+    size_t helpers;
+
+    std::mutex errorMutex;
+    std::exception_ptr error;
+};
+
+ChThreadPool::ChThreadPool(size_t threadCount) : stopping_(false)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    workers_.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; ++i)
+    {
+        workers_.emplace_back(&ChThreadPool::work, this);
+    }
+}
+
+ChThreadPool::~ChThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (std::thread &worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void ChThreadPool::run(size_t taskCount, const std::function<void(size_t)> &task)
+{
+    if (taskCount == 0)
+    {
+        return;
+    }
+
+    Batch batch;
+    batch.task = &task;
+    batch.count = taskCount;
+    batch.next = 0;
+    batch.helpers = 1;
+
+    if (taskCount > 1 && !workers_.empty())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batches_.push_back(&batch);
+        }
+        wake_.notify_all();
+    }
+
+    execute(batch);
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto queued = std::find(batches_.begin(), batches_.end(), &batch);
+        if (queued != batches_.end())
+        {
+            batches_.erase(queued);
+        }
+        --batch.helpers;
+        finished_.wait(lock, [&batch] { return batch.helpers == 0; });
+    }
+
+    if (batch.error)
+    {
+        std::rethrow_exception(batch.error);
+    }
+}
+
+size_t ChThreadPool::threadCount() const
+{
+    return workers_.size() + 1;
+}
+
+ChThreadPool &ChThreadPool::global()
+{
+    static ChThreadPool pool;
+    return pool;
+}
+
+void ChThreadPool::execute(Batch &batch)
+{
+    for (;;)
+    {
+        size_t index = batch.next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= batch.count)
+        {
+            return;
+        }
+
+        try
+        {
+            (*batch.task)(index);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(batch.errorMutex);
+            if (!batch.error)
+            {
+                batch.error = std::current_exception();
+            }
+        }
+    }
+}
+
+void ChThreadPool::work()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+        wake_.wait(lock, [this] { return stopping_ || !batches_.empty(); });
+        if (batches_.empty())
+        {
+            return;
+        }
+
+        Batch *batch = batches_.front();
+        ++batch->helpers;
+        lock.unlock();
+
+        execute(*batch);
+
+        lock.lock();
+        // Every task has been claimed, so nobody else needs to find the batch in the queue
+        if (!batches_.empty() && batches_.front() == batch)
+        {
+            batches_.pop_front();
+        }
+        if (--batch->helpers == 0)
+        {
+            finished_.notify_all();
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef CHTHREADPOOL
+#define CHTHREADPOOL
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A fixed set of worker threads that execute indexed tasks.
+ *
+ * `run` hands a batch of tasks to the workers and helps executing them on the calling thread until the whole batch is
+ * done, so a batch always makes progress, even when `run` is called from inside another task.
+ *
+ * @code
+ * ChThreadPool::global().run(chunks, [&](size_t chunk)
+ * {
+ *     ...
+ * });
+ * @endcode
+ */
+class ChThreadPool
+{
+public:
+    /**
+     * @brief Constructs a pool in which `threadCount` threads, including the caller of `run`, execute tasks.
+     *
+     * @param threadCount The number of threads, or 0 for the number of hardware threads.
+     */
+    explicit ChThreadPool(size_t threadCount = 0);
+
+    /**
+     * @brief Destructor. Waits for the workers to finish the queued batches and joins them.
+     */
+    ~ChThreadPool();
+
+    ChThreadPool(const ChThreadPool &) = delete;
+    ChThreadPool &operator=(const ChThreadPool &) = delete;
+
+    /**
+     * @brief Calls `task(i)` for every i in [0, taskCount) and returns when all calls have finished.
+     *
+     * The calls run concurrently in no particular order. If calls throw, the remaining ones still run and the first
+     * exception caught is rethrown to the caller.
+     *
+     * @param taskCount The number of tasks.
+     * @param task The task to execute, called with the task index.
+     */
+    void run(size_t taskCount, const std::function<void(size_t)> &task);
+
+    /**
+     * @brief Returns the number of threads that execute tasks, including the caller of `run`.
+     */
+    size_t threadCount() const;
+
+    /**
+     * @brief Returns the process wide pool with one thread per hardware thread.
+     */
+    static ChThreadPool &global();
+
+private:
+    struct Batch;
+
+    /**
+     * @brief Executes unclaimed tasks of `batch` until none are left.
+     */
+    static void execute(Batch &batch);
+
+    /**
+     * @brief Main loop of a worker thread.
+     */
+    void work();
+
+    std::vector<std::thread> workers_;
+    std::deque<Batch *> batches_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable finished_;
+    bool stopping_;
+};
+
+#endif
\ No newline at end of file
@@ -1,9 +1,69 @@
 #include "ChTuple.h"
 
-ChTuple::ChTuple()
+template <typename... Ts>
+template <typename... Us, typename>
+ChTuple<Ts...>::ChTuple(Us &&...values) : data_(std::forward<Us>(values)...) {}
+
+template <typename... Ts>
+template <typename... Us, typename>
+ChTuple<Ts...>::ChTuple(const ChTuple<Us...> &other) : data_(static_cast<const std::tuple<Us...> &>(other)) {}
+
+template <typename... Ts>
+template <typename... Us>
+ChTuple<Ts...> &ChTuple<Ts...>::operator=(const ChTuple<Us...> &other)
+{
+    data_ = static_cast<const std::tuple<Us...> &>(other);
+    return *this;
+}
+
+template <typename... Ts>
+template <typename... Us>
+ChTuple<Ts...> &ChTuple<Ts...>::operator=(ChTuple<Us...> &&other)
+{
+    data_ = std::move(static_cast<std::tuple<Us...> &>(other));
+    return *this;
+}
+
+template <typename... Ts>
+ChTuple<Ts...>::operator std::tuple<Ts...> &()
+{
+    return data_;
+}
+
+template <typename... Ts>
+ChTuple<Ts...>::operator const std::tuple<Ts...> &() const
 {
+    return data_;
 }
 
-ChTuple::~ChTuple()
+template <typename... Ts>
+template <size_t I>
+typename std::tuple_element<I, std::tuple<Ts...>>::type &ChTuple<Ts...>::get()
 {
+    return std::get<I>(data_);
 }
+
+template <typename... Ts>
+template <size_t I>
+const typename std::tuple_element<I, std::tuple<Ts...>>::type &ChTuple<Ts...>::get() const
+{
+    return std::get<I>(data_);
+}
+
+template <typename... Ts, typename... Us>
+bool operator==(const ChTuple<Ts...> &left, const ChTuple<Us...> &right)
+{
+    return static_cast<const std::tuple<Ts...> &>(left) == static_cast<const std::tuple<Us...> &>(right);
+}
+
+template <typename... Ts, typename... Us>
+bool operator!=(const ChTuple<Ts...> &left, const ChTuple<Us...> &right)
+{
+    return !(left == right);
+}
+
+template <typename... Ts, typename... Us>
+bool operator<(const ChTuple<Ts...> &left, const ChTuple<Us...> &right)
+{
+    return static_cast<const std::tuple<Ts...> &>(left) < static_cast<const std::tuple<Us...> &>(right);
+}
\ No newline at end of file
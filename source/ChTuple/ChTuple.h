@@ -1,10 +1,140 @@
 #ifndef CHTUPLE
 #define CHTUPLE
 
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief A fixed-size collection of values of different types, such as one record of a table.
+ *
+ * The ChTuple class wraps around an std::tuple object. Its elements are read and written with `get<I>()`, and it can
+ * be unpacked with structured bindings.
+ *
+ * A ChTuple of references, such as the rows of a ChTupleVector, refers to values stored elsewhere. Assigning to it
+ * writes through to those values, like assigning to an std::tuple of references:
+ *
+ * @code
+ * ChTupleVector<int, double> table;
+ * table.push_back({1, 0.5});
+ * table[0] = ChTuple<int, double>(2, 1.5);
+ * auto [id, weight] = table[0];
+ * weight *= 2;
+ * @endcode
+ *
+ * @tparam Ts The types of the elements.
+ */
+template <typename... Ts>
 class ChTuple
 {
-    ChTuple();
-    ~ChTuple();
+public:
+    /**
+     * @brief Default constructor. Value-initializes every element.
+     */
+    ChTuple() = default;
+
+    /**
+     * @brief Constructs the tuple with one value per element.
+     *
+     * @param values The values to initialize the elements with, in order.
+     */
+    template <typename... Us, typename = typename std::enable_if<sizeof...(Us) == sizeof...(Ts) && (sizeof...(Ts) > 0) && std::conjunction<std::is_constructible<Ts, Us &&>...>::value>::type>
+    ChTuple(Us &&...values);
+
+    /**
+     * @brief Constructs the tuple from the elements of a tuple of other types, for example a row of values from a row
+     * of references.
+     *
+     * @param other The tuple to copy the elements from.
+     */
+    template <typename... Us, typename = typename std::enable_if<sizeof...(Us) == sizeof...(Ts) && !std::is_same<ChTuple<Us...>, ChTuple>::value && std::conjunction<std::is_constructible<Ts, const Us &>...>::value>::type>
+    ChTuple(const ChTuple<Us...> &other);
+
+    /**
+     * @brief Assigns the elements of `other` to the elements of this tuple. Through a tuple of references, this
+     * writes to the referenced values.
+     *
+     * @param other The tuple to copy the elements from.
+     */
+    template <typename... Us>
+    ChTuple &operator=(const ChTuple<Us...> &other);
+
+    /**
+     * @brief Moves the elements of `other` into the elements of this tuple.
+     *
+     * @param other The tuple to move the elements from.
+     */
+    template <typename... Us>
+    ChTuple &operator=(ChTuple<Us...> &&other);
+
+    /**
+     * @brief Conversion operator to a reference to the internal std::tuple object.
+     */
+    operator std::tuple<Ts...> &();
+
+    /**
+     * @brief Conversion operator to a const reference to the internal std::tuple object.
+     */
+    operator const std::tuple<Ts...> &() const;
+
+    /**
+     * @brief Returns the element at index I. For an element of reference type, returns the referenced value.
+     *
+     * @tparam I The index of the element.
+     */
+    template <size_t I>
+    typename std::tuple_element<I, std::tuple<Ts...>>::type &get();
+
+    /**
+     * @brief Returns the element at index I. For an element of reference type, returns the referenced value.
+     *
+     * @tparam I The index of the element.
+     */
+    template <size_t I>
+    const typename std::tuple_element<I, std::tuple<Ts...>>::type &get() const;
+
+    /**
+     * @brief Returns the number of elements.
+     */
+    static constexpr size_t size() noexcept
+    {
+        return sizeof...(Ts);
+    }
+
+private:
+    std::tuple<Ts...> data_;
 };
 
+/**
+ * @brief Checks whether two tuples have equal elements.
+ */
+template <typename... Ts, typename... Us>
+bool operator==(const ChTuple<Ts...> &left, const ChTuple<Us...> &right);
+
+/**
+ * @brief Checks whether two tuples differ in any element.
+ */
+template <typename... Ts, typename... Us>
+bool operator!=(const ChTuple<Ts...> &left, const ChTuple<Us...> &right);
+
+/**
+ * @brief Compares two tuples lexicographically.
+ */
+template <typename... Ts, typename... Us>
+bool operator<(const ChTuple<Ts...> &left, const ChTuple<Us...> &right);
+
+namespace std
+{
+    template <typename... Ts>
+    struct tuple_size<ChTuple<Ts...>> : std::integral_constant<size_t, sizeof...(Ts)>
+    {
+    };
+
+    template <size_t I, typename... Ts>
+    struct tuple_element<I, ChTuple<Ts...>> : std::tuple_element<I, std::tuple<Ts...>>
+    {
+    };
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,373 @@
+#include "ChTupleVector.h"
+#include <algorithm>
+#include <stdexcept>
+
+template <typename... Ts>
+ChTupleVector<Ts...>::ChTupleVector() {}
+
+template <typename... Ts>
+ChTupleVector<Ts...>::ChTupleVector(std::initializer_list<value_type> rows)
+{
+    reserve(rows.size());
+    for (const value_type &row : rows)
+    {
+        push_back(row);
+    }
+}
+
+template <typename... Ts>
+ChTupleVector<Ts...>::ChTupleVector(const ChTupleVector &other) : columns_(other.columns_) {}
+
+template <typename... Ts>
+ChTupleVector<Ts...>::ChTupleVector(ChTupleVector &&other) noexcept : columns_(std::move(other.columns_)) {}
+
+template <typename... Ts>
+ChTupleVector<Ts...> &ChTupleVector<Ts...>::operator=(const ChTupleVector &other)
+{
+    if (this != &other)
+    {
+        // Copying into a temporary first keeps the columns the same size if one of them fails to copy
+        ChTupleVector copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+template <typename... Ts>
+ChTupleVector<Ts...> &ChTupleVector<Ts...>::operator=(ChTupleVector &&other) noexcept
+{
+    columns_ = std::move(other.columns_);
+    return *this;
+}
+
+template <typename... Ts>
+template <size_t I>
+const ChVector<typename ChTupleVector<Ts...>::template element_type<I>> &ChTupleVector<Ts...>::column() const noexcept
+{
+    return std::get<I>(columns_);
+}
+
+template <typename... Ts>
+template <size_t I>
+typename ChTupleVector<Ts...>::template element_type<I> *ChTupleVector<Ts...>::data() noexcept
+{
+    return std::get<I>(columns_).data();
+}
+
+template <typename... Ts>
+template <size_t I>
+const typename ChTupleVector<Ts...>::template element_type<I> *ChTupleVector<Ts...>::data() const noexcept
+{
+    return std::get<I>(columns_).data();
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::iterator ChTupleVector<Ts...>::begin() noexcept
+{
+    return iterator(this, 0);
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::const_iterator ChTupleVector<Ts...>::begin() const noexcept
+{
+    return const_iterator(this, 0);
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::iterator ChTupleVector<Ts...>::end() noexcept
+{
+    return iterator(this, size());
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::const_iterator ChTupleVector<Ts...>::end() const noexcept
+{
+    return const_iterator(this, size());
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::const_iterator ChTupleVector<Ts...>::cbegin() const noexcept
+{
+    return begin();
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::const_iterator ChTupleVector<Ts...>::cend() const noexcept
+{
+    return end();
+}
+
+template <typename... Ts>
+size_t ChTupleVector<Ts...>::size() const noexcept
+{
+    return std::get<0>(columns_).size();
+}
+
+template <typename... Ts>
+bool ChTupleVector<Ts...>::isEmpty() const noexcept
+{
+    return size() == 0;
+}
+
+template <typename... Ts>
+size_t ChTupleVector<Ts...>::capacity() const noexcept
+{
+    return std::apply([](const auto &...columns)
+    {
+        return std::min({columns.capacity()...});
+    }, columns_);
+}
+
+template <typename... Ts>
+void ChTupleVector<Ts...>::reserve(size_t n)
+{
+    forEachColumn([n](auto &column)
+    {
+        column.reserve(n);
+    });
+}
+
+template <typename... Ts>
+void ChTupleVector<Ts...>::shrink()
+{
+    forEachColumn([](auto &column)
+    {
+        column.shrink();
+    });
+}
+
+template <typename... Ts>
+void ChTupleVector<Ts...>::resize(size_t n)
+{
+    const size_t oldSize = size();
+    try
+    {
+        forEachColumn([n](auto &column)
+        {
+            column.resize(n);
+        });
+    }
+    catch (...)
+    {
+        forEachColumn([oldSize](auto &column)
+        {
+            column.resize(oldSize);
+        });
+        throw;
+    }
+}
+
+template <typename... Ts>
+void ChTupleVector<Ts...>::resize(size_t n, const value_type &row)
+{
+    resizeColumns(std::index_sequence_for<Ts...>(), n, row);
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::reference ChTupleVector<Ts...>::operator[](size_t index)
+{
+    return row(std::index_sequence_for<Ts...>(), index);
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::const_reference ChTupleVector<Ts...>::operator[](size_t index) const
+{
+    return row(std::index_sequence_for<Ts...>(), index);
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::reference ChTupleVector<Ts...>::at(size_t index)
+{
+    if (index >= size())
+    {
+        throw std::out_of_range("ChTupleVector index out of range");
+    }
+    return (*this)[index];
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::const_reference ChTupleVector<Ts...>::at(size_t index) const
+{
+    if (index >= size())
+    {
+        throw std::out_of_range("ChTupleVector index out of range");
+    }
+    return (*this)[index];
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::reference ChTupleVector<Ts...>::front()
+{
+    return (*this)[0];
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::const_reference ChTupleVector<Ts...>::front() const
+{
+    return (*this)[0];
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::reference ChTupleVector<Ts...>::back()
+{
+    return (*this)[size() - 1];
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::const_reference ChTupleVector<Ts...>::back() const
+{
+    return (*this)[size() - 1];
+}
+
+template <typename... Ts>
+void ChTupleVector<Ts...>::push_back(const value_type &row)
+{
+    appendRow(std::index_sequence_for<Ts...>(), row);
+}
+
+template <typename... Ts>
+void ChTupleVector<Ts...>::push_back(value_type &&row)
+{
+    appendRow(std::index_sequence_for<Ts...>(), std::move(row));
+}
+
+template <typename... Ts>
+template <typename... Us>
+typename ChTupleVector<Ts...>::reference ChTupleVector<Ts...>::emplace_back(Us &&...values)
+{
+    static_assert(sizeof...(Us) == sizeof...(Ts), "emplace_back takes one value per column");
+    if (size() < capacity())
+    {
+        emplaceRow(std::index_sequence_for<Ts...>(), std::forward<Us>(values)...);
+    }
+    else
+    {
+        // `values` may refer to fields of this table, so the row is built before the columns reallocate
+        appendRow(std::index_sequence_for<Ts...>(), value_type(std::forward<Us>(values)...));
+    }
+    return back();
+}
+
+template <typename... Ts>
+void ChTupleVector<Ts...>::pop_back()
+{
+    forEachColumn([](auto &column)
+    {
+        column.pop_back();
+    });
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::iterator ChTupleVector<Ts...>::erase(const_iterator pos)
+{
+    return erase(pos, pos + 1);
+}
+
+template <typename... Ts>
+typename ChTupleVector<Ts...>::iterator ChTupleVector<Ts...>::erase(const_iterator first, const_iterator last)
+{
+    const size_t index = first.index();
+    const size_t count = last - first;
+    forEachColumn([index, count](auto &column)
+    {
+        column.erase(column.begin() + index, column.begin() + index + count);
+    });
+    return iterator(this, index);
+}
+
+template <typename... Ts>
+void ChTupleVector<Ts...>::swap(ChTupleVector &other) noexcept
+{
+    columns_.swap(other.columns_);
+}
+
+template <typename... Ts>
+void ChTupleVector<Ts...>::clear() noexcept
+{
+    forEachColumn([](auto &column)
+    {
+        column.clear();
+    });
+}
+
+template <typename... Ts>
+template <size_t... Is>
+typename ChTupleVector<Ts...>::reference ChTupleVector<Ts...>::row(std::index_sequence<Is...>, size_t index)
+{
+    return reference(std::get<Is>(columns_)[index]...);
+}
+
+template <typename... Ts>
+template <size_t... Is>
+typename ChTupleVector<Ts...>::const_reference ChTupleVector<Ts...>::row(std::index_sequence<Is...>, size_t index) const
+{
+    return const_reference(std::get<Is>(columns_)[index]...);
+}
+
+template <typename... Ts>
+template <size_t... Is>
+void ChTupleVector<Ts...>::resizeColumns(std::index_sequence<Is...>, size_t n, const value_type &row)
+{
+    // `row` may be a copy of a row of this table, but it is a value and is not invalidated by the columns growing
+    const size_t oldSize = size();
+    try
+    {
+        (std::get<Is>(columns_).resize(n, row.template get<Is>()), ...);
+    }
+    catch (...)
+    {
+        forEachColumn([oldSize](auto &column)
+        {
+            column.resize(oldSize);
+        });
+        throw;
+    }
+}
+
+template <typename... Ts>
+template <size_t... Is, typename... Us>
+void ChTupleVector<Ts...>::emplaceRow(std::index_sequence<Is...>, Us &&...values)
+{
+    // Growing every column up front means that only the construction of a field can fail below, and a failed row is
+    // undone by removing the fields that were already added
+    const size_t oldSize = size();
+    if (oldSize == capacity())
+    {
+        reserve(std::max<size_t>(2 * oldSize, 8));
+    }
+
+    size_t added = 0;
+    try
+    {
+        ((std::get<Is>(columns_).emplace_back(std::forward<Us>(values)), ++added), ...);
+    }
+    catch (...)
+    {
+        ((Is < added ? std::get<Is>(columns_).pop_back() : void()), ...);
+        throw;
+    }
+}
+
+template <typename... Ts>
+template <size_t... Is>
+void ChTupleVector<Ts...>::appendRow(std::index_sequence<Is...> indices, const value_type &row)
+{
+    emplaceRow(indices, row.template get<Is>()...);
+}
+
+template <typename... Ts>
+template <size_t... Is>
+void ChTupleVector<Ts...>::appendRow(std::index_sequence<Is...> indices, value_type &&row)
+{
+    emplaceRow(indices, std::move(row.template get<Is>())...);
+}
+
+template <typename... Ts>
+template <typename Fn>
+void ChTupleVector<Ts...>::forEachColumn(Fn func)
+{
+    std::apply([&func](auto &...columns)
+    {
+        (func(columns), ...);
+    }, columns_);
+}
\ No newline at end of file
@@ -0,0 +1,478 @@
+#ifndef CHTUPLEVECTOR
+#define CHTUPLEVECTOR
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "ChTuple.h"
+#include "ChVector.h"
+
+/**
+ * @brief A table of rows of type ChTuple<Ts...> that stores each field in its own contiguous column.
+ *
+ * A ChVector of structs interleaves the fields, so a scan over one field also pulls the others through the cache.
+ * ChTupleVector keeps one ChVector per field instead ("structure of arrays"). A column can be read on its own with
+ * `column<I>()`, which makes the ChVector operations, including the SIMD kernels of `sum`, `minimum`, `indexOf` and
+ * the like, work on just that field.
+ *
+ * Rows are accessed through proxies: `operator[]` and the iterators return a ChTuple of references into the columns,
+ * and writing to the proxy writes to the table. A proxy becomes invalid when the table reallocates.
+ *
+ * @code
+ * ChTupleVector<int, double, float> particles;
+ * particles.emplace_back(7, 0.25, 1.5f);
+ * for (auto [id, mass, charge] : particles)
+ * {
+ *     mass *= 2;
+ * }
+ * double total = particles.column<1>().sum();
+ * @endcode
+ *
+ * A ChVector<bool> cannot hand out references to its elements, so bool fields are not supported; store them as
+ * unsigned char instead.
+ *
+ * @tparam Ts The types of the fields of a row.
+ */
+template <typename... Ts>
+class ChTupleVector
+{
+    static_assert(sizeof...(Ts) > 0, "ChTupleVector needs at least one column");
+    static_assert(!std::disjunction<std::is_same<Ts, bool>...>::value, "ChTupleVector does not support bool columns");
+
+    template <bool Const>
+    class Iterator;
+
+public:
+    using value_type = ChTuple<Ts...>;
+    using reference = ChTuple<Ts &...>;
+    using const_reference = ChTuple<const Ts &...>;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    /**
+     * @brief The type of the field at index I.
+     */
+    template <size_t I>
+    using element_type = typename std::tuple_element<I, std::tuple<Ts...>>::type;
+
+    /**
+     * @brief Default constructor. Constructs an empty table.
+     */
+    ChTupleVector();
+
+    /**
+     * @brief Constructs the table with the given rows.
+     *
+     * @param rows The rows to initialize the table with.
+     */
+    ChTupleVector(std::initializer_list<value_type> rows);
+
+    /**
+     * @brief Copy constructor. Constructs the table with the copy of the contents of `other`.
+     *
+     * @param other Another ChTupleVector object to copy the rows from.
+     */
+    ChTupleVector(const ChTupleVector &other);
+
+    /**
+     * @brief Move constructor. Takes over the columns of `other`.
+     *
+     * @param other Another ChTupleVector object to move the rows from. `other` is left empty.
+     */
+    ChTupleVector(ChTupleVector &&other) noexcept;
+
+    /**
+     * @brief Copy assignment operator. Replaces the contents of the table with a copy of the contents of `other`.
+     *
+     * @param other Another ChTupleVector object to copy the rows from.
+     * @return *this
+     */
+    ChTupleVector &operator=(const ChTupleVector &other);
+
+    /**
+     * @brief Move assignment operator. Replaces the contents of the table with the contents of `other`.
+     *
+     * @param other Another ChTupleVector object to move the rows from. `other` is left empty.
+     * @return *this
+     */
+    ChTupleVector &operator=(ChTupleVector &&other) noexcept;
+
+    /**
+     * @brief Returns the column of the field at index I.
+     *
+     * The column is read-only so that all columns keep the same size; write single fields through `data<I>()` or the
+     * row proxies.
+     *
+     * @tparam I The index of the field.
+     */
+    template <size_t I>
+    const ChVector<element_type<I>> &column() const noexcept;
+
+    /**
+     * @brief Returns a pointer to the first element of the column of the field at index I.
+     *
+     * @tparam I The index of the field.
+     */
+    template <size_t I>
+    element_type<I> *data() noexcept;
+
+    /**
+     * @brief Returns a const pointer to the first element of the column of the field at index I.
+     *
+     * @tparam I The index of the field.
+     */
+    template <size_t I>
+    const element_type<I> *data() const noexcept;
+
+    /**
+     * @brief Returns an iterator to the first row of the table.
+     */
+    iterator begin() noexcept;
+
+    /**
+     * @brief Returns a const iterator to the first row of the table.
+     */
+    const_iterator begin() const noexcept;
+
+    /**
+     * @brief Returns an iterator past the last row of the table.
+     */
+    iterator end() noexcept;
+
+    /**
+     * @brief Returns a const iterator past the last row of the table.
+     */
+    const_iterator end() const noexcept;
+
+    /**
+     * @brief Returns a const iterator to the first row of the table.
+     */
+    const_iterator cbegin() const noexcept;
+
+    /**
+     * @brief Returns a const iterator past the last row of the table.
+     */
+    const_iterator cend() const noexcept;
+
+    /**
+     * @brief Returns the number of rows in the table.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Checks whether the table is empty.
+     */
+    bool isEmpty() const noexcept;
+
+    /**
+     * @brief Returns the number of rows the table can hold without reallocating any column.
+     */
+    size_t capacity() const noexcept;
+
+    /**
+     * @brief Reserves room for at least `n` rows in every column.
+     *
+     * @param n The number of rows to reserve room for.
+     */
+    void reserve(size_t n);
+
+    /**
+     * @brief Releases the unused capacity of every column.
+     */
+    void shrink();
+
+    /**
+     * @brief Resizes the table to `n` rows. New rows are value-initialized.
+     *
+     * If a column fails to grow, every column is restored to the previous size.
+     *
+     * @param n The new number of rows.
+     */
+    void resize(size_t n);
+
+    /**
+     * @brief Resizes the table to `n` rows. New rows are copies of `row`.
+     *
+     * If a column fails to grow, every column is restored to the previous size.
+     *
+     * @param n The new number of rows.
+     * @param row The value of the new rows.
+     */
+    void resize(size_t n, const value_type &row);
+
+    /**
+     * @brief Returns a proxy of the row at `index`. No bounds checking is performed.
+     *
+     * @param index The index of the row.
+     */
+    reference operator[](size_t index);
+
+    /**
+     * @brief Returns a const proxy of the row at `index`. No bounds checking is performed.
+     *
+     * @param index The index of the row.
+     */
+    const_reference operator[](size_t index) const;
+
+    /**
+     * @brief Returns a proxy of the row at `index`.
+     *
+     * @param index The index of the row.
+     * @throws std::out_of_range if `index` is not less than the size.
+     */
+    reference at(size_t index);
+
+    /**
+     * @brief Returns a const proxy of the row at `index`.
+     *
+     * @param index The index of the row.
+     * @throws std::out_of_range if `index` is not less than the size.
+     */
+    const_reference at(size_t index) const;
+
+    /**
+     * @brief Returns a proxy of the first row. The table must not be empty.
+     */
+    reference front();
+
+    /**
+     * @brief Returns a const proxy of the first row. The table must not be empty.
+     */
+    const_reference front() const;
+
+    /**
+     * @brief Returns a proxy of the last row. The table must not be empty.
+     */
+    reference back();
+
+    /**
+     * @brief Returns a const proxy of the last row. The table must not be empty.
+     */
+    const_reference back() const;
+
+    /**
+     * @brief Adds a copy of `row` to the end of the table.
+     *
+     * @param row The row to add.
+     */
+    void push_back(const value_type &row);
+
+    /**
+     * @brief Moves `row` to the end of the table.
+     *
+     * @param row The row to add.
+     */
+    void push_back(value_type &&row);
+
+    /**
+     * @brief Adds a row to the end of the table, constructing each field from the corresponding argument.
+     *
+     * If a field fails to construct, the fields already added are removed again and the table is unchanged.
+     *
+     * @param values One value per field, in order.
+     * @return A proxy of the new row.
+     */
+    template <typename... Us>
+    reference emplace_back(Us &&...values);
+
+    /**
+     * @brief Removes the last row of the table. The table must not be empty.
+     */
+    void pop_back();
+
+    /**
+     * @brief Removes the row at `pos`.
+     *
+     * @param pos Iterator to the row to remove.
+     * @return Iterator to the row that followed the removed one.
+     */
+    iterator erase(const_iterator pos);
+
+    /**
+     * @brief Removes the rows in the range [first, last).
+     *
+     * @param first Iterator to the first row to remove.
+     * @param last Iterator past the last row to remove.
+     * @return Iterator to the row that followed the removed ones.
+     */
+    iterator erase(const_iterator first, const_iterator last);
+
+    /**
+     * @brief Exchanges the contents of the table with those of `other`.
+     *
+     * @param other The table to exchange the contents with.
+     */
+    void swap(ChTupleVector &other) noexcept;
+
+    /**
+     * @brief Removes all rows from the table.
+     */
+    void clear() noexcept;
+
+private:
+    template <size_t... Is>
+    reference row(std::index_sequence<Is...>, size_t index);
+
+    template <size_t... Is>
+    const_reference row(std::index_sequence<Is...>, size_t index) const;
+
+    template <size_t... Is>
+    void resizeColumns(std::index_sequence<Is...>, size_t n, const value_type &row);
+
+    template <size_t... Is, typename... Us>
+    void emplaceRow(std::index_sequence<Is...>, Us &&...values);
+
+    template <size_t... Is>
+    void appendRow(std::index_sequence<Is...>, const value_type &row);
+
+    template <size_t... Is>
+    void appendRow(std::index_sequence<Is...>, value_type &&row);
+
+    template <typename Fn>
+    void forEachColumn(Fn func);
+
+    std::tuple<ChVector<Ts>...> columns_;
+};
+
+/**
+ * @brief Random access iterator over the rows of a ChTupleVector. Dereferencing it yields a row proxy.
+ */
+template <typename... Ts>
+template <bool Const>
+class ChTupleVector<Ts...>::Iterator
+{
+    using Table = typename std::conditional<Const, const ChTupleVector, ChTupleVector>::type;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = ChTupleVector::value_type;
+    using reference = typename std::conditional<Const, ChTupleVector::const_reference, ChTupleVector::reference>::type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+
+    Iterator() : table_(nullptr), index_(0) {}
+
+    Iterator(Table *table, size_t index) : table_(table), index_(index) {}
+
+    template <bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+    Iterator(const Iterator<OtherConst> &other) : table_(other.table_), index_(other.index_) {}
+
+    reference operator*() const
+    {
+        return (*table_)[index_];
+    }
+
+    reference operator[](difference_type offset) const
+    {
+        return (*table_)[index_ + offset];
+    }
+
+    Iterator &operator++()
+    {
+        ++index_;
+        return *this;
+    }
+
+    Iterator operator++(int)
+    {
+        Iterator previous = *this;
+        ++index_;
+        return previous;
+    }
+
+    Iterator &operator--()
+    {
+        --index_;
+        return *this;
+    }
+
+    Iterator operator--(int)
+    {
+        Iterator previous = *this;
+        --index_;
+        return previous;
+    }
+
+    Iterator &operator+=(difference_type offset)
+    {
+        index_ += offset;
+        return *this;
+    }
+
+    Iterator &operator-=(difference_type offset)
+    {
+        index_ -= offset;
+        return *this;
+    }
+
+    Iterator operator+(difference_type offset) const
+    {
+        return Iterator(table_, index_ + offset);
+    }
+
+    friend Iterator operator+(difference_type offset, const Iterator &it)
+    {
+        return it + offset;
+    }
+
+    Iterator operator-(difference_type offset) const
+    {
+        return Iterator(table_, index_ - offset);
+    }
+
+    difference_type operator-(const Iterator &other) const
+    {
+        return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+
+    bool operator==(const Iterator &other) const
+    {
+        return index_ == other.index_;
+    }
+
+    bool operator!=(const Iterator &other) const
+    {
+        return index_ != other.index_;
+    }
+
+    bool operator<(const Iterator &other) const
+    {
+        return index_ < other.index_;
+    }
+
+    bool operator>(const Iterator &other) const
+    {
+        return index_ > other.index_;
+    }
+
+    bool operator<=(const Iterator &other) const
+    {
+        return index_ <= other.index_;
+    }
+
+    bool operator>=(const Iterator &other) const
+    {
+        return index_ >= other.index_;
+    }
+
+    /**
+     * @brief Returns the index of the row the iterator points to.
+     */
+    size_t index() const
+    {
+        return index_;
+    }
+
+private:
+    template <bool>
+    friend class Iterator;
+
+    Table *table_;
+    size_t index_;
+};
+
+#endif
\ No newline at end of file
@@ -1,9 +1,1069 @@
 #include "ChUnorderedSet.h"
+#include "ChBits.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <vector>
 
-ChUnorderedSet::ChUnorderedSet()
+template <typename T, typename Hash, typename KeyEqual>
+ChUnorderedSet<T, Hash, KeyEqual>::ChUnorderedSet()
+    : mode_(emptyMode()), size_(0), baseWord_(0), seed_(0), control_(nullptr), slots_(nullptr), capacity_(0), growthLimit_(0), hash_(), equal_()
 {
 }
 
-ChUnorderedSet::~ChUnorderedSet()
+template <typename T, typename Hash, typename KeyEqual>
+ChUnorderedSet<T, Hash, KeyEqual>::ChUnorderedSet(size_t count, const Hash &hash, const KeyEqual &equal)
+    : mode_(emptyMode()), size_(0), baseWord_(0), seed_(0), control_(nullptr), slots_(nullptr), capacity_(0), growthLimit_(0), hash_(hash), equal_(equal)
 {
+    reserve(count);
 }
+
+template <typename T, typename Hash, typename KeyEqual>
+ChUnorderedSet<T, Hash, KeyEqual>::ChUnorderedSet(std::initializer_list<T> values) : ChUnorderedSet()
+{
+    insert(values.begin(), values.end());
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+template <typename InputIt>
+ChUnorderedSet<T, Hash, KeyEqual>::ChUnorderedSet(InputIt first, InputIt last) : ChUnorderedSet()
+{
+    insert(first, last);
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+ChUnorderedSet<T, Hash, KeyEqual>::ChUnorderedSet(const ChUnorderedSet &other)
+    : mode_(other.mode_), size_(other.size_), words_(other.words_), baseWord_(other.baseWord_), elements_(other.elements_), pilots_(other.pilots_),
+      seed_(other.seed_), control_(nullptr), slots_(nullptr), capacity_(0), growthLimit_(0), hash_(other.hash_), equal_(other.equal_)
+{
+    if (other.capacity_ == 0)
+    {
+        return;
+    }
+
+    // Copy slot by slot into a table of the same size, which keeps every element at the same position. The control
+    // byte of a slot is only set once its element exists, so a failed copy destroys just those.
+    rehashTo(other.capacity_);
+    try
+    {
+        for (size_t slot = 0; slot < capacity_; ++slot)
+        {
+            if (other.control_[slot] >= 0)
+            {
+                ::new (static_cast<void *>(slots_ + slot)) T(other.slots_[slot]);
+                ChHashTable::setControl(control_, capacity_, slot, other.control_[slot]);
+            }
+        }
+    }
+    catch (...)
+    {
+        releaseTable();
+        throw;
+    }
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+ChUnorderedSet<T, Hash, KeyEqual>::ChUnorderedSet(ChUnorderedSet &&other) noexcept : ChUnorderedSet()
+{
+    swap(other);
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+ChUnorderedSet<T, Hash, KeyEqual>::~ChUnorderedSet()
+{
+    releaseTable();
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+ChUnorderedSet<T, Hash, KeyEqual> &ChUnorderedSet<T, Hash, KeyEqual>::operator=(const ChUnorderedSet &other)
+{
+    if (this != &other)
+    {
+        ChUnorderedSet copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+ChUnorderedSet<T, Hash, KeyEqual> &ChUnorderedSet<T, Hash, KeyEqual>::operator=(ChUnorderedSet &&other) noexcept
+{
+    if (this != &other)
+    {
+        clear();
+        swap(other);
+    }
+    return *this;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+ChUnorderedSet<T, Hash, KeyEqual> ChUnorderedSet<T, Hash, KeyEqual>::frozen(ChVector<T> values, const Hash &hash, const KeyEqual &equal)
+{
+    ChUnorderedSet set(0, hash, equal);
+    if (values.isEmpty())
+    {
+        return set;
+    }
+    if constexpr (bitsetCapable)
+    {
+        uint64_t lowest = ordinalOf(values[0]);
+        uint64_t highest = lowest;
+        for (size_t i = 1; i < values.size(); ++i)
+        {
+            lowest = std::min(lowest, ordinalOf(values[i]));
+            highest = std::max(highest, ordinalOf(values[i]));
+        }
+        if ((highest >> 6) - (lowest >> 6) < maxBitsetWords(values.size()))
+        {
+            set.toBitset(lowest, highest);
+            set.insert(values.begin(), values.end());
+            return set;
+        }
+    }
+    if (!set.buildPerfectHash(values))
+    {
+        set.toHashTable(values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            set.insert(std::move(values[i]));
+        }
+    }
+    return set;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+ChUnorderedSetMode ChUnorderedSet<T, Hash, KeyEqual>::mode() const noexcept
+{
+    return mode_;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+typename ChUnorderedSet<T, Hash, KeyEqual>::const_iterator ChUnorderedSet<T, Hash, KeyEqual>::begin() const noexcept
+{
+    return const_iterator(this, firstPosition());
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+typename ChUnorderedSet<T, Hash, KeyEqual>::const_iterator ChUnorderedSet<T, Hash, KeyEqual>::end() const noexcept
+{
+    return const_iterator(this, endPosition());
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+typename ChUnorderedSet<T, Hash, KeyEqual>::const_iterator ChUnorderedSet<T, Hash, KeyEqual>::cbegin() const noexcept
+{
+    return begin();
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+typename ChUnorderedSet<T, Hash, KeyEqual>::const_iterator ChUnorderedSet<T, Hash, KeyEqual>::cend() const noexcept
+{
+    return end();
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+size_t ChUnorderedSet<T, Hash, KeyEqual>::size() const noexcept
+{
+    return size_;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+bool ChUnorderedSet<T, Hash, KeyEqual>::isEmpty() const noexcept
+{
+    return size_ == 0;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+void ChUnorderedSet<T, Hash, KeyEqual>::reserve(size_t count)
+{
+    if (mode_ == ChUnorderedSetMode::HashTable && count > growthLimit_)
+    {
+        rehashTo(slotsFor(count));
+    }
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+typename ChUnorderedSet<T, Hash, KeyEqual>::const_iterator ChUnorderedSet<T, Hash, KeyEqual>::find(const T &value) const
+{
+    return const_iterator(this, findPosition(value));
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+template <typename Q, typename>
+typename ChUnorderedSet<T, Hash, KeyEqual>::const_iterator ChUnorderedSet<T, Hash, KeyEqual>::find(const Q &value) const
+{
+    return const_iterator(this, findPosition(value));
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+bool ChUnorderedSet<T, Hash, KeyEqual>::contains(const T &value) const
+{
+    return findPosition(value) != endPosition();
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+template <typename Q, typename>
+bool ChUnorderedSet<T, Hash, KeyEqual>::contains(const Q &value) const
+{
+    return findPosition(value) != endPosition();
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+size_t ChUnorderedSet<T, Hash, KeyEqual>::count(const T &value) const
+{
+    return contains(value) ? 1 : 0;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+template <typename Q, typename>
+size_t ChUnorderedSet<T, Hash, KeyEqual>::count(const Q &value) const
+{
+    return contains(value) ? 1 : 0;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+bool ChUnorderedSet<T, Hash, KeyEqual>::insert(const T &value)
+{
+    return insertValue(value);
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+bool ChUnorderedSet<T, Hash, KeyEqual>::insert(T &&value)
+{
+    return insertValue(std::move(value));
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+template <typename InputIt>
+void ChUnorderedSet<T, Hash, KeyEqual>::insert(InputIt first, InputIt last)
+{
+    for (; first != last; ++first)
+    {
+        insertValue(*first);
+    }
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+size_t ChUnorderedSet<T, Hash, KeyEqual>::erase(const T &value)
+{
+    if constexpr (bitsetCapable)
+    {
+        if (mode_ == ChUnorderedSetMode::Bitset)
+        {
+            const uint64_t ordinal = ordinalOf(value);
+            if (!bitsetCovers(ordinal))
+            {
+                return 0;
+            }
+            uint64_t &word = words_[static_cast<size_t>((ordinal >> 6) - baseWord_)];
+            const uint64_t bit = uint64_t(1) << (ordinal & 63);
+            if ((word & bit) == 0)
+            {
+                return 0;
+            }
+            word &= ~bit;
+            --size_;
+            return 1;
+        }
+    }
+    if (mode_ == ChUnorderedSetMode::PerfectHash)
+    {
+        if (findPosition(value) == endPosition())
+        {
+            return 0;
+        }
+        toHashTable(size_);
+    }
+    size_t slot = findSlot(value, hashOf(value));
+    if (slot == ChHashTable::noSlot)
+    {
+        return 0;
+    }
+    eraseSlot(slot);
+    return 1;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+template <typename Pred>
+size_t ChUnorderedSet<T, Hash, KeyEqual>::eraseIf(Pred pred)
+{
+    size_t erased = 0;
+    if constexpr (bitsetCapable)
+    {
+        if (mode_ == ChUnorderedSetMode::Bitset)
+        {
+            for (size_t w = 0; w < words_.size(); ++w)
+            {
+                for (uint64_t bits = words_[w]; bits != 0; bits &= bits - 1)
+                {
+                    const unsigned bit = ChBits::countTrailingZeros(bits);
+                    if (pred(valueOf(((baseWord_ + w) << 6) | bit)))
+                    {
+                        words_[w] &= ~(uint64_t(1) << bit);
+                        ++erased;
+                    }
+                }
+            }
+            size_ -= erased;
+            return erased;
+        }
+    }
+    if (mode_ == ChUnorderedSetMode::PerfectHash)
+    {
+        toHashTable(size_);
+    }
+    if (size_ == 0)
+    {
+        return 0;
+    }
+    // Start right after an empty slot and go once around the table. An erase only moves elements backwards within
+    // their run, into the slot just checked, and no run crosses the empty slot, so every element is checked once.
+    const size_t mask = capacity_ - 1;
+    const size_t empty = ChHashTable::findEmptySlot(control_, mask, 0);
+    for (size_t offset = 1; offset < capacity_;)
+    {
+        const size_t slot = (empty + offset) & mask;
+        if (control_[slot] >= 0 && pred(static_cast<const T &>(slots_[slot])))
+        {
+            eraseSlot(slot);
+            ++erased;
+        }
+        else
+        {
+            ++offset;
+        }
+    }
+    return erased;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+void ChUnorderedSet<T, Hash, KeyEqual>::clear() noexcept
+{
+    releaseTable();
+    ChVector<uint64_t>().swap(words_);
+    ChVector<T>().swap(elements_);
+    ChVector<uint32_t>().swap(pilots_);
+    mode_ = emptyMode();
+    size_ = 0;
+    baseWord_ = 0;
+    seed_ = 0;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+void ChUnorderedSet<T, Hash, KeyEqual>::swap(ChUnorderedSet &other) noexcept
+{
+    std::swap(mode_, other.mode_);
+    std::swap(size_, other.size_);
+    words_.swap(other.words_);
+    std::swap(baseWord_, other.baseWord_);
+    elements_.swap(other.elements_);
+    pilots_.swap(other.pilots_);
+    std::swap(seed_, other.seed_);
+    std::swap(control_, other.control_);
+    std::swap(slots_, other.slots_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(growthLimit_, other.growthLimit_);
+    std::swap(hash_, other.hash_);
+    std::swap(equal_, other.equal_);
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+Hash ChUnorderedSet<T, Hash, KeyEqual>::hash_function() const
+{
+    return hash_;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+KeyEqual ChUnorderedSet<T, Hash, KeyEqual>::key_eq() const
+{
+    return equal_;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+ChUnorderedSetMode ChUnorderedSet<T, Hash, KeyEqual>::emptyMode() noexcept
+{
+    return bitsetCapable ? ChUnorderedSetMode::Bitset : ChUnorderedSetMode::HashTable;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+size_t ChUnorderedSet<T, Hash, KeyEqual>::maxBitsetWords(size_t count) noexcept
+{
+    // 16 * (sizeof(T) + 1) bits per element
+    const size_t words = count / 4 * (sizeof(T) + 1);
+    return words > minBitsetWords ? words : minBitsetWords;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+uint64_t ChUnorderedSet<T, Hash, KeyEqual>::ordinalOf(T value) noexcept
+{
+    // Flipping the sign bit maps signed values onto unsigned ones in the same order
+    using Unsigned = typename std::make_unsigned<T>::type;
+    uint64_t ordinal = static_cast<Unsigned>(value);
+    if constexpr (std::is_signed<T>::value)
+    {
+        ordinal ^= uint64_t(1) << (sizeof(T) * 8 - 1);
+    }
+    return ordinal;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+T ChUnorderedSet<T, Hash, KeyEqual>::valueOf(uint64_t ordinal) noexcept
+{
+    using Unsigned = typename std::make_unsigned<T>::type;
+    if constexpr (std::is_signed<T>::value)
+    {
+        ordinal ^= uint64_t(1) << (sizeof(T) * 8 - 1);
+    }
+    return static_cast<T>(static_cast<Unsigned>(ordinal));
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+uint64_t ChUnorderedSet<T, Hash, KeyEqual>::maxWord() noexcept
+{
+    return static_cast<uint64_t>(std::numeric_limits<typename std::make_unsigned<T>::type>::max()) >> 6;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+size_t ChUnorderedSet<T, Hash, KeyEqual>::firstPosition() const noexcept
+{
+    switch (mode_)
+    {
+    case ChUnorderedSetMode::Bitset:
+        for (size_t w = 0; w < words_.size(); ++w)
+        {
+            if (words_[w] != 0)
+            {
+                return (w << 6) | ChBits::countTrailingZeros(words_[w]);
+            }
+        }
+        return endPosition();
+    case ChUnorderedSetMode::PerfectHash:
+        return 0;
+    default:
+        for (size_t slot = 0; slot < capacity_; ++slot)
+        {
+            if (control_[slot] >= 0)
+            {
+                return slot;
+            }
+        }
+        return capacity_;
+    }
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+size_t ChUnorderedSet<T, Hash, KeyEqual>::nextPosition(size_t position) const noexcept
+{
+    switch (mode_)
+    {
+    case ChUnorderedSetMode::Bitset:
+    {
+        ++position;
+        size_t w = position >> 6;
+        if (w >= words_.size())
+        {
+            return endPosition();
+        }
+        // Clear the bits below the position in its word, then look for the next word with a bit set
+        uint64_t bits = words_[w] & (~uint64_t(0) << (position & 63));
+        while (bits == 0)
+        {
+            if (++w == words_.size())
+            {
+                return endPosition();
+            }
+            bits = words_[w];
+        }
+        return (w << 6) | ChBits::countTrailingZeros(bits);
+    }
+    case ChUnorderedSetMode::PerfectHash:
+        return position + 1;
+    default:
+        do
+        {
+            ++position;
+        } while (position < capacity_ && control_[position] < 0);
+        return position;
+    }
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+size_t ChUnorderedSet<T, Hash, KeyEqual>::endPosition() const noexcept
+{
+    switch (mode_)
+    {
+    case ChUnorderedSetMode::Bitset:
+        return words_.size() << 6;
+    case ChUnorderedSetMode::PerfectHash:
+        return size_;
+    default:
+        return capacity_;
+    }
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+typename ChUnorderedSet<T, Hash, KeyEqual>::reference ChUnorderedSet<T, Hash, KeyEqual>::valueAt(size_t position) const
+{
+    if constexpr (bitsetCapable)
+    {
+        if (mode_ == ChUnorderedSetMode::Bitset)
+        {
+            return valueOf(((baseWord_ + (position >> 6)) << 6) | (position & 63));
+        }
+    }
+    return mode_ == ChUnorderedSetMode::PerfectHash ? elements_[position] : slots_[position];
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+template <typename Q>
+size_t ChUnorderedSet<T, Hash, KeyEqual>::findPosition(const Q &value) const
+{
+    switch (mode_)
+    {
+    case ChUnorderedSetMode::Bitset:
+        if constexpr (bitsetCapable)
+        {
+            const uint64_t ordinal = ordinalOf(value);
+            if (bitsetCovers(ordinal))
+            {
+                const size_t position = static_cast<size_t>(((ordinal >> 6) - baseWord_) << 6) | static_cast<size_t>(ordinal & 63);
+                if ((words_[position >> 6] >> (position & 63)) & 1)
+                {
+                    return position;
+                }
+            }
+        }
+        return endPosition();
+    case ChUnorderedSetMode::PerfectHash:
+    {
+        const size_t position = perfectPosition(value);
+        return equal_(elements_[position], value) ? position : size_;
+    }
+    default:
+    {
+        const size_t slot = findSlot(value, hashOf(value));
+        return slot == ChHashTable::noSlot ? capacity_ : slot;
+    }
+    }
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+template <typename U>
+bool ChUnorderedSet<T, Hash, KeyEqual>::insertValue(U &&value)
+{
+    if constexpr (bitsetCapable)
+    {
+        if (mode_ == ChUnorderedSetMode::Bitset)
+        {
+            const uint64_t ordinal = ordinalOf(value);
+            if (bitsetCovers(ordinal) || growBitset(ordinal))
+            {
+                uint64_t &word = words_[static_cast<size_t>((ordinal >> 6) - baseWord_)];
+                const uint64_t bit = uint64_t(1) << (ordinal & 63);
+                if ((word & bit) != 0)
+                {
+                    return false;
+                }
+                word |= bit;
+                ++size_;
+                return true;
+            }
+            toHashTable(size_ + 1);
+        }
+    }
+    if (mode_ == ChUnorderedSetMode::PerfectHash)
+    {
+        if (findPosition(value) != endPosition())
+        {
+            return false;
+        }
+        toHashTable(size_ + 1);
+    }
+
+    const uint64_t hash = hashOf(value);
+    if (findSlot(value, hash) != ChHashTable::noSlot)
+    {
+        return false;
+    }
+    if (size_ >= growthLimit_)
+    {
+        if constexpr (bitsetCapable)
+        {
+            // Elements inserted in random order may only become dense over time
+            uint64_t lowest;
+            uint64_t highest;
+            if (fitsBitset(ordinalOf(value), lowest, highest))
+            {
+                toBitset(lowest, highest);
+                return insertValue(std::forward<U>(value));
+            }
+        }
+        rehashTo(capacity_ == 0 ? ChHashTable::minCapacity : capacity_ * 2);
+    }
+    // The control byte is set after the element is constructed, so a throwing constructor leaves the set unchanged
+    const size_t slot = ChHashTable::findEmptySlot(control_, capacity_ - 1, ChHashTable::homeSlot(hash, capacity_ - 1));
+    ::new (static_cast<void *>(slots_ + slot)) T(std::forward<U>(value));
+    ChHashTable::setControl(control_, capacity_, slot, ChHashTable::controlByte(hash));
+    ++size_;
+    return true;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+bool ChUnorderedSet<T, Hash, KeyEqual>::bitsetCovers(uint64_t ordinal) const noexcept
+{
+    // Ordinals below the base wrap around to large word offsets
+    return (ordinal >> 6) - baseWord_ < words_.size();
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+bool ChUnorderedSet<T, Hash, KeyEqual>::growBitset(uint64_t ordinal)
+{
+    const uint64_t word = ordinal >> 6;
+    uint64_t lowWord = word;
+    uint64_t highWord = word;
+    if (!words_.isEmpty())
+    {
+        lowWord = std::min<uint64_t>(baseWord_, word);
+        highWord = std::max<uint64_t>(baseWord_ + words_.size() - 1, word);
+        const uint64_t limit = maxBitsetWords(size_ + 1);
+        if (highWord - lowWord + 1 > limit)
+        {
+            return false;
+        }
+        // Leave room on the side the bitset grows to, so that increasing or decreasing values only reallocate a
+        // logarithmic number of times
+        const uint64_t target = std::max<uint64_t>(highWord - lowWord + 1, std::min<uint64_t>(limit, 2 * words_.size()));
+        if (word > baseWord_)
+        {
+            highWord = std::min<uint64_t>(maxWord(), lowWord + target - 1);
+        }
+        else
+        {
+            lowWord = highWord + 1 >= target ? highWord + 1 - target : 0;
+        }
+    }
+    ChVector<uint64_t> grown;
+    grown.resize(static_cast<size_t>(highWord - lowWord + 1));
+    if (!words_.isEmpty())
+    {
+        std::memcpy(grown.data() + (baseWord_ - lowWord), words_.data(), words_.size() * sizeof(uint64_t));
+    }
+    words_.swap(grown);
+    baseWord_ = lowWord;
+    return true;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+void ChUnorderedSet<T, Hash, KeyEqual>::toBitset(uint64_t lowest, uint64_t highest)
+{
+    ChVector<uint64_t> words;
+    words.resize(static_cast<size_t>((highest >> 6) - (lowest >> 6) + 1));
+    const uint64_t baseWord = lowest >> 6;
+    for (size_t slot = 0; slot < capacity_; ++slot)
+    {
+        if (control_[slot] >= 0)
+        {
+            const uint64_t ordinal = ordinalOf(slots_[slot]);
+            words[static_cast<size_t>((ordinal >> 6) - baseWord)] |= uint64_t(1) << (ordinal & 63);
+        }
+    }
+    releaseTable();
+    words_.swap(words);
+    baseWord_ = baseWord;
+    mode_ = ChUnorderedSetMode::Bitset;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+bool ChUnorderedSet<T, Hash, KeyEqual>::fitsBitset(uint64_t ordinal, uint64_t &lowest, uint64_t &highest) const
+{
+    lowest = ordinal;
+    highest = ordinal;
+    for (size_t slot = 0; slot < capacity_; ++slot)
+    {
+        if (control_[slot] >= 0)
+        {
+            lowest = std::min(lowest, ordinalOf(slots_[slot]));
+            highest = std::max(highest, ordinalOf(slots_[slot]));
+        }
+    }
+    return (highest >> 6) - (lowest >> 6) < maxBitsetWords(size_ + 1);
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+template <typename Q>
+uint64_t ChUnorderedSet<T, Hash, KeyEqual>::hashOf(const Q &value) const
+{
+    return ChHashTable::mix(static_cast<uint64_t>(hash_(value)));
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+template <typename Q>
+size_t ChUnorderedSet<T, Hash, KeyEqual>::perfectPosition(const Q &value) const
+{
+    const uint64_t hash = ChHashTable::mix(static_cast<uint64_t>(hash_(value)) ^ seed_);
+    return reduce(pilotHash(hash, pilots_[reduce(hash, pilots_.size())]), size_);
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+size_t ChUnorderedSet<T, Hash, KeyEqual>::reduce(uint64_t hash, size_t range) noexcept
+{
+    // Maps the high 32 bits of the hash onto [0, range) with a multiplication instead of a division
+    return static_cast<size_t>(((hash >> 32) * static_cast<uint64_t>(range)) >> 32);
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+uint64_t ChUnorderedSet<T, Hash, KeyEqual>::pilotHash(uint64_t hash, uint32_t pilot) noexcept
+{
+    return ChHashTable::mix(hash ^ (static_cast<uint64_t>(pilot) * 0x9E3779B97F4A7C15ull));
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+bool ChUnorderedSet<T, Hash, KeyEqual>::buildPerfectHash(ChVector<T> &values)
+{
+    const size_t count = values.size();
+    if (count > std::numeric_limits<uint32_t>::max())
+    {
+        return false;
+    }
+    const size_t bucketCount = count / perfectBucketLoad + 1;
+    // The last buckets to be placed have a single element and few free positions left. Finding one of them takes
+    // `count` seeds on average when one position is left, so allow far more than that before giving up.
+    const uint64_t pilotLimit = std::min<uint64_t>(std::numeric_limits<uint32_t>::max(), std::max<uint64_t>(uint64_t(1) << 20, uint64_t(64) * count));
+
+    std::vector<uint64_t> hashes(count);
+    std::vector<uint32_t> bucketStart(bucketCount + 1);
+    std::vector<uint32_t> members(count);
+    std::vector<uint32_t> pilots(bucketCount);
+    std::vector<uint32_t> positions(count);
+    std::vector<uint64_t> taken;
+    std::vector<uint32_t> order;
+    for (unsigned attempt = 0; attempt < perfectAttempts; ++attempt)
+    {
+        const uint64_t seed = ChHashTable::mix(0x9E3779B97F4A7C15ull * (attempt + 1));
+        for (size_t i = 0; i < count; ++i)
+        {
+            hashes[i] = ChHashTable::mix(static_cast<uint64_t>(hash_(values[i])) ^ seed);
+        }
+
+        // Group the elements by bucket (a counting sort)
+        std::fill(bucketStart.begin(), bucketStart.end(), 0);
+        for (size_t i = 0; i < count; ++i)
+        {
+            ++bucketStart[reduce(hashes[i], bucketCount) + 1];
+        }
+        for (size_t b = 0; b < bucketCount; ++b)
+        {
+            bucketStart[b + 1] += bucketStart[b];
+        }
+        {
+            std::vector<uint32_t> next(bucketStart.begin(), bucketStart.end() - 1);
+            for (size_t i = 0; i < count; ++i)
+            {
+                members[next[reduce(hashes[i], bucketCount)]++] = static_cast<uint32_t>(i);
+            }
+        }
+
+        // Drop repeated elements, which share their hash, and keep the first. Different elements with the same hash
+        // cannot be told apart by any seed of the buckets, only by a new seed of the whole function.
+        bool separable = true;
+        size_t unique = 0;
+        size_t largest = 0;
+        size_t start = 0;
+        for (size_t b = 0; b < bucketCount && separable; ++b)
+        {
+            const size_t end = bucketStart[b + 1];
+            bucketStart[b] = static_cast<uint32_t>(unique);
+            std::sort(members.begin() + start, members.begin() + end, [&](uint32_t x, uint32_t y)
+            {
+                return hashes[x] != hashes[y] ? hashes[x] < hashes[y] : x < y;
+            });
+            const size_t first = unique;
+            for (size_t m = start; m < end; ++m)
+            {
+                const uint32_t member = members[m];
+                if (unique > first && hashes[members[unique - 1]] == hashes[member])
+                {
+                    if (!equal_(values[members[unique - 1]], values[member]))
+                    {
+                        separable = false;
+                        break;
+                    }
+                    continue;
+                }
+                members[unique++] = member;
+            }
+            largest = std::max(largest, unique - first);
+            start = end;
+        }
+        if (!separable)
+        {
+            continue;
+        }
+        bucketStart[bucketCount] = static_cast<uint32_t>(unique);
+
+        // Place the largest buckets first, while most positions are free
+        std::vector<uint32_t> sizeStart(largest + 2, 0);
+        for (size_t b = 0; b < bucketCount; ++b)
+        {
+            ++sizeStart[largest - (bucketStart[b + 1] - bucketStart[b]) + 1];
+        }
+        for (size_t s = 0; s <= largest; ++s)
+        {
+            sizeStart[s + 1] += sizeStart[s];
+        }
+        order.assign(bucketCount, 0);
+        for (size_t b = 0; b < bucketCount; ++b)
+        {
+            order[sizeStart[largest - (bucketStart[b + 1] - bucketStart[b])]++] = static_cast<uint32_t>(b);
+        }
+
+        taken.assign((unique + 63) / 64, 0);
+        bool placed = true;
+        for (size_t o = 0; o < bucketCount && placed; ++o)
+        {
+            const uint32_t b = order[o];
+            const size_t first = bucketStart[b];
+            const size_t last = bucketStart[b + 1];
+            pilots[b] = 0;
+            if (first == last)
+            {
+                continue;
+            }
+            for (uint64_t pilot = 0;; ++pilot)
+            {
+                if (pilot == pilotLimit)
+                {
+                    placed = false;
+                    break;
+                }
+                bool free = true;
+                for (size_t m = first; m < last && free; ++m)
+                {
+                    const size_t position = reduce(pilotHash(hashes[members[m]], static_cast<uint32_t>(pilot)), unique);
+                    free = ((taken[position >> 6] >> (position & 63)) & 1) == 0;
+                    for (size_t earlier = first; earlier < m && free; ++earlier)
+                    {
+                        free = positions[members[earlier]] != position;
+                    }
+                    positions[members[m]] = static_cast<uint32_t>(position);
+                }
+                if (free)
+                {
+                    for (size_t m = first; m < last; ++m)
+                    {
+                        const uint32_t position = positions[members[m]];
+                        taken[position >> 6] |= uint64_t(1) << (position & 63);
+                    }
+                    pilots[b] = static_cast<uint32_t>(pilot);
+                    break;
+                }
+            }
+        }
+        if (!placed)
+        {
+            continue;
+        }
+
+        // Move the elements into the positions the function assigns them
+        std::vector<uint32_t> atPosition(unique);
+        for (size_t m = 0; m < unique; ++m)
+        {
+            atPosition[positions[members[m]]] = members[m];
+        }
+        ChVector<T> elements;
+        elements.reserve(unique);
+        for (size_t position = 0; position < unique; ++position)
+        {
+            elements.push_back(std::move(values[atPosition[position]]));
+        }
+        ChVector<uint32_t> pilotValues;
+        pilotValues.assign(pilots.begin(), pilots.end());
+        elements_.swap(elements);
+        pilots_.swap(pilotValues);
+        seed_ = seed;
+        size_ = unique;
+        mode_ = ChUnorderedSetMode::PerfectHash;
+        return true;
+    }
+    return false;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+template <typename Q>
+size_t ChUnorderedSet<T, Hash, KeyEqual>::findSlot(const Q &value, uint64_t hash) const
+{
+    if (size_ == 0)
+    {
+        return ChHashTable::noSlot;
+    }
+    return ChHashTable::findSlot(control_, capacity_ - 1, hash, [&](size_t slot) { return equal_(slots_[slot], value); });
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+void ChUnorderedSet<T, Hash, KeyEqual>::insertSlot(T &&value, uint64_t hash) noexcept
+{
+    const size_t slot = ChHashTable::findEmptySlot(control_, capacity_ - 1, ChHashTable::homeSlot(hash, capacity_ - 1));
+    ::new (static_cast<void *>(slots_ + slot)) T(std::move(value));
+    ChHashTable::setControl(control_, capacity_, slot, ChHashTable::controlByte(hash));
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+void ChUnorderedSet<T, Hash, KeyEqual>::eraseSlot(size_t slot)
+{
+    slots_[slot].~T();
+    --size_;
+    ChHashTable::eraseSlot(control_, capacity_, slot, [this](size_t from)
+    {
+        return ChHashTable::homeSlot(hashOf(slots_[from]), capacity_ - 1);
+    }, [this](size_t from, size_t to)
+    {
+        ::new (static_cast<void *>(slots_ + to)) T(std::move(slots_[from]));
+        slots_[from].~T();
+    });
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+void ChUnorderedSet<T, Hash, KeyEqual>::rehashTo(size_t slots)
+{
+    int8_t *control = static_cast<int8_t *>(::operator new(ChHashTable::controlSize(slots)));
+    T *elements;
+    try
+    {
+        elements = std::allocator<T>().allocate(slots);
+    }
+    catch (...)
+    {
+        ::operator delete(control);
+        throw;
+    }
+    std::memset(control, ChHashTable::emptyControl, ChHashTable::controlSize(slots));
+    int8_t *oldControl = control_;
+    T *oldSlots = slots_;
+    size_t oldCapacity = capacity_;
+    control_ = control;
+    slots_ = elements;
+    capacity_ = slots;
+    growthLimit_ = slots / 5 * 4;
+    // Moving the elements cannot throw, so from here on the rehash cannot fail half way
+    for (size_t slot = 0; slot < oldCapacity; ++slot)
+    {
+        if (oldControl[slot] >= 0)
+        {
+            insertSlot(std::move(oldSlots[slot]), hashOf(oldSlots[slot]));
+            oldSlots[slot].~T();
+        }
+    }
+    if (oldCapacity != 0)
+    {
+        std::allocator<T>().deallocate(oldSlots, oldCapacity);
+        ::operator delete(oldControl);
+    }
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+size_t ChUnorderedSet<T, Hash, KeyEqual>::slotsFor(size_t count) const
+{
+    size_t slots = ChHashTable::minCapacity;
+    while (slots / 5 * 4 < count)
+    {
+        if (slots > std::allocator_traits<std::allocator<T>>::max_size(std::allocator<T>()) / 2)
+        {
+            throw std::length_error("ChUnorderedSet cannot hold that many elements");
+        }
+        slots *= 2;
+    }
+    return slots;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+void ChUnorderedSet<T, Hash, KeyEqual>::toHashTable(size_t count)
+{
+    const ChUnorderedSetMode from = mode_;
+    mode_ = ChUnorderedSetMode::HashTable;
+    try
+    {
+        rehashTo(slotsFor(count));
+    }
+    catch (...)
+    {
+        mode_ = from;
+        throw;
+    }
+    if constexpr (bitsetCapable)
+    {
+        if (from == ChUnorderedSetMode::Bitset)
+        {
+            for (size_t w = 0; w < words_.size(); ++w)
+            {
+                for (uint64_t bits = words_[w]; bits != 0; bits &= bits - 1)
+                {
+                    const T value = valueOf(((baseWord_ + w) << 6) | ChBits::countTrailingZeros(bits));
+                    insertSlot(T(value), hashOf(value));
+                }
+            }
+            ChVector<uint64_t>().swap(words_);
+            baseWord_ = 0;
+        }
+    }
+    if (from == ChUnorderedSetMode::PerfectHash)
+    {
+        for (size_t i = 0; i < elements_.size(); ++i)
+        {
+            const uint64_t hash = hashOf(elements_[i]);
+            insertSlot(std::move(elements_[i]), hash);
+        }
+        ChVector<T>().swap(elements_);
+        ChVector<uint32_t>().swap(pilots_);
+        seed_ = 0;
+    }
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+void ChUnorderedSet<T, Hash, KeyEqual>::releaseTable() noexcept
+{
+    if (capacity_ != 0)
+    {
+        if (!std::is_trivially_destructible<T>::value)
+        {
+            for (size_t slot = 0; slot < capacity_; ++slot)
+            {
+                if (control_[slot] >= 0)
+                {
+                    slots_[slot].~T();
+                }
+            }
+        }
+        std::allocator<T>().deallocate(slots_, capacity_);
+        ::operator delete(control_);
+    }
+    control_ = nullptr;
+    slots_ = nullptr;
+    capacity_ = 0;
+    growthLimit_ = 0;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+bool operator==(const ChUnorderedSet<T, Hash, KeyEqual> &a, const ChUnorderedSet<T, Hash, KeyEqual> &b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (auto &&value : a)
+    {
+        if (!b.contains(value))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+bool operator!=(const ChUnorderedSet<T, Hash, KeyEqual> &a, const ChUnorderedSet<T, Hash, KeyEqual> &b)
+{
+    return !(a == b);
+}
\ No newline at end of file
@@ -1,10 +1,463 @@
 #ifndef CHUNORDEREDSET
 #define CHUNORDEREDSET
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "ChHash.h"
+#include "ChHashTable.h"
+#include "ChVector.h"
+
+/**
+ * @brief The representations a ChUnorderedSet switches between.
+ */
+enum class ChUnorderedSetMode
+{
+    /**
+     * @brief One bit per value of the range between the smallest and the largest element. Only for integral elements
+     * whose range is small compared to their number.
+     */
+    Bitset,
+
+    /**
+     * @brief The elements of a set built with `ChUnorderedSet::frozen`, each at the position a minimal perfect hash
+     * function computes for it, so that a lookup reads exactly one element.
+     */
+    PerfectHash,
+
+    /**
+     * @brief An open-addressing hash table with SIMD probing, the same as the one of ChHashMap.
+     */
+    HashTable
+};
+
+/**
+ * @brief An unordered set of unique elements of type T that picks the most compact representation for its contents.
+ *
+ * All three representations sit behind the same interface, and the set moves between them on its own:
+ *
+ * - Integral elements start out as a bitset over the range between the smallest and the largest element, which is
+ *   the smallest and fastest representation for dense values such as ids. The set stays a bitset as long as the range
+ *   takes at most 16 * (sizeof(T) + 1) bits per element, which is about what the hash table takes when it is half
+ *   full. When an element makes the range too sparse, the set moves into a hash table; when the hash table has to
+ *   grow, it checks whether its elements have become dense enough for a bitset again.
+ * - `frozen` builds a set that is not expected to change. Unless the elements fit a bitset, it computes a minimal
+ *   perfect hash function for them (hash and displace: the elements are hashed into buckets of about three, and every
+ *   bucket gets the first seed that sends all its elements to free positions). The elements are stored in an array of
+ *   exactly `size()` entries at their positions, plus one 32-bit seed per bucket, and a lookup hashes the value
+ *   twice and compares it with the one element at its position. Inserting or erasing moves the set into a hash table.
+ * - Everything else is an open-addressing hash table, probed a group of control bytes at a time as in ChHashMap.
+ *
+ * `mode()` reports the current representation. Integral elements are only kept in a bitset if the set compares them
+ * with std::equal_to; the hash function does not matter there.
+ *
+ * The iterators of sets that can be a bitset return the elements by value; the others return references. Any change
+ * to the set invalidates its iterators. The order of the elements is unspecified; a bitset visits them in increasing
+ * order.
+ *
+ * @code
+ * ChUnorderedSet<std::string> keywords = ChUnorderedSet<std::string>::frozen(loadKeywords());
+ * if (keywords.contains(std::string_view(token)))
+ * {
+ *     highlight(token);
+ * }
+ * @endcode
+ *
+ * Elements move when the set changes its representation, so T must be nothrow move constructible.
+ *
+ * @tparam T The type of the elements.
+ * @tparam Hash The hash function of the elements.
+ * @tparam KeyEqual The comparison of the elements.
+ */
+template <typename T, typename Hash = ChHash<T>, typename KeyEqual = std::equal_to<>>
 class ChUnorderedSet
 {
+    static_assert(std::is_nothrow_move_constructible<T>::value, "ChUnorderedSet needs nothrow move constructible elements");
+
+    class Iterator;
+
+    // Enables the heterogeneous overloads for types other than T
+    template <typename Q>
+    using EnableIfTransparent = typename std::enable_if<ChHashTable::IsTransparent<Hash, KeyEqual>::value && !std::is_same<Q, T>::value>::type;
+
+    // Whether the set can be a bitset: integral elements compared by value, and no lookups with other types
+    static constexpr bool bitsetCapable = std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+                                          (std::is_same<KeyEqual, std::equal_to<>>::value || std::is_same<KeyEqual, std::equal_to<T>>::value) &&
+                                          !ChHashTable::IsTransparent<Hash, KeyEqual>::value;
+
+public:
+    using key_type = T;
+    using value_type = T;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = typename std::conditional<bitsetCapable, T, const T &>::type;
+    using const_reference = reference;
+    using iterator = Iterator;
+    using const_iterator = Iterator;
+
+    /**
+     * @brief Default constructor. Constructs an empty set that has not allocated any memory.
+     */
     ChUnorderedSet();
+
+    /**
+     * @brief Constructs an empty set. A set that starts out as a hash table makes room for `count` elements.
+     *
+     * @param count The number of elements to reserve room for.
+     * @param hash The hash function to use.
+     * @param equal The comparison to use.
+     */
+    explicit ChUnorderedSet(size_t count, const Hash &hash = Hash(), const KeyEqual &equal = KeyEqual());
+
+    /**
+     * @brief Constructs the set with the given elements.
+     *
+     * @param values The elements to initialize the set with.
+     */
+    ChUnorderedSet(std::initializer_list<T> values);
+
+    /**
+     * @brief Constructs the set from the elements in the range [first, last).
+     *
+     * @param first The beginning of the range.
+     * @param last The end of the range.
+     */
+    template <typename InputIt>
+    ChUnorderedSet(InputIt first, InputIt last);
+
+    /**
+     * @brief Copy constructor. Constructs the set with a copy of the contents of `other`, in the same representation.
+     *
+     * @param other Another ChUnorderedSet object to copy the elements from.
+     */
+    ChUnorderedSet(const ChUnorderedSet &other);
+
+    /**
+     * @brief Move constructor. Takes over the contents of `other`.
+     *
+     * @param other Another ChUnorderedSet object to move the elements from. `other` is left empty.
+     */
+    ChUnorderedSet(ChUnorderedSet &&other) noexcept;
+
+    /**
+     * @brief Destructor. Destroys the elements and frees the memory.
+     */
     ~ChUnorderedSet();
+
+    /**
+     * @brief Copy assignment operator. Replaces the contents of the set with a copy of the contents of `other`.
+     *
+     * @param other Another ChUnorderedSet object to copy the elements from.
+     * @return *this
+     */
+    ChUnorderedSet &operator=(const ChUnorderedSet &other);
+
+    /**
+     * @brief Move assignment operator. Replaces the contents of the set with the contents of `other`.
+     *
+     * @param other Another ChUnorderedSet object to move the elements from. `other` is left empty.
+     * @return *this
+     */
+    ChUnorderedSet &operator=(ChUnorderedSet &&other) noexcept;
+
+    /**
+     * @brief Builds a set of elements that are not expected to change: a bitset if they are dense integers, and
+     * otherwise an array with a minimal perfect hash function. Of equal elements, the first one is kept.
+     *
+     * Building the perfect hash function takes a few hundred nanoseconds per element. In the unlikely case that the
+     * hash function maps distinct elements to the same 64-bit value, which no seed can separate, the set falls back to
+     * a hash table.
+     *
+     * @param values The elements of the set.
+     * @param hash The hash function to use.
+     * @param equal The comparison to use.
+     * @return The set.
+     */
+    static ChUnorderedSet frozen(ChVector<T> values, const Hash &hash = Hash(), const KeyEqual &equal = KeyEqual());
+
+    /**
+     * @brief Returns the current representation of the set.
+     */
+    ChUnorderedSetMode mode() const noexcept;
+
+    /**
+     * @brief Returns an iterator to the first element of the set. The order of the elements is unspecified.
+     */
+    const_iterator begin() const noexcept;
+
+    /**
+     * @brief Returns an iterator past the last element of the set.
+     */
+    const_iterator end() const noexcept;
+
+    /**
+     * @brief Returns an iterator to the first element of the set.
+     */
+    const_iterator cbegin() const noexcept;
+
+    /**
+     * @brief Returns an iterator past the last element of the set.
+     */
+    const_iterator cend() const noexcept;
+
+    /**
+     * @brief Returns the number of elements.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Returns whether the set has no elements.
+     */
+    bool isEmpty() const noexcept;
+
+    /**
+     * @brief Makes room for `count` elements in a hash table. Has no effect in the other representations.
+     *
+     * @param count The number of elements to make room for.
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Finds the element equal to `value`.
+     *
+     * @param value The value to look for.
+     * @return An iterator to the element, or `end()` if there is none.
+     */
+    const_iterator find(const T &value) const;
+
+    /**
+     * @brief Heterogeneous version of `find`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    const_iterator find(const Q &value) const;
+
+    /**
+     * @brief Returns whether the set holds an element equal to `value`.
+     *
+     * @param value The value to look for.
+     * @return True if the value is in the set.
+     */
+    bool contains(const T &value) const;
+
+    /**
+     * @brief Heterogeneous version of `contains`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    bool contains(const Q &value) const;
+
+    /**
+     * @brief Returns the number of elements equal to `value`, 0 or 1.
+     *
+     * @param value The value to count.
+     * @return 1 if the value is in the set, and 0 otherwise.
+     */
+    size_t count(const T &value) const;
+
+    /**
+     * @brief Heterogeneous version of `count`.
+     */
+    template <typename Q, typename = EnableIfTransparent<Q>>
+    size_t count(const Q &value) const;
+
+    /**
+     * @brief Inserts `value` unless the set already holds an equal element.
+     *
+     * @param value The value to insert.
+     * @return True if the value was inserted.
+     */
+    bool insert(const T &value);
+
+    /**
+     * @brief Inserts `value` unless the set already holds an equal element.
+     *
+     * @param value The value to insert.
+     * @return True if the value was inserted.
+     */
+    bool insert(T &&value);
+
+    /**
+     * @brief Inserts the elements in the range [first, last) that the set does not hold yet.
+     *
+     * @param first The beginning of the range.
+     * @param last The end of the range.
+     */
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last);
+
+    /**
+     * @brief Removes the element equal to `value`, if there is one.
+     *
+     * @param value The value to remove.
+     * @return The number of elements removed, 0 or 1.
+     */
+    size_t erase(const T &value);
+
+    /**
+     * @brief Removes every element for which `pred(element)` returns true.
+     *
+     * @param pred The predicate, called once with each element.
+     * @return The number of elements removed.
+     */
+    template <typename Pred>
+    size_t eraseIf(Pred pred);
+
+    /**
+     * @brief Removes all elements and frees the memory.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Exchanges the contents of the set with those of `other`.
+     *
+     * @param other The set to exchange the contents with.
+     */
+    void swap(ChUnorderedSet &other) noexcept;
+
+    /**
+     * @brief Returns the hash function of the set.
+     */
+    Hash hash_function() const;
+
+    /**
+     * @brief Returns the comparison of the set.
+     */
+    KeyEqual key_eq() const;
+
+private:
+    // The bitset always may span this many words, however few elements it has
+    static const size_t minBitsetWords = 64;
+
+    // The average number of elements per bucket of the perfect hash function
+    static const size_t perfectBucketLoad = 3;
+
+    // The number of seeds for the whole function tried before giving up on a perfect hash function
+    static const unsigned perfectAttempts = 4;
+
+    static ChUnorderedSetMode emptyMode() noexcept;
+    static size_t maxBitsetWords(size_t count) noexcept;
+    static uint64_t ordinalOf(T value) noexcept;
+    static T valueOf(uint64_t ordinal) noexcept;
+    static uint64_t maxWord() noexcept;
+
+    size_t firstPosition() const noexcept;
+    size_t nextPosition(size_t position) const noexcept;
+    size_t endPosition() const noexcept;
+    reference valueAt(size_t position) const;
+
+    template <typename Q>
+    size_t findPosition(const Q &value) const;
+    template <typename U>
+    bool insertValue(U &&value);
+
+    bool bitsetCovers(uint64_t ordinal) const noexcept;
+    bool growBitset(uint64_t ordinal);
+    void toBitset(uint64_t lowest, uint64_t highest);
+    bool fitsBitset(uint64_t ordinal, uint64_t &lowest, uint64_t &highest) const;
+
+    template <typename Q>
+    uint64_t hashOf(const Q &value) const;
+    template <typename Q>
+    size_t perfectPosition(const Q &value) const;
+    static size_t reduce(uint64_t hash, size_t range) noexcept;
+    static uint64_t pilotHash(uint64_t hash, uint32_t pilot) noexcept;
+    bool buildPerfectHash(ChVector<T> &values);
+
+    template <typename Q>
+    size_t findSlot(const Q &value, uint64_t hash) const;
+    void insertSlot(T &&value, uint64_t hash) noexcept;
+    void eraseSlot(size_t slot);
+    void rehashTo(size_t slots);
+    size_t slotsFor(size_t count) const;
+    void toHashTable(size_t count);
+    void releaseTable() noexcept;
+
+    ChUnorderedSetMode mode_;
+    size_t size_;
+
+    // The bitset: bit i of words_[w] stands for the value with the ordinal 64 * (baseWord_ + w) + i
+    ChVector<uint64_t> words_;
+    uint64_t baseWord_;
+
+    // The perfect hash function: the elements in the order of their positions, and the seed of every bucket
+    ChVector<T> elements_;
+    ChVector<uint32_t> pilots_;
+    uint64_t seed_;
+
+    // The hash table
+    int8_t *control_;
+    T *slots_;
+    size_t capacity_;
+    size_t growthLimit_;
+
+    Hash hash_;
+    KeyEqual equal_;
 };
 
+/**
+ * @brief Forward iterator over the elements of a ChUnorderedSet.
+ */
+template <typename T, typename Hash, typename KeyEqual>
+class ChUnorderedSet<T, Hash, KeyEqual>::Iterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using reference = ChUnorderedSet::reference;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() : set_(nullptr), position_(0) {}
+
+    Iterator(const ChUnorderedSet *set, size_t position) : set_(set), position_(position) {}
+
+    reference operator*() const
+    {
+        return set_->valueAt(position_);
+    }
+
+    Iterator &operator++()
+    {
+        position_ = set_->nextPosition(position_);
+        return *this;
+    }
+
+    Iterator operator++(int)
+    {
+        Iterator previous = *this;
+        ++*this;
+        return previous;
+    }
+
+    bool operator==(const Iterator &other) const
+    {
+        return position_ == other.position_;
+    }
+
+    bool operator!=(const Iterator &other) const
+    {
+        return position_ != other.position_;
+    }
+
+private:
+    const ChUnorderedSet *set_;
+    size_t position_;
+};
+
+/**
+ * @brief Returns whether both sets hold equal elements, whatever their representations.
+ */
+template <typename T, typename Hash, typename KeyEqual>
+bool operator==(const ChUnorderedSet<T, Hash, KeyEqual> &a, const ChUnorderedSet<T, Hash, KeyEqual> &b);
+
+/**
+ * @brief Returns whether the sets differ.
+ */
+template <typename T, typename Hash, typename KeyEqual>
+bool operator!=(const ChUnorderedSet<T, Hash, KeyEqual> &a, const ChUnorderedSet<T, Hash, KeyEqual> &b);
+
 #endif
\ No newline at end of file
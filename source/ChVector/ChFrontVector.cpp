@@ -0,0 +1,882 @@
+#include "ChFrontVector.h"
+#include "ChVectorAlgorithms.h"
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+template <typename T>
+ChFrontVector<T>::ChFrontVector() : buffer_(nullptr), capacity_(0), head_(0), size_(0) {}
+
+template <typename T>
+ChFrontVector<T>::ChFrontVector(std::initializer_list<T> values) : ChFrontVector()
+{
+    assign(values.begin(), values.end());
+}
+
+template <typename T>
+ChFrontVector<T>::ChFrontVector(const ChFrontVector &other) : ChFrontVector()
+{
+    assign(other.begin(), other.end());
+}
+
+template <typename T>
+ChFrontVector<T>::ChFrontVector(ChFrontVector &&other) noexcept : ChFrontVector()
+{
+    swap(other);
+}
+
+template <typename T>
+ChFrontVector<T>::~ChFrontVector()
+{
+    reset();
+}
+
+template <typename T>
+ChFrontVector<T> &ChFrontVector<T>::operator=(const ChFrontVector &other)
+{
+    if (this != &other)
+    {
+        assign(other.begin(), other.end());
+    }
+    return *this;
+}
+
+template <typename T>
+ChFrontVector<T> &ChFrontVector<T>::operator=(ChFrontVector &&other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        swap(other);
+    }
+    return *this;
+}
+
+template <typename T>
+bool ChFrontVector<T>::contains(const T &value) const
+{
+    return ChVectorAlgorithms::indexOf(data(), size_, value) != size_;
+}
+
+template <typename T>
+void ChFrontVector<T>::remove(const T &value)
+{
+    erase(std::remove(begin(), end(), value), end());
+}
+
+template <typename T>
+size_t ChFrontVector<T>::count(const T &value) const
+{
+    return ChVectorAlgorithms::count(data(), size_, value);
+}
+
+template <typename T>
+typename ChFrontVector<T>::iterator ChFrontVector<T>::find(const T &value)
+{
+    return data() + ChVectorAlgorithms::indexOf(data(), size_, value);
+}
+
+template <typename T>
+typename ChFrontVector<T>::const_iterator ChFrontVector<T>::find(const T &value) const
+{
+    return data() + ChVectorAlgorithms::indexOf(data(), size_, value);
+}
+
+template <typename T>
+int ChFrontVector<T>::indexOf(const T &element) const
+{
+    size_t index = ChVectorAlgorithms::indexOf(data(), size_, element);
+    return index == size_ ? -1 : static_cast<int>(index);
+}
+
+template <typename T>
+int ChFrontVector<T>::lastIndexOf(const T &element) const
+{
+    if constexpr (ChVectorKernels::HasKernels<T>::value)
+    {
+        size_t index = ChVectorKernels::lastIndexOf(data(), size_, element);
+        return index == size_ ? -1 : static_cast<int>(index);
+    }
+
+    auto it = std::find(rbegin(), rend(), element);
+    if (it == rend())
+    {
+        return -1;
+    }
+    return static_cast<int>(std::distance(it, rend()) - 1);
+}
+
+template <typename T>
+void ChFrontVector<T>::reverse()
+{
+    std::reverse(begin(), end());
+}
+
+template <typename T>
+void ChFrontVector<T>::shuffle(unsigned int seed)
+{
+    std::shuffle(begin(), end(), std::default_random_engine(seed));
+}
+
+template <typename T>
+void ChFrontVector<T>::concat(const ChFrontVector &other)
+{
+    if (&other == this)
+    {
+        // Making room first keeps the source iterators valid
+        reserve(2 * size_);
+    }
+    insert(end(), other.begin(), other.end());
+}
+
+template <typename T>
+template <typename U>
+typename std::enable_if<std::is_same<decltype(std::declval<U>() + std::declval<U>()), U>::value, U>::type ChFrontVector<T>::sum() const
+{
+    if constexpr (ChVectorKernels::HasKernels<U>::value && std::is_same<U, T>::value)
+    {
+        return ChVectorKernels::sum(data(), size_);
+    }
+
+    U result = U();
+    for (const U &value : *this)
+    {
+        result += value;
+    }
+    return result;
+}
+
+template <typename T>
+template <typename U>
+typename std::enable_if<std::is_floating_point<U>::value, U>::type ChFrontVector<T>::average() const
+{
+    if (size_ == 0)
+    {
+        return U();
+    }
+    return sum<U>() / size_;
+}
+
+template <typename T>
+T ChFrontVector<T>::minimum() const
+{
+    size_t index = argMin();
+    return index == size_ ? T() : data()[index];
+}
+
+template <typename T>
+T ChFrontVector<T>::maximum() const
+{
+    size_t index = argMax();
+    return index == size_ ? T() : data()[index];
+}
+
+template <typename T>
+size_t ChFrontVector<T>::argMin() const
+{
+    if constexpr (ChVectorKernels::HasKernels<T>::value)
+    {
+        return ChVectorKernels::argMin(data(), size_);
+    }
+    else
+    {
+        return std::min_element(begin(), end()) - begin();
+    }
+}
+
+template <typename T>
+size_t ChFrontVector<T>::argMax() const
+{
+    if constexpr (ChVectorKernels::HasKernels<T>::value)
+    {
+        return ChVectorKernels::argMax(data(), size_);
+    }
+    else
+    {
+        return std::max_element(begin(), end()) - begin();
+    }
+}
+
+template <typename T>
+T ChFrontVector<T>::dot(const ChFrontVector &other) const
+{
+    if (size_ != other.size_)
+    {
+        throw std::out_of_range("Vectors must have the same size for dot");
+    }
+
+    if constexpr (ChVectorKernels::HasKernels<T>::value)
+    {
+        return ChVectorKernels::dot(data(), other.data(), size_);
+    }
+    else
+    {
+        T result = T();
+        for (size_t i = 0; i < size_; ++i)
+        {
+            result += data()[i] * other.data()[i];
+        }
+        return result;
+    }
+}
+
+template <typename T>
+void ChFrontVector<T>::sort()
+{
+    std::sort(begin(), end());
+}
+
+template <typename T>
+void ChFrontVector<T>::unique()
+{
+    erase(std::unique(begin(), end()), end());
+}
+
+template <typename T>
+void ChFrontVector<T>::removeDuplicates()
+{
+    erase(begin() + ChVectorAlgorithms::removeDuplicates(data(), size_), end());
+}
+
+template <typename T>
+void ChFrontVector<T>::removeDuplicatesSorted()
+{
+    erase(begin() + ChVectorAlgorithms::sortUnique(data(), size_), end());
+}
+
+template <typename T>
+template <typename Fn>
+ChFrontVector<typename std::result_of<Fn(T)>::type> ChFrontVector<T>::map(Fn func) const
+{
+    ChFrontVector<typename std::result_of<Fn(T)>::type> result;
+    result.reserve(size_);
+    for (const T &value : *this)
+    {
+        result.push_back(func(value));
+    }
+    return result;
+}
+
+template <typename T>
+ChSpanView<T> ChFrontVector<T>::view() const
+{
+    return ChSpanView<T>(data(), data() + size_);
+}
+
+template <typename T>
+void ChFrontVector<T>::prepend(const std::initializer_list<T> &values)
+{
+    insert(begin(), values);
+}
+
+template <typename T>
+void ChFrontVector<T>::prepend(const ChFrontVector &other)
+{
+    if (&other == this)
+    {
+        // Making room first keeps the source iterators valid
+        reserveFront(other.size_);
+    }
+    insert(begin(), other.begin(), other.end());
+}
+
+template <typename T>
+typename ChFrontVector<T>::iterator ChFrontVector<T>::begin() noexcept
+{
+    return buffer_ + head_;
+}
+
+template <typename T>
+typename ChFrontVector<T>::const_iterator ChFrontVector<T>::begin() const noexcept
+{
+    return buffer_ + head_;
+}
+
+template <typename T>
+typename ChFrontVector<T>::iterator ChFrontVector<T>::end() noexcept
+{
+    return buffer_ + head_ + size_;
+}
+
+template <typename T>
+typename ChFrontVector<T>::const_iterator ChFrontVector<T>::end() const noexcept
+{
+    return buffer_ + head_ + size_;
+}
+
+template <typename T>
+typename ChFrontVector<T>::reverse_iterator ChFrontVector<T>::rbegin() noexcept
+{
+    return reverse_iterator(end());
+}
+
+template <typename T>
+typename ChFrontVector<T>::const_reverse_iterator ChFrontVector<T>::rbegin() const noexcept
+{
+    return const_reverse_iterator(end());
+}
+
+template <typename T>
+typename ChFrontVector<T>::reverse_iterator ChFrontVector<T>::rend() noexcept
+{
+    return reverse_iterator(begin());
+}
+
+template <typename T>
+typename ChFrontVector<T>::const_reverse_iterator ChFrontVector<T>::rend() const noexcept
+{
+    return const_reverse_iterator(begin());
+}
+
+template <typename T>
+typename ChFrontVector<T>::const_iterator ChFrontVector<T>::cbegin() const noexcept
+{
+    return begin();
+}
+
+template <typename T>
+typename ChFrontVector<T>::const_iterator ChFrontVector<T>::cend() const noexcept
+{
+    return end();
+}
+
+template <typename T>
+typename ChFrontVector<T>::const_reverse_iterator ChFrontVector<T>::crbegin() const noexcept
+{
+    return rbegin();
+}
+
+template <typename T>
+typename ChFrontVector<T>::const_reverse_iterator ChFrontVector<T>::crend() const noexcept
+{
+    return rend();
+}
+
+template <typename T>
+size_t ChFrontVector<T>::size() const noexcept
+{
+    return size_;
+}
+
+template <typename T>
+size_t ChFrontVector<T>::max_size() const noexcept
+{
+    return std::allocator_traits<std::allocator<T>>::max_size(std::allocator<T>());
+}
+
+template <typename T>
+void ChFrontVector<T>::resize(size_t n)
+{
+    if (n <= size_)
+    {
+        erase(begin() + n, end());
+        return;
+    }
+    makeRoomAtBack(n - size_);
+    std::uninitialized_value_construct(end(), begin() + n);
+    size_ = n;
+}
+
+template <typename T>
+void ChFrontVector<T>::resize(size_t n, const T &val)
+{
+    if (n <= size_)
+    {
+        erase(begin() + n, end());
+        return;
+    }
+    if (backCapacity() < n - size_)
+    {
+        // `val` may be an element that is about to move
+        T copy(val);
+        makeRoomAtBack(n - size_);
+        std::uninitialized_fill(end(), begin() + n, copy);
+    }
+    else
+    {
+        std::uninitialized_fill(end(), begin() + n, val);
+    }
+    size_ = n;
+}
+
+template <typename T>
+size_t ChFrontVector<T>::capacity() const noexcept
+{
+    return capacity_;
+}
+
+template <typename T>
+size_t ChFrontVector<T>::frontCapacity() const noexcept
+{
+    return head_;
+}
+
+template <typename T>
+size_t ChFrontVector<T>::backCapacity() const noexcept
+{
+    return capacity_ - head_ - size_;
+}
+
+template <typename T>
+bool ChFrontVector<T>::isEmpty() const noexcept
+{
+    return size_ == 0;
+}
+
+template <typename T>
+void ChFrontVector<T>::reserve(size_t n)
+{
+    if (n > capacity_ - head_)
+    {
+        reallocate(head_ + n, head_);
+    }
+}
+
+template <typename T>
+void ChFrontVector<T>::reserveFront(size_t count)
+{
+    if (count > head_)
+    {
+        reallocate(capacity_ - head_ + count, count);
+    }
+}
+
+template <typename T>
+void ChFrontVector<T>::shrink()
+{
+    if (size_ == 0)
+    {
+        reset();
+    }
+    else if (capacity_ != size_)
+    {
+        reallocate(size_, 0);
+    }
+}
+
+template <typename T>
+T &ChFrontVector<T>::operator[](size_t index)
+{
+    return data()[index];
+}
+
+template <typename T>
+const T &ChFrontVector<T>::operator[](size_t index) const
+{
+    return data()[index];
+}
+
+template <typename T>
+T &ChFrontVector<T>::at(size_t index)
+{
+    if (index >= size_)
+    {
+        throw std::out_of_range("ChFrontVector index out of range");
+    }
+    return data()[index];
+}
+
+template <typename T>
+const T &ChFrontVector<T>::at(size_t index) const
+{
+    if (index >= size_)
+    {
+        throw std::out_of_range("ChFrontVector index out of range");
+    }
+    return data()[index];
+}
+
+template <typename T>
+T &ChFrontVector<T>::front()
+{
+    return data()[0];
+}
+
+template <typename T>
+const T &ChFrontVector<T>::front() const
+{
+    return data()[0];
+}
+
+template <typename T>
+T &ChFrontVector<T>::back()
+{
+    return data()[size_ - 1];
+}
+
+template <typename T>
+const T &ChFrontVector<T>::back() const
+{
+    return data()[size_ - 1];
+}
+
+template <typename T>
+T *ChFrontVector<T>::data() noexcept
+{
+    return buffer_ + head_;
+}
+
+template <typename T>
+const T *ChFrontVector<T>::data() const noexcept
+{
+    return buffer_ + head_;
+}
+
+template <typename T>
+void ChFrontVector<T>::assign(size_t count, const T &value)
+{
+    // `value` may be one of the elements that are about to be destroyed
+    T copy(value);
+    clear();
+    resize(count, copy);
+}
+
+template <typename T>
+template <typename InputIt, typename>
+void ChFrontVector<T>::assign(InputIt first, InputIt last)
+{
+    clear();
+    insert(end(), first, last);
+}
+
+template <typename T>
+void ChFrontVector<T>::assign(std::initializer_list<T> ilist)
+{
+    assign(ilist.begin(), ilist.end());
+}
+
+template <typename T>
+void ChFrontVector<T>::push_back(const T &val)
+{
+    emplace_back(val);
+}
+
+template <typename T>
+void ChFrontVector<T>::push_back(T &&val)
+{
+    emplace_back(std::move(val));
+}
+
+template <typename T>
+void ChFrontVector<T>::pop_back()
+{
+    --size_;
+    buffer_[head_ + size_].~T();
+}
+
+template <typename T>
+void ChFrontVector<T>::push_front(const T &val)
+{
+    emplace_front(val);
+}
+
+template <typename T>
+void ChFrontVector<T>::push_front(T &&val)
+{
+    emplace_front(std::move(val));
+}
+
+template <typename T>
+void ChFrontVector<T>::pop_front()
+{
+    buffer_[head_].~T();
+    ++head_;
+    --size_;
+}
+
+template <typename T>
+typename ChFrontVector<T>::iterator ChFrontVector<T>::insert(const_iterator pos, const T &value)
+{
+    return emplace(pos, value);
+}
+
+template <typename T>
+typename ChFrontVector<T>::iterator ChFrontVector<T>::insert(const_iterator pos, T &&value)
+{
+    return emplace(pos, std::move(value));
+}
+
+template <typename T>
+typename ChFrontVector<T>::iterator ChFrontVector<T>::insert(const_iterator pos, size_t count, const T &value)
+{
+    const size_t index = pos - begin();
+    if (count == 0)
+    {
+        return begin() + index;
+    }
+
+    // `value` may be an element that is about to move
+    T copy(value);
+    if (index <= size_ / 2)
+    {
+        makeRoomAtFront(count);
+        std::uninitialized_fill(begin() - count, begin(), copy);
+        head_ -= count;
+        size_ += count;
+        std::rotate(begin(), begin() + count, begin() + count + index);
+    }
+    else
+    {
+        const size_t oldSize = size_;
+        makeRoomAtBack(count);
+        std::uninitialized_fill(end(), end() + count, copy);
+        size_ += count;
+        std::rotate(begin() + index, begin() + oldSize, end());
+    }
+    return begin() + index;
+}
+
+template <typename T>
+template <typename InputIt, typename>
+typename ChFrontVector<T>::iterator ChFrontVector<T>::insert(const_iterator pos, InputIt first, InputIt last)
+{
+    // The new elements are added at the end closer to `pos` and then rotated into place
+    const size_t index = pos - begin();
+    using Category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (std::is_base_of<std::forward_iterator_tag, Category>::value)
+    {
+        const size_t count = static_cast<size_t>(std::distance(first, last));
+        if (index <= size_ / 2)
+        {
+            makeRoomAtFront(count);
+            std::uninitialized_copy(first, last, begin() - count);
+            head_ -= count;
+            size_ += count;
+            std::rotate(begin(), begin() + count, begin() + count + index);
+            return begin() + index;
+        }
+        makeRoomAtBack(count);
+    }
+
+    const size_t oldSize = size_;
+    for (; first != last; ++first)
+    {
+        emplace_back(*first);
+    }
+    std::rotate(begin() + index, begin() + oldSize, end());
+    return begin() + index;
+}
+
+template <typename T>
+typename ChFrontVector<T>::iterator ChFrontVector<T>::insert(const_iterator pos, std::initializer_list<T> ilist)
+{
+    return insert(pos, ilist.begin(), ilist.end());
+}
+
+template <typename T>
+typename ChFrontVector<T>::iterator ChFrontVector<T>::erase(const_iterator pos)
+{
+    return erase(pos, pos + 1);
+}
+
+template <typename T>
+typename ChFrontVector<T>::iterator ChFrontVector<T>::erase(const_iterator first, const_iterator last)
+{
+    const size_t index = first - begin();
+    const size_t count = last - first;
+    if (count == 0)
+    {
+        return begin() + index;
+    }
+
+    if (index < size_ - index - count)
+    {
+        // Fewer elements precede the range than follow it, so the front part closes the gap
+        std::move_backward(begin(), begin() + index, begin() + index + count);
+        std::destroy(begin(), begin() + count);
+        head_ += count;
+    }
+    else
+    {
+        std::destroy(std::move(begin() + index + count, end(), begin() + index), end());
+    }
+    size_ -= count;
+    return begin() + index;
+}
+
+template <typename T>
+void ChFrontVector<T>::swap(ChFrontVector &other) noexcept
+{
+    std::swap(buffer_, other.buffer_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(head_, other.head_);
+    std::swap(size_, other.size_);
+}
+
+template <typename T>
+void ChFrontVector<T>::clear() noexcept
+{
+    std::destroy(begin(), end());
+    size_ = 0;
+    head_ = 0;
+}
+
+template <typename T>
+template <typename... Args>
+T &ChFrontVector<T>::emplace_back(Args &&...args)
+{
+    if (head_ + size_ == capacity_)
+    {
+        // `args` may refer to an element, so the value is built before the elements move
+        T value(std::forward<Args>(args)...);
+        makeRoomAtBack(1);
+        ::new (static_cast<void *>(end())) T(std::move(value));
+    }
+    else
+    {
+        ::new (static_cast<void *>(end())) T(std::forward<Args>(args)...);
+    }
+    ++size_;
+    return back();
+}
+
+template <typename T>
+template <typename... Args>
+T &ChFrontVector<T>::emplace_front(Args &&...args)
+{
+    if (head_ == 0)
+    {
+        // `args` may refer to an element, so the value is built before the elements move
+        T value(std::forward<Args>(args)...);
+        makeRoomAtFront(1);
+        ::new (static_cast<void *>(begin() - 1)) T(std::move(value));
+    }
+    else
+    {
+        ::new (static_cast<void *>(begin() - 1)) T(std::forward<Args>(args)...);
+    }
+    --head_;
+    ++size_;
+    return front();
+}
+
+template <typename T>
+template <typename... Args>
+typename ChFrontVector<T>::iterator ChFrontVector<T>::emplace(const_iterator pos, Args &&...args)
+{
+    const size_t index = pos - begin();
+    if (index < size_ - index)
+    {
+        emplace_front(std::forward<Args>(args)...);
+        std::rotate(begin(), begin() + 1, begin() + 1 + index);
+    }
+    else
+    {
+        emplace_back(std::forward<Args>(args)...);
+        std::rotate(begin() + index, end() - 1, end());
+    }
+    return begin() + index;
+}
+
+template <typename T>
+void ChFrontVector<T>::makeRoomAtFront(size_t count)
+{
+    if (head_ >= count)
+    {
+        return;
+    }
+
+    // With at least half of the buffer free, moving the elements back is cheaper than growing. Either way the front
+    // gains room in proportion to the size, which keeps prepending amortized O(1).
+    const size_t needed = size_ + count;
+    if (std::is_nothrow_move_constructible<T>::value && capacity_ >= 2 * needed)
+    {
+        shift(count + (capacity_ - needed) / 2);
+        return;
+    }
+    const size_t newCapacity = grownCapacity(needed);
+    reallocate(newCapacity, newCapacity - backCapacity() - size_);
+}
+
+template <typename T>
+void ChFrontVector<T>::makeRoomAtBack(size_t count)
+{
+    if (backCapacity() >= count)
+    {
+        return;
+    }
+
+    const size_t needed = size_ + count;
+    if (std::is_nothrow_move_constructible<T>::value && capacity_ >= 2 * needed)
+    {
+        shift((capacity_ - needed) / 2);
+        return;
+    }
+    reallocate(grownCapacity(needed), head_);
+}
+
+template <typename T>
+void ChFrontVector<T>::reallocate(size_t newCapacity, size_t newHead)
+{
+    T *target = std::allocator<T>().allocate(newCapacity);
+    try
+    {
+        ChVectorAlgorithms::relocate(begin(), size_, target + newHead);
+    }
+    catch (...)
+    {
+        std::allocator<T>().deallocate(target, newCapacity);
+        throw;
+    }
+
+    std::destroy(begin(), end());
+    if (buffer_ != nullptr)
+    {
+        std::allocator<T>().deallocate(buffer_, capacity_);
+    }
+    buffer_ = target;
+    capacity_ = newCapacity;
+    head_ = newHead;
+}
+
+template <typename T>
+void ChFrontVector<T>::shift(size_t newHead)
+{
+    // Each element is moved and destroyed before the element whose slot it takes over, so the ranges may overlap
+    T *source = buffer_ + head_;
+    T *target = buffer_ + newHead;
+    if (newHead < head_)
+    {
+        for (size_t i = 0; i < size_; ++i)
+        {
+            ::new (static_cast<void *>(target + i)) T(std::move(source[i]));
+            source[i].~T();
+        }
+    }
+    else
+    {
+        for (size_t i = size_; i-- > 0;)
+        {
+            ::new (static_cast<void *>(target + i)) T(std::move(source[i]));
+            source[i].~T();
+        }
+    }
+    head_ = newHead;
+}
+
+template <typename T>
+size_t ChFrontVector<T>::grownCapacity(size_t needed) const
+{
+    if (needed > max_size() / 2)
+    {
+        if (needed > max_size())
+        {
+            throw std::length_error("ChFrontVector exceeds its maximum size");
+        }
+        return needed;
+    }
+    return std::max<size_t>({capacity_ * 2, needed * 2, 8});
+}
+
+template <typename T>
+void ChFrontVector<T>::reset() noexcept
+{
+    clear();
+    if (buffer_ != nullptr)
+    {
+        std::allocator<T>().deallocate(buffer_, capacity_);
+    }
+    buffer_ = nullptr;
+    capacity_ = 0;
+}
\ No newline at end of file
@@ -0,0 +1,753 @@
+#include "ChSmallVector.h"
+#include "ChVectorAlgorithms.h"
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+template <typename T, size_t N>
+ChSmallVector<T, N>::ChSmallVector() : data_(inlineData()), size_(0), capacity_(N) {}
+
+template <typename T, size_t N>
+ChSmallVector<T, N>::ChSmallVector(std::initializer_list<T> values) : ChSmallVector()
+{
+    assign(values.begin(), values.end());
+}
+
+template <typename T, size_t N>
+ChSmallVector<T, N>::ChSmallVector(const ChSmallVector &other) : ChSmallVector()
+{
+    assign(other.begin(), other.end());
+}
+
+template <typename T, size_t N>
+ChSmallVector<T, N>::ChSmallVector(ChSmallVector &&other) noexcept(std::is_nothrow_move_constructible<T>::value) : ChSmallVector()
+{
+    takeFrom(other);
+}
+
+template <typename T, size_t N>
+ChSmallVector<T, N>::~ChSmallVector()
+{
+    reset();
+}
+
+template <typename T, size_t N>
+ChSmallVector<T, N> &ChSmallVector<T, N>::operator=(const ChSmallVector &other)
+{
+    if (this != &other)
+    {
+        assign(other.begin(), other.end());
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+ChSmallVector<T, N> &ChSmallVector<T, N>::operator=(ChSmallVector &&other) noexcept(std::is_nothrow_move_constructible<T>::value)
+{
+    if (this != &other)
+    {
+        reset();
+        takeFrom(other);
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+bool ChSmallVector<T, N>::contains(const T &value) const
+{
+    return ChVectorAlgorithms::indexOf(data_, size_, value) != size_;
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::remove(const T &value)
+{
+    erase(std::remove(begin(), end(), value), end());
+}
+
+template <typename T, size_t N>
+size_t ChSmallVector<T, N>::count(const T &value) const
+{
+    return ChVectorAlgorithms::count(data_, size_, value);
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::iterator ChSmallVector<T, N>::find(const T &value)
+{
+    return data_ + ChVectorAlgorithms::indexOf(data_, size_, value);
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::const_iterator ChSmallVector<T, N>::find(const T &value) const
+{
+    return data_ + ChVectorAlgorithms::indexOf(data_, size_, value);
+}
+
+template <typename T, size_t N>
+int ChSmallVector<T, N>::indexOf(const T &element) const
+{
+    size_t index = ChVectorAlgorithms::indexOf(data_, size_, element);
+    return index == size_ ? -1 : static_cast<int>(index);
+}
+
+template <typename T, size_t N>
+int ChSmallVector<T, N>::lastIndexOf(const T &element) const
+{
+    if constexpr (ChVectorKernels::HasKernels<T>::value)
+    {
+        size_t index = ChVectorKernels::lastIndexOf(data_, size_, element);
+        return index == size_ ? -1 : static_cast<int>(index);
+    }
+
+    auto it = std::find(rbegin(), rend(), element);
+    if (it == rend())
+    {
+        return -1;
+    }
+    return static_cast<int>(std::distance(it, rend()) - 1);
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::reverse()
+{
+    std::reverse(begin(), end());
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::shuffle(unsigned int seed)
+{
+    std::shuffle(begin(), end(), std::default_random_engine(seed));
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::concat(const ChSmallVector &other)
+{
+    if (&other == this)
+    {
+        // Making room first keeps the source iterators valid
+        reserve(2 * size_);
+    }
+    insert(end(), other.begin(), other.end());
+}
+
+template <typename T, size_t N>
+template <typename U>
+typename std::enable_if<std::is_same<decltype(std::declval<U>() + std::declval<U>()), U>::value, U>::type ChSmallVector<T, N>::sum() const
+{
+    if constexpr (ChVectorKernels::HasKernels<U>::value && std::is_same<U, T>::value)
+    {
+        return ChVectorKernels::sum(data_, size_);
+    }
+
+    U result = U();
+    for (const U &value : *this)
+    {
+        result += value;
+    }
+    return result;
+}
+
+template <typename T, size_t N>
+template <typename U>
+typename std::enable_if<std::is_floating_point<U>::value, U>::type ChSmallVector<T, N>::average() const
+{
+    if (size_ == 0)
+    {
+        return U();
+    }
+    return sum<U>() / size_;
+}
+
+template <typename T, size_t N>
+T ChSmallVector<T, N>::minimum() const
+{
+    size_t index = argMin();
+    return index == size_ ? T() : data_[index];
+}
+
+template <typename T, size_t N>
+T ChSmallVector<T, N>::maximum() const
+{
+    size_t index = argMax();
+    return index == size_ ? T() : data_[index];
+}
+
+template <typename T, size_t N>
+size_t ChSmallVector<T, N>::argMin() const
+{
+    if constexpr (ChVectorKernels::HasKernels<T>::value)
+    {
+        return ChVectorKernels::argMin(data_, size_);
+    }
+    else
+    {
+        return std::min_element(begin(), end()) - begin();
+    }
+}
+
+template <typename T, size_t N>
+size_t ChSmallVector<T, N>::argMax() const
+{
+    if constexpr (ChVectorKernels::HasKernels<T>::value)
+    {
+        return ChVectorKernels::argMax(data_, size_);
+    }
+    else
+    {
+        return std::max_element(begin(), end()) - begin();
+    }
+}
+
+template <typename T, size_t N>
+T ChSmallVector<T, N>::dot(const ChSmallVector &other) const
+{
+    if (size_ != other.size_)
+    {
+        throw std::out_of_range("Vectors must have the same size for dot");
+    }
+
+    if constexpr (ChVectorKernels::HasKernels<T>::value)
+    {
+        return ChVectorKernels::dot(data_, other.data_, size_);
+    }
+    else
+    {
+        T result = T();
+        for (size_t i = 0; i < size_; ++i)
+        {
+            result += data_[i] * other.data_[i];
+        }
+        return result;
+    }
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::sort()
+{
+    std::sort(begin(), end());
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::unique()
+{
+    erase(std::unique(begin(), end()), end());
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::removeDuplicates()
+{
+    erase(begin() + ChVectorAlgorithms::removeDuplicates(data_, size_), end());
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::removeDuplicatesSorted()
+{
+    erase(begin() + ChVectorAlgorithms::sortUnique(data_, size_), end());
+}
+
+template <typename T, size_t N>
+template <typename Fn>
+ChSmallVector<typename std::result_of<Fn(T)>::type, N> ChSmallVector<T, N>::map(Fn func) const
+{
+    ChSmallVector<typename std::result_of<Fn(T)>::type, N> result;
+    result.reserve(size_);
+    for (const T &value : *this)
+    {
+        result.push_back(func(value));
+    }
+    return result;
+}
+
+template <typename T, size_t N>
+ChSpanView<T> ChSmallVector<T, N>::view() const
+{
+    return ChSpanView<T>(data_, data_ + size_);
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::prepend(const std::initializer_list<T> &values)
+{
+    insert(begin(), values);
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::iterator ChSmallVector<T, N>::begin() noexcept
+{
+    return data_;
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::const_iterator ChSmallVector<T, N>::begin() const noexcept
+{
+    return data_;
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::iterator ChSmallVector<T, N>::end() noexcept
+{
+    return data_ + size_;
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::const_iterator ChSmallVector<T, N>::end() const noexcept
+{
+    return data_ + size_;
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::reverse_iterator ChSmallVector<T, N>::rbegin() noexcept
+{
+    return reverse_iterator(end());
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::const_reverse_iterator ChSmallVector<T, N>::rbegin() const noexcept
+{
+    return const_reverse_iterator(end());
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::reverse_iterator ChSmallVector<T, N>::rend() noexcept
+{
+    return reverse_iterator(begin());
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::const_reverse_iterator ChSmallVector<T, N>::rend() const noexcept
+{
+    return const_reverse_iterator(begin());
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::const_iterator ChSmallVector<T, N>::cbegin() const noexcept
+{
+    return begin();
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::const_iterator ChSmallVector<T, N>::cend() const noexcept
+{
+    return end();
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::const_reverse_iterator ChSmallVector<T, N>::crbegin() const noexcept
+{
+    return rbegin();
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::const_reverse_iterator ChSmallVector<T, N>::crend() const noexcept
+{
+    return rend();
+}
+
+template <typename T, size_t N>
+size_t ChSmallVector<T, N>::size() const noexcept
+{
+    return size_;
+}
+
+template <typename T, size_t N>
+size_t ChSmallVector<T, N>::max_size() const noexcept
+{
+    return std::allocator_traits<std::allocator<T>>::max_size(std::allocator<T>());
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::resize(size_t n)
+{
+    if (n <= size_)
+    {
+        erase(begin() + n, end());
+        return;
+    }
+    if (n > capacity_)
+    {
+        reallocate(grownCapacity(n));
+    }
+    std::uninitialized_value_construct(data_ + size_, data_ + n);
+    size_ = n;
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::resize(size_t n, const T &val)
+{
+    if (n <= size_)
+    {
+        erase(begin() + n, end());
+        return;
+    }
+    if (n > capacity_)
+    {
+        // `val` may be an element that the reallocation moves away
+        T copy(val);
+        reallocate(grownCapacity(n));
+        std::uninitialized_fill(data_ + size_, data_ + n, copy);
+    }
+    else
+    {
+        std::uninitialized_fill(data_ + size_, data_ + n, val);
+    }
+    size_ = n;
+}
+
+template <typename T, size_t N>
+size_t ChSmallVector<T, N>::capacity() const noexcept
+{
+    return capacity_;
+}
+
+template <typename T, size_t N>
+bool ChSmallVector<T, N>::isEmpty() const noexcept
+{
+    return size_ == 0;
+}
+
+template <typename T, size_t N>
+bool ChSmallVector<T, N>::isInline() const noexcept
+{
+    return data_ == reinterpret_cast<const T *>(inline_);
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::reserve(size_t n)
+{
+    if (n > capacity_)
+    {
+        reallocate(n);
+    }
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::shrink()
+{
+    if (!isInline() && size_ < capacity_)
+    {
+        reallocate(std::max(size_, N));
+    }
+}
+
+template <typename T, size_t N>
+T &ChSmallVector<T, N>::operator[](size_t index)
+{
+    return data_[index];
+}
+
+template <typename T, size_t N>
+const T &ChSmallVector<T, N>::operator[](size_t index) const
+{
+    return data_[index];
+}
+
+template <typename T, size_t N>
+T &ChSmallVector<T, N>::at(size_t index)
+{
+    if (index >= size_)
+    {
+        throw std::out_of_range("ChSmallVector index out of range");
+    }
+    return data_[index];
+}
+
+template <typename T, size_t N>
+const T &ChSmallVector<T, N>::at(size_t index) const
+{
+    if (index >= size_)
+    {
+        throw std::out_of_range("ChSmallVector index out of range");
+    }
+    return data_[index];
+}
+
+template <typename T, size_t N>
+T &ChSmallVector<T, N>::front()
+{
+    return data_[0];
+}
+
+template <typename T, size_t N>
+const T &ChSmallVector<T, N>::front() const
+{
+    return data_[0];
+}
+
+template <typename T, size_t N>
+T &ChSmallVector<T, N>::back()
+{
+    return data_[size_ - 1];
+}
+
+template <typename T, size_t N>
+const T &ChSmallVector<T, N>::back() const
+{
+    return data_[size_ - 1];
+}
+
+template <typename T, size_t N>
+T *ChSmallVector<T, N>::data() noexcept
+{
+    return data_;
+}
+
+template <typename T, size_t N>
+const T *ChSmallVector<T, N>::data() const noexcept
+{
+    return data_;
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::assign(size_t count, const T &value)
+{
+    // `value` may be one of the elements that are about to be destroyed
+    T copy(value);
+    clear();
+    resize(count, copy);
+}
+
+template <typename T, size_t N>
+template <typename InputIt, typename>
+void ChSmallVector<T, N>::assign(InputIt first, InputIt last)
+{
+    clear();
+    insert(end(), first, last);
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::assign(std::initializer_list<T> ilist)
+{
+    assign(ilist.begin(), ilist.end());
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::push_back(const T &val)
+{
+    emplace_back(val);
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::push_back(T &&val)
+{
+    emplace_back(std::move(val));
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::pop_back()
+{
+    --size_;
+    data_[size_].~T();
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::iterator ChSmallVector<T, N>::insert(const_iterator pos, const T &value)
+{
+    return emplace(pos, value);
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::iterator ChSmallVector<T, N>::insert(const_iterator pos, T &&value)
+{
+    return emplace(pos, std::move(value));
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::iterator ChSmallVector<T, N>::insert(const_iterator pos, size_t count, const T &value)
+{
+    const size_t index = pos - data_;
+    const size_t oldSize = size_;
+    resize(size_ + count, value);
+    std::rotate(data_ + index, data_ + oldSize, data_ + size_);
+    return data_ + index;
+}
+
+template <typename T, size_t N>
+template <typename InputIt, typename>
+typename ChSmallVector<T, N>::iterator ChSmallVector<T, N>::insert(const_iterator pos, InputIt first, InputIt last)
+{
+    // The new elements are appended and then rotated into place, which also keeps `pos` meaningful across a
+    // reallocation
+    const size_t index = pos - data_;
+    const size_t oldSize = size_;
+    using Category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (std::is_base_of<std::forward_iterator_tag, Category>::value)
+    {
+        const size_t needed = size_ + static_cast<size_t>(std::distance(first, last));
+        if (needed > capacity_)
+        {
+            reallocate(grownCapacity(needed));
+        }
+    }
+    for (; first != last; ++first)
+    {
+        emplace_back(*first);
+    }
+    std::rotate(data_ + index, data_ + oldSize, data_ + size_);
+    return data_ + index;
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::iterator ChSmallVector<T, N>::insert(const_iterator pos, std::initializer_list<T> ilist)
+{
+    return insert(pos, ilist.begin(), ilist.end());
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::iterator ChSmallVector<T, N>::erase(const_iterator pos)
+{
+    return erase(pos, pos + 1);
+}
+
+template <typename T, size_t N>
+typename ChSmallVector<T, N>::iterator ChSmallVector<T, N>::erase(const_iterator first, const_iterator last)
+{
+    iterator target = data_ + (first - data_);
+    if (first != last)
+    {
+        iterator newEnd = std::move(data_ + (last - data_), end(), target);
+        std::destroy(newEnd, end());
+        size_ = newEnd - data_;
+    }
+    return target;
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::swap(ChSmallVector &other) noexcept(std::is_nothrow_move_constructible<T>::value)
+{
+    ChSmallVector temporary(std::move(other));
+    other = std::move(*this);
+    *this = std::move(temporary);
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::clear() noexcept
+{
+    std::destroy(data_, data_ + size_);
+    size_ = 0;
+}
+
+template <typename T, size_t N>
+template <typename... Args>
+T &ChSmallVector<T, N>::emplace_back(Args &&...args)
+{
+    if (size_ < capacity_)
+    {
+        ::new (static_cast<void *>(data_ + size_)) T(std::forward<Args>(args)...);
+        ++size_;
+        return back();
+    }
+
+    // The new element is constructed before the old ones move, because `args` may refer to one of them
+    const size_t newCapacity = grownCapacity(size_ + 1);
+    T *target = std::allocator<T>().allocate(newCapacity);
+    try
+    {
+        ::new (static_cast<void *>(target + size_)) T(std::forward<Args>(args)...);
+        try
+        {
+            ChVectorAlgorithms::relocate(data_, size_, target);
+        }
+        catch (...)
+        {
+            target[size_].~T();
+            throw;
+        }
+    }
+    catch (...)
+    {
+        std::allocator<T>().deallocate(target, newCapacity);
+        throw;
+    }
+
+    std::destroy(data_, data_ + size_);
+    if (!isInline())
+    {
+        std::allocator<T>().deallocate(data_, capacity_);
+    }
+    data_ = target;
+    capacity_ = newCapacity;
+    ++size_;
+    return back();
+}
+
+template <typename T, size_t N>
+template <typename... Args>
+typename ChSmallVector<T, N>::iterator ChSmallVector<T, N>::emplace(const_iterator pos, Args &&...args)
+{
+    const size_t index = pos - data_;
+    emplace_back(std::forward<Args>(args)...);
+    std::rotate(data_ + index, data_ + size_ - 1, data_ + size_);
+    return data_ + index;
+}
+
+template <typename T, size_t N>
+T *ChSmallVector<T, N>::inlineData() noexcept
+{
+    return reinterpret_cast<T *>(inline_);
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::reallocate(size_t newCapacity)
+{
+    T *target = newCapacity == N ? inlineData() : std::allocator<T>().allocate(newCapacity);
+    try
+    {
+        ChVectorAlgorithms::relocate(data_, size_, target);
+    }
+    catch (...)
+    {
+        if (target != inlineData())
+        {
+            std::allocator<T>().deallocate(target, newCapacity);
+        }
+        throw;
+    }
+
+    std::destroy(data_, data_ + size_);
+    if (!isInline())
+    {
+        std::allocator<T>().deallocate(data_, capacity_);
+    }
+    data_ = target;
+    capacity_ = newCapacity;
+}
+
+template <typename T, size_t N>
+size_t ChSmallVector<T, N>::grownCapacity(size_t minCapacity) const
+{
+    if (minCapacity > max_size())
+    {
+        throw std::length_error("ChSmallVector exceeds its maximum size");
+    }
+    return std::max(minCapacity, std::min(capacity_ * 2, max_size()));
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::reset() noexcept
+{
+    clear();
+    if (!isInline())
+    {
+        std::allocator<T>().deallocate(data_, capacity_);
+        data_ = inlineData();
+        capacity_ = N;
+    }
+}
+
+template <typename T, size_t N>
+void ChSmallVector<T, N>::takeFrom(ChSmallVector &other) noexcept(std::is_nothrow_move_constructible<T>::value)
+{
+    if (!other.isInline())
+    {
+        data_ = other.data_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        other.data_ = other.inlineData();
+        other.size_ = 0;
+        other.capacity_ = N;
+        return;
+    }
+
+    std::uninitialized_move(other.data_, other.data_ + other.size_, data_);
+    size_ = other.size_;
+    other.clear();
+}
\ No newline at end of file
@@ -0,0 +1,532 @@
+#ifndef CHSMALLVECTOR
+#define CHSMALLVECTOR
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <random>
+#include <type_traits>
+#include <utility>
+
+#include "ChView.h"
+
+/**
+ * @brief A vector that stores up to N elements inside the object and only allocates when it grows beyond that.
+ *
+ * ChSmallVector offers the interface of ChVector, so it can replace a ChVector that usually holds a handful of
+ * elements. Such a vector costs no heap allocation at all, and its elements sit next to the object that owns it.
+ * Beyond N elements the elements move to the heap and the vector behaves like a ChVector; shrinking back to N
+ * elements or fewer and calling `shrink()` returns them inline.
+ *
+ * Unlike with ChVector, moving or swapping a vector whose elements are inline moves the elements one by one and
+ * invalidates iterators and references to them.
+ *
+ * @tparam T The type of the elements stored in the vector.
+ * @tparam N The number of elements stored inline.
+ */
+template <typename T, size_t N>
+class ChSmallVector
+{
+    static_assert(N > 0, "ChSmallVector needs room for at least one inline element");
+
+public:
+    using iterator = T *;
+    using const_iterator = const T *;
+    using reverse_iterator = std::reverse_iterator<T *>;
+    using const_reverse_iterator = std::reverse_iterator<const T *>;
+
+    /**
+     * @brief Default constructor. Constructs an empty vector without allocating.
+     */
+    ChSmallVector();
+
+    /**
+     * @brief Constructs the vector with the elements of `values`.
+     *
+     * @param values The elements to initialize the vector with.
+     */
+    ChSmallVector(std::initializer_list<T> values);
+
+    /**
+     * @brief Copy constructor. Constructs the vector with the copy of the contents of `other`.
+     *
+     * @param other Another ChSmallVector object to be used as source to initialize the elements of the vector with.
+     */
+    ChSmallVector(const ChSmallVector &other);
+
+    /**
+     * @brief Move constructor. Takes over the heap buffer of `other`, or moves its inline elements one by one.
+     *
+     * @param other Another ChSmallVector object to be used as source to initialize the elements of the vector with.
+     * `other` is left empty.
+     */
+    ChSmallVector(ChSmallVector &&other) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+    /**
+     * @brief Destructor. Destroys the elements and frees the heap buffer, if any.
+     */
+    ~ChSmallVector();
+
+    /**
+     * @brief Copy assignment operator. Replaces the contents of the vector with a copy of the contents of `other`.
+     *
+     * @param other Another ChSmallVector object to be used as source to copy the elements from.
+     * @return A reference to the vector object.
+     */
+    ChSmallVector &operator=(const ChSmallVector &other);
+
+    /**
+     * @brief Move assignment operator. Replaces the contents of the vector with the contents of `other`.
+     *
+     * @param other Another ChSmallVector object to be used as source to move the elements from. `other` is left empty.
+     * @return A reference to the vector object.
+     */
+    ChSmallVector &operator=(ChSmallVector &&other) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+    /**
+     * @brief Checks whether the vector contains an element with the given value.
+     *
+     * @param value The value to search for.
+     * @return `true` if the vector contains an element with the given value, `false` otherwise.
+     */
+    bool contains(const T &value) const;
+
+    /**
+     * @brief Removes all elements from the vector that have the given value.
+     *
+     * @param value The value to remove from the vector.
+     */
+    void remove(const T &value);
+
+    /**
+     * Count the number of occurrences of a value in the vector.
+     *
+     * @param value The value to count.
+     * @return The number of occurrences of the value in the vector.
+     */
+    size_t count(const T &value) const;
+
+    /**
+     * Find the first occurrence of a value in the vector.
+     *
+     * @param value The value to search for.
+     * @return An iterator to the first occurrence of the value in the vector, or end() if the value is not found.
+     */
+    iterator find(const T &value);
+
+    /**
+     * Find the first occurrence of a value in the vector (const version).
+     *
+     * @param value The value to search for.
+     * @return A const iterator to the first occurrence of the value in the vector, or end() if the value is not found.
+     */
+    const_iterator find(const T &value) const;
+
+    /**
+     * @brief Returns the index of the first occurrence of the specified element, or -1 if there is none.
+     *
+     * @param element The element to search for.
+     * @return The index of the first occurrence of the specified element, or -1.
+     */
+    int indexOf(const T &element) const;
+
+    /**
+     * @brief Returns the index of the last occurrence of the specified element, or -1 if there is none.
+     *
+     * @param element The element to search for.
+     * @return The index of the last occurrence of the specified element, or -1.
+     */
+    int lastIndexOf(const T &element) const;
+
+    /**
+     * @brief Reverse the order of elements in the vector.
+     */
+    void reverse();
+
+    /**
+     * @brief Shuffle the elements in the vector in a random order.
+     *
+     * @param seed The seed for the random number generator used by std::shuffle().
+     */
+    void shuffle(unsigned int seed = std::default_random_engine::default_seed);
+
+    /**
+     * @brief Appends copies of the elements of `other` to this vector.
+     *
+     * @param other The vector to concatenate with this one.
+     */
+    void concat(const ChSmallVector &other);
+
+    /**
+     * @brief Get the sum of all elements in the vector.
+     *
+     * @return The sum of all elements in the vector, or zero if the vector is empty.
+     */
+    template <typename U = T>
+    typename std::enable_if<std::is_same<decltype(std::declval<U>() + std::declval<U>()), U>::value, U>::type sum() const;
+
+    /**
+     * @brief Computes the average value of the elements in the vector.
+     *
+     * This function is enabled only if the element type is a floating-point type.
+     * @return The average value of the elements in the vector.
+     */
+    template <typename U = T>
+    typename std::enable_if<std::is_floating_point<U>::value, U>::type average() const;
+
+    /**
+     * @brief Returns the smallest element of the vector. NaN elements of float and double vectors are
+     * skipped by the vector kernels; other element types are only compared with `<`.
+     *
+     * @return The smallest element, or a value-initialized T if there is none.
+     */
+    T minimum() const;
+
+    /**
+     * @brief Returns the largest element of the vector. NaN elements of float and double vectors are
+     * skipped by the vector kernels; other element types are only compared with `<`.
+     *
+     * @return The largest element, or a value-initialized T if there is none.
+     */
+    T maximum() const;
+
+    /**
+     * @brief Returns the index of the first smallest element. NaN elements of float and double vectors are
+     * skipped by the vector kernels; other element types are only compared with `<`.
+     *
+     * @return The index of the element, or `size()` if there is none.
+     */
+    size_t argMin() const;
+
+    /**
+     * @brief Returns the index of the first largest element. NaN elements of float and double vectors are
+     * skipped by the vector kernels; other element types are only compared with `<`.
+     *
+     * @return The index of the element, or `size()` if there is none.
+     */
+    size_t argMax() const;
+
+    /**
+     * @brief Computes the dot product of this vector and `other`.
+     *
+     * @param other The vector to multiply element-wise with this one.
+     * @return The sum of the products of the corresponding elements.
+     * @throws std::out_of_range if the vectors are of different sizes
+     */
+    T dot(const ChSmallVector &other) const;
+
+    /**
+     * @brief Sorts the elements of the vector in ascending order.
+     */
+    void sort();
+
+    /**
+     * @brief Removes consecutive duplicate elements from the vector.
+     */
+    void unique();
+
+    /**
+     * @brief Removes duplicates from the vector, keeping the first occurrence of each value in place.
+     */
+    void removeDuplicates();
+
+    /**
+     * @brief Sorts the vector in ascending order and removes duplicates.
+     */
+    void removeDuplicatesSorted();
+
+    /**
+     * Applies the given function to each element of the vector and returns a new vector containing the results.
+     *
+     * @param func The function to apply to each element.
+     * @return A new vector with the same inline capacity containing the results of applying the function.
+     */
+    template <typename Fn>
+    ChSmallVector<typename std::result_of<Fn(T)>::type, N> map(Fn func) const;
+
+    /**
+     * @brief Returns a lazy view of the elements. See ChViewBase. The view is invalidated by any modification of the
+     * vector.
+     */
+    ChSpanView<T> view() const;
+
+    /**
+     * @brief Add elements to the front of the vector.
+     *
+     * @param values The elements to add to the front of the vector.
+     */
+    void prepend(const std::initializer_list<T> &values);
+
+    /**
+     * @brief Returns an iterator to the first element of the vector.
+     */
+    iterator begin() noexcept;
+    const_iterator begin() const noexcept;
+
+    /**
+     * @brief Returns an iterator to the element following the last element of the vector.
+     */
+    iterator end() noexcept;
+    const_iterator end() const noexcept;
+
+    /**
+     * @brief Returns a reverse iterator to the last element of the vector.
+     */
+    reverse_iterator rbegin() noexcept;
+    const_reverse_iterator rbegin() const noexcept;
+
+    /**
+     * @brief Returns a reverse iterator to the element preceding the first element of the vector.
+     */
+    reverse_iterator rend() noexcept;
+    const_reverse_iterator rend() const noexcept;
+
+    /**
+     * @brief Returns a const iterator to the first element of the vector.
+     */
+    const_iterator cbegin() const noexcept;
+
+    /**
+     * @brief Returns a const iterator to the element following the last element of the vector.
+     */
+    const_iterator cend() const noexcept;
+
+    /**
+     * @brief Returns a const reverse iterator to the last element of the vector.
+     */
+    const_reverse_iterator crbegin() const noexcept;
+
+    /**
+     * @brief Returns a const reverse iterator to the element preceding the first element of the vector.
+     */
+    const_reverse_iterator crend() const noexcept;
+
+    /**
+     * @brief Returns the number of elements in the vector.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Returns the maximum number of elements the vector can hold.
+     */
+    size_t max_size() const noexcept;
+
+    /**
+     * @brief Resizes the vector to contain `n` elements. New elements are value-initialized.
+     *
+     * @param n The new size of the vector.
+     */
+    void resize(size_t n);
+
+    /**
+     * @brief Resizes the vector to contain `n` elements. New elements are copies of `val`.
+     *
+     * @param n The new size of the vector.
+     * @param val The value to initialize new elements with.
+     */
+    void resize(size_t n, const T &val);
+
+    /**
+     * @brief Returns the number of elements the vector can hold without allocating, at least N.
+     */
+    size_t capacity() const noexcept;
+
+    /**
+     * @brief Checks whether the vector is empty.
+     */
+    bool isEmpty() const noexcept;
+
+    /**
+     * @brief Checks whether the elements are stored inside the object rather than on the heap.
+     */
+    bool isInline() const noexcept;
+
+    /**
+     * @brief Makes room for at least `n` elements. Moves the elements to the heap if `n` exceeds N.
+     *
+     * @param n The number of elements to make room for.
+     */
+    void reserve(size_t n);
+
+    /**
+     * @brief Releases unused capacity. Moves the elements back inline if they fit.
+     */
+    void shrink();
+
+    /**
+     * @brief Returns a reference to the element at `index`. No bounds checking is performed.
+     */
+    T &operator[](size_t index);
+    const T &operator[](size_t index) const;
+
+    /**
+     * @brief Returns a reference to the element at `index`.
+     *
+     * @throws std::out_of_range if `index` is not less than `size()`.
+     */
+    T &at(size_t index);
+    const T &at(size_t index) const;
+
+    /**
+     * @brief Returns a reference to the first element. The vector must not be empty.
+     */
+    T &front();
+    const T &front() const;
+
+    /**
+     * @brief Returns a reference to the last element. The vector must not be empty.
+     */
+    T &back();
+    const T &back() const;
+
+    /**
+     * @brief Returns a pointer to the elements.
+     */
+    T *data() noexcept;
+    const T *data() const noexcept;
+
+    /**
+     * @brief Replaces the contents with `count` copies of `value`.
+     */
+    void assign(size_t count, const T &value);
+
+    /**
+     * @brief Replaces the contents with copies of the elements in [first, last).
+     *
+     * @tparam InputIt Type of the input iterators. Only iterator types take part in overload resolution.
+     */
+    template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void assign(InputIt first, InputIt last);
+
+    /**
+     * @brief Replaces the contents with the elements of `ilist`.
+     */
+    void assign(std::initializer_list<T> ilist);
+
+    /**
+     * @brief Appends a copy of `val` to the end of the vector.
+     */
+    void push_back(const T &val);
+
+    /**
+     * @brief Moves `val` to the end of the vector.
+     */
+    void push_back(T &&val);
+
+    /**
+     * @brief Removes the last element. The vector must not be empty.
+     */
+    void pop_back();
+
+    /**
+     * @brief Inserts a copy of `value` before `pos`.
+     *
+     * @return Iterator pointing to the inserted element.
+     */
+    iterator insert(const_iterator pos, const T &value);
+
+    /**
+     * @brief Moves `value` into the vector before `pos`.
+     *
+     * @return Iterator pointing to the inserted element.
+     */
+    iterator insert(const_iterator pos, T &&value);
+
+    /**
+     * @brief Inserts `count` copies of `value` before `pos`.
+     *
+     * @return Iterator pointing to the first inserted element, or `pos` if `count` is zero.
+     */
+    iterator insert(const_iterator pos, size_t count, const T &value);
+
+    /**
+     * @brief Inserts copies of the elements in [first, last) before `pos`.
+     *
+     * @tparam InputIt The type of the iterator. Only iterator types take part in overload resolution.
+     * @return Iterator pointing to the first inserted element, or `pos` if the range is empty.
+     */
+    template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    iterator insert(const_iterator pos, InputIt first, InputIt last);
+
+    /**
+     * @brief Inserts the elements of `ilist` before `pos`.
+     *
+     * @return Iterator pointing to the first inserted element, or `pos` if `ilist` is empty.
+     */
+    iterator insert(const_iterator pos, std::initializer_list<T> ilist);
+
+    /**
+     * @brief Removes the element at `pos`.
+     *
+     * @return Iterator following the removed element.
+     */
+    iterator erase(const_iterator pos);
+
+    /**
+     * @brief Removes the elements in [first, last).
+     *
+     * @return Iterator following the last removed element.
+     */
+    iterator erase(const_iterator first, const_iterator last);
+
+    /**
+     * @brief Exchanges the contents of the vector with those of `other`.
+     */
+    void swap(ChSmallVector &other) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+    /**
+     * @brief Removes all elements. The capacity is kept.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Constructs an element in place at the end of the vector.
+     *
+     * @tparam Args Types of arguments to be passed to the constructor of the element.
+     * @return A reference to the new element.
+     */
+    template <typename... Args>
+    T &emplace_back(Args &&...args);
+
+    /**
+     * @brief Constructs an element in place before `pos`.
+     *
+     * @tparam Args Types of arguments to be passed to the constructor of the element.
+     * @return Iterator pointing to the new element.
+     */
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args &&...args);
+
+private:
+    /**
+     * @brief Returns the inline storage.
+     */
+    T *inlineData() noexcept;
+
+    /**
+     * @brief Moves the elements into a heap buffer of `newCapacity` elements, or back inline if that is N.
+     */
+    void reallocate(size_t newCapacity);
+
+    /**
+     * @brief Returns the capacity to grow to so that at least `minCapacity` elements fit.
+     */
+    size_t grownCapacity(size_t minCapacity) const;
+
+    /**
+     * @brief Destroys the elements and frees the heap buffer, if any, leaving the vector empty and inline.
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief Takes over the elements of `other`, which must be empty on this side, and leaves `other` empty.
+     */
+    void takeFrom(ChSmallVector &other) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+    T *data_;
+    size_t size_;
+    size_t capacity_;
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+};
+
+#endif
\ No newline at end of file
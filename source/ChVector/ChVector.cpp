@@ -1,77 +1,195 @@
 #include "ChVector.h"
+#include "ChVectorAlgorithms.h"
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
 
-template <typename T>
-ChVector<T>::ChVector() {}
+template <typename T, typename Allocator>
+ChVector<T, Allocator>::ChVector() {}
 
-template <typename T>
-ChVector<T>::ChVector(const ChVector &other) : data_(other.data_) {}
+template <typename T, typename Allocator>
+ChVector<T, Allocator>::ChVector(const Allocator &allocator) : data_(allocator) {}
 
-template <typename T>
-ChVector<T>::ChVector(ChVector &&other) noexcept : data_(std::move(other.data_)) {}
+template <typename T, typename Allocator>
+ChVector<T, Allocator>::ChVector(const ChVector &other) : data_(other.data_) {}
 
-template <typename T>
-ChVector<T>::~ChVector() {}
+template <typename T, typename Allocator>
+ChVector<T, Allocator>::ChVector(ChVector &&other) noexcept : data_(std::move(other.data_)) {}
 
-template <typename T>
-ChVector<T> &ChVector<T>::operator=(const ChVector &other)
+template <typename T, typename Allocator>
+ChVector<T, Allocator>::~ChVector() {}
+
+template <typename T, typename Allocator>
+ChVector<T, Allocator> &ChVector<T, Allocator>::operator=(const ChVector &other)
 {
     data_ = other.data_;
     return *this;
 }
 
-template <typename T>
-ChVector<T> &ChVector<T>::operator=(ChVector &&other) noexcept
+template <typename T, typename Allocator>
+ChVector<T, Allocator> &ChVector<T, Allocator>::operator=(ChVector &&other) noexcept(std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value || std::allocator_traits<Allocator>::is_always_equal::value)
 {
     data_ = std::move(other.data_);
     return *this;
 }
 
-template <typename T>
-ChVector<T>::operator std::vector<T> &()
+template <typename T, typename Allocator>
+ChVector<T, Allocator>::operator std::vector<T, Allocator> &()
 {
     return data_;
 }
 
-template <typename T>
-ChVector<T>::operator const std::vector<T> &() const
+template <typename T, typename Allocator>
+ChVector<T, Allocator>::operator const std::vector<T, Allocator> &() const
 {
     return data_;
 }
 
-template <typename T>
-bool ChVector<T>::contains(const T &value) const
+template <typename T, typename Allocator>
+Allocator ChVector<T, Allocator>::allocator() const
+{
+    return data_.get_allocator();
+}
+
+template <typename T, typename Allocator>
+bool ChVector<T, Allocator>::contains(const T &value) const
 {
-    return std::find(data_.begin(), data_.end(), value) != data_.end();
+    if constexpr (ChVectorKernels::HasKernels<T>::value)
+    {
+        return ChVectorKernels::indexOf(data_.data(), data_.size(), value) != data_.size();
+    }
+    else
+    {
+        // Iterators rather than data(), which std::vector<bool> does not have
+        return std::find(data_.begin(), data_.end(), value) != data_.end();
+    }
 }
 
-template <typename T>
-void ChVector<T>::remove(const T &value)
+template <typename T, typename Allocator>
+bool ChVector<T, Allocator>::contains(ChExecutionPolicy policy, const T &value) const
+{
+    const size_t chunks = ChVectorAlgorithms::chunkCount(data_.size(), policy);
+    if (chunks == 1)
+    {
+        return contains(value);
+    }
+
+    // Chunks scan in blocks and give up as soon as another chunk has found the value
+    std::atomic<bool> found(false);
+    ChVectorAlgorithms::forEachChunk(data_.size(), chunks, [&](size_t, size_t begin, size_t end)
+    {
+        while (begin < end && !found.load(std::memory_order_relaxed))
+        {
+            size_t blockEnd = std::min(end, begin + ChVectorAlgorithms::minChunkSize);
+            bool blockContains;
+            if constexpr (ChVectorKernels::HasKernels<T>::value)
+            {
+                blockContains = ChVectorKernels::indexOf(data_.data() + begin, blockEnd - begin, value) != blockEnd - begin;
+            }
+            else
+            {
+                blockContains = std::find(data_.begin() + begin, data_.begin() + blockEnd, value) != data_.begin() + blockEnd;
+            }
+            if (blockContains)
+            {
+                found.store(true, std::memory_order_relaxed);
+            }
+            begin = blockEnd;
+        }
+    });
+    return found.load();
+}
+
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::remove(const T &value)
 {
     data_.erase(std::remove(data_.begin(), data_.end(), value), data_.end());
 }
 
-template <typename T>
-size_t ChVector<T>::count(const T &value)
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::remove(ChExecutionPolicy policy, const T &value)
+{
+    const size_t chunks = ChVectorAlgorithms::writeChunkCount<T>(data_.size(), policy);
+    if (chunks == 1)
+    {
+        remove(value);
+        return;
+    }
+
+    // Every chunk compacts its kept elements to its own front; the chunks are then closed up in order
+    std::vector<size_t> kept(chunks);
+    ChVectorAlgorithms::forEachChunk(data_.size(), chunks, [&](size_t chunk, size_t begin, size_t end)
+    {
+        kept[chunk] = std::remove(data_.begin() + begin, data_.begin() + end, value) - (data_.begin() + begin);
+    });
+
+    auto out = data_.begin() + kept[0];
+    for (size_t chunk = 1; chunk < chunks; ++chunk)
+    {
+        auto begin = data_.begin() + ChVectorAlgorithms::chunkBegin(data_.size(), chunks, chunk);
+        out = std::move(begin, begin + kept[chunk], out);
+    }
+    data_.erase(out, data_.end());
+}
+
+template <typename T, typename Allocator>
+size_t ChVector<T, Allocator>::count(const T &value)
+{
+    if constexpr (ChVectorKernels::HasKernels<T>::value)
+    {
+        return ChVectorKernels::count(data_.data(), data_.size(), value);
+    }
+    else
+    {
+        return std::count(data_.begin(), data_.end(), value);
+    }
+}
+
+template <typename T, typename Allocator>
+size_t ChVector<T, Allocator>::count(ChExecutionPolicy policy, const T &value) const
 {
-    return std::count(data_.begin(), data_.end(), value);
+    const size_t chunks = ChVectorAlgorithms::chunkCount(data_.size(), policy);
+    std::vector<size_t> counts(chunks);
+    ChVectorAlgorithms::forEachChunk(data_.size(), chunks, [&](size_t chunk, size_t begin, size_t end)
+    {
+        if constexpr (ChVectorKernels::HasKernels<T>::value)
+        {
+            counts[chunk] = ChVectorKernels::count(data_.data() + begin, end - begin, value);
+        }
+        else
+        {
+            counts[chunk] = std::count(data_.begin() + begin, data_.begin() + end, value);
+        }
+    });
+    return std::accumulate(counts.begin(), counts.end(), static_cast<size_t>(0));
 }
 
-template <typename T>
-typename std::vector<T>::iterator ChVector<T>::find(const T &value)
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator ChVector<T, Allocator>::find(const T &value)
 {
     return std::find(data_.begin(), data_.end(), value);
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator ChVector<T>::find(const T &value) const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator ChVector<T, Allocator>::find(const T &value) const
 {
     return std::find(data_.cbegin(), data_.cend(), value);
 }
 
-template <typename T>
-int ChVector<T>::indexOf(const T &element) const
+template <typename T, typename Allocator>
+int ChVector<T, Allocator>::indexOf(const T &element) const
 {
+    if constexpr (ChVectorKernels::HasKernels<T>::value)
+    {
+        size_t index = ChVectorKernels::indexOf(data_.data(), data_.size(), element);
+        return index == data_.size() ? -1 : static_cast<int>(index);
+    }
+
     auto it = std::find(data_.begin(), data_.end(), element);
     if (it == data_.end())
     {
@@ -80,394 +198,630 @@ int ChVector<T>::indexOf(const T &element) const
     return std::distance(data_.begin(), it);
 }
 
-template <typename T>
-int ChVector<T>::lastIndexOf(const T &element) const
+template <typename T, typename Allocator>
+int ChVector<T, Allocator>::lastIndexOf(const T &element) const
 {
-    auto it = std::find_end(data_.begin(), data_.end(), std::initializer_list<T>{element});
-    if (it == data_.end())
+    if constexpr (ChVectorKernels::HasKernels<T>::value)
+    {
+        size_t index = ChVectorKernels::lastIndexOf(data_.data(), data_.size(), element);
+        return index == data_.size() ? -1 : static_cast<int>(index);
+    }
+
+    auto it = std::find(data_.rbegin(), data_.rend(), element);
+    if (it == data_.rend())
     {
         return -1;
     }
-    return std::distance(data_.begin(), it);
+    return std::distance(it, data_.rend()) - 1;
 }
 
-template <typename T>
-void ChVector<T>::reverse()
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::reverse()
 {
     std::reverse(data_.begin(), data_.end());
 }
 
-template <typename T>
-void ChVector<T>::shuffle(unsigned int seed)
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::reverse(ChExecutionPolicy policy)
+{
+    const size_t size = data_.size();
+    const size_t half = size / 2;
+    ChVectorAlgorithms::forEachChunk(half, ChVectorAlgorithms::writeChunkCount<T>(size, policy), [&](size_t, size_t begin, size_t end)
+    {
+        std::swap_ranges(data_.begin() + begin, data_.begin() + end, data_.rbegin() + begin);
+    });
+}
+
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::shuffle(unsigned int seed)
 {
     std::shuffle(data_.begin(), data_.end(), std::default_random_engine(seed));
 }
 
-template <typename T>
-void ChVector<T>::concat(const ChVector<T> &other)
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::concat(const ChVector &other)
 {
     data_.insert(data_.end(), other.data_.begin(), other.data_.end());
 }
 
-template <typename T>
+template <typename T, typename Allocator>
 template <typename U>
-typename std::enable_if<std::is_same<decltype(std::declval<U>() + std::declval<U>()), U>::value, U>::type ChVector<T>::sum() const
+typename std::enable_if<std::is_same<decltype(std::declval<U>() + std::declval<U>()), U>::value, U>::type ChVector<T, Allocator>::sum() const
 {
+    if constexpr (ChVectorKernels::HasKernels<U>::value && std::is_same<U, T>::value)
+    {
+        return ChVectorKernels::sum(data_.data(), data_.size());
+    }
+
     U result = U();
-    for (const U &value : data_)
+    for (const T &value : data_)
     {
-        result += value;
+        result += static_cast<U>(value);
     }
     return result;
 }
 
-template <typename T>
+template <typename T, typename Allocator>
+template <typename U>
+typename std::enable_if<std::is_same<decltype(std::declval<U>() + std::declval<U>()), U>::value, U>::type ChVector<T, Allocator>::sum(ChExecutionPolicy policy, bool deterministic) const
+{
+    const size_t size = data_.size();
+    if (deterministic)
+    {
+        const size_t blocks = (size + ChVectorAlgorithms::deterministicBlockSize - 1) / ChVectorAlgorithms::deterministicBlockSize;
+        std::vector<U> blockSums(blocks);
+        ChVectorAlgorithms::forEachChunk(blocks, ChVectorAlgorithms::chunkCount(size, policy), [&](size_t, size_t begin, size_t end)
+        {
+            for (size_t block = begin; block < end; ++block)
+            {
+                size_t first = block * ChVectorAlgorithms::deterministicBlockSize;
+                size_t count = std::min(ChVectorAlgorithms::deterministicBlockSize, size - first);
+                blockSums[block] = ChVectorAlgorithms::sumRange<U>(data_.data() + first, count);
+            }
+        });
+        return ChVectorAlgorithms::sumRange<U>(blockSums.data(), blocks);
+    }
+
+    const size_t chunks = ChVectorAlgorithms::chunkCount(size, policy);
+    std::vector<U> partialSums(chunks);
+    ChVectorAlgorithms::forEachChunk(size, chunks, [&](size_t chunk, size_t begin, size_t end)
+    {
+        if constexpr (ChVectorKernels::HasKernels<U>::value && std::is_same<U, T>::value)
+        {
+            partialSums[chunk] = ChVectorKernels::sum(data_.data() + begin, end - begin);
+            return;
+        }
+        else if constexpr (std::is_arithmetic<U>::value)
+        {
+            if (policy == ChExecutionPolicy::ParallelVectorized)
+            {
+                partialSums[chunk] = ChVectorAlgorithms::sumRangeVectorized<U>(data_.data() + begin, end - begin);
+                return;
+            }
+        }
+        partialSums[chunk] = ChVectorAlgorithms::sumRange<U>(data_.data() + begin, end - begin);
+    });
+    return ChVectorAlgorithms::sumRange<U>(partialSums.data(), chunks);
+}
+
+template <typename T, typename Allocator>
 template <typename U>
-typename std::enable_if<std::is_floating_point<U>::value, U>::type ChVector<T>::average() const
+typename std::enable_if<std::is_floating_point<U>::value, U>::type ChVector<T, Allocator>::average() const
 {
     if (data_.empty())
     {
         return U();
     }
-    U sum = U();
-    for (const auto &value : data_)
+    return sum<U>() / data_.size();
+}
+
+template <typename T, typename Allocator>
+template <typename U>
+typename std::enable_if<std::is_floating_point<U>::value, U>::type ChVector<T, Allocator>::sum(ChSummation summation) const
+{
+    switch (summation)
+    {
+    // The kernels add up in the element type, so a wider U takes the generic path that converts every element
+    case ChSummation::Kahan:
+        if constexpr (ChVectorKernels::HasKernels<U>::value && std::is_same<U, T>::value)
+        {
+            return ChVectorKernels::sumKahan(data_.data(), data_.size());
+        }
+        else
+        {
+            return ChVectorAlgorithms::sumKahan<U>(data_.data(), data_.size());
+        }
+    case ChSummation::Pairwise:
+        if constexpr (ChVectorKernels::HasKernels<U>::value && std::is_same<U, T>::value)
+        {
+            return ChVectorKernels::sumPairwise(data_.data(), data_.size());
+        }
+        else
+        {
+            return ChVectorAlgorithms::sumPairwise<U>(data_.data(), data_.size());
+        }
+    default:
+        return sum<U>();
+    }
+}
+
+template <typename T, typename Allocator>
+template <typename U>
+typename std::enable_if<std::is_floating_point<U>::value, U>::type ChVector<T, Allocator>::average(ChSummation summation) const
+{
+    if (data_.empty())
     {
-        sum += value;
+        return U();
     }
-    return sum / data_.size();
+    return sum<U>(summation) / data_.size();
 }
 
-template <typename T>
-void ChVector<T>::sort()
+template <typename T, typename Allocator>
+T ChVector<T, Allocator>::minimum() const
+{
+    size_t index = argMin();
+    return index == data_.size() ? T() : data_[index];
+}
+
+template <typename T, typename Allocator>
+T ChVector<T, Allocator>::maximum() const
+{
+    size_t index = argMax();
+    return index == data_.size() ? T() : data_[index];
+}
+
+template <typename T, typename Allocator>
+size_t ChVector<T, Allocator>::argMin() const
+{
+    if constexpr (ChVectorKernels::HasKernels<T>::value)
+    {
+        return ChVectorKernels::argMin(data_.data(), data_.size());
+    }
+    else
+    {
+        return std::min_element(data_.begin(), data_.end()) - data_.begin();
+    }
+}
+
+template <typename T, typename Allocator>
+size_t ChVector<T, Allocator>::argMax() const
+{
+    if constexpr (ChVectorKernels::HasKernels<T>::value)
+    {
+        return ChVectorKernels::argMax(data_.data(), data_.size());
+    }
+    else
+    {
+        // std::max_element returns the first largest element, like the kernels
+        return std::max_element(data_.begin(), data_.end()) - data_.begin();
+    }
+}
+
+template <typename T, typename Allocator>
+T ChVector<T, Allocator>::dot(const ChVector &other) const
+{
+    if (data_.size() != other.data_.size())
+    {
+        throw std::out_of_range("Vectors must have the same size for dot");
+    }
+
+    if constexpr (ChVectorKernels::HasKernels<T>::value)
+    {
+        return ChVectorKernels::dot(data_.data(), other.data_.data(), data_.size());
+    }
+    else
+    {
+        T result = T();
+        for (size_t i = 0; i < data_.size(); ++i)
+        {
+            result += data_[i] * other.data_[i];
+        }
+        return result;
+    }
+}
+
+template <typename T, typename Allocator>
+template <typename U>
+typename std::enable_if<std::is_floating_point<U>::value, U>::type ChVector<T, Allocator>::average(ChExecutionPolicy policy, bool deterministic) const
+{
+    if (data_.empty())
+    {
+        return U();
+    }
+    return sum<U>(policy, deterministic) / data_.size();
+}
+
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::sort()
 {
     std::sort(data_.begin(), data_.end());
 }
 
-template <typename T>
-void ChVector<T>::unique()
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::sort(ChExecutionPolicy policy)
+{
+    const size_t size = data_.size();
+    const size_t chunks = ChVectorAlgorithms::writeChunkCount<T>(size, policy);
+    ChVectorAlgorithms::forEachChunk(size, chunks, [&](size_t, size_t begin, size_t end)
+    {
+        std::sort(data_.begin() + begin, data_.begin() + end);
+    });
+
+    // Merge neighbouring sorted runs until a single run is left; the merges of one round are independent
+    for (size_t width = 1; width < chunks; width *= 2)
+    {
+        const size_t merges = (chunks + 2 * width - 1) / (2 * width);
+        ChThreadPool::global().run(merges, [&](size_t merge)
+        {
+            size_t first = merge * 2 * width;
+            size_t middle = std::min(first + width, chunks);
+            size_t last = std::min(first + 2 * width, chunks);
+            if (middle < last)
+            {
+                std::inplace_merge(data_.begin() + ChVectorAlgorithms::chunkBegin(size, chunks, first),
+                                   data_.begin() + ChVectorAlgorithms::chunkBegin(size, chunks, middle),
+                                   data_.begin() + ChVectorAlgorithms::chunkBegin(size, chunks, last));
+            }
+        });
+    }
+}
+
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::unique()
 {
     auto it = std::unique(data_.begin(), data_.end());
     data_.erase(it, data_.end());
 }
 
-template <typename T>
-void ChVector<T>::removeDuplicates()
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::removeDuplicates()
 {
-    std::set<T> uniqueElements(data_.begin(), data_.end());
-    data_.clear();
-    data_.insert(data_.end(), uniqueElements.begin(), uniqueElements.end());
+    data_.erase(data_.begin() + ChVectorAlgorithms::removeDuplicates(data_.data(), data_.size()), data_.end());
 }
 
-template <typename T, typename U>
-ChVector<std::pair<T, U>> zip(const ChVector<T> &vec1, const ChVector<U> &vec2)
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::removeDuplicatesSorted()
+{
+    data_.erase(data_.begin() + ChVectorAlgorithms::sortUnique(data_.data(), data_.size()), data_.end());
+}
+
+template <typename T, typename U, typename AllocatorT, typename AllocatorU>
+ChZipView<ChSpanView<T>, ChSpanView<U>> zip(const ChVector<T, AllocatorT> &vec1, const ChVector<U, AllocatorU> &vec2)
 {
     if (vec1.size() != vec2.size())
     {
         throw std::out_of_range("Vectors must have the same size for zip");
     }
+    return vec1.view().zip(vec2.view());
+}
 
-    ChVector<std::pair<T, U>> result;
-    for (std::size_t i = 0; i < vec1.size(); ++i)
+template <typename T, typename Allocator>
+template <typename Fn>
+ChVector<typename std::result_of<Fn(T)>::type> ChVector<T, Allocator>::map(Fn func) const
+{
+    ChVector<typename std::result_of<Fn(T)>::type> result;
+    result.reserve(data_.size());
+    for (const T &value : data_)
     {
-        result.push_back(std::make_pair(vec1[i], vec2[i]));
+        result.push_back(func(value));
     }
-
     return result;
 }
 
-template <typename T>
+template <typename T, typename Allocator>
 template <typename Fn>
-ChVector<typename std::result_of<Fn(T)>::type> ChVector<T>::map(Fn func) const
+ChVector<typename std::result_of<Fn(T)>::type> ChVector<T, Allocator>::map(ChExecutionPolicy policy, Fn func) const
 {
-    ChVector<typename std::result_of<Fn(T)>::type> result;
-    std::transform(data_.begin(), data_.end(), std::back_inserter(result), func);
-    return result;
+    using Result = typename std::result_of<Fn(T)>::type;
+    const size_t chunks = ChVectorAlgorithms::writeChunkCount<Result>(data_.size(), policy);
+    if constexpr (std::is_default_constructible<Result>::value)
+    {
+        if (chunks > 1)
+        {
+            std::vector<Result> values(data_.size());
+            ChVectorAlgorithms::forEachChunk(data_.size(), chunks, [&](size_t, size_t begin, size_t end)
+            {
+                std::transform(data_.begin() + begin, data_.begin() + end, values.begin() + begin, func);
+            });
+
+            ChVector<Result> result;
+            result.swap(values);
+            return result;
+        }
+    }
+    return map(func);
 }
 
-template <typename T>
-void ChVector<T>::prepend(const std::initializer_list<T> &values)
+template <typename T, typename Allocator>
+ChSpanView<T> ChVector<T, Allocator>::view() const
+{
+    return ChSpanView<T>(data_.data(), data_.data() + data_.size());
+}
+
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::prepend(const std::initializer_list<T> &values)
 {
     data_.insert(data_.begin(), values);
 }
 
-template <typename T>
-typename std::vector<T>::iterator ChVector<T>::begin() noexcept
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator ChVector<T, Allocator>::begin() noexcept
 {
     return data_.begin();
 }
 
-template <typename T>
-typename std::vector<T>::iterator ChVector<T>::end() noexcept
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator ChVector<T, Allocator>::end() noexcept
 {
     return data_.end();
 }
 
-template <typename T>
-typename std::vector<T>::reverse_iterator ChVector<T>::rbegin() noexcept
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::reverse_iterator ChVector<T, Allocator>::rbegin() noexcept
 {
     return data_.rbegin();
 }
 
-template <typename T>
-typename std::vector<T>::reverse_iterator ChVector<T>::rend() noexcept
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::reverse_iterator ChVector<T, Allocator>::rend() noexcept
 {
     return data_.rend();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator ChVector<T>::cbegin() noexcept
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator ChVector<T, Allocator>::cbegin() noexcept
 {
     return data_.cbegin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator ChVector<T>::cend() noexcept
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator ChVector<T, Allocator>::cend() noexcept
 {
     return data_.cend();
 }
 
-template <typename T>
-typename std::vector<T>::const_reverse_iterator ChVector<T>::crbegin() noexcept
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_reverse_iterator ChVector<T, Allocator>::crbegin() noexcept
 {
     return data_.crbegin();
 }
 
-template <typename T>
-typename std::vector<T>::const_reverse_iterator ChVector<T>::crend() noexcept
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_reverse_iterator ChVector<T, Allocator>::crend() noexcept
 {
     return data_.crend();
 }
 
-template <typename T>
-size_t ChVector<T>::size() const noexcept
+template <typename T, typename Allocator>
+size_t ChVector<T, Allocator>::size() const noexcept
 {
     return data_.size();
 }
 
-template <typename T>
-size_t ChVector<T>::max_size() const noexcept
+template <typename T, typename Allocator>
+size_t ChVector<T, Allocator>::max_size() const noexcept
 {
     return data_.max_size();
 }
 
-template <typename T>
-void ChVector<T>::resize(size_t n)
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::resize(size_t n)
 {
     data_.resize(n);
 }
 
-template <typename T>
-void ChVector<T>::resize(size_t n, const T &val)
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::resize(size_t n, const T &val)
 {
     data_.resize(n, val);
 }
 
-template <typename T>
-size_t ChVector<T>::capacity() const noexcept
+template <typename T, typename Allocator>
+size_t ChVector<T, Allocator>::capacity() const noexcept
 {
     return data_.capacity();
 }
 
-template <typename T>
-bool ChVector<T>::isEmpty() const noexcept
+template <typename T, typename Allocator>
+bool ChVector<T, Allocator>::isEmpty() const noexcept
 {
     return data_.empty();
 }
 
-template <typename T>
-void ChVector<T>::reserve(size_t n)
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::reserve(size_t n)
 {
     data_.reserve(n);
 }
 
-template <typename T>
-void ChVector<T>::shrink()
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::shrink()
 {
     data_.shrink_to_fit();
 }
 
-template <typename T>
-T &ChVector<T>::operator[](size_t index)
+template <typename T, typename Allocator>
+T &ChVector<T, Allocator>::operator[](size_t index)
 {
     return data_[index];
 }
 
-template <typename T>
-const T &ChVector<T>::operator[](size_t index) const
+template <typename T, typename Allocator>
+const T &ChVector<T, Allocator>::operator[](size_t index) const
 {
     return data_[index];
 }
 
-template <typename T>
-T &ChVector<T>::at(size_t index)
+template <typename T, typename Allocator>
+T &ChVector<T, Allocator>::at(size_t index)
 {
     return data_.at(index);
 }
 
-template <typename T>
-const T &ChVector<T>::at(size_t index) const
+template <typename T, typename Allocator>
+const T &ChVector<T, Allocator>::at(size_t index) const
 {
     return data_.at(index);
 }
 
-template <typename T>
-T &ChVector<T>::front()
+template <typename T, typename Allocator>
+T &ChVector<T, Allocator>::front()
 {
     return data_.front();
 }
 
-template <typename T>
-const T &ChVector<T>::front() const
+template <typename T, typename Allocator>
+const T &ChVector<T, Allocator>::front() const
 {
     return data_.front();
 }
 
-template <typename T>
-T &ChVector<T>::back()
+template <typename T, typename Allocator>
+T &ChVector<T, Allocator>::back()
 {
     return data_.back();
 }
 
-template <typename T>
-const T &ChVector<T>::back() const
+template <typename T, typename Allocator>
+const T &ChVector<T, Allocator>::back() const
 {
     return data_.back();
 }
 
-template <typename T>
-T *ChVector<T>::data() noexcept
+template <typename T, typename Allocator>
+T *ChVector<T, Allocator>::data() noexcept
 {
     return data_.data();
 }
 
-template <typename T>
-const T *ChVector<T>::data() const noexcept
+template <typename T, typename Allocator>
+const T *ChVector<T, Allocator>::data() const noexcept
 {
     return data_.data();
 }
 
-template <typename T>
-void ChVector<T>::assign(size_t count, const T &value)
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::assign(size_t count, const T &value)
 {
     data_.assign(count, value);
 }
 
-template <typename T>
+template <typename T, typename Allocator>
 template <typename InputIt>
-void ChVector<T>::assign(InputIt first, InputIt last)
+void ChVector<T, Allocator>::assign(InputIt first, InputIt last)
 {
     data_.assign(first, last);
 }
 
-template <typename T>
-void ChVector<T>::assign(std::initializer_list<T> ilist)
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::assign(std::initializer_list<T> ilist)
 {
-    data_.insert(ilist);
+    data_.assign(ilist);
 }
 
-template <typename T>
-void ChVector<T>::push_back(const T &val)
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::push_back(const T &val)
 {
     data_.push_back(val);
 }
 
-template <typename T>
-void ChVector<T>::push_back(T &&val)
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::push_back(T &&val)
 {
-    data_.push_back(val);
+    data_.push_back(std::move(val));
 }
 
-template <typename T>
-void ChVector<T>::pop_back()
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::pop_back()
 {
     data_.pop_back();
 }
 
-template <typename T>
-typename std::vector<T>::iterator ChVector<T>::insert(typename std::vector<T>::const_iterator pos, const T &value)
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator ChVector<T, Allocator>::insert(typename std::vector<T, Allocator>::const_iterator pos, const T &value)
 {
     return data_.insert(pos, value);
 }
 
-template <typename T>
-typename std::vector<T>::iterator ChVector<T>::insert(typename std::vector<T>::const_iterator pos, T &&value)
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator ChVector<T, Allocator>::insert(typename std::vector<T, Allocator>::const_iterator pos, T &&value)
 {
-    return data_.insert(pos, value);
+    return data_.insert(pos, std::move(value));
 }
 
-template <typename T>
-typename std::vector<T>::iterator ChVector<T>::insert(typename std::vector<T>::const_iterator pos, size_t count, const T &value)
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator ChVector<T, Allocator>::insert(typename std::vector<T, Allocator>::const_iterator pos, size_t count, const T &value)
 {
     return data_.insert(pos, count, value);
 }
 
-template <typename T>
+template <typename T, typename Allocator>
 template <typename InputIt>
-typename std::vector<T>::iterator ChVector<T>::insert(typename std::vector<T>::const_iterator pos, InputIt first, InputIt last)
+typename std::vector<T, Allocator>::iterator ChVector<T, Allocator>::insert(typename std::vector<T, Allocator>::const_iterator pos, InputIt first, InputIt last)
 {
     return data_.insert(pos, first, last);
 }
 
-template <typename T>
-typename std::vector<T>::iterator ChVector<T>::insert(typename std::vector<T>::const_iterator pos, std::initializer_list<T> ilist)
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator ChVector<T, Allocator>::insert(typename std::vector<T, Allocator>::const_iterator pos, std::initializer_list<T> ilist)
 {
     return data_.insert(pos, ilist);
 }
 
-template <typename T>
-typename std::vector<T>::iterator ChVector<T>::erase(typename std::vector<T>::const_iterator pos)
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator ChVector<T, Allocator>::erase(typename std::vector<T, Allocator>::const_iterator pos)
 {
     return data_.erase(pos);
 }
 
-template <typename T>
-typename std::vector<T>::iterator ChVector<T>::erase(typename std::vector<T>::const_iterator first, typename std::vector<T>::const_iterator last)
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator ChVector<T, Allocator>::erase(typename std::vector<T, Allocator>::const_iterator first, typename std::vector<T, Allocator>::const_iterator last)
 {
     return data_.erase(first, last);
 }
 
-template <typename T>
-void ChVector<T>::swap(ChVector &other) noexcept
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::swap(ChVector &other) noexcept
 {
     data_.swap(other.data_);
 }
 
-template <typename T>
-void ChVector<T>::swap(std::vector<T> &other) noexcept
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::swap(std::vector<T, Allocator> &other) noexcept
 {
     data_.swap(other);
 }
 
-template <typename T>
-void ChVector<T>::clear() noexcept
+template <typename T, typename Allocator>
+void ChVector<T, Allocator>::clear() noexcept
 {
     data_.clear();
 }
 
-template <typename T>
+template <typename T, typename Allocator>
 template <typename... Args>
-void ChVector<T>::emplace_back(Args &&...args)
+void ChVector<T, Allocator>::emplace_back(Args &&...args)
 {
-    data_.emplace_back(args);
+    data_.emplace_back(std::forward<Args>(args)...);
 }
 
-template <typename T>
+template <typename T, typename Allocator>
 template <typename... Args>
-void ChVector<T>::emplace(typename std::vector<T>::iterator pos, Args &&...args)
+void ChVector<T, Allocator>::emplace(typename std::vector<T, Allocator>::iterator pos, Args &&...args)
 {
-    data_.emplace(pos, args);
+    data_.emplace(pos, std::forward<Args>(args)...);
 }
 
-template <typename T>
+template <typename T, typename Allocator>
 template <typename... Args>
-typename std::vector<T>::iterator ChVector<T>::emplace(typename std::vector<T>::const_iterator pos, Args &&...args)
+typename std::vector<T, Allocator>::iterator ChVector<T, Allocator>::emplace(typename std::vector<T, Allocator>::const_iterator pos, Args &&...args)
 {
-    data_.emplace(pos, args);
+    return data_.emplace(pos, std::forward<Args>(args)...);
 }
 
-template <typename T>
+template <typename T, typename Allocator>
 template <typename... Args>
-typename std::vector<T>::iterator ChVector<T>::emplace(typename std::vector<T>::const_iterator pos, std::initializer_list<T> ilist, Args &&...args)
+typename std::vector<T, Allocator>::iterator ChVector<T, Allocator>::emplace(typename std::vector<T, Allocator>::const_iterator pos, std::initializer_list<T> ilist, Args &&...args)
 {
-    data_.emplace(pos, ilist, args);
+    return data_.emplace(pos, ilist, std::forward<Args>(args)...);
 }
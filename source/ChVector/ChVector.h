@@ -2,8 +2,39 @@
 #define CHVECTOR
 
 #include <vector>
+#include <memory>
 #include <random>
 #include <type_traits>
+#include <initializer_list>
+#include <utility>
+#include <cstddef>
+
+#include "ChAllocator.h"
+#include "ChExecutionPolicy.h"
+#include "ChView.h"
+
+/**
+ * @brief Selects the summation algorithm of the floating-point ChVector sums.
+ */
+enum class ChSummation
+{
+    /**
+     * @brief Sums in several independent accumulators. The fastest, with an error that grows with the size.
+     */
+    Fast,
+
+    /**
+     * @brief Carries the rounding error of every addition forward (Kahan summation). About as accurate as summing in
+     * twice the precision, at a few times the cost of Fast.
+     */
+    Kahan,
+
+    /**
+     * @brief Sums both halves of the range recursively. The error grows with the logarithm of the size, at nearly the
+     * cost of Fast.
+     */
+    Pairwise
+};
 
 /**
  * @brief A custom implementation of std::vector with additional functionalities.
@@ -13,9 +44,20 @@
  * The ChVector class has all the capabilities of the std::vector class, but the internal std::vector object is not directly accessible
  * from outside the class. All operations on the internal std::vector object should be done via the member functions of the ChVector class.
  *
+ * The memory of the elements comes from `Allocator`. A ChVector that only lives for one request can take a
+ * ChArenaAllocator and leave its memory to the arena, which frees it all at once:
+ *
+ * @code
+ * ChArena arena;
+ * ChVector<int, ChArenaAllocator<int>> ids(arena);
+ * ...
+ * arena.reset();
+ * @endcode
+ *
  * @tparam T The type of the elements stored in the vector.
+ * @tparam Allocator The allocator of the elements, std::allocator<T> by default.
  */
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 class ChVector
 {
 public:
@@ -24,6 +66,13 @@ public:
      */
     ChVector();
 
+    /**
+     * @brief Constructs an empty vector that allocates its elements with `allocator`.
+     *
+     * @param allocator The allocator to use for all memory of the vector.
+     */
+    explicit ChVector(const Allocator &allocator);
+
     /**
      * @brief Copy constructor. Constructs the vector with the copy of the contents of `other`.
      *
@@ -57,27 +106,36 @@ public:
      *
      * @param other Another ChVector object to be used as source to move the elements from. `other` is left in a valid but unspecified state.
      *
+     * Like std::vector, the assignment is only noexcept if the allocator moves along with the elements or all its
+     * instances are equal. Between vectors on different arenas or pools the elements are moved one by one into newly
+     * allocated memory, which may throw std::bad_alloc.
+     *
      * @return A reference to the vector object.
      */
-    ChVector &operator=(ChVector &&other) noexcept;
+    ChVector &operator=(ChVector &&other) noexcept(std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value || std::allocator_traits<Allocator>::is_always_equal::value);
 
     /**
      * @brief Conversion operator to implicitly convert ChVector to std::vector.
      *
      * @tparam T Type of the elements stored in the vector.
      *
-     * @return A reference to the internal std::vector<T> object.
+     * @return A reference to the internal std::vector<T, Allocator> object.
      */
-    operator std::vector<T> &();
+    operator std::vector<T, Allocator> &();
 
     /**
      * @brief Conversion operator to implicitly convert ChVector to std::vector.
      *
      * @tparam T Type of the elements stored in the vector.
      *
-     * @return A const reference to the internal std::vector<T> object.
+     * @return A const reference to the internal std::vector<T, Allocator> object.
      */
-    operator const std::vector<T> &() const;
+    operator const std::vector<T, Allocator> &() const;
+
+    /**
+     * @brief Returns a copy of the allocator of the vector.
+     */
+    Allocator allocator() const;
 
     /**
      * @brief Checks whether the vector contains an element with the given value.
@@ -88,6 +146,16 @@ public:
      */
     inline bool contains(const T &value) const;
 
+    /**
+     * @brief Checks whether the vector contains an element with the given value.
+     *
+     * @param policy How the search is executed. Parallel searches stop early once any chunk finds the value.
+     * @param value The value to search for.
+     *
+     * @return `true` if the vector contains an element with the given value, `false` otherwise.
+     */
+    bool contains(ChExecutionPolicy policy, const T &value) const;
+
     /**
      * @brief Removes all elements from the vector that have the given value.
      *
@@ -95,6 +163,14 @@ public:
      */
     inline void remove(const T &value);
 
+    /**
+     * @brief Removes all elements from the vector that have the given value, keeping the order of the others.
+     *
+     * @param policy How the removal is executed.
+     * @param value The value to remove from the vector.
+     */
+    void remove(ChExecutionPolicy policy, const T &value);
+
     /**
      * Count the number of occurrences of a value in the vector.
      *
@@ -103,6 +179,15 @@ public:
      */
     inline size_t count(const T &value);
 
+    /**
+     * Count the number of occurrences of a value in the vector.
+     *
+     * @param policy How the count is executed.
+     * @param value The value to count.
+     * @return The number of occurrences of the value in the vector.
+     */
+    size_t count(ChExecutionPolicy policy, const T &value) const;
+
     /**
      * Find the first occurrence of a value in the vector.
      *
@@ -110,7 +195,7 @@ public:
      * @return An iterator to the first occurrence of the value in the vector,
      *         or vec_.end() if the value is not found.
      */
-    typename std::vector<T>::iterator find(const T &value);
+    typename std::vector<T, Allocator>::iterator find(const T &value);
 
     /**
      * Find the first occurrence of a value in the vector (const version).
@@ -119,7 +204,7 @@ public:
      * @return A const iterator to the first occurrence of the value in the vector,
      *         or vec_.end() if the value is not found.
      */
-    typename std::vector<T>::const_iterator find(const T &value) const;
+    typename std::vector<T, Allocator>::const_iterator find(const T &value) const;
 
     /**
      * @brief Returns the index of the first occurrence of the specified element in this ChVector,
@@ -130,7 +215,7 @@ public:
      * @return The index of the first occurrence of the specified element in this ChVector,
      *         or -1 if this ChVector does not contain the element.
      */
-    int ChVector<T>::indexOf(const T &element) const;
+    int indexOf(const T &element) const;
 
     /**
      * @brief Returns the index of the last occurrence of the specified element in this ChVector,
@@ -141,7 +226,7 @@ public:
      * @return The index of the last occurrence of the specified element in this ChVector,
      *         or -1 if this ChVector does not contain the element.
      */
-    int ChVector<T>::lastIndexOf(const T &element) const;
+    int lastIndexOf(const T &element) const;
 
     /**
      * @brief Reverse the order of elements in the vector.
@@ -151,6 +236,13 @@ public:
      */
     void reverse();
 
+    /**
+     * @brief Reverse the order of elements in the vector.
+     *
+     * @param policy How the reversal is executed.
+     */
+    void reverse(ChExecutionPolicy policy);
+
     /**
      * @brief Shuffle the elements in the vector in a random order.
      *
@@ -171,7 +263,7 @@ public:
      *
      * @param other The ChVector object to concatenate with this one.
      */
-    void concat(const ChVector<T> &other);
+    void concat(const ChVector &other);
 
     /**
      * @brief Get the sum of all elements in the vector.
@@ -185,6 +277,20 @@ public:
     template <typename U = T>
     typename std::enable_if<std::is_same<decltype(std::declval<U>() + std::declval<U>()), U>::value, U>::type sum() const;
 
+    /**
+     * @brief Get the sum of all elements in the vector.
+     *
+     * Parallel policies sum chunks concurrently and add the partial sums in chunk order, so `+` must be associative.
+     * For floating-point elements the result then depends on the chunking; pass `deterministic` to get the same
+     * result for every policy and thread count.
+     *
+     * @param policy How the sum is executed.
+     * @param deterministic If true, the elements are summed in fixed-size blocks whose sums are added in order.
+     * @return The sum of all elements in the vector.
+     */
+    template <typename U = T>
+    typename std::enable_if<std::is_same<decltype(std::declval<U>() + std::declval<U>()), U>::value, U>::type sum(ChExecutionPolicy policy, bool deterministic = false) const;
+
     /**
      * @brief Computes the average value of the elements in the ChVector.
      *
@@ -194,33 +300,122 @@ public:
     template <typename U = T>
     typename std::enable_if<std::is_floating_point<U>::value, U>::type average() const;
 
+    /**
+     * @brief Computes the average value of the elements in the ChVector.
+     *
+     * @param policy How the underlying sum is executed.
+     * @param deterministic If true, the result does not depend on the policy or the number of threads.
+     * @return The average value of the elements in the ChVector.
+     */
+    template <typename U = T>
+    typename std::enable_if<std::is_floating_point<U>::value, U>::type average(ChExecutionPolicy policy, bool deterministic = false) const;
+
+    /**
+     * @brief Get the sum of all elements in the vector with the given summation algorithm.
+     *
+     * This function is enabled only if the element type is a floating-point type.
+     *
+     * @param summation The summation algorithm, trading speed for accuracy.
+     * @return The sum of all elements in the vector.
+     */
+    template <typename U = T>
+    typename std::enable_if<std::is_floating_point<U>::value, U>::type sum(ChSummation summation) const;
+
+    /**
+     * @brief Computes the average value of the elements in the ChVector with the given summation algorithm.
+     *
+     * This function is enabled only if the element type is a floating-point type.
+     *
+     * @param summation The summation algorithm, trading speed for accuracy.
+     * @return The average value of the elements in the ChVector.
+     */
+    template <typename U = T>
+    typename std::enable_if<std::is_floating_point<U>::value, U>::type average(ChSummation summation) const;
+
+    /**
+     * @brief Returns the smallest element of the vector.
+     *
+     * NaN elements of float and double vectors are skipped by the vector kernels. Other element types, long double
+     * included, have no kernels and are only compared with `<`.
+     *
+     * @return The smallest element, or a value-initialized T if there is none.
+     */
+    T minimum() const;
+
+    /**
+     * @brief Returns the largest element of the vector.
+     *
+     * NaN elements of float and double vectors are skipped by the vector kernels. Other element types, long double
+     * included, have no kernels and are only compared with `<`.
+     *
+     * @return The largest element, or a value-initialized T if there is none.
+     */
+    T maximum() const;
+
+    /**
+     * @brief Returns the index of the first smallest element of the vector.
+     *
+     * NaN elements of float and double vectors are skipped by the vector kernels. Other element types, long double
+     * included, have no kernels and are only compared with `<`.
+     *
+     * @return The index of the element, or `size()` if there is none.
+     */
+    size_t argMin() const;
+
+    /**
+     * @brief Returns the index of the first largest element of the vector.
+     *
+     * NaN elements of float and double vectors are skipped by the vector kernels. Other element types, long double
+     * included, have no kernels and are only compared with `<`.
+     *
+     * @return The index of the element, or `size()` if there is none.
+     */
+    size_t argMax() const;
+
+    /**
+     * @brief Computes the dot product of this vector and `other`.
+     *
+     * @param other The vector to multiply element-wise with this one.
+     * @return The sum of the products of the corresponding elements.
+     * @throws std::out_of_range if the vectors are of different sizes
+     */
+    T dot(const ChVector &other) const;
+
     /**
      * @brief Sorts the elements of the ChVector in ascending order.
      */
     void sort();
 
+    /**
+     * @brief Sorts the elements of the ChVector in ascending order.
+     *
+     * Parallel policies sort chunks concurrently and then merge them pairwise. The order of equal elements is
+     * unspecified. A ChVector<bool> is always sorted sequentially, as are its reversal and removals.
+     *
+     * @param policy How the sort is executed.
+     */
+    void sort(ChExecutionPolicy policy);
+
     /**
      * @brief Removes consecutive duplicate elements from the ChVector.
      */
     void unique();
 
     /**
-     * @brief Removes duplicates from the ChVector object
+     * @brief Removes duplicates from the ChVector object, keeping the first occurrence of each value in place.
+     *
+     * Small vectors compare every pair of elements. Larger ones take O(n) with an open-addressing scratch table sized
+     * from `size()` when std::hash<T> is available, and O(n log n) by sorting element indices otherwise. The relative order of the remaining elements is preserved.
      */
     void removeDuplicates();
 
     /**
-     * @brief Zips two ChVector objects into a vector of pairs
+     * @brief Sorts the ChVector object in ascending order and removes duplicates.
      *
-     * @tparam T Type of the elements in the first ChVector
-     * @tparam U Type of the elements in the second ChVector
-     * @param vec1 First ChVector object
-     * @param vec2 Second ChVector object
-     * @return ChVector<std::pair<T, U>> Vector of pairs of elements from both vectors
-     * @throws std::out_of_range if the vectors are of different sizes
+     * Cheaper than `removeDuplicates()` when the order does not matter. Integral elements are sorted with an LSD radix
+     * sort in O(n); other types use std::sort.
      */
-    template <typename T, typename U>
-    ChVector<std::pair<T, U>> zip(const ChVector<T> &vec1, const ChVector<U> &vec2);
+    void removeDuplicatesSorted();
 
     /**
      * Applies the given function to each element of the vector and returns a new vector
@@ -229,73 +424,97 @@ public:
      * @tparam Func The type of the function to apply. It must take an argument of type T and
      *              return a value of type U.
      * @param func The function to apply to each element.
-     * @return A new vector containing the results of applying the function to each element.
+     * @return A new vector containing the results of applying the function to each element. It uses the default
+     * allocator. Use `view().map(func)` to chain further operations without materializing intermediate vectors.
      */
     template <typename Fn>
     ChVector<typename std::result_of<Fn(T)>::type> map(Fn func) const;
 
+    /**
+     * Applies the given function to each element of the vector and returns a new vector
+     * containing the results.
+     *
+     * Parallel policies call `func` concurrently on different elements, so it must be safe to do so. Results that
+     * are not default constructible, and `bool` results, which std::vector packs into shared words, are always
+     * produced sequentially.
+     *
+     * @param policy How the function calls are executed.
+     * @param func The function to apply to each element.
+     * @return A new vector containing the results of applying the function to each element.
+     */
+    template <typename Fn>
+    ChVector<typename std::result_of<Fn(T)>::type> map(ChExecutionPolicy policy, Fn func) const;
+
+    /**
+     * @brief Returns a lazy view of the elements, the start of a chain of `map`, `filter`, `take`, `zip` and
+     * `enumerate` adaptors that runs in a single pass. See ChViewBase.
+     *
+     * The view is invalidated by any modification of the vector.
+     */
+    ChSpanView<T> view() const;
+
     /**
      * @brief Add elements to the front of the vector.
      *
      * @param values The elements to add to the front of the vector.
      */
-    void ChVector<T>::prepend(const std::initializer_list<T> &values);
+    void prepend(const std::initializer_list<T> &values);
 
     /**
      * @brief Returns an iterator to the beginning of the vector.
      *
      * @return An iterator to the beginning of the vector.
      */
-    typename std::vector<T>::iterator begin() noexcept;
+    typename std::vector<T, Allocator>::iterator begin() noexcept;
 
     /**
      * @brief Returns an iterator to the end of the vector.
      *
      * @return An iterator to the end of the vector.
      */
-    typename std::vector<T>::iterator end() noexcept;
+    typename std::vector<T, Allocator>::iterator end() noexcept;
 
     /**
      * @brief Returns a reverse iterator to the beginning of the reversed vector.
      *
      * @return A reverse iterator to the beginning of the reversed vector.
      */
-    typename std::vector<T>::reverse_iterator rbegin() noexcept;
+    typename std::vector<T, Allocator>::reverse_iterator rbegin() noexcept;
 
     /**
      * @brief Returns a reverse iterator to the end of the reversed vector.
      *
      * @return A reverse iterator to the end of the reversed vector.
      */
-    typename std::vector<T>::reverse_iterator rend() noexcept;
+    typename std::vector<T, Allocator>::reverse_iterator rend() noexcept;
 
     /**
      * @brief Returns a constant iterator to the beginning of the vector.
      *
      * @return A constant iterator to the beginning of the vector.
      */
-    typename std::vector<T>::const_iterator cbegin() noexcept;
+    typename std::vector<T, Allocator>::const_iterator cbegin() noexcept;
 
     /**
      * @brief Returns a constant iterator to the end of the vector.
      *
      * @return A constant iterator to the end of the vector.
      */
-    typename std::vector<T>::const_iterator cend() noexcept;
+    typename std::vector<T, Allocator>::const_iterator cend() noexcept;
 
     /**
      * @brief Returns a constant reverse iterator to the beginning of the reversed vector.
      *
      * @return A constant reverse iterator to the beginning of the reversed vector.
      */
-    typename std::vector<T>::const_reverse_iterator crbegin() noexcept;
+    typename std::vector<T, Allocator>::const_reverse_iterator crbegin() noexcept;
 
     /**
      * @brief Returns a constant reverse iterator to the end of the reversed vector.
      *
      * @return A constant reverse iterator to the end of the reversed vector.
      */
-    typename std::vector<T>::const_reverse_iterator crend() noexcept;
+    typename std::vector<T, Allocator>::const_reverse_iterator crend() noexcept;
 
     /**
      * @brief Returns the number of elements in the vector.
@@ -478,18 +697,18 @@ public:
      *
      * @param pos Const iterator pointing to the position where the element should be inserted.
      * @param value The value to be inserted.
-     * @return typename std::vector<T>::iterator Iterator pointing to the inserted element.
+     * @return typename std::vector<T, Allocator>::iterator Iterator pointing to the inserted element.
      */
-    typename std::vector<T>::iterator insert(typename std::vector<T>::const_iterator pos, const T &value);
+    typename std::vector<T, Allocator>::iterator insert(typename std::vector<T, Allocator>::const_iterator pos, const T &value);
 
     /**
      * @brief Inserts a movable element to the vector at the specified position.
      *
      * @param pos Const iterator pointing to the position where the element should be inserted.
      * @param value The value to be inserted.
-     * @return typename std::vector<T>::iterator Iterator pointing to the inserted element.
+     * @return typename std::vector<T, Allocator>::iterator Iterator pointing to the inserted element.
      */
-    typename std::vector<T>::iterator insert(typename std::vector<T>::const_iterator pos, T &&value);
+    typename std::vector<T, Allocator>::iterator insert(typename std::vector<T, Allocator>::const_iterator pos, T &&value);
 
     /**
      * @brief Inserts multiple elements to the vector at the specified position.
@@ -497,9 +716,9 @@ public:
      * @param pos Const iterator pointing to the position where the elements should be inserted.
      * @param count The number of elements to insert.
      * @param value The value to be inserted.
-     * @return typename std::vector<T>::iterator Iterator pointing to the first inserted element.
+     * @return typename std::vector<T, Allocator>::iterator Iterator pointing to the first inserted element.
      */
-    typename std::vector<T>::iterator insert(typename std::vector<T>::const_iterator pos, size_t count, const T &value);
+    typename std::vector<T, Allocator>::iterator insert(typename std::vector<T, Allocator>::const_iterator pos, size_t count, const T &value);
 
     /**
      * @brief Inserts elements from a range [first, last) before the element at the specified position.
@@ -512,7 +731,7 @@ public:
      * @return Iterator pointing to the first element inserted, or @p pos if `first==last`.
      */
     template <typename InputIt>
-    typename std::vector<T>::iterator insert(typename std::vector<T>::const_iterator pos, InputIt first, InputIt last);
+    typename std::vector<T, Allocator>::iterator insert(typename std::vector<T, Allocator>::const_iterator pos, InputIt first, InputIt last);
 
     /**
      * @brief Inserts elements from an initializer list before the element at the specified position.
@@ -522,7 +741,7 @@ public:
      *
      * @return Iterator pointing to the first element inserted, or @p pos if `ilist` is empty.
      */
-    typename std::vector<T>::iterator insert(typename std::vector<T>::const_iterator pos, std::initializer_list<T> ilist);
+    typename std::vector<T, Allocator>::iterator insert(typename std::vector<T, Allocator>::const_iterator pos, std::initializer_list<T> ilist);
 
     /**
      * @brief Removes the element at the specified position.
@@ -531,7 +750,7 @@ public:
      *
      * @return Iterator following the last removed element. If @p pos refers to the last element, then the end() iterator is returned.
      */
-    typename std::vector<T>::iterator erase(typename std::vector<T>::const_iterator pos);
+    typename std::vector<T, Allocator>::iterator erase(typename std::vector<T, Allocator>::const_iterator pos);
 
     /**
      * @brief Removes elements in the range [first, last).
@@ -541,7 +760,7 @@ public:
      *
      * @return Iterator following the last removed element. If the @p last iterator refers to the last element, then the end() iterator is returned.
      */
-    typename std::vector<T>::iterator erase(typename std::vector<T>::const_iterator first, typename std::vector<T>::const_iterator last);
+    typename std::vector<T, Allocator>::iterator erase(typename std::vector<T, Allocator>::const_iterator first, typename std::vector<T, Allocator>::const_iterator last);
 
     /**
      * @brief Exchanges the contents of this vector with the contents of `other`.
@@ -555,7 +774,7 @@ public:
      *
      * @param other The vector to swap with.
      */
-    void swap(std::vector<T> &other) noexcept;
+    void swap(std::vector<T, Allocator> &other) noexcept;
 
     /**
      * @brief Removes all elements from the vector, leaving the size zero and the capacity unchanged.
@@ -580,7 +799,7 @@ public:
      * @return Iterator pointing to the newly inserted element.
      */
     template <typename... Args>
-    void emplace(typename std::vector<T>::iterator pos, Args &&...args);
+    void emplace(typename std::vector<T, Allocator>::iterator pos, Args &&...args);
 
     /**
      * @brief Inserts an element to the container by constructing it in-place at a given position.
@@ -591,7 +810,7 @@ public:
      * @return Iterator pointing to the newly inserted element.
      */
     template <typename... Args>
-    typename std::vector<T>::iterator emplace(typename std::vector<T>::const_iterator pos, Args &&...args);
+    typename std::vector<T, Allocator>::iterator emplace(typename std::vector<T, Allocator>::const_iterator pos, Args &&...args);
 
     /**
      * @brief Inserts an element to the container by constructing it in-place at a given position.
@@ -603,10 +822,28 @@ public:
      * @return Iterator pointing to the newly inserted element.
      */
     template <typename... Args>
-    typename std::vector<T>::iterator emplace(typename std::vector<T>::const_iterator pos, std::initializer_list<T> ilist, Args &&...args);
+    typename std::vector<T, Allocator>::iterator emplace(typename std::vector<T, Allocator>::const_iterator pos, std::initializer_list<T> ilist, Args &&...args);
 
 private:
-    std::vector<T> data_;
+    std::vector<T, Allocator> data_;
 };
 
+/**
+ * @brief Zips two ChVector objects into a lazy view of pairs of corresponding elements
+ *
+ * The elements are not copied. The view converts to ChVector<std::pair<T, U>> when it is assigned to one, or when
+ * `collect()` is called.
+ *
+ * @tparam T Type of the elements in the first ChVector
+ * @tparam U Type of the elements in the second ChVector
+ * @tparam AllocatorT Allocator of the first ChVector
+ * @tparam AllocatorU Allocator of the second ChVector
+ * @param vec1 First ChVector object
+ * @param vec2 Second ChVector object
+ * @return A view of pairs of references to the elements of both vectors
+ * @throws std::out_of_range if the vectors are of different sizes
+ */
+template <typename T, typename U, typename AllocatorT, typename AllocatorU>
+ChZipView<ChSpanView<T>, ChSpanView<U>> zip(const ChVector<T, AllocatorT> &vec1, const ChVector<U, AllocatorU> &vec2);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,429 @@
+#ifndef CHVECTORALGORITHMS
+#define CHVECTORALGORITHMS
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ChExecutionPolicy.h"
+#include "ChThreadPool.h"
+#include "ChVectorKernels.h"
+
+/**
+ * @brief Building blocks shared by the ChVector algorithms. Not part of the public interface.
+ */
+namespace ChVectorAlgorithms
+{
+    // Below this size std::sort beats the fixed cost of the radix passes
+    const size_t minRadixSortSize = 256;
+
+    // Inputs smaller than this are processed on the calling thread whatever the execution policy
+    const size_t minParallelSize = 1 << 15;
+
+    // Chunks smaller than this do not pay for their hand-off to the thread pool
+    const size_t minChunkSize = 1 << 13;
+
+    // Up to this size duplicates are found by comparing every pair, which is cheaper than building a hash table
+    const size_t maxQuadraticDeduplicationSize = 32;
+
+    // Deterministic reductions sum blocks of this many elements and then add the block sums in order, so the result
+    // does not depend on the execution policy or the number of threads
+    const size_t deterministicBlockSize = 1 << 12;
+
+    /**
+     * @brief Returns the number of chunks to split `size` elements into under `policy`.
+     *
+     * Parallel policies use a few chunks per thread so that uneven chunks balance out.
+     */
+    inline size_t chunkCount(size_t size, ChExecutionPolicy policy)
+    {
+        if (policy == ChExecutionPolicy::Sequential || size < minParallelSize)
+        {
+            return 1;
+        }
+        return std::max<size_t>(1, std::min(ChThreadPool::global().threadCount() * 4, size / minChunkSize));
+    }
+
+    /**
+     * @brief Returns the number of chunks to split `size` elements into under `policy` when every chunk writes its own
+     * elements of a std::vector<T>, or results of type T.
+     *
+     * std::vector<bool> packs its elements into shared words, and chunk boundaries do not fall on word boundaries,
+     * so writes to it always run as a single chunk.
+     */
+    template <typename T>
+    size_t writeChunkCount(size_t size, ChExecutionPolicy policy)
+    {
+        return std::is_same<T, bool>::value ? 1 : chunkCount(size, policy);
+    }
+
+    /**
+     * @brief Returns the first element index of chunk `chunk` when `size` elements are split into `chunks` chunks.
+     */
+    inline size_t chunkBegin(size_t size, size_t chunks, size_t chunk)
+    {
+        return static_cast<size_t>(static_cast<unsigned long long>(size) * chunk / chunks);
+    }
+
+    /**
+     * @brief Calls `body(chunk, begin, end)` for each of `chunks` chunks of [0, size), on the thread pool if there is
+     * more than one chunk.
+     */
+    template <typename Body>
+    void forEachChunk(size_t size, size_t chunks, Body body)
+    {
+        if (chunks <= 1)
+        {
+            body(0, 0, size);
+            return;
+        }
+        ChThreadPool::global().run(chunks, [&](size_t chunk)
+        {
+            body(chunk, chunkBegin(size, chunks, chunk), chunkBegin(size, chunks, chunk + 1));
+        });
+    }
+
+    /**
+     * @brief Sums `size` values from left to right. Every value is converted to U before it is added, so a wider U
+     * does not overflow where T would.
+     */
+    template <typename U, typename T>
+    U sumRange(const T *data, size_t size)
+    {
+        U result = U();
+        for (size_t i = 0; i < size; ++i)
+        {
+            result += static_cast<U>(data[i]);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Sums `size` arithmetic values into eight interleaved accumulators, which the compiler can keep in vector
+     * registers. The accumulators have the type U. Floating-point results may differ from `sumRange` in the last bits.
+     */
+    template <typename U, typename T>
+    U sumRangeVectorized(const T *data, size_t size)
+    {
+        U lanes[8] = {};
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            for (size_t lane = 0; lane < 8; ++lane)
+            {
+                lanes[lane] += static_cast<U>(data[i + lane]);
+            }
+        }
+
+        U result = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+        for (; i < size; ++i)
+        {
+            result += static_cast<U>(data[i]);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Sums `size` values with Kahan compensation, converted to and accumulated in U.
+     */
+    template <typename U, typename T>
+    U sumKahan(const T *data, size_t size)
+    {
+        U result = U();
+        U compensation = U();
+        for (size_t i = 0; i < size; ++i)
+        {
+            U corrected = static_cast<U>(data[i]) - compensation;
+            U next = result + corrected;
+            compensation = (next - result) - corrected;
+            result = next;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Sums `size` values by recursively halving the range, converted to and accumulated in U.
+     */
+    template <typename U, typename T>
+    U sumPairwise(const T *data, size_t size)
+    {
+        if (size <= 256)
+        {
+            return sumRange<U>(data, size);
+        }
+        size_t half = size / 2;
+        return sumPairwise<U>(data, half) + sumPairwise<U>(data + half, size - half);
+    }
+
+    /**
+     * @brief Returns the index of the first value equal to `value`, or `size`. Uses the vector kernels if T has them.
+     */
+    template <typename T>
+    size_t indexOf(const T *data, size_t size, const T &value)
+    {
+        if constexpr (ChVectorKernels::HasKernels<T>::value)
+        {
+            return ChVectorKernels::indexOf(data, size, value);
+        }
+        else
+        {
+            return std::find(data, data + size, value) - data;
+        }
+    }
+
+    /**
+     * @brief Returns the number of values equal to `value`. Uses the vector kernels if T has them.
+     */
+    template <typename T>
+    size_t count(const T *data, size_t size, const T &value)
+    {
+        if constexpr (ChVectorKernels::HasKernels<T>::value)
+        {
+            return ChVectorKernels::count(data, size, value);
+        }
+        else
+        {
+            return std::count(data, data + size, value);
+        }
+    }
+
+    /**
+     * @brief Spreads a hash value over all bits and returns its top `bits` bits (Fibonacci hashing).
+     *
+     * std::hash is the identity for integers on common implementations, so the raw value makes a poor table index.
+     */
+    inline size_t tableIndex(size_t hash, unsigned bits)
+    {
+        return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+    }
+
+    /**
+     * @brief Returns the number of bits of the smallest power of two table that keeps `size` entries at most half full.
+     */
+    inline unsigned tableBits(size_t size)
+    {
+        unsigned bits = 1;
+        while ((static_cast<size_t>(1) << bits) < size * 2)
+        {
+            ++bits;
+        }
+        return bits;
+    }
+
+    /**
+     * @brief Maps an integral value to an unsigned key with the same ordering.
+     */
+    template <typename T>
+    inline typename std::make_unsigned<T>::type radixKey(T value)
+    {
+        using Key = typename std::make_unsigned<T>::type;
+        Key key = static_cast<Key>(value);
+        if (std::is_signed<T>::value)
+        {
+            key ^= static_cast<Key>(static_cast<Key>(1) << (sizeof(T) * CHAR_BIT - 1));
+        }
+        return key;
+    }
+
+    /**
+     * @brief Sorts `size` integral values in ascending order with an LSD radix sort over bytes.
+     *
+     * Passes in which every value has the same byte are skipped, so narrow value ranges cost fewer passes.
+     */
+    template <typename T>
+    void radixSort(T *data, size_t size)
+    {
+        static_assert(std::is_integral<T>::value, "radixSort requires an integral type");
+
+        if (size < minRadixSortSize)
+        {
+            std::sort(data, data + size);
+            return;
+        }
+
+        std::vector<T> scratch(size);
+        T *source = data;
+        T *target = scratch.data();
+        for (unsigned shift = 0; shift < sizeof(T) * CHAR_BIT; shift += 8)
+        {
+            size_t counts[256] = {};
+            for (size_t i = 0; i < size; ++i)
+            {
+                ++counts[(radixKey(source[i]) >> shift) & 0xFF];
+            }
+            if (counts[(radixKey(source[0]) >> shift) & 0xFF] == size)
+            {
+                continue;
+            }
+
+            size_t offset = 0;
+            for (size_t &count : counts)
+            {
+                size_t next = offset + count;
+                count = offset;
+                offset = next;
+            }
+            for (size_t i = 0; i < size; ++i)
+            {
+                target[counts[(radixKey(source[i]) >> shift) & 0xFF]++] = source[i];
+            }
+            std::swap(source, target);
+        }
+
+        if (source != data)
+        {
+            std::copy(source, source + size, data);
+        }
+    }
+
+    /**
+     * @brief Moves `size` elements from `source` into the uninitialized memory at `target`, or copies them if moving
+     * could throw and copying is possible, so that the source stays intact if an element fails.
+     */
+    template <typename T>
+    void relocate(T *source, size_t size, T *target)
+    {
+        if constexpr (std::is_nothrow_move_constructible<T>::value || !std::is_copy_constructible<T>::value)
+        {
+            std::uninitialized_move(source, source + size, target);
+        }
+        else
+        {
+            std::uninitialized_copy(source, source + size, target);
+        }
+    }
+
+    /**
+     * @brief Moves the elements of `data` that are kept to the front and returns how many are kept.
+     *
+     * `keep(i, kept)` decides whether element `i` is kept, given that elements [0, kept) are the ones kept so far.
+     */
+    template <typename T, typename Keep>
+    size_t compactKept(T *data, size_t size, Keep keep)
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (keep(i, kept))
+            {
+                if (kept != i)
+                {
+                    data[kept] = std::move(data[i]);
+                }
+                ++kept;
+            }
+        }
+        return kept;
+    }
+
+    /**
+     * @brief Hash based implementation of `removeDuplicates`. `Index` must be able to hold `size`.
+     */
+    template <typename Index, typename T>
+    size_t removeDuplicatesHashed(T *data, size_t size)
+    {
+        // The table holds the positions of the kept elements. Kept elements are compacted towards the front as the
+        // scan proceeds, so a position never refers to an element that has been moved away.
+        const Index empty = std::numeric_limits<Index>::max();
+        const unsigned bits = tableBits(size);
+        const size_t mask = (static_cast<size_t>(1) << bits) - 1;
+        std::vector<Index> slots(mask + 1, empty);
+        std::hash<T> hasher;
+
+        return compactKept(data, size, [&](size_t i, size_t kept)
+        {
+            size_t slot = tableIndex(hasher(data[i]), bits);
+            while (slots[slot] != empty && !(data[slots[slot]] == data[i]))
+            {
+                slot = (slot + 1) & mask;
+            }
+            if (slots[slot] != empty)
+            {
+                return false;
+            }
+            slots[slot] = static_cast<Index>(kept);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Comparison based implementation of `removeDuplicates` for types without std::hash.
+     */
+    template <typename T>
+    size_t removeDuplicatesStable(T *data, size_t size)
+    {
+        std::vector<size_t> order(size);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [data](size_t a, size_t b) { return data[a] < data[b]; });
+
+        // The first index of every run of equal values is the occurrence to keep
+        std::vector<bool> keep(size, false);
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            keep[order[i]] = i == 0 || data[order[i - 1]] < data[order[i]];
+        }
+
+        return compactKept(data, size, [&](size_t i, size_t) { return keep[i]; });
+    }
+
+    /**
+     * @brief Removes repeated values from `data`, keeping the first occurrence of each in order. The elements past
+     * the returned count are left in a valid but unspecified state.
+     *
+     * @return The number of elements kept.
+     */
+    template <typename T>
+    size_t removeDuplicates(T *data, size_t size)
+    {
+        if (size <= maxQuadraticDeduplicationSize)
+        {
+            return compactKept(data, size, [data](size_t i, size_t kept)
+            {
+                return std::find(data, data + kept, data[i]) == data + kept;
+            });
+        }
+
+        // Disabled std::hash specializations are not default constructible
+        if constexpr (std::is_default_constructible<std::hash<T>>::value)
+        {
+            if (size <= std::numeric_limits<uint32_t>::max() / 2)
+            {
+                return removeDuplicatesHashed<uint32_t>(data, size);
+            }
+            return removeDuplicatesHashed<size_t>(data, size);
+        }
+        else
+        {
+            return removeDuplicatesStable(data, size);
+        }
+    }
+
+    /**
+     * @brief Sorts `data` in ascending order and moves one element of every value to the front.
+     *
+     * @return The number of distinct values.
+     */
+    template <typename T>
+    size_t sortUnique(T *data, size_t size)
+    {
+        if constexpr (std::is_integral<T>::value && !std::is_same<T, bool>::value)
+        {
+            radixSort(data, size);
+        }
+        else
+        {
+            std::sort(data, data + size);
+        }
+        return std::unique(data, data + size) - data;
+    }
+}
+
+#endif
\ No newline at end of file
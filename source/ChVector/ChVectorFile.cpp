@@ -0,0 +1,376 @@
+#include "ChVectorFile.h"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <cstdio>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char magic[8] = {'C', 'H', 'V', 'E', 'C', 'T', 'O', 'R'};
+    const uint32_t byteOrderMark = 0x01020304;
+
+    // The fixed-size header at the start of every file
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint64_t typeTag;
+        uint64_t count;
+        uint32_t elementSize;
+        uint32_t alignment;
+        uint64_t dataOffset;
+        uint64_t checksum;
+        uint32_t byteOrder;
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(Header) == 64, "The file header must stay 64 bytes");
+
+    const uint64_t prime1 = 0x9E3779B185EBCA87;
+    const uint64_t prime2 = 0xC2B2AE3D27D4EB4F;
+    const uint64_t prime3 = 0x165667B19E3779F9;
+
+    uint64_t rotateLeft(uint64_t value, unsigned bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    uint64_t load64(const unsigned char *bytes)
+    {
+        uint64_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    uint64_t mix(uint64_t lane, uint64_t word)
+    {
+        return rotateLeft(lane + word * prime2, 31) * prime1;
+    }
+
+    size_t dataOffset(size_t alignment)
+    {
+        return (sizeof(Header) + alignment - 1) / alignment * alignment;
+    }
+
+    // Returns the error of the last failed system call. It must be read before any cleanup calls.
+    std::error_code lastError()
+    {
+#if defined(_WIN32)
+        return std::error_code(static_cast<int>(GetLastError()), std::system_category());
+#else
+        return std::error_code(errno, std::generic_category());
+#endif
+    }
+
+#if !defined(_WIN32)
+    // Writes every byte of the buffers, continuing after partial writes and interruptions
+    void writeAll(int file, iovec *buffers, int bufferCount)
+    {
+        while (bufferCount > 0)
+        {
+            ssize_t written = ::writev(file, buffers, bufferCount);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw std::system_error(lastError(), "ChVectorFile cannot write");
+            }
+
+            size_t remaining = static_cast<size_t>(written);
+            while (bufferCount > 0 && remaining >= buffers->iov_len)
+            {
+                remaining -= buffers->iov_len;
+                ++buffers;
+                --bufferCount;
+            }
+            if (bufferCount > 0)
+            {
+                buffers->iov_base = static_cast<char *>(buffers->iov_base) + remaining;
+                buffers->iov_len -= remaining;
+            }
+        }
+    }
+#endif
+}
+
+ChFileMapping::ChFileMapping() noexcept : data_(nullptr), size_(0) {}
+
+ChFileMapping::ChFileMapping(const std::string &path) : data_(nullptr), size_(0)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw std::system_error(lastError(), "ChFileMapping cannot open " + path);
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        std::error_code error = lastError();
+        CloseHandle(file);
+        throw std::system_error(error, "ChFileMapping cannot read the size of " + path);
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    if (size_ > 0)
+    {
+        // The view keeps the file mapped after both handles are closed
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void *view = mapping == nullptr ? nullptr : MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr)
+        {
+            std::error_code error = lastError();
+            if (mapping != nullptr)
+            {
+                CloseHandle(mapping);
+            }
+            CloseHandle(file);
+            throw std::system_error(error, "ChFileMapping cannot map " + path);
+        }
+        CloseHandle(mapping);
+        data_ = static_cast<const unsigned char *>(view);
+    }
+    CloseHandle(file);
+#else
+    int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+    {
+        throw std::system_error(lastError(), "ChFileMapping cannot open " + path);
+    }
+    struct stat status;
+    if (::fstat(file, &status) != 0)
+    {
+        std::error_code error = lastError();
+        ::close(file);
+        throw std::system_error(error, "ChFileMapping cannot read the size of " + path);
+    }
+    size_ = static_cast<size_t>(status.st_size);
+    if (size_ > 0)
+    {
+        // The mapping stays valid after the descriptor is closed
+        void *view = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+        if (view == MAP_FAILED)
+        {
+            std::error_code error = lastError();
+            ::close(file);
+            throw std::system_error(error, "ChFileMapping cannot map " + path);
+        }
+        data_ = static_cast<const unsigned char *>(view);
+    }
+    ::close(file);
+#endif
+}
+
+ChFileMapping::ChFileMapping(ChFileMapping &&other) noexcept : data_(other.data_), size_(other.size_)
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+ChFileMapping &ChFileMapping::operator=(ChFileMapping &&other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+        data_ = other.data_;
+        size_ = other.size_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+ChFileMapping::~ChFileMapping()
+{
+    unmap();
+}
+
+const unsigned char *ChFileMapping::data() const noexcept
+{
+    return data_;
+}
+
+size_t ChFileMapping::size() const noexcept
+{
+    return size_;
+}
+
+void ChFileMapping::unmap() noexcept
+{
+    if (data_ != nullptr)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(data_);
+#else
+        ::munmap(const_cast<unsigned char *>(data_), size_);
+#endif
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+uint64_t ChVectorFile::checksum(const void *data, size_t size)
+{
+    // Four independent lanes of 8 bytes each keep several multiplications in flight, so the checksum runs at memory
+    // speed rather than at one byte per step
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    uint64_t lanes[4] = {prime1 + prime2, prime2, 0, 0 - prime1};
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        lanes[0] = mix(lanes[0], load64(bytes + i));
+        lanes[1] = mix(lanes[1], load64(bytes + i + 8));
+        lanes[2] = mix(lanes[2], load64(bytes + i + 16));
+        lanes[3] = mix(lanes[3], load64(bytes + i + 24));
+    }
+
+    uint64_t result = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) + rotateLeft(lanes[2], 12) + rotateLeft(lanes[3], 18);
+    result += static_cast<uint64_t>(size);
+    for (; i + 8 <= size; i += 8)
+    {
+        result = rotateLeft(result ^ mix(0, load64(bytes + i)), 27) * prime1 + prime3;
+    }
+    for (; i < size; ++i)
+    {
+        result = rotateLeft(result ^ (bytes[i] * prime3), 11) * prime1;
+    }
+
+    result ^= result >> 33;
+    result *= prime2;
+    result ^= result >> 29;
+    result *= prime3;
+    result ^= result >> 32;
+    return result;
+}
+
+uint64_t ChVectorFile::typeTag(const char *name, size_t size, size_t alignment)
+{
+    uint64_t result = checksum(name, std::strlen(name));
+    result = mix(result, size);
+    return mix(result, alignment);
+}
+
+void ChVectorFile::write(const std::string &path, uint64_t typeTag, size_t elementSize, size_t alignment, const void *data, size_t count)
+{
+    const size_t bytes = elementSize * count;
+    Header header = {};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.headerSize = sizeof(Header);
+    header.typeTag = typeTag;
+    header.count = count;
+    header.elementSize = static_cast<uint32_t>(elementSize);
+    header.alignment = static_cast<uint32_t>(alignment);
+    header.dataOffset = dataOffset(alignment);
+    header.checksum = checksum(data, bytes);
+    header.byteOrder = byteOrderMark;
+
+    static const unsigned char padding[maxAlignment] = {};
+    const size_t paddingSize = header.dataOffset - sizeof(Header);
+    const std::string temporary = path + ".tmp";
+
+#if defined(_WIN32)
+    std::FILE *file = std::fopen(temporary.c_str(), "wb");
+    if (file == nullptr)
+    {
+        throw std::system_error(errno, std::generic_category(), "ChVectorFile cannot create " + temporary);
+    }
+    bool written = std::fwrite(&header, sizeof(Header), 1, file) == 1 && std::fwrite(padding, 1, paddingSize, file) == paddingSize && std::fwrite(data, 1, bytes, file) == bytes;
+    if (std::fclose(file) != 0 || !written)
+    {
+        std::error_code error(errno, std::generic_category());
+        std::remove(temporary.c_str());
+        throw std::system_error(error, "ChVectorFile cannot write " + temporary);
+    }
+#else
+    int file = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (file < 0)
+    {
+        throw std::system_error(lastError(), "ChVectorFile cannot create " + temporary);
+    }
+    iovec buffers[3] = {
+        {&header, sizeof(Header)},
+        {const_cast<unsigned char *>(padding), paddingSize},
+        {const_cast<void *>(data), bytes}};
+    try
+    {
+        writeAll(file, buffers, 3);
+    }
+    catch (...)
+    {
+        ::close(file);
+        ::unlink(temporary.c_str());
+        throw;
+    }
+    if (::close(file) != 0)
+    {
+        std::error_code error = lastError();
+        ::unlink(temporary.c_str());
+        throw std::system_error(error, "ChVectorFile cannot write " + temporary);
+    }
+#endif
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error)
+    {
+        std::error_code ignored;
+        std::filesystem::remove(temporary, ignored);
+        throw std::system_error(error, "ChVectorFile cannot replace " + path);
+    }
+}
+
+const void *ChVectorFile::open(const ChFileMapping &mapping, uint64_t typeTag, size_t elementSize, size_t alignment, bool verify, size_t &count)
+{
+    Header header;
+    if (mapping.size() < sizeof(Header))
+    {
+        throw std::runtime_error("ChVectorFile is too short for a header");
+    }
+    std::memcpy(&header, mapping.data(), sizeof(Header));
+
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0)
+    {
+        throw std::runtime_error("ChVectorFile has no ChVectorFile header");
+    }
+    if (header.byteOrder != byteOrderMark)
+    {
+        throw std::runtime_error("ChVectorFile was written with a different byte order");
+    }
+    if (header.version != version || header.headerSize != sizeof(Header))
+    {
+        throw std::runtime_error("ChVectorFile has unsupported version " + std::to_string(header.version));
+    }
+    if (header.typeTag != typeTag || header.elementSize != elementSize || header.alignment != alignment)
+    {
+        throw std::runtime_error("ChVectorFile holds elements of a different type");
+    }
+    if (header.dataOffset != dataOffset(alignment) || header.dataOffset > mapping.size() || header.count > (mapping.size() - header.dataOffset) / elementSize)
+    {
+        throw std::runtime_error("ChVectorFile is truncated");
+    }
+
+    const unsigned char *elements = mapping.data() + header.dataOffset;
+    if (verify && checksum(elements, header.count * elementSize) != header.checksum)
+    {
+        throw std::runtime_error("ChVectorFile fails its checksum");
+    }
+    count = static_cast<size_t>(header.count);
+    return elements;
+}
\ No newline at end of file
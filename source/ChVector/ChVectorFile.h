@@ -0,0 +1,368 @@
+#ifndef CHVECTORFILE
+#define CHVECTORFILE
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+
+#include "ChVector.h"
+#include "ChVectorAlgorithms.h"
+#include "ChView.h"
+
+/**
+ * @brief A read-only memory mapping of a whole file.
+ *
+ * The mapping is released when the object is destroyed. It is movable but not copyable.
+ */
+class ChFileMapping
+{
+public:
+    /**
+     * @brief Constructs an empty mapping.
+     */
+    ChFileMapping() noexcept;
+
+    /**
+     * @brief Maps the file at `path` for reading.
+     *
+     * @param path The path of the file.
+     * @throws std::system_error if the file cannot be opened or mapped.
+     */
+    explicit ChFileMapping(const std::string &path);
+
+    ChFileMapping(ChFileMapping &&other) noexcept;
+
+    ChFileMapping &operator=(ChFileMapping &&other) noexcept;
+
+    ChFileMapping(const ChFileMapping &) = delete;
+
+    ChFileMapping &operator=(const ChFileMapping &) = delete;
+
+    /**
+     * @brief Destructor. Unmaps the file.
+     */
+    ~ChFileMapping();
+
+    /**
+     * @brief Returns the first byte of the file, or nullptr for an empty mapping.
+     */
+    const unsigned char *data() const noexcept;
+
+    /**
+     * @brief Returns the size of the file in bytes.
+     */
+    size_t size() const noexcept;
+
+private:
+    void unmap() noexcept;
+
+    const unsigned char *data_;
+    size_t size_;
+};
+
+/**
+ * @brief Identifies the element type of a ChVector file.
+ *
+ * The default tag is derived from the compiler's name for T and from its size and alignment, so a file written by a
+ * program built with one compiler may be rejected by a program built with another. Specialize this template with a
+ * fixed `tag()` for types whose files are shared between builds:
+ *
+ * @code
+ * template <>
+ * struct ChVectorFileType<Sample>
+ * {
+ *     static uint64_t tag() { return 0x53414d504c450001; }
+ * };
+ * @endcode
+ *
+ * @tparam T The element type.
+ */
+template <typename T>
+struct ChVectorFileType
+{
+    static uint64_t tag();
+};
+
+/**
+ * @brief Binary snapshots of vectors of trivially copyable elements.
+ *
+ * A file is a 64 byte header followed by the raw bytes of the elements, which start at an offset that is a multiple
+ * of the alignment of the element type. The header holds a format version, the type tag of the elements
+ * (see ChVectorFileType), the element count, size and alignment, and a checksum of the element bytes. Files use the
+ * byte order of the machine that wrote them; a file of the other byte order is rejected.
+ *
+ * `save` writes the header and the elements with one vectored write, without touching the elements one by one.
+ * `map` maps the file into memory and returns a read-only vector over the mapped elements, so nothing is copied and
+ * pages are only read from disk when they are first accessed:
+ *
+ * @code
+ * ChVectorFile::save("prices.bin", prices);
+ * ChMappedVector<double> mapped = ChVectorFile::map<double>("prices.bin");
+ * double total = mapped.sum();
+ * @endcode
+ */
+namespace ChVectorFile
+{
+    /**
+     * @brief The version of the format written by this library.
+     */
+    const uint32_t version = 1;
+
+    /**
+     * @brief The largest element alignment a file can store.
+     */
+    const size_t maxAlignment = 4096;
+
+    /**
+     * @brief Returns a 64-bit checksum of `size` bytes at `data`.
+     */
+    uint64_t checksum(const void *data, size_t size);
+
+    /**
+     * @brief Returns a type tag made from a type name, size and alignment.
+     */
+    uint64_t typeTag(const char *name, size_t size, size_t alignment);
+
+    /**
+     * @brief Writes a file of `count` elements of `elementSize` bytes at `data`. Not part of the public interface;
+     * use `save`.
+     */
+    void write(const std::string &path, uint64_t typeTag, size_t elementSize, size_t alignment, const void *data, size_t count);
+
+    /**
+     * @brief Checks the header of a mapped file and returns the first element and the element count. Not part of the
+     * public interface; use `map`.
+     */
+    const void *open(const ChFileMapping &mapping, uint64_t typeTag, size_t elementSize, size_t alignment, bool verify, size_t &count);
+
+    /**
+     * @brief Writes the `count` elements at `data` to the file at `path`.
+     *
+     * The file is written under a temporary name next to `path` and then renamed over it, so readers that still map
+     * the previous file keep seeing it intact. The data is not flushed to stable storage.
+     *
+     * @param path The path of the file.
+     * @param data The first element.
+     * @param count The number of elements.
+     * @throws std::system_error if the file cannot be written.
+     */
+    template <typename T>
+    void save(const std::string &path, const T *data, size_t count)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "ChVectorFile stores trivially copyable elements only");
+        static_assert(alignof(T) <= maxAlignment, "ChVectorFile does not support this alignment");
+        write(path, ChVectorFileType<T>::tag(), sizeof(T), alignof(T), data, count);
+    }
+
+    /**
+     * @brief Writes the elements of `vector` to the file at `path`. See `save(path, data, count)`.
+     */
+    template <typename T, typename Allocator>
+    void save(const std::string &path, const ChVector<T, Allocator> &vector)
+    {
+        save(path, vector.data(), vector.size());
+    }
+}
+
+/**
+ * @brief A read-only vector over the elements of a memory-mapped ChVectorFile.
+ *
+ * The elements are used in place: nothing is copied, and the file stays mapped until the ChMappedVector is destroyed.
+ * It offers the read-only part of the ChVector interface and `view()` for everything else.
+ *
+ * @tparam T The element type. It must match the type the file was saved with.
+ */
+template <typename T>
+class ChMappedVector
+{
+public:
+    using value_type = T;
+    using const_iterator = const T *;
+    using iterator = const T *;
+
+    /**
+     * @brief Constructs an empty vector.
+     */
+    ChMappedVector() : data_(nullptr), size_(0) {}
+
+    /**
+     * @brief Maps the file at `path`.
+     *
+     * @param path The path of the file.
+     * @param verify Whether to compare the checksum of the elements with the header. This reads the whole file.
+     * @throws std::system_error if the file cannot be mapped, std::runtime_error if it is not a ChVectorFile of T or
+     * fails the checksum.
+     */
+    explicit ChMappedVector(const std::string &path, bool verify = true) : mapping_(path), size_(0)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "ChVectorFile stores trivially copyable elements only");
+        data_ = static_cast<const T *>(ChVectorFile::open(mapping_, ChVectorFileType<T>::tag(), sizeof(T), alignof(T), verify, size_));
+    }
+
+    /**
+     * @brief Returns a pointer to the first element.
+     */
+    const T *data() const noexcept
+    {
+        return data_;
+    }
+
+    /**
+     * @brief Returns the number of elements.
+     */
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Checks whether the vector is empty.
+     */
+    bool isEmpty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    const T *begin() const noexcept
+    {
+        return data_;
+    }
+
+    const T *end() const noexcept
+    {
+        return data_ + size_;
+    }
+
+    const T *cbegin() const noexcept
+    {
+        return data_;
+    }
+
+    const T *cend() const noexcept
+    {
+        return data_ + size_;
+    }
+
+    /**
+     * @brief Returns the element at `index`. No bounds checking is performed.
+     */
+    const T &operator[](size_t index) const
+    {
+        return data_[index];
+    }
+
+    /**
+     * @brief Returns the element at `index`.
+     *
+     * @throws std::out_of_range if `index` is not less than the size.
+     */
+    const T &at(size_t index) const
+    {
+        if (index >= size_)
+        {
+            throw std::out_of_range("ChMappedVector index out of range");
+        }
+        return data_[index];
+    }
+
+    const T &front() const
+    {
+        return data_[0];
+    }
+
+    const T &back() const
+    {
+        return data_[size_ - 1];
+    }
+
+    /**
+     * @brief Returns the index of the first element equal to `value`, or -1 if there is none.
+     */
+    int indexOf(const T &value) const
+    {
+        const size_t index = ChVectorAlgorithms::indexOf(data_, size_, value);
+        return index == size_ ? -1 : static_cast<int>(index);
+    }
+
+    /**
+     * @brief Checks whether the vector contains an element equal to `value`.
+     */
+    bool contains(const T &value) const
+    {
+        return indexOf(value) != -1;
+    }
+
+    /**
+     * @brief Returns the sum of the elements.
+     */
+    template <typename U = T>
+    typename std::enable_if<std::is_arithmetic<U>::value, U>::type sum() const
+    {
+        if constexpr (ChVectorKernels::HasKernels<U>::value && std::is_same<U, T>::value)
+        {
+            return ChVectorKernels::sum(data_, size_);
+        }
+        else
+        {
+            return ChVectorAlgorithms::sumRangeVectorized<U>(data_, size_);
+        }
+    }
+
+    /**
+     * @brief Returns a lazy view of the elements.
+     */
+    ChSpanView<T> view() const
+    {
+        return ChSpanView<T>(data_, data_ + size_);
+    }
+
+    /**
+     * @brief Copies the elements into a ChVector.
+     */
+    ChVector<T> toVector() const
+    {
+        ChVector<T> result;
+        result.assign(begin(), end());
+        return result;
+    }
+
+private:
+    ChFileMapping mapping_;
+    const T *data_;
+    size_t size_;
+};
+
+template <typename T>
+uint64_t ChVectorFileType<T>::tag()
+{
+    return ChVectorFile::typeTag(typeid(T).name(), sizeof(T), alignof(T));
+}
+
+namespace ChVectorFile
+{
+    /**
+     * @brief Maps the file at `path` and returns a read-only vector over its elements. See ChMappedVector.
+     */
+    template <typename T>
+    ChMappedVector<T> map(const std::string &path, bool verify = true)
+    {
+        return ChMappedVector<T>(path, verify);
+    }
+
+    /**
+     * @brief Reads the elements of the file at `path` into a ChVector.
+     *
+     * @throws std::system_error if the file cannot be read, std::runtime_error if it is not a ChVectorFile of T or
+     * fails the checksum.
+     */
+    template <typename T>
+    ChVector<T> load(const std::string &path)
+    {
+        return ChMappedVector<T>(path, true).toVector();
+    }
+}
+
+#endif
\ No newline at end of file
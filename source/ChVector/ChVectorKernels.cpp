@@ -0,0 +1,670 @@
+#include "ChVectorKernels.h"
+#include "ChBits.h"
+#include "ChCpuFeatures.h"
+
+#include <limits>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CHVECTOR_USE_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // Ranges up to this size are summed directly by the pairwise summation
+    const size_t pairwiseBlockSize = 256;
+
+    template <typename T>
+    struct Kernels
+    {
+        T (*sum)(const T *, size_t);
+        T (*sumKahan)(const T *, size_t);
+        T (*dot)(const T *, const T *, size_t);
+        size_t (*indexOf)(const T *, size_t, T);
+        size_t (*lastIndexOf)(const T *, size_t, T);
+        size_t (*count)(const T *, size_t, T);
+        T (*minimum)(const T *, size_t);
+        T (*maximum)(const T *, size_t);
+    };
+
+    /**
+     * @brief Starting value of a minimum search; every value except NaN compares less or equal.
+     */
+    template <typename T>
+    inline T minimumIdentity()
+    {
+        return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+    }
+
+    /**
+     * @brief Starting value of a maximum search; every value except NaN compares greater or equal.
+     */
+    template <typename T>
+    inline T maximumIdentity()
+    {
+        return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+    }
+
+    /**
+     * @brief Adds two values. Integers wrap around on overflow, as they do in the vector lanes.
+     */
+    template <typename T>
+    inline T wrappingAdd(T a, T b)
+    {
+        if constexpr (std::is_integral<T>::value)
+        {
+            using Unsigned = typename std::make_unsigned<T>::type;
+            return static_cast<T>(static_cast<Unsigned>(a) + static_cast<Unsigned>(b));
+        }
+        else
+        {
+            return a + b;
+        }
+    }
+
+    /**
+     * @brief Multiplies two values. Integers wrap around on overflow, as they do in the vector lanes.
+     */
+    template <typename T>
+    inline T wrappingMul(T a, T b)
+    {
+        if constexpr (std::is_integral<T>::value)
+        {
+            using Unsigned = typename std::make_unsigned<T>::type;
+            return static_cast<T>(static_cast<Unsigned>(a) * static_cast<Unsigned>(b));
+        }
+        else
+        {
+            return a * b;
+        }
+    }
+
+    /**
+     * @brief Adds `value` to the compensated sum held in `sum` and `compensation`.
+     */
+    template <typename T>
+    inline void kahanAdd(T &sum, T &compensation, T value)
+    {
+        T corrected = value - compensation;
+        T next = sum + corrected;
+        compensation = (next - sum) - corrected;
+        sum = next;
+    }
+
+    template <typename T>
+    T sumScalar(const T *data, size_t size)
+    {
+        T result = T();
+        for (size_t i = 0; i < size; ++i)
+        {
+            result = wrappingAdd(result, data[i]);
+        }
+        return result;
+    }
+
+    template <typename T>
+    T sumKahanScalar(const T *data, size_t size)
+    {
+        T result = T();
+        T compensation = T();
+        for (size_t i = 0; i < size; ++i)
+        {
+            kahanAdd(result, compensation, data[i]);
+        }
+        return result;
+    }
+
+    template <typename T>
+    T dotScalar(const T *left, const T *right, size_t size)
+    {
+        T result = T();
+        for (size_t i = 0; i < size; ++i)
+        {
+            result = wrappingAdd(result, wrappingMul(left[i], right[i]));
+        }
+        return result;
+    }
+
+    template <typename T>
+    size_t indexOfScalar(const T *data, size_t size, T value)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (data[i] == value)
+            {
+                return i;
+            }
+        }
+        return size;
+    }
+
+    template <typename T>
+    size_t lastIndexOfScalar(const T *data, size_t size, T value)
+    {
+        for (size_t i = size; i > 0; --i)
+        {
+            if (data[i - 1] == value)
+            {
+                return i - 1;
+            }
+        }
+        return size;
+    }
+
+    template <typename T>
+    size_t countScalar(const T *data, size_t size, T value)
+    {
+        size_t result = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            result += data[i] == value ? 1 : 0;
+        }
+        return result;
+    }
+
+    template <typename T>
+    T minimumScalar(const T *data, size_t size)
+    {
+        T result = minimumIdentity<T>();
+        for (size_t i = 0; i < size; ++i)
+        {
+            result = data[i] < result ? data[i] : result;
+        }
+        return result;
+    }
+
+    template <typename T>
+    T maximumScalar(const T *data, size_t size)
+    {
+        T result = maximumIdentity<T>();
+        for (size_t i = 0; i < size; ++i)
+        {
+            result = data[i] > result ? data[i] : result;
+        }
+        return result;
+    }
+
+    template <typename T>
+    Kernels<T> scalarKernels()
+    {
+        Kernels<T> result;
+        result.sum = sumScalar<T>;
+        result.sumKahan = sumKahanScalar<T>;
+        result.dot = dotScalar<T>;
+        result.indexOf = indexOfScalar<T>;
+        result.lastIndexOf = lastIndexOfScalar<T>;
+        result.count = countScalar<T>;
+        result.minimum = minimumScalar<T>;
+        result.maximum = maximumScalar<T>;
+        return result;
+    }
+}
+
+#if defined(CHVECTOR_USE_SIMD_DISPATCH)
+
+// The kernels below are compiled for instruction sets the build does not assume; they only run after ChCpuFeatures
+// confirmed support. GCC and Clang need the instruction set enabled for the functions using its intrinsics, MSVC
+// accepts them anywhere.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace
+{
+    namespace Avx2
+    {
+        struct F32
+        {
+            using Scalar = float;
+            using Reg = __m256;
+            static constexpr size_t width = 8;
+
+            static Reg zero() { return _mm256_setzero_ps(); }
+            static Reg set1(float value) { return _mm256_set1_ps(value); }
+            static Reg load(const float *data) { return _mm256_loadu_ps(data); }
+            static void store(float *data, Reg reg) { _mm256_storeu_ps(data, reg); }
+            static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+            static Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+            static Reg minimum(Reg x, Reg acc) { return _mm256_min_ps(x, acc); }
+            static Reg maximum(Reg x, Reg acc) { return _mm256_max_ps(x, acc); }
+            static unsigned equalMask(Reg a, Reg b) { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ))); }
+        };
+
+        struct F64
+        {
+            using Scalar = double;
+            using Reg = __m256d;
+            static constexpr size_t width = 4;
+
+            static Reg zero() { return _mm256_setzero_pd(); }
+            static Reg set1(double value) { return _mm256_set1_pd(value); }
+            static Reg load(const double *data) { return _mm256_loadu_pd(data); }
+            static void store(double *data, Reg reg) { _mm256_storeu_pd(data, reg); }
+            static Reg add(Reg a, Reg b) { return _mm256_add_pd(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm256_sub_pd(a, b); }
+            static Reg mul(Reg a, Reg b) { return _mm256_mul_pd(a, b); }
+            static Reg minimum(Reg x, Reg acc) { return _mm256_min_pd(x, acc); }
+            static Reg maximum(Reg x, Reg acc) { return _mm256_max_pd(x, acc); }
+            static unsigned equalMask(Reg a, Reg b) { return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ))); }
+        };
+
+        struct I32
+        {
+            using Scalar = int32_t;
+            using Reg = __m256i;
+            static constexpr size_t width = 8;
+
+            static Reg zero() { return _mm256_setzero_si256(); }
+            static Reg set1(int32_t value) { return _mm256_set1_epi32(value); }
+            static Reg load(const int32_t *data) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)); }
+            static void store(int32_t *data, Reg reg) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(data), reg); }
+            static Reg add(Reg a, Reg b) { return _mm256_add_epi32(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm256_sub_epi32(a, b); }
+            static Reg mul(Reg a, Reg b) { return _mm256_mullo_epi32(a, b); }
+            static Reg minimum(Reg x, Reg acc) { return _mm256_min_epi32(x, acc); }
+            static Reg maximum(Reg x, Reg acc) { return _mm256_max_epi32(x, acc); }
+            static unsigned equalMask(Reg a, Reg b) { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)))); }
+        };
+
+        struct I64
+        {
+            using Scalar = int64_t;
+            using Reg = __m256i;
+            static constexpr size_t width = 4;
+
+            static Reg zero() { return _mm256_setzero_si256(); }
+            static Reg set1(int64_t value) { return _mm256_set1_epi64x(value); }
+            static Reg load(const int64_t *data) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)); }
+            static void store(int64_t *data, Reg reg) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(data), reg); }
+            static Reg add(Reg a, Reg b) { return _mm256_add_epi64(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm256_sub_epi64(a, b); }
+
+            // AVX2 has no 64-bit multiply; combine the 32-bit partial products, the high one only matters modulo 2^64
+            static Reg mul(Reg a, Reg b)
+            {
+                Reg low = _mm256_mul_epu32(a, b);
+                Reg cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b), _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+                return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+            }
+
+            static Reg minimum(Reg x, Reg acc) { return _mm256_blendv_epi8(acc, x, _mm256_cmpgt_epi64(acc, x)); }
+            static Reg maximum(Reg x, Reg acc) { return _mm256_blendv_epi8(acc, x, _mm256_cmpgt_epi64(x, acc)); }
+            static unsigned equalMask(Reg a, Reg b) { return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)))); }
+        };
+
+#include "ChVectorKernelsSimd.h"
+    }
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+// The AVX-512 intrinsics start from deliberately undefined registers, which GCC 12 reports with -Wall
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace
+{
+    namespace Avx512
+    {
+        struct F32
+        {
+            using Scalar = float;
+            using Reg = __m512;
+            static constexpr size_t width = 16;
+
+            static Reg zero() { return _mm512_setzero_ps(); }
+            static Reg set1(float value) { return _mm512_set1_ps(value); }
+            static Reg load(const float *data) { return _mm512_loadu_ps(data); }
+            static void store(float *data, Reg reg) { _mm512_storeu_ps(data, reg); }
+            static Reg add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+            static Reg mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+            static Reg minimum(Reg x, Reg acc) { return _mm512_min_ps(x, acc); }
+            static Reg maximum(Reg x, Reg acc) { return _mm512_max_ps(x, acc); }
+            static unsigned equalMask(Reg a, Reg b) { return static_cast<unsigned>(_mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ)); }
+        };
+
+        struct F64
+        {
+            using Scalar = double;
+            using Reg = __m512d;
+            static constexpr size_t width = 8;
+
+            static Reg zero() { return _mm512_setzero_pd(); }
+            static Reg set1(double value) { return _mm512_set1_pd(value); }
+            static Reg load(const double *data) { return _mm512_loadu_pd(data); }
+            static void store(double *data, Reg reg) { _mm512_storeu_pd(data, reg); }
+            static Reg add(Reg a, Reg b) { return _mm512_add_pd(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm512_sub_pd(a, b); }
+            static Reg mul(Reg a, Reg b) { return _mm512_mul_pd(a, b); }
+            static Reg minimum(Reg x, Reg acc) { return _mm512_min_pd(x, acc); }
+            static Reg maximum(Reg x, Reg acc) { return _mm512_max_pd(x, acc); }
+            static unsigned equalMask(Reg a, Reg b) { return static_cast<unsigned>(_mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ)); }
+        };
+
+        struct I32
+        {
+            using Scalar = int32_t;
+            using Reg = __m512i;
+            static constexpr size_t width = 16;
+
+            static Reg zero() { return _mm512_setzero_si512(); }
+            static Reg set1(int32_t value) { return _mm512_set1_epi32(value); }
+            static Reg load(const int32_t *data) { return _mm512_loadu_si512(data); }
+            static void store(int32_t *data, Reg reg) { _mm512_storeu_si512(data, reg); }
+            static Reg add(Reg a, Reg b) { return _mm512_add_epi32(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm512_sub_epi32(a, b); }
+            static Reg mul(Reg a, Reg b) { return _mm512_mullo_epi32(a, b); }
+            static Reg minimum(Reg x, Reg acc) { return _mm512_min_epi32(x, acc); }
+            static Reg maximum(Reg x, Reg acc) { return _mm512_max_epi32(x, acc); }
+            static unsigned equalMask(Reg a, Reg b) { return static_cast<unsigned>(_mm512_cmpeq_epi32_mask(a, b)); }
+        };
+
+        struct I64
+        {
+            using Scalar = int64_t;
+            using Reg = __m512i;
+            static constexpr size_t width = 8;
+
+            static Reg zero() { return _mm512_setzero_si512(); }
+            static Reg set1(int64_t value) { return _mm512_set1_epi64(value); }
+            static Reg load(const int64_t *data) { return _mm512_loadu_si512(data); }
+            static void store(int64_t *data, Reg reg) { _mm512_storeu_si512(data, reg); }
+            static Reg add(Reg a, Reg b) { return _mm512_add_epi64(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm512_sub_epi64(a, b); }
+
+            // The native 64-bit multiply needs AVX-512DQ; the foundation set only multiplies 32-bit halves
+            static Reg mul(Reg a, Reg b)
+            {
+                Reg low = _mm512_mul_epu32(a, b);
+                Reg cross = _mm512_add_epi64(_mm512_mul_epu32(_mm512_srli_epi64(a, 32), b), _mm512_mul_epu32(a, _mm512_srli_epi64(b, 32)));
+                return _mm512_add_epi64(low, _mm512_slli_epi64(cross, 32));
+            }
+
+            static Reg minimum(Reg x, Reg acc) { return _mm512_min_epi64(x, acc); }
+            static Reg maximum(Reg x, Reg acc) { return _mm512_max_epi64(x, acc); }
+            static unsigned equalMask(Reg a, Reg b) { return static_cast<unsigned>(_mm512_cmpeq_epi64_mask(a, b)); }
+        };
+
+#include "ChVectorKernelsSimd.h"
+    }
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+#endif
+
+#endif
+
+namespace
+{
+    template <typename T, typename Avx2Traits, typename Avx512Traits>
+    Kernels<T> selectKernels()
+    {
+#if defined(CHVECTOR_USE_SIMD_DISPATCH)
+        if (ChCpuFeatures::hasAvx512f())
+        {
+            return Avx512::kernels<Avx512Traits>();
+        }
+        if (ChCpuFeatures::hasAvx2())
+        {
+            return Avx2::kernels<Avx2Traits>();
+        }
+#endif
+        return scalarKernels<T>();
+    }
+
+#if defined(CHVECTOR_USE_SIMD_DISPATCH)
+    template <typename T>
+    struct Traits;
+
+    template <>
+    struct Traits<float>
+    {
+        using Avx2Traits = Avx2::F32;
+        using Avx512Traits = Avx512::F32;
+    };
+
+    template <>
+    struct Traits<double>
+    {
+        using Avx2Traits = Avx2::F64;
+        using Avx512Traits = Avx512::F64;
+    };
+
+    template <>
+    struct Traits<int32_t>
+    {
+        using Avx2Traits = Avx2::I32;
+        using Avx512Traits = Avx512::I32;
+    };
+
+    template <>
+    struct Traits<int64_t>
+    {
+        using Avx2Traits = Avx2::I64;
+        using Avx512Traits = Avx512::I64;
+    };
+#else
+    template <typename T>
+    struct Traits
+    {
+        using Avx2Traits = void;
+        using Avx512Traits = void;
+    };
+#endif
+
+    /**
+     * @brief Returns the kernels for T, selected once on first use.
+     */
+    template <typename T>
+    const Kernels<T> &kernelsFor()
+    {
+        static const Kernels<T> selected = selectKernels<T, typename Traits<T>::Avx2Traits, typename Traits<T>::Avx512Traits>();
+        return selected;
+    }
+
+    template <typename T>
+    T sumPairwise(const T *data, size_t size)
+    {
+        if (size <= pairwiseBlockSize)
+        {
+            return kernelsFor<T>().sum(data, size);
+        }
+        size_t half = size / 2;
+        return sumPairwise(data, half) + sumPairwise(data + half, size - half);
+    }
+
+    template <typename T>
+    size_t argMinimum(const T *data, size_t size)
+    {
+        const Kernels<T> &kernels = kernelsFor<T>();
+        // If every value is NaN the minimum stays at its identity, which is then not found either
+        return kernels.indexOf(data, size, kernels.minimum(data, size));
+    }
+
+    template <typename T>
+    size_t argMaximum(const T *data, size_t size)
+    {
+        const Kernels<T> &kernels = kernelsFor<T>();
+        return kernels.indexOf(data, size, kernels.maximum(data, size));
+    }
+}
+
+float ChVectorKernels::sum(const float *data, size_t size)
+{
+    return kernelsFor<float>().sum(data, size);
+}
+
+double ChVectorKernels::sum(const double *data, size_t size)
+{
+    return kernelsFor<double>().sum(data, size);
+}
+
+int32_t ChVectorKernels::sum(const int32_t *data, size_t size)
+{
+    return kernelsFor<int32_t>().sum(data, size);
+}
+
+int64_t ChVectorKernels::sum(const int64_t *data, size_t size)
+{
+    return kernelsFor<int64_t>().sum(data, size);
+}
+
+float ChVectorKernels::sumKahan(const float *data, size_t size)
+{
+    return kernelsFor<float>().sumKahan(data, size);
+}
+
+double ChVectorKernels::sumKahan(const double *data, size_t size)
+{
+    return kernelsFor<double>().sumKahan(data, size);
+}
+
+float ChVectorKernels::sumPairwise(const float *data, size_t size)
+{
+    return ::sumPairwise(data, size);
+}
+
+double ChVectorKernels::sumPairwise(const double *data, size_t size)
+{
+    return ::sumPairwise(data, size);
+}
+
+float ChVectorKernels::dot(const float *left, const float *right, size_t size)
+{
+    return kernelsFor<float>().dot(left, right, size);
+}
+
+double ChVectorKernels::dot(const double *left, const double *right, size_t size)
+{
+    return kernelsFor<double>().dot(left, right, size);
+}
+
+int32_t ChVectorKernels::dot(const int32_t *left, const int32_t *right, size_t size)
+{
+    return kernelsFor<int32_t>().dot(left, right, size);
+}
+
+int64_t ChVectorKernels::dot(const int64_t *left, const int64_t *right, size_t size)
+{
+    return kernelsFor<int64_t>().dot(left, right, size);
+}
+
+size_t ChVectorKernels::indexOf(const float *data, size_t size, float value)
+{
+    return kernelsFor<float>().indexOf(data, size, value);
+}
+
+size_t ChVectorKernels::indexOf(const double *data, size_t size, double value)
+{
+    return kernelsFor<double>().indexOf(data, size, value);
+}
+
+size_t ChVectorKernels::indexOf(const int32_t *data, size_t size, int32_t value)
+{
+    return kernelsFor<int32_t>().indexOf(data, size, value);
+}
+
+size_t ChVectorKernels::indexOf(const int64_t *data, size_t size, int64_t value)
+{
+    return kernelsFor<int64_t>().indexOf(data, size, value);
+}
+
+size_t ChVectorKernels::lastIndexOf(const float *data, size_t size, float value)
+{
+    return kernelsFor<float>().lastIndexOf(data, size, value);
+}
+
+size_t ChVectorKernels::lastIndexOf(const double *data, size_t size, double value)
+{
+    return kernelsFor<double>().lastIndexOf(data, size, value);
+}
+
+size_t ChVectorKernels::lastIndexOf(const int32_t *data, size_t size, int32_t value)
+{
+    return kernelsFor<int32_t>().lastIndexOf(data, size, value);
+}
+
+size_t ChVectorKernels::lastIndexOf(const int64_t *data, size_t size, int64_t value)
+{
+    return kernelsFor<int64_t>().lastIndexOf(data, size, value);
+}
+
+size_t ChVectorKernels::count(const float *data, size_t size, float value)
+{
+    return kernelsFor<float>().count(data, size, value);
+}
+
+size_t ChVectorKernels::count(const double *data, size_t size, double value)
+{
+    return kernelsFor<double>().count(data, size, value);
+}
+
+size_t ChVectorKernels::count(const int32_t *data, size_t size, int32_t value)
+{
+    return kernelsFor<int32_t>().count(data, size, value);
+}
+
+size_t ChVectorKernels::count(const int64_t *data, size_t size, int64_t value)
+{
+    return kernelsFor<int64_t>().count(data, size, value);
+}
+
+size_t ChVectorKernels::argMin(const float *data, size_t size)
+{
+    return argMinimum(data, size);
+}
+
+size_t ChVectorKernels::argMin(const double *data, size_t size)
+{
+    return argMinimum(data, size);
+}
+
+size_t ChVectorKernels::argMin(const int32_t *data, size_t size)
+{
+    return argMinimum(data, size);
+}
+
+size_t ChVectorKernels::argMin(const int64_t *data, size_t size)
+{
+    return argMinimum(data, size);
+}
+
+size_t ChVectorKernels::argMax(const float *data, size_t size)
+{
+    return argMaximum(data, size);
+}
+
+size_t ChVectorKernels::argMax(const double *data, size_t size)
+{
+    return argMaximum(data, size);
+}
+
+size_t ChVectorKernels::argMax(const int32_t *data, size_t size)
+{
+    return argMaximum(data, size);
+}
+
+size_t ChVectorKernels::argMax(const int64_t *data, size_t size)
+{
+    return argMaximum(data, size);
+}
\ No newline at end of file
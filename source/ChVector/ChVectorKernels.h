@@ -0,0 +1,119 @@
+#ifndef CHVECTORKERNELS
+#define CHVECTORKERNELS
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Vectorized reductions and searches behind the arithmetic ChVector algorithms. Not part of the public
+ * interface.
+ *
+ * Kernels exist for float, double, int32_t and int64_t. Each picks the widest implementation the running processor
+ * supports on first use: AVX-512, then AVX2, then scalar. Searches compare with `==`, so NaN is never found.
+ * Floating-point sums use several accumulators and may differ from a left-to-right sum in the last bits.
+ */
+namespace ChVectorKernels
+{
+    /**
+     * @brief True for the element types that have kernels.
+     */
+    template <typename T>
+    struct HasKernels : std::false_type
+    {
+    };
+
+    template <>
+    struct HasKernels<float> : std::true_type
+    {
+    };
+
+    template <>
+    struct HasKernels<double> : std::true_type
+    {
+    };
+
+    template <>
+    struct HasKernels<int32_t> : std::true_type
+    {
+    };
+
+    template <>
+    struct HasKernels<int64_t> : std::true_type
+    {
+    };
+
+    /**
+     * @brief Returns the sum of the `size` values at `data`.
+     */
+    float sum(const float *data, size_t size);
+    double sum(const double *data, size_t size);
+    int32_t sum(const int32_t *data, size_t size);
+    int64_t sum(const int64_t *data, size_t size);
+
+    /**
+     * @brief Returns the sum of the `size` values at `data` with Kahan compensation in every vector lane.
+     */
+    float sumKahan(const float *data, size_t size);
+    double sumKahan(const double *data, size_t size);
+
+    /**
+     * @brief Returns the sum of the `size` values at `data` by recursively halving the range.
+     *
+     * The rounding error grows with the logarithm of `size` instead of linearly.
+     */
+    float sumPairwise(const float *data, size_t size);
+    double sumPairwise(const double *data, size_t size);
+
+    /**
+     * @brief Returns the sum of the products of the `size` value pairs at `left` and `right`.
+     */
+    float dot(const float *left, const float *right, size_t size);
+    double dot(const double *left, const double *right, size_t size);
+    int32_t dot(const int32_t *left, const int32_t *right, size_t size);
+    int64_t dot(const int64_t *left, const int64_t *right, size_t size);
+
+    /**
+     * @brief Returns the index of the first value equal to `value`, or `size` if there is none.
+     */
+    size_t indexOf(const float *data, size_t size, float value);
+    size_t indexOf(const double *data, size_t size, double value);
+    size_t indexOf(const int32_t *data, size_t size, int32_t value);
+    size_t indexOf(const int64_t *data, size_t size, int64_t value);
+
+    /**
+     * @brief Returns the index of the last value equal to `value`, or `size` if there is none.
+     */
+    size_t lastIndexOf(const float *data, size_t size, float value);
+    size_t lastIndexOf(const double *data, size_t size, double value);
+    size_t lastIndexOf(const int32_t *data, size_t size, int32_t value);
+    size_t lastIndexOf(const int64_t *data, size_t size, int64_t value);
+
+    /**
+     * @brief Returns the number of values equal to `value`.
+     */
+    size_t count(const float *data, size_t size, float value);
+    size_t count(const double *data, size_t size, double value);
+    size_t count(const int32_t *data, size_t size, int32_t value);
+    size_t count(const int64_t *data, size_t size, int64_t value);
+
+    /**
+     * @brief Returns the index of the first smallest value, or `size` if there is none. NaN values are skipped, which
+     * holds only for these kernel types: the element types without kernels fall back to the standard algorithms.
+     */
+    size_t argMin(const float *data, size_t size);
+    size_t argMin(const double *data, size_t size);
+    size_t argMin(const int32_t *data, size_t size);
+    size_t argMin(const int64_t *data, size_t size);
+
+    /**
+     * @brief Returns the index of the first largest value, or `size` if there is none. NaN values are skipped, which
+     * holds only for these kernel types: the element types without kernels fall back to the standard algorithms.
+     */
+    size_t argMax(const float *data, size_t size);
+    size_t argMax(const double *data, size_t size);
+    size_t argMax(const int32_t *data, size_t size);
+    size_t argMax(const int64_t *data, size_t size);
+}
+
+#endif
\ No newline at end of file
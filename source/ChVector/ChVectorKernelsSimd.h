@@ -0,0 +1,242 @@
+// Kernel bodies shared by every vector instruction set. Not part of the public interface.
+//
+// ChVectorKernels.cpp includes this file once per instruction set, inside a namespace that defines the register
+// traits F32, F64, I32 and I64 and inside a region that enables that instruction set for the compiler. It therefore
+// has no include guard. Every kernel is a template over the traits V, which provide:
+//
+//   Scalar, Reg, width, zero(), set1(value), load(pointer), store(pointer, reg), add, sub, mul,
+//   minimum(x, acc) and maximum(x, acc) which keep `acc` when `x` is NaN,
+//   equalMask(a, b) which returns one bit per lane.
+//
+// Integer lanes wrap around on overflow, so the scalar parts use wrappingAdd and wrappingMul to match them.
+
+template <typename V>
+typename V::Scalar horizontalSum(typename V::Reg reg)
+{
+    typename V::Scalar lanes[V::width];
+    V::store(lanes, reg);
+    typename V::Scalar result = typename V::Scalar();
+    for (size_t lane = 0; lane < V::width; ++lane)
+    {
+        result = wrappingAdd(result, lanes[lane]);
+    }
+    return result;
+}
+
+template <typename V>
+typename V::Scalar sumSimd(const typename V::Scalar *data, size_t size)
+{
+    const size_t width = V::width;
+    typename V::Reg sum0 = V::zero();
+    typename V::Reg sum1 = V::zero();
+    typename V::Reg sum2 = V::zero();
+    typename V::Reg sum3 = V::zero();
+    size_t i = 0;
+    for (; i + 4 * width <= size; i += 4 * width)
+    {
+        sum0 = V::add(sum0, V::load(data + i));
+        sum1 = V::add(sum1, V::load(data + i + width));
+        sum2 = V::add(sum2, V::load(data + i + 2 * width));
+        sum3 = V::add(sum3, V::load(data + i + 3 * width));
+    }
+    for (; i + width <= size; i += width)
+    {
+        sum0 = V::add(sum0, V::load(data + i));
+    }
+
+    typename V::Scalar result = horizontalSum<V>(V::add(V::add(sum0, sum1), V::add(sum2, sum3)));
+    for (; i < size; ++i)
+    {
+        result = wrappingAdd(result, data[i]);
+    }
+    return result;
+}
+
+template <typename V>
+typename V::Scalar sumKahanSimd(const typename V::Scalar *data, size_t size)
+{
+    using T = typename V::Scalar;
+    const size_t width = V::width;
+    typename V::Reg sum = V::zero();
+    typename V::Reg compensation = V::zero();
+    size_t i = 0;
+    for (; i + width <= size; i += width)
+    {
+        typename V::Reg value = V::sub(V::load(data + i), compensation);
+        typename V::Reg next = V::add(sum, value);
+        compensation = V::sub(V::sub(next, sum), value);
+        sum = next;
+    }
+
+    T sums[V::width];
+    T compensations[V::width];
+    V::store(sums, sum);
+    V::store(compensations, compensation);
+    T result = T();
+    T carry = T();
+    for (size_t lane = 0; lane < width; ++lane)
+    {
+        kahanAdd(result, carry, sums[lane]);
+        kahanAdd(result, carry, -compensations[lane]);
+    }
+    for (; i < size; ++i)
+    {
+        kahanAdd(result, carry, data[i]);
+    }
+    return result;
+}
+
+template <typename V>
+typename V::Scalar dotSimd(const typename V::Scalar *left, const typename V::Scalar *right, size_t size)
+{
+    const size_t width = V::width;
+    typename V::Reg sum0 = V::zero();
+    typename V::Reg sum1 = V::zero();
+    size_t i = 0;
+    for (; i + 2 * width <= size; i += 2 * width)
+    {
+        sum0 = V::add(sum0, V::mul(V::load(left + i), V::load(right + i)));
+        sum1 = V::add(sum1, V::mul(V::load(left + i + width), V::load(right + i + width)));
+    }
+    for (; i + width <= size; i += width)
+    {
+        sum0 = V::add(sum0, V::mul(V::load(left + i), V::load(right + i)));
+    }
+
+    typename V::Scalar result = horizontalSum<V>(V::add(sum0, sum1));
+    for (; i < size; ++i)
+    {
+        result = wrappingAdd(result, wrappingMul(left[i], right[i]));
+    }
+    return result;
+}
+
+template <typename V>
+size_t indexOfSimd(const typename V::Scalar *data, size_t size, typename V::Scalar value)
+{
+    const typename V::Reg needle = V::set1(value);
+    size_t i = 0;
+    for (; i + V::width <= size; i += V::width)
+    {
+        unsigned mask = V::equalMask(V::load(data + i), needle);
+        if (mask != 0)
+        {
+            return i + ChBits::countTrailingZeros(mask);
+        }
+    }
+    for (; i < size; ++i)
+    {
+        if (data[i] == value)
+        {
+            return i;
+        }
+    }
+    return size;
+}
+
+template <typename V>
+size_t lastIndexOfSimd(const typename V::Scalar *data, size_t size, typename V::Scalar value)
+{
+    const typename V::Reg needle = V::set1(value);
+    size_t i = size;
+    while (i >= V::width)
+    {
+        i -= V::width;
+        unsigned mask = V::equalMask(V::load(data + i), needle);
+        if (mask != 0)
+        {
+            return i + ChBits::highestSetBit(mask);
+        }
+    }
+    while (i > 0)
+    {
+        --i;
+        if (data[i] == value)
+        {
+            return i;
+        }
+    }
+    return size;
+}
+
+template <typename V>
+size_t countSimd(const typename V::Scalar *data, size_t size, typename V::Scalar value)
+{
+    const typename V::Reg needle = V::set1(value);
+    size_t result = 0;
+    size_t i = 0;
+    for (; i + V::width <= size; i += V::width)
+    {
+        result += ChBits::popCount(V::equalMask(V::load(data + i), needle));
+    }
+    for (; i < size; ++i)
+    {
+        result += data[i] == value ? 1 : 0;
+    }
+    return result;
+}
+
+template <typename V>
+typename V::Scalar minimumSimd(const typename V::Scalar *data, size_t size)
+{
+    using T = typename V::Scalar;
+    typename V::Reg best = V::set1(minimumIdentity<T>());
+    size_t i = 0;
+    for (; i + V::width <= size; i += V::width)
+    {
+        best = V::minimum(V::load(data + i), best);
+    }
+
+    T lanes[V::width];
+    V::store(lanes, best);
+    T result = minimumIdentity<T>();
+    for (size_t lane = 0; lane < V::width; ++lane)
+    {
+        result = lanes[lane] < result ? lanes[lane] : result;
+    }
+    for (; i < size; ++i)
+    {
+        result = data[i] < result ? data[i] : result;
+    }
+    return result;
+}
+
+template <typename V>
+typename V::Scalar maximumSimd(const typename V::Scalar *data, size_t size)
+{
+    using T = typename V::Scalar;
+    typename V::Reg best = V::set1(maximumIdentity<T>());
+    size_t i = 0;
+    for (; i + V::width <= size; i += V::width)
+    {
+        best = V::maximum(V::load(data + i), best);
+    }
+
+    T lanes[V::width];
+    V::store(lanes, best);
+    T result = maximumIdentity<T>();
+    for (size_t lane = 0; lane < V::width; ++lane)
+    {
+        result = lanes[lane] > result ? lanes[lane] : result;
+    }
+    for (; i < size; ++i)
+    {
+        result = data[i] > result ? data[i] : result;
+    }
+    return result;
+}
+
+template <typename V>
+Kernels<typename V::Scalar> kernels()
+{
+    Kernels<typename V::Scalar> result;
+    result.sum = sumSimd<V>;
+    result.sumKahan = sumKahanSimd<V>;
+    result.dot = dotSimd<V>;
+    result.indexOf = indexOfSimd<V>;
+    result.lastIndexOf = lastIndexOfSimd<V>;
+    result.count = countSimd<V>;
+    result.minimum = minimumSimd<V>;
+    result.maximum = maximumSimd<V>;
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,613 @@
+#ifndef CHVIEW
+#define CHVIEW
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+template <typename T, typename Allocator>
+class ChVector;
+
+template <typename Base, typename Fn>
+class ChMapView;
+
+template <typename Base, typename Pred>
+class ChFilterView;
+
+template <typename Base>
+class ChTakeView;
+
+template <typename Base>
+class ChEnumerateView;
+
+template <typename First, typename Second>
+class ChZipView;
+
+/**
+ * @brief Adaptors shared by all lazy views.
+ *
+ * A view does not own or copy elements. Adaptors such as `map` and `filter` return a new view that applies the
+ * operation on the fly, so a chain of them runs as a single pass over the source when it is iterated or when a
+ * terminal operation (`collect`, `sum`, `forEach`) consumes it. Nothing is allocated before `collect`.
+ *
+ * @code
+ * double total = samples.view()
+ *     .map([](const Sample &s) { return s.weight; })
+ *     .filter([](double w) { return w > 0; })
+ *     .sum();
+ * @endcode
+ *
+ * A view refers to the elements of the container it was made from; it becomes invalid when that container is
+ * modified or destroyed. Functions passed to adaptors are stored in the view and must be callable as const.
+ *
+ * Every view provides `value_type`, `reference`, `begin()`, `end()` and `push(sink)`. `push` passes each element to
+ * `sink` until the sink returns false; terminal operations use it so that every function in the chain is called
+ * once per element.
+ *
+ * @tparam Derived The view type.
+ */
+template <typename Derived>
+class ChViewBase
+{
+public:
+    /**
+     * @brief Returns a view of `func(element)` for every element.
+     */
+    template <typename Fn>
+    ChMapView<Derived, Fn> map(Fn func) const
+    {
+        return ChMapView<Derived, Fn>(derived(), std::move(func));
+    }
+
+    /**
+     * @brief Returns a view of the elements for which `predicate(element)` is true.
+     */
+    template <typename Pred>
+    ChFilterView<Derived, Pred> filter(Pred predicate) const
+    {
+        return ChFilterView<Derived, Pred>(derived(), std::move(predicate));
+    }
+
+    /**
+     * @brief Returns a view of the first `count` elements, or of all elements if there are fewer.
+     */
+    ChTakeView<Derived> take(size_t count) const
+    {
+        return ChTakeView<Derived>(derived(), count);
+    }
+
+    /**
+     * @brief Returns a view of (index, element) pairs, counting from zero.
+     */
+    ChEnumerateView<Derived> enumerate() const
+    {
+        return ChEnumerateView<Derived>(derived());
+    }
+
+    /**
+     * @brief Returns a view of (element, other element) pairs. It ends with the shorter of the two views.
+     */
+    template <typename Other>
+    ChZipView<Derived, Other> zip(const Other &other) const
+    {
+        return ChZipView<Derived, Other>(derived(), other);
+    }
+
+    /**
+     * @brief Calls `func(element)` for every element.
+     */
+    template <typename Fn>
+    void forEach(Fn func) const
+    {
+        derived().push([&func](auto &&value)
+        {
+            func(std::forward<decltype(value)>(value));
+            return true;
+        });
+    }
+
+    /**
+     * @brief Returns the sum of the elements, or a value-initialized value_type if there are none.
+     */
+    auto sum() const
+    {
+        typename Derived::value_type result = typename Derived::value_type();
+        derived().push([&result](auto &&value)
+        {
+            result += value;
+            return true;
+        });
+        return result;
+    }
+
+    /**
+     * @brief Materializes the view into a new ChVector.
+     */
+    auto collect() const
+    {
+        using Value = typename Derived::value_type;
+        ChVector<Value, std::allocator<Value>> result;
+        derived().push([&result](auto &&value)
+        {
+            result.emplace_back(std::forward<decltype(value)>(value));
+            return true;
+        });
+        return result;
+    }
+
+    /**
+     * @brief Materializes the view into a ChVector, so that views can be assigned to ChVector objects.
+     */
+    template <typename T, typename Allocator>
+    operator ChVector<T, Allocator>() const
+    {
+        ChVector<T, Allocator> result;
+        derived().push([&result](auto &&value)
+        {
+            result.emplace_back(std::forward<decltype(value)>(value));
+            return true;
+        });
+        return result;
+    }
+
+protected:
+    const Derived &derived() const
+    {
+        return static_cast<const Derived &>(*this);
+    }
+};
+
+/**
+ * @brief A view of a contiguous range of elements, the source of a view chain.
+ *
+ * @tparam T The type of the elements.
+ */
+template <typename T>
+class ChSpanView : public ChViewBase<ChSpanView<T>>
+{
+public:
+    using value_type = T;
+    using reference = const T &;
+    using iterator = const T *;
+
+    /**
+     * @brief Constructs a view of the elements in [first, last).
+     */
+    ChSpanView(const T *first, const T *last) : first_(first), last_(last) {}
+
+    iterator begin() const
+    {
+        return first_;
+    }
+
+    iterator end() const
+    {
+        return last_;
+    }
+
+    /**
+     * @brief Returns the number of elements.
+     */
+    size_t size() const
+    {
+        return static_cast<size_t>(last_ - first_);
+    }
+
+    template <typename Sink>
+    bool push(Sink &&sink) const
+    {
+        for (const T *it = first_; it != last_; ++it)
+        {
+            if (!sink(*it))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    const T *first_;
+    const T *last_;
+};
+
+/**
+ * @brief A view of `func(element)` for every element of `Base`. See ChViewBase::map.
+ */
+template <typename Base, typename Fn>
+class ChMapView : public ChViewBase<ChMapView<Base, Fn>>
+{
+public:
+    using reference = decltype(std::declval<const Fn &>()(std::declval<typename Base::reference>()));
+    using value_type = typename std::decay<reference>::type;
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = ChMapView::value_type;
+        using reference = ChMapView::reference;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+
+        iterator(typename Base::iterator it, const Fn *func) : it_(it), func_(func) {}
+
+        reference operator*() const
+        {
+            return (*func_)(*it_);
+        }
+
+        iterator &operator++()
+        {
+            ++it_;
+            return *this;
+        }
+
+        bool operator==(const iterator &other) const
+        {
+            return it_ == other.it_;
+        }
+
+        bool operator!=(const iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        typename Base::iterator it_;
+        const Fn *func_;
+    };
+
+    ChMapView(const Base &base, Fn func) : base_(base), func_(std::move(func)) {}
+
+    iterator begin() const
+    {
+        return iterator(base_.begin(), &func_);
+    }
+
+    iterator end() const
+    {
+        return iterator(base_.end(), &func_);
+    }
+
+    template <typename Sink>
+    bool push(Sink &&sink) const
+    {
+        return base_.push([this, &sink](auto &&value)
+        {
+            return sink(func_(std::forward<decltype(value)>(value)));
+        });
+    }
+
+private:
+    Base base_;
+    Fn func_;
+};
+
+/**
+ * @brief A view of the elements of `Base` that satisfy a predicate. See ChViewBase::filter.
+ */
+template <typename Base, typename Pred>
+class ChFilterView : public ChViewBase<ChFilterView<Base, Pred>>
+{
+public:
+    using reference = typename Base::reference;
+    using value_type = typename Base::value_type;
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = ChFilterView::value_type;
+        using reference = ChFilterView::reference;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+
+        iterator(typename Base::iterator it, typename Base::iterator end, const Pred *predicate)
+            : it_(it), end_(end), predicate_(predicate)
+        {
+            skipRejected();
+        }
+
+        reference operator*() const
+        {
+            return *it_;
+        }
+
+        iterator &operator++()
+        {
+            ++it_;
+            skipRejected();
+            return *this;
+        }
+
+        bool operator==(const iterator &other) const
+        {
+            return it_ == other.it_;
+        }
+
+        bool operator!=(const iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        void skipRejected()
+        {
+            while (it_ != end_ && !(*predicate_)(*it_))
+            {
+                ++it_;
+            }
+        }
+
+        typename Base::iterator it_;
+        typename Base::iterator end_;
+        const Pred *predicate_;
+    };
+
+    ChFilterView(const Base &base, Pred predicate) : base_(base), predicate_(std::move(predicate)) {}
+
+    iterator begin() const
+    {
+        return iterator(base_.begin(), base_.end(), &predicate_);
+    }
+
+    iterator end() const
+    {
+        return iterator(base_.end(), base_.end(), &predicate_);
+    }
+
+    template <typename Sink>
+    bool push(Sink &&sink) const
+    {
+        return base_.push([this, &sink](auto &&value)
+        {
+            return !predicate_(value) || sink(std::forward<decltype(value)>(value));
+        });
+    }
+
+private:
+    Base base_;
+    Pred predicate_;
+};
+
+/**
+ * @brief A view of the first elements of `Base`. See ChViewBase::take.
+ */
+template <typename Base>
+class ChTakeView : public ChViewBase<ChTakeView<Base>>
+{
+public:
+    using reference = typename Base::reference;
+    using value_type = typename Base::value_type;
+
+    /**
+     * @brief Iterates until either the count is used up or `Base` ends. Only comparisons with `end()` are meaningful.
+     */
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = ChTakeView::value_type;
+        using reference = ChTakeView::reference;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+
+        iterator(typename Base::iterator it, size_t remaining) : it_(it), remaining_(remaining) {}
+
+        reference operator*() const
+        {
+            return *it_;
+        }
+
+        iterator &operator++()
+        {
+            ++it_;
+            --remaining_;
+            return *this;
+        }
+
+        bool operator==(const iterator &other) const
+        {
+            return remaining_ == other.remaining_ || it_ == other.it_;
+        }
+
+        bool operator!=(const iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        typename Base::iterator it_;
+        size_t remaining_;
+    };
+
+    ChTakeView(const Base &base, size_t count) : base_(base), count_(count) {}
+
+    iterator begin() const
+    {
+        return iterator(base_.begin(), count_);
+    }
+
+    iterator end() const
+    {
+        return iterator(base_.end(), 0);
+    }
+
+    template <typename Sink>
+    bool push(Sink &&sink) const
+    {
+        if (count_ == 0)
+        {
+            return true;
+        }
+        size_t remaining = count_;
+        return base_.push([&remaining, &sink](auto &&value)
+        {
+            return sink(std::forward<decltype(value)>(value)) && --remaining != 0;
+        });
+    }
+
+private:
+    Base base_;
+    size_t count_;
+};
+
+/**
+ * @brief A view of (index, element) pairs of `Base`. See ChViewBase::enumerate.
+ */
+template <typename Base>
+class ChEnumerateView : public ChViewBase<ChEnumerateView<Base>>
+{
+public:
+    using reference = std::pair<size_t, typename Base::reference>;
+    using value_type = std::pair<size_t, typename Base::value_type>;
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = ChEnumerateView::value_type;
+        using reference = ChEnumerateView::reference;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+
+        iterator(typename Base::iterator it) : it_(it), index_(0) {}
+
+        reference operator*() const
+        {
+            return reference(index_, *it_);
+        }
+
+        iterator &operator++()
+        {
+            ++it_;
+            ++index_;
+            return *this;
+        }
+
+        bool operator==(const iterator &other) const
+        {
+            return it_ == other.it_;
+        }
+
+        bool operator!=(const iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        typename Base::iterator it_;
+        size_t index_;
+    };
+
+    explicit ChEnumerateView(const Base &base) : base_(base) {}
+
+    iterator begin() const
+    {
+        return iterator(base_.begin());
+    }
+
+    iterator end() const
+    {
+        return iterator(base_.end());
+    }
+
+    template <typename Sink>
+    bool push(Sink &&sink) const
+    {
+        size_t index = 0;
+        return base_.push([&index, &sink](auto &&value)
+        {
+            return sink(reference(index++, std::forward<decltype(value)>(value)));
+        });
+    }
+
+private:
+    Base base_;
+};
+
+/**
+ * @brief A view of pairs of corresponding elements of two views. See ChViewBase::zip.
+ */
+template <typename First, typename Second>
+class ChZipView : public ChViewBase<ChZipView<First, Second>>
+{
+public:
+    using reference = std::pair<typename First::reference, typename Second::reference>;
+    using value_type = std::pair<typename First::value_type, typename Second::value_type>;
+
+    /**
+     * @brief Iterates until either view ends. Only comparisons with `end()` are meaningful.
+     */
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = ChZipView::value_type;
+        using reference = ChZipView::reference;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+
+        iterator(typename First::iterator first, typename Second::iterator second) : first_(first), second_(second) {}
+
+        reference operator*() const
+        {
+            return reference(*first_, *second_);
+        }
+
+        iterator &operator++()
+        {
+            ++first_;
+            ++second_;
+            return *this;
+        }
+
+        bool operator==(const iterator &other) const
+        {
+            return first_ == other.first_ || second_ == other.second_;
+        }
+
+        bool operator!=(const iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        typename First::iterator first_;
+        typename Second::iterator second_;
+    };
+
+    ChZipView(const First &first, const Second &second) : first_(first), second_(second) {}
+
+    iterator begin() const
+    {
+        return iterator(first_.begin(), second_.begin());
+    }
+
+    iterator end() const
+    {
+        return iterator(first_.end(), second_.end());
+    }
+
+    template <typename Sink>
+    bool push(Sink &&sink) const
+    {
+        for (iterator it = begin(), last = end(); it != last; ++it)
+        {
+            if (!sink(*it))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    First first_;
+    Second second_;
+};
+
+#endif
\ No newline at end of file